@@ -0,0 +1,630 @@
+/**
+ * @file trace_replay.c
+ * @author Iwan Ćulumović
+ * @brief Trace replay benchmark. Replays a recorded or synthetic job trace through flow control, the communication
+ * manager and the calculator on the Linux target, with the simulated transport acting as the master.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/* ============================== INCLUDES */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include "comm/comm_manager.h"
+#include "comm/comm_protocol.h"
+#include "comm/driver/sim_manager.h"
+#include "sha256_calculator.h"
+#include "sha256_stream.h"
+#include "flow_control.h"
+#include "log_deferred.h"
+#include "profiler.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Log tag. */
+#define LOG_TAG                                 ("TRACE_REPLAY")
+
+/** @brief Maximum number of jobs in a trace. */
+#define TRACE_MAX_JOBS                          (8192)
+
+/** @brief Maximum trace file line length. */
+#define TRACE_LINE_SIZE                         (256)
+
+/** @brief Number of distinct puzzle IDs. */
+#define PUZZLE_ID_COUNT                         (256)
+
+/** @brief Time to wait for the last job to be solved after the trace ends. */
+#define DRAIN_TIMEOUT_US                        (10000000)
+
+/** @brief Master read timeout of the solution reader task. */
+#define READ_TIMEOUT_MS                         (100)
+
+/** @brief Solution reader task stack depth. */
+#define TASK_SOLUTION_READER_STACK_DEPTH        (4096)
+
+/** @brief Solution reader task priority. Higher than the firmware tasks so solutions are read as soon as they are set. */
+#define TASK_SOLUTION_READER_PRIORITY           (2)
+
+/** @brief Replay task stack depth. */
+#define TASK_REPLAY_STACK_DEPTH                 (4096)
+
+/** @brief Replay task priority. Higher than the firmware tasks so jobs are written on time. */
+#define TASK_REPLAY_PRIORITY                    (2)
+
+/** @brief Default number of synthetic jobs, TRACE_JOBS. */
+#define TRACE_JOBS_DEFAULT                      (200)
+
+/** @brief Default mean number of jobs in a burst, TRACE_BURST_SIZE. */
+#define TRACE_BURST_SIZE_DEFAULT                (4)
+
+/** @brief Default mean gap between bursts, TRACE_BURST_GAP_US. */
+#define TRACE_BURST_GAP_US_DEFAULT              (200000)
+
+/** @brief Default mean spacing of jobs in a burst, TRACE_BURST_SPACING_US. */
+#define TRACE_BURST_SPACING_US_DEFAULT          (2000)
+
+/** @brief Default smallest number of compared target bits, TRACE_MASK_BITS_MIN. */
+#define TRACE_MASK_BITS_MIN_DEFAULT             (8)
+
+/** @brief Default largest number of compared target bits, TRACE_MASK_BITS_MAX. */
+#define TRACE_MASK_BITS_MAX_DEFAULT             (18)
+
+/** @brief Default random seed, TRACE_SEED. */
+#define TRACE_SEED_DEFAULT                      (1)
+
+/** @brief Default time budget of every job, TRACE_TIME_BUDGET_MS, 0 for no limit. */
+#define TRACE_TIME_BUDGET_MS_DEFAULT            (0)
+
+/** @brief Default hash budget of every job, TRACE_HASH_BUDGET, 0 for no limit. */
+#define TRACE_HASH_BUDGET_DEFAULT               (0)
+
+/** @brief Default number of distinct targets of a synthetic trace, TRACE_TARGETS, 0 for a new target every job. */
+#define TRACE_TARGETS_DEFAULT                   (0)
+
+/** @brief Default job encoding, TRACE_RESIDENT, 1 writes jobs as resident job requests. */
+#define TRACE_RESIDENT_DEFAULT                  (0)
+
+/* ============================== TYPE DEFINITIONS */
+
+/**
+ * @brief Trace job.
+ * 
+ */
+typedef struct {
+    int64_t arrival_us;                                 //! Arrival time relative to the start of the replay
+    sha256_nonce_t input_offset;                        //! Input offset of the puzzle
+    uint8_t target_solution_mask_offset;                //! Mask offset of the puzzle
+    uint8_t target_solution[SHA256_BYTE_DIGEST_SIZE];   //! Target solution of the puzzle
+    int64_t written_us;                                 //! Time the master wrote the job, set during the replay
+    int64_t solved_us;                                  //! Time the master read the solution, 0 if never solved
+    uint8_t status;                                     //! Solution status, valid if solved
+} trace_job_t;
+
+/* ============================== PRIVATE FUNCTION DECLARATIONS */
+
+/**
+ * @brief Reads an integer parameter from the environment.
+ * 
+ * @param p_name Environment variable name.
+ * @param default_value Value if the variable isn't set.
+ * 
+ * @return long long Parameter value.
+ */
+static long long _trace_param_get(const char *p_name, long long default_value);
+
+/**
+ * @brief Loads a trace from a CSV file with lines of arrival_us,mask_offset,input_offset,target_hex.
+ * 
+ * @param p_path Path to the trace file.
+ * 
+ * @return int Number of loaded jobs.
+ */
+static int _trace_load(const char *p_path);
+
+/**
+ * @brief Generates a synthetic trace of bursty job arrivals with mixed difficulties.
+ * 
+ * @return int Number of generated jobs.
+ */
+static int _trace_generate(void);
+
+/**
+ * @brief Saves the trace to a CSV file that can be replayed with TRACE_FILE.
+ * 
+ * @param p_path Path to the trace file.
+ */
+static void _trace_save(const char *p_path);
+
+/**
+ * @brief Task that replays the trace and reports the results.
+ * 
+ * @param p_task_params Task parameters (not used).
+ */
+static void _trace_replay_task(void *p_task_params);
+
+/**
+ * @brief Writes a job as the master, as a full job or as a resident job request that names a resident target.
+ * 
+ * @param job_index Index of the trace job.
+ * @param p_sha256_input_variables_queue_element Pointer to the full job.
+ * @param b_resident True to write a resident job request, storing the job first if its target isn't resident.
+ * 
+ * @return size_t Number of bytes written.
+ */
+static size_t _trace_job_write(int job_index, const sha256_input_variables_queue_element_t *p_sha256_input_variables_queue_element, bool b_resident);
+
+/**
+ * @brief Task that reads solutions as the master.
+ * 
+ * @param p_task_params Task parameters (not used).
+ */
+static void _solution_reader_task(void *p_task_params);
+
+/**
+ * @brief Records the solve time of the job a solution belongs to.
+ * 
+ * @param p_sha256_offset_solution_queue_element Pointer to the offset solution queue element.
+ */
+static void _solution_record(const sha256_offset_solution_queue_element_t *p_sha256_offset_solution_queue_element);
+
+/**
+ * @brief Logs solution latency percentiles, idle fraction and wasted work.
+ * 
+ * @param p_status_start Pointer to the calculator status at the start of the replay.
+ * @param p_status_end Pointer to the calculator status at the end of the replay.
+ * @param replay_us Duration of the replay.
+ */
+static void _trace_report(const sha256_calculator_status_t *p_status_start, const sha256_calculator_status_t *p_status_end, int64_t replay_us);
+
+/**
+ * @brief Compares two latencies for sorting.
+ * 
+ * @param p_a Pointer to the first latency.
+ * @param p_b Pointer to the second latency.
+ * 
+ * @return int Comparison result.
+ */
+static int _latency_compare(const void *p_a, const void *p_b);
+
+/* ============================== PRIVATE VARIABLES */
+
+/** @brief Trace jobs. */
+static trace_job_t _g_trace_jobs[TRACE_MAX_JOBS] = {0};
+
+/** @brief Number of trace jobs. */
+static int _g_trace_job_count = 0;
+
+/** @brief Index of the job last written with each puzzle ID. */
+static volatile int _g_puzzle_job_index[PUZZLE_ID_COUNT] = {0};
+
+/** @brief Solution latencies of solved jobs, filled by the report. */
+static int64_t _g_latencies_us[TRACE_MAX_JOBS] = {0};
+
+/** @brief Trace job whose target each resident job holds, -1 if none, replay task only. */
+static int _g_resident_job_index[COMM_RESIDENT_JOB_COUNT] = {0};
+
+/** @brief Resident job replaced by the next target that isn't resident, replay task only. */
+static int _g_resident_job_next = 0;
+
+/** @brief Bytes the master wrote during the replay. */
+static uint64_t _g_bytes_written = 0;
+
+/* ============================== PUBLIC VARIABLES */
+
+/* ============================== PUBLIC FUNCTION DEFINITIONS */
+
+void app_main(void)
+{
+    const char *p_trace_file = getenv("TRACE_FILE");
+    const char *p_trace_save = getenv("TRACE_SAVE");
+
+    _g_trace_job_count = (NULL != p_trace_file) ? _trace_load(p_trace_file) : _trace_generate();
+    if (0 == _g_trace_job_count)
+    {
+        ESP_LOGE(LOG_TAG, "Empty trace. Aborting!");
+        abort();
+    }
+
+    if (NULL != p_trace_save) _trace_save(p_trace_save);
+
+    log_deferred_init();
+    profiler_init();
+    sha256_stream_init();
+    comm_manager_init();
+    sha256_calculator_init();
+    flow_control_init();
+
+    xTaskCreate(_solution_reader_task, "SOLUTION_READ", TASK_SOLUTION_READER_STACK_DEPTH, NULL, TASK_SOLUTION_READER_PRIORITY, NULL);
+    xTaskCreate(_trace_replay_task, "TRACE_REPLAY", TASK_REPLAY_STACK_DEPTH, NULL, TASK_REPLAY_PRIORITY, NULL);
+}
+
+/* ============================== PRIVATE FUNCTION DEFINITIONS */
+
+static long long _trace_param_get(const char *p_name, long long default_value)
+{
+    const char *p_value = getenv(p_name);
+
+    return (NULL != p_value) ? strtoll(p_value, NULL, 0) : default_value;
+}
+
+static int _trace_load(const char *p_path)
+{
+    FILE *p_file = fopen(p_path, "r");
+    char line[TRACE_LINE_SIZE] = {0};
+    char target_hex[2 * SHA256_BYTE_DIGEST_SIZE + 1] = {0};
+    long long arrival_us = 0;
+    unsigned int mask_offset = 0;
+    unsigned long long input_offset = 0;
+    trace_job_t *p_job = NULL;
+    int count = 0;
+    int i = 0;
+
+    if (NULL == p_file)
+    {
+        ESP_LOGE(LOG_TAG, "Failed to open trace file %s. Aborting!", p_path);
+        abort();
+    }
+
+    while ((count < TRACE_MAX_JOBS) && (NULL != fgets(line, sizeof(line), p_file)))
+    {
+        if (('#' == line[0]) || ('\n' == line[0])) continue;
+
+        if (4 != sscanf(line, "%lld,%u,%llu,%64s", &arrival_us, &mask_offset, &input_offset, target_hex))
+        {
+            ESP_LOGE(LOG_TAG, "Malformed trace line: %s Aborting!", line);
+            abort();
+        }
+
+        p_job = &_g_trace_jobs[count++];
+        p_job->arrival_us = arrival_us;
+        p_job->target_solution_mask_offset = (uint8_t)mask_offset;
+        p_job->input_offset = (sha256_nonce_t)input_offset;
+        for (i = 0; i < SHA256_BYTE_DIGEST_SIZE; i++)
+        {
+            sscanf(&target_hex[2 * i], "%2hhx", &p_job->target_solution[i]);
+        }
+    }
+
+    fclose(p_file);
+
+    ESP_LOGI(LOG_TAG, "Loaded %d jobs from %s.", count, p_path);
+
+    return count;
+}
+
+static int _trace_generate(void)
+{
+    int jobs = (int)_trace_param_get("TRACE_JOBS", TRACE_JOBS_DEFAULT);
+    int burst_size = (int)_trace_param_get("TRACE_BURST_SIZE", TRACE_BURST_SIZE_DEFAULT);
+    int64_t burst_gap_us = _trace_param_get("TRACE_BURST_GAP_US", TRACE_BURST_GAP_US_DEFAULT);
+    int64_t burst_spacing_us = _trace_param_get("TRACE_BURST_SPACING_US", TRACE_BURST_SPACING_US_DEFAULT);
+    int mask_bits_min = (int)_trace_param_get("TRACE_MASK_BITS_MIN", TRACE_MASK_BITS_MIN_DEFAULT);
+    int mask_bits_max = (int)_trace_param_get("TRACE_MASK_BITS_MAX", TRACE_MASK_BITS_MAX_DEFAULT);
+    int targets = (int)_trace_param_get("TRACE_TARGETS", TRACE_TARGETS_DEFAULT);
+    int64_t arrival_us = 0;
+    int burst_left = 0;
+    trace_job_t *p_job = NULL;
+    int count = 0;
+    int i = 0;
+
+    srand((unsigned int)_trace_param_get("TRACE_SEED", TRACE_SEED_DEFAULT));
+
+    if (jobs > TRACE_MAX_JOBS) jobs = TRACE_MAX_JOBS;
+    if (burst_size < 1) burst_size = 1;
+    if (mask_bits_min < 1) mask_bits_min = 1;
+    if (mask_bits_max < mask_bits_min) mask_bits_max = mask_bits_min;
+
+    for (count = 0; count < jobs; count++)
+    {
+        /* Bursts of 1 to 2 * burst size jobs, each job in a burst replaces the previous one */
+        if (0 == burst_left)
+        {
+            burst_left = 1 + (rand() % (2 * burst_size));
+            arrival_us += (0 == count) ? 0 : (burst_gap_us / 2) + (rand() % (burst_gap_us + 1));
+        }
+        else
+        {
+            arrival_us += (burst_spacing_us / 2) + (rand() % (burst_spacing_us + 1));
+        }
+        burst_left--;
+
+        p_job = &_g_trace_jobs[count];
+        p_job->arrival_us = arrival_us;
+        p_job->target_solution_mask_offset = (uint8_t)(mask_bits_min + (rand() % (mask_bits_max - mask_bits_min + 1)) - 1);
+        p_job->input_offset = (sha256_nonce_t)rand();
+        for (i = 0; i < SHA256_BYTE_DIGEST_SIZE; i++)
+        {
+            p_job->target_solution[i] = (uint8_t)rand();
+        }
+
+        /* Once every distinct target was generated, jobs reuse one of them with a new input offset */
+        if ((0 < targets) && (count >= targets))
+        {
+            i = rand() % targets;
+            p_job->target_solution_mask_offset = _g_trace_jobs[i].target_solution_mask_offset;
+            memcpy(p_job->target_solution, _g_trace_jobs[i].target_solution, SHA256_BYTE_DIGEST_SIZE);
+        }
+    }
+
+    ESP_LOGI(LOG_TAG, "Generated %d jobs, %lld us long.", count, (long long)arrival_us);
+
+    return count;
+}
+
+static void _trace_save(const char *p_path)
+{
+    FILE *p_file = fopen(p_path, "w");
+    trace_job_t *p_job = NULL;
+    int i = 0;
+    int j = 0;
+
+    if (NULL == p_file)
+    {
+        ESP_LOGE(LOG_TAG, "Failed to open trace file %s. Aborting!", p_path);
+        abort();
+    }
+
+    fprintf(p_file, "# arrival_us,mask_offset,input_offset,target_hex\n");
+    for (i = 0; i < _g_trace_job_count; i++)
+    {
+        p_job = &_g_trace_jobs[i];
+        fprintf(p_file, "%lld,%u,%llu,", (long long)p_job->arrival_us, p_job->target_solution_mask_offset, (unsigned long long)p_job->input_offset);
+        for (j = 0; j < SHA256_BYTE_DIGEST_SIZE; j++)
+        {
+            fprintf(p_file, "%02x", p_job->target_solution[j]);
+        }
+        fprintf(p_file, "\n");
+    }
+
+    fclose(p_file);
+}
+
+static void _trace_replay_task(void *p_task_params)
+{
+    sha256_input_variables_queue_element_t sha256_input_variables_queue_element = {0};
+    sha256_input_variables_t *p_sha256_input_variables = &sha256_input_variables_queue_element.sha256_input_variables;
+    sha256_calculator_status_t status_start = {0};
+    sha256_calculator_status_t status_end = {0};
+    uint8_t identify_request = COMM_REQUEST_IDENTIFY;
+    uint32_t time_budget_ms = (uint32_t)_trace_param_get("TRACE_TIME_BUDGET_MS", TRACE_TIME_BUDGET_MS_DEFAULT);
+    uint64_t hash_budget = (uint64_t)_trace_param_get("TRACE_HASH_BUDGET", TRACE_HASH_BUDGET_DEFAULT);
+    bool b_resident = (0 != _trace_param_get("TRACE_RESIDENT", TRACE_RESIDENT_DEFAULT));
+    trace_job_t *p_job = NULL;
+    int64_t start_us = 0;
+    int64_t now_us = 0;
+    int i = 0;
+
+    /* Handshake first, the worker capabilities are logged by the solution reader */
+    sim_manager_master_write(&identify_request, sizeof(identify_request));
+
+    for (i = 0; i < COMM_RESIDENT_JOB_COUNT; i++)
+    {
+        _g_resident_job_index[i] = -1;
+    }
+
+    sha256_calculator_get_status(&status_start);
+    start_us = esp_timer_get_time();
+
+    for (i = 0; i < _g_trace_job_count; i++)
+    {
+        p_job = &_g_trace_jobs[i];
+
+        /* Wait for the arrival time, tick resolution is good enough for millisecond scale traces */
+        while ((now_us = esp_timer_get_time() - start_us) < p_job->arrival_us)
+        {
+            vTaskDelay(((p_job->arrival_us - now_us) >= 2000) ? pdMS_TO_TICKS((p_job->arrival_us - now_us) / 1000) : 1);
+        }
+
+        sha256_input_variables_queue_element.job_type = SHA256_JOB_TYPE_SHA256;
+        sha256_input_variables_queue_element.puzzle_id = (uint8_t)(i % PUZZLE_ID_COUNT);
+        p_sha256_input_variables->input_offset = p_job->input_offset;
+        p_sha256_input_variables->target_solution_mask_offset = p_job->target_solution_mask_offset;
+        memcpy(p_sha256_input_variables->target_solution, p_job->target_solution, SHA256_BYTE_DIGEST_SIZE);
+        sha256_input_variables_queue_element.job_budget.time_budget_ms = time_budget_ms;
+        sha256_input_variables_queue_element.job_budget.hash_budget = hash_budget;
+
+        _g_puzzle_job_index[i % PUZZLE_ID_COUNT] = i;
+        p_job->written_us = esp_timer_get_time();
+        _g_bytes_written += _trace_job_write(i, &sha256_input_variables_queue_element, b_resident);
+    }
+
+    /* Let the last job finish */
+    p_job = &_g_trace_jobs[_g_trace_job_count - 1];
+    while ((0 == p_job->solved_us) && ((esp_timer_get_time() - p_job->written_us) < DRAIN_TIMEOUT_US))
+    {
+        vTaskDelay(1);
+    }
+
+    sha256_calculator_get_status(&status_end);
+    _trace_report(&status_start, &status_end, esp_timer_get_time() - start_us);
+
+    fflush(stdout);
+    exit(0);
+}
+
+static size_t _trace_job_write(int job_index, const sha256_input_variables_queue_element_t *p_sha256_input_variables_queue_element, bool b_resident)
+{
+    comm_request_t comm_request = {0};
+    const trace_job_t *p_job = &_g_trace_jobs[job_index];
+    const trace_job_t *p_resident = NULL;
+    size_t written = 0;
+    int index = 0;
+
+    if (false == b_resident)
+    {
+        sim_manager_master_write((uint8_t *)p_sha256_input_variables_queue_element, sizeof(*p_sha256_input_variables_queue_element));
+        return sizeof(*p_sha256_input_variables_queue_element);
+    }
+
+    for (index = 0; index < COMM_RESIDENT_JOB_COUNT; index++)
+    {
+        p_resident = (0 <= _g_resident_job_index[index]) ? &_g_trace_jobs[_g_resident_job_index[index]] : NULL;
+        if ((NULL != p_resident) &&
+            (p_resident->target_solution_mask_offset == p_job->target_solution_mask_offset) &&
+            (0 == memcmp(p_resident->target_solution, p_job->target_solution, SHA256_BYTE_DIGEST_SIZE)))
+        {
+            break;
+        }
+    }
+
+    /* Target isn't resident, replace the resident jobs round robin. The stored budget stays for later requests. */
+    if (COMM_RESIDENT_JOB_COUNT == index)
+    {
+        index = _g_resident_job_next;
+        _g_resident_job_next = (_g_resident_job_next + 1) % COMM_RESIDENT_JOB_COUNT;
+        _g_resident_job_index[index] = job_index;
+
+        comm_request.resident_store.message_type = COMM_REQUEST_RESIDENT_STORE;
+        comm_request.resident_store.index = (uint8_t)index;
+        comm_request.resident_store.sha256_input_variables_queue_element = *p_sha256_input_variables_queue_element;
+        sim_manager_master_write((uint8_t *)&comm_request, sizeof(comm_request.resident_store));
+        written += sizeof(comm_request.resident_store);
+    }
+
+    comm_request.resident_job.message_type = COMM_REQUEST_RESIDENT_JOB;
+    comm_request.resident_job.puzzle_id = p_sha256_input_variables_queue_element->puzzle_id;
+    comm_request.resident_job.index = (uint8_t)index;
+    comm_request.resident_job.fields = COMM_RESIDENT_JOB_FIELD_INPUT;
+    memcpy(comm_request.resident_job.field_data, &p_job->input_offset, sizeof(sha256_nonce_t));
+    sim_manager_master_write((uint8_t *)&comm_request, offsetof(comm_resident_job_request_t, field_data) + sizeof(sha256_nonce_t));
+    written += offsetof(comm_resident_job_request_t, field_data) + sizeof(sha256_nonce_t);
+
+    return written;
+}
+
+static void _solution_reader_task(void *p_task_params)
+{
+    comm_response_t comm_response = {0};
+    sha256_calculator_capabilities_t *p_capabilities = &comm_response.identify.sha256_calculator_capabilities;
+    int i = 0;
+
+    while (1)
+    {
+        if (false == sim_manager_master_read((uint8_t *)&comm_response, sizeof(comm_response), pdMS_TO_TICKS(READ_TIMEOUT_MS)))
+        {
+            continue;
+        }
+
+        if (COMM_RESPONSE_IDENTIFY == comm_response.message_type)
+        {
+            ESP_LOGI(LOG_TAG, "Worker: protocol %u, transport %u, %u cores, frames %u/%u bytes, nonce %u bytes, job types 0x%02X, SHA256 %lu H/s, SHA256d %lu H/s",
+                comm_response.identify.protocol_version,
+                comm_response.identify.transport,
+                comm_response.identify.core_count,
+                comm_response.identify.max_write_size,
+                comm_response.identify.max_read_size,
+                p_capabilities->nonce_size,
+                p_capabilities->job_types,
+                (unsigned long)p_capabilities->hash_rate_sha256,
+                (unsigned long)p_capabilities->hash_rate_sha256d);
+            continue;
+        }
+
+        if (COMM_RESPONSE_SOLUTION == comm_response.message_type)
+        {
+            _solution_record(&comm_response.solution.sha256_offset_solution_queue_element);
+        }
+        else if (COMM_RESPONSE_SOLUTION_BATCH == comm_response.message_type)
+        {
+            for (i = 0; i < comm_response.solution_batch.count; i++)
+            {
+                _solution_record(&comm_response.solution_batch.sha256_offset_solution_queue_elements[i]);
+            }
+        }
+        else if (COMM_RESPONSE_PROGRESS == comm_response.message_type)
+        {
+            _solution_record(&comm_response.progress.sha256_progress_queue_element.sha256_offset_solution_queue_element);
+        }
+    }
+}
+
+static void _solution_record(const sha256_offset_solution_queue_element_t *p_sha256_offset_solution_queue_element)
+{
+    trace_job_t *p_job = &_g_trace_jobs[_g_puzzle_job_index[p_sha256_offset_solution_queue_element->puzzle_id]];
+
+    if (0 == p_job->solved_us)
+    {
+        p_job->solved_us = esp_timer_get_time();
+        p_job->status = p_sha256_offset_solution_queue_element->status;
+    }
+}
+
+static void _trace_report(const sha256_calculator_status_t *p_status_start, const sha256_calculator_status_t *p_status_end, int64_t replay_us)
+{
+    uint64_t hashes = p_status_end->hashes_total - p_status_start->hashes_total;
+    uint64_t hashes_superseded = p_status_end->hashes_superseded - p_status_start->hashes_superseded;
+    uint64_t idle_us = p_status_end->idle_us_total - p_status_start->idle_us_total;
+    comm_manager_status_t comm_manager_status = {0};
+    trace_job_t *p_job = NULL;
+    int solved = 0;
+    int superseded = 0;
+    int exhausted = 0;
+    int budget_exhausted = 0;
+    int i = 0;
+
+    for (i = 0; i < _g_trace_job_count; i++)
+    {
+        p_job = &_g_trace_jobs[i];
+
+        if (0 == p_job->solved_us)
+        {
+            /* Unsolved jobs other than the last were replaced by the next job */
+            if (i < (_g_trace_job_count - 1)) superseded++;
+            continue;
+        }
+
+        if (SHA256_SOLUTION_STATUS_EXHAUSTED == p_job->status) exhausted++;
+        if (SHA256_SOLUTION_STATUS_BUDGET_EXHAUSTED == p_job->status) budget_exhausted++;
+        _g_latencies_us[solved++] = p_job->solved_us - p_job->written_us;
+    }
+
+    qsort(_g_latencies_us, solved, sizeof(_g_latencies_us[0]), _latency_compare);
+
+    ESP_LOGI(LOG_TAG, "Jobs: %d, solved: %d, superseded: %d, exhausted: %d, budget exhausted: %d, replay: %lld ms",
+        _g_trace_job_count, solved, superseded, exhausted, budget_exhausted, (long long)(replay_us / 1000));
+
+    ESP_LOGI(LOG_TAG, "Master bytes written: %llu, %.1f per job",
+        (unsigned long long)_g_bytes_written,
+        (double)_g_bytes_written / (double)_g_trace_job_count);
+
+    if (0 != solved)
+    {
+        ESP_LOGI(LOG_TAG, "Solution latency: p50 %lld us, p90 %lld us, p99 %lld us, max %lld us",
+            (long long)_g_latencies_us[(solved * 50) / 100],
+            (long long)_g_latencies_us[(solved * 90) / 100],
+            (long long)_g_latencies_us[(solved * 99) / 100],
+            (long long)_g_latencies_us[solved - 1]);
+    }
+
+    ESP_LOGI(LOG_TAG, "Worker idle: %.1f %%, wasted work on superseded puzzles: %.1f %% (%llu of %llu hashes), hash rate: %llu H/s",
+        (100.0 * (double)idle_us) / (double)replay_us,
+        (0 != hashes) ? ((100.0 * (double)hashes_superseded) / (double)hashes) : 0.0,
+        (unsigned long long)hashes_superseded,
+        (unsigned long long)hashes,
+        (unsigned long long)((hashes * 1000000) / (uint64_t)replay_us));
+
+    comm_manager_get_status(&comm_manager_status);
+    ESP_LOGI(LOG_TAG, "Results sent: %lu in %lu frames, max %u results per frame",
+        (unsigned long)comm_manager_status.results_sent,
+        (unsigned long)comm_manager_status.result_frames_sent,
+        comm_manager_status.results_per_frame_max);
+}
+
+static int _latency_compare(const void *p_a, const void *p_b)
+{
+    int64_t a = *(const int64_t *)p_a;
+    int64_t b = *(const int64_t *)p_b;
+
+    return (a > b) - (a < b);
+}
+
+/* ============================== INTERRUPT FUNCTION DEFINITIONS */
@@ -0,0 +1,187 @@
+/**
+ * @file sha256_master.h
+ * @author Iwan Ćulumović
+ * @brief See sha256_master.c file.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef __SHA256_MASTER_H__
+#define __SHA256_MASTER_H__
+
+/* ============================== INCLUDES */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "comm/comm_protocol.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Largest number of workers. */
+#define SHA256_MASTER_WORKERS_MAX               (32)
+
+/** @brief Largest number of buses, every bus has its own thread. */
+#define SHA256_MASTER_BUSES_MAX                 (8)
+
+/** @brief Largest number of requests written to a worker that wait for their response. */
+#define SHA256_MASTER_IN_FLIGHT_MAX             (16)
+
+/** @brief Transport, SPI slave (spi_manager.c) through a spidev device per chip select, interrupt out GPIO per worker. */
+#define SHA256_MASTER_TRANSPORT_SPIDEV          (0x00)
+
+/** @brief Transport, I2C slave (i2c_manager.c) through an i2c-dev bus device, interrupt out GPIO per worker. */
+#define SHA256_MASTER_TRANSPORT_I2CDEV          (0x01)
+
+/** @brief Transport, I2C register map slave (i2c_regmap_manager.c) through an i2c-dev bus device, polled. */
+#define SHA256_MASTER_TRANSPORT_I2C_REGMAP      (0x02)
+
+/** @brief Transport, in-process stand-in worker for testing without hardware. */
+#define SHA256_MASTER_TRANSPORT_LOOPBACK        (0x03)
+
+/** @brief Number of transports. */
+#define SHA256_MASTER_TRANSPORT_COUNT           (4)
+
+/** @brief Completion, a request without a response was written. */
+#define SHA256_MASTER_COMPLETION_WRITTEN        (0x00)
+
+/** @brief Completion, the final response of a request arrived. */
+#define SHA256_MASTER_COMPLETION_RESPONSE       (0x01)
+
+/** @brief Completion, a response that doesn't finish the request arrived: a chain checkpoint or a Merkle proof. */
+#define SHA256_MASTER_COMPLETION_PARTIAL        (0x02)
+
+/** @brief Completion, the final response of a later job of the worker arrived first, the job was replaced. */
+#define SHA256_MASTER_COMPLETION_SUPERSEDED     (0x03)
+
+/** @brief Completion, a response no request in flight waits for, e.g. of a puzzle replaced by a Merkle leaves request. */
+#define SHA256_MASTER_COMPLETION_UNSOLICITED    (0x04)
+
+/** @brief Completion, the request couldn't be written. */
+#define SHA256_MASTER_COMPLETION_ERROR          (0x05)
+
+/** @brief Completion, the worker dropped the digest of a streamed message because its digest queue was full. */
+#define SHA256_MASTER_COMPLETION_DROPPED        (0x06)
+
+/* ============================== TYPE DEFINITIONS */
+
+/**
+ * @brief Worker configuration.
+ * 
+ */
+typedef struct {
+    uint8_t transport;                                  //! SHA256_MASTER_TRANSPORT_*, the same for every worker of a bus
+    uint8_t bus;                                        //! Bus index, workers of a bus are served by one thread and read in batches
+    const char *p_device;                               //! spidev device of the chip select, or the i2c-dev bus device
+    uint16_t address;                                   //! I2C slave address
+    uint32_t speed_hz;                                  //! SPI clock, 0 keeps the spidev default, modelled bus speed of loopback workers
+    const char *p_gpio_chip;                            //! GPIO chip of the interrupt out line, NULL for polled transports
+    uint32_t gpio_line;                                 //! Interrupt out line offset on the GPIO chip
+    uint8_t in_flight_max;                              //! Requests waiting for a response, 0 for the receive queue length from identify
+} sha256_master_worker_config_t;
+
+/**
+ * @brief Completion of a submitted request, or a response no request waits for.
+ * 
+ */
+typedef struct {
+    uint64_t tag;                                       //! Tag of the request, 0 for unsolicited responses
+    uint32_t latency_us;                                //! Time from the submission to the completion
+    uint8_t worker;                                     //! Worker index
+    uint8_t kind;                                       //! SHA256_MASTER_COMPLETION_*
+    uint16_t size;                                      //! Response size in bytes, 0 without a response
+    comm_response_t response;                           //! Solutions of a solution batch complete one by one as solution responses
+} sha256_master_completion_t;
+
+/**
+ * @brief Master status, counters since initialization.
+ * 
+ */
+typedef struct {
+    uint64_t requests_written;                          //! Request and stream frames written
+    uint64_t responses_read;                            //! Response frames read
+    uint64_t read_batches;                              //! Bus operations the responses were read in
+    uint64_t status_polls;                              //! Status register polls of polled transports
+    uint64_t bus_errors;                                //! Failed transfers
+    uint64_t proofs_late;                               //! Merkle proofs that arrived after the root had completed their job
+} sha256_master_status_t;
+
+/* ============================== PUBLIC FUNCTION DECLARATIONS */
+
+/**
+ * @brief Initialize master. Opens the devices of every worker and starts a thread per bus.
+ * 
+ * @param p_worker_configs Pointer to the worker configurations, the worker index is the position.
+ * @param worker_count Number of workers, up to SHA256_MASTER_WORKERS_MAX.
+ * 
+ * @return bool Returns true if initialized, false if a configuration is invalid or a device couldn't be opened.
+ */
+bool sha256_master_init(const sha256_master_worker_config_t *p_worker_configs, int worker_count);
+
+/**
+ * @brief Stops the bus threads and closes every device. Requests not written yet are dropped.
+ * 
+ */
+void sha256_master_deinit(void);
+
+/**
+ * @brief Submits a request frame to a worker. Non-blocking function, requests of a worker must be submitted from a
+ * single thread. The request is written as soon as the worker has room for it, several requests are kept in flight.
+ * 
+ * @param worker Worker index.
+ * @param p_request Pointer to the request frame.
+ * @param request_size Size of the request, up to sizeof(comm_request_t). The rest of the frame is written as zero.
+ * @param tag Tag returned with the completion.
+ * 
+ * @return bool Returns true if submitted, false if the submission queue of the worker is full.
+ */
+bool sha256_master_submit(uint8_t worker, const comm_request_t *p_request, size_t request_size, uint64_t tag);
+
+/**
+ * @brief Submits a stream frame to a worker, see sha256_master_submit. Only the SPI transport streams, the last frame
+ * of a message completes with the digest response.
+ * 
+ * @param worker Worker index.
+ * @param p_stream_frame Pointer to the stream frame, only the header and data_size bytes of data are written.
+ * @param tag Tag returned with the completion.
+ * 
+ * @return bool Returns true if submitted, false if the submission queue of the worker is full.
+ */
+bool sha256_master_stream_submit(uint8_t worker, const comm_stream_frame_t *p_stream_frame, uint64_t tag);
+
+/**
+ * @brief Gets the next completion. Must be called from a single thread.
+ * 
+ * @param p_completion Pointer to where the completion will be written.
+ * @param timeout_ms Time to wait for a completion in milliseconds, 0 doesn't wait and -1 waits forever.
+ * 
+ * @return bool Returns true if a completion was taken, false on timeout.
+ */
+bool sha256_master_completion_get(sha256_master_completion_t *p_completion, int timeout_ms);
+
+/**
+ * @brief Gets a file descriptor that becomes readable when completions are waiting, for use with poll or epoll.
+ * sha256_master_completion_get clears it.
+ * 
+ * @return int File descriptor.
+ */
+int sha256_master_completion_fd(void);
+
+/**
+ * @brief Gets a snapshot of the master status.
+ * 
+ * @param p_sha256_master_status Pointer to where the status will be written.
+ */
+void sha256_master_get_status(sha256_master_status_t *p_sha256_master_status);
+
+/**
+ * @brief Gets the size of a response frame from its first two bytes, the response type and the solution count of a
+ * solution batch.
+ * 
+ * @param p_header Pointer to the first two bytes of the response.
+ * 
+ * @return size_t Response size in bytes, 0 for an unknown response type.
+ */
+size_t sha256_master_response_size(const uint8_t *p_header);
+
+#endif
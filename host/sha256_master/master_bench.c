@@ -0,0 +1,404 @@
+/**
+ * @file master_bench.c
+ * @author Iwan Ćulumović
+ * @brief Master driver benchmark. Runs SHA256 jobs on loopback workers with one request in flight per worker and then
+ * pipelined with the window the workers report, where one job and the queries around it are in flight, checks every
+ * solution and reports the solved job rate and latency.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/* ============================== INCLUDES */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sha256_kernel.h"
+#include "sha256_master.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Default number of loopback workers, MASTER_WORKERS. */
+#define MASTER_WORKERS_DEFAULT                  (4)
+
+/** @brief Default number of buses the workers are spread over, MASTER_BUSES. */
+#define MASTER_BUSES_DEFAULT                    (1)
+
+/** @brief Default number of jobs per worker, MASTER_JOBS. */
+#define MASTER_JOBS_DEFAULT                     (500)
+
+/** @brief Default modelled bus speed of the loopback workers in Hz, MASTER_SPEED_HZ, 0 for no bus time. */
+#define MASTER_SPEED_HZ_DEFAULT                 (1000000)
+
+/** @brief Default number of compared target bits, MASTER_MASK_BITS, about 2^n hashes per job. Queued jobs replace
+ * jobs that outlast a worker batch, as on the worker, so pipelining pays off for short jobs. */
+#define MASTER_MASK_BITS_DEFAULT                (10)
+
+/** @brief Default random seed, MASTER_SEED. */
+#define MASTER_SEED_DEFAULT                     (1)
+
+/** @brief Longest time without a completion before the run is considered stalled in milliseconds. */
+#define MASTER_STALL_TIMEOUT_MS                 (5000)
+
+/** @brief Tag of the queries, jobs are tagged with their index plus one. */
+#define MASTER_QUERY_TAG                        (0xFFFFFFFFFFFFFFFFULL)
+
+/* ============================== TYPE DEFINITIONS */
+
+/**
+ * @brief Result of a benchmark pass.
+ * 
+ */
+typedef struct {
+    double seconds;                                     //! Time from the first job submission to the last completion
+    long long solved;                                   //! Jobs answered with a solution or as exhausted
+    long long superseded;                               //! Jobs replaced by a later job before they finished
+    long long failed;                                   //! Unsolicited responses, errors and invalid solutions
+    uint64_t worker_hashes;                             //! Hashes the workers report in their status
+    uint32_t latency_p50_us;
+    uint32_t latency_p99_us;
+    sha256_master_status_t status;
+    bool b_stalled;
+} master_bench_result_t;
+
+/* ============================== PRIVATE FUNCTION DECLARATIONS */
+
+/**
+ * @brief Reads an integer parameter from the environment.
+ * 
+ * @param p_name Environment variable name.
+ * @param default_value Value if the variable isn't set.
+ * 
+ * @return long long Parameter value.
+ */
+static long long _bench_param_get(const char *p_name, long long default_value);
+
+/**
+ * @brief Monotonic time in seconds.
+ * 
+ * @return double Time in seconds.
+ */
+static double _bench_time_get(void);
+
+/**
+ * @brief Runs every job on the loopback workers.
+ * 
+ * @param p_jobs Pointer to the jobs, jobs_per_worker per worker.
+ * @param worker_count Number of workers.
+ * @param bus_count Number of buses.
+ * @param jobs_per_worker Number of jobs per worker.
+ * @param speed_hz Modelled bus speed in Hz.
+ * @param in_flight_max Requests in flight per worker, 0 for the window the workers report.
+ * @param p_result Pointer to where the result will be written.
+ */
+static void _bench_pass_run(const sha256_input_variables_queue_element_t *p_jobs, int worker_count, int bus_count, int jobs_per_worker, uint32_t speed_hz, uint8_t in_flight_max, master_bench_result_t *p_result);
+
+/**
+ * @brief Sends a query to every worker and waits for the responses.
+ * 
+ * @param worker_count Number of workers.
+ * @param message_type COMM_REQUEST_IDENTIFY or COMM_REQUEST_STATUS.
+ * @param p_result Pointer to the result, the worker hashes are added from status responses.
+ * 
+ * @return bool Returns true if every worker answered, else false.
+ */
+static bool _bench_query(int worker_count, uint8_t message_type, master_bench_result_t *p_result);
+
+/**
+ * @brief Checks a solution of a SHA256 job by hashing its offset.
+ * 
+ * @param p_job Pointer to the job.
+ * @param offset_solution Offset solution.
+ * 
+ * @return bool Returns true if the digest matches the target, else false.
+ */
+static bool _bench_solution_check(const sha256_input_variables_queue_element_t *p_job, sha256_nonce_t offset_solution);
+
+/**
+ * @brief Compares two latencies for qsort.
+ * 
+ * @param p_a Pointer to the first latency.
+ * @param p_b Pointer to the second latency.
+ * 
+ * @return int Comparison result.
+ */
+static int _bench_latency_compare(const void *p_a, const void *p_b);
+
+/**
+ * @brief Prints the result of a pass.
+ * 
+ * @param p_name Pass name.
+ * @param p_result Pointer to the result.
+ * @param jobs Number of jobs.
+ */
+static void _bench_result_print(const char *p_name, const master_bench_result_t *p_result, long long jobs);
+
+/* ============================== PRIVATE VARIABLES */
+
+static uint32_t *_gp_bench_latencies = NULL;
+
+/* ============================== PUBLIC VARIABLES */
+
+/* ============================== PUBLIC FUNCTION DEFINITIONS */
+
+int main(void)
+{
+    int worker_count = (int)_bench_param_get("MASTER_WORKERS", MASTER_WORKERS_DEFAULT);
+    int bus_count = (int)_bench_param_get("MASTER_BUSES", MASTER_BUSES_DEFAULT);
+    int jobs_per_worker = (int)_bench_param_get("MASTER_JOBS", MASTER_JOBS_DEFAULT);
+    int mask_bits = (int)_bench_param_get("MASTER_MASK_BITS", MASTER_MASK_BITS_DEFAULT);
+    uint32_t speed_hz = (uint32_t)_bench_param_get("MASTER_SPEED_HZ", MASTER_SPEED_HZ_DEFAULT);
+    sha256_input_variables_queue_element_t *p_jobs = NULL;
+    master_bench_result_t serial_result = {0};
+    master_bench_result_t pipelined_result = {0};
+    long long job_count = 0;
+    long long i = 0;
+    int j = 0;
+
+    srand((unsigned int)_bench_param_get("MASTER_SEED", MASTER_SEED_DEFAULT));
+
+    if (worker_count < 1) worker_count = 1;
+    if (worker_count > SHA256_MASTER_WORKERS_MAX) worker_count = SHA256_MASTER_WORKERS_MAX;
+    if (bus_count < 1) bus_count = 1;
+    if (bus_count > SHA256_MASTER_BUSES_MAX) bus_count = SHA256_MASTER_BUSES_MAX;
+    if (jobs_per_worker < 1) jobs_per_worker = 1;
+    if (mask_bits < 1) mask_bits = 1;
+    if (mask_bits > 24) mask_bits = 24;
+    job_count = (long long)worker_count * jobs_per_worker;
+
+    p_jobs = calloc((size_t)job_count, sizeof(*p_jobs));
+    _gp_bench_latencies = calloc((size_t)job_count, sizeof(*_gp_bench_latencies));
+    if ((NULL == p_jobs) || (NULL == _gp_bench_latencies))
+    {
+        fprintf(stderr, "Failed to allocate %lld jobs. Aborting!\n", job_count);
+        abort();
+    }
+
+    /* Puzzle IDs count up per worker so the results of replaced jobs can be told apart */
+    for (i = 0; i < job_count; i++)
+    {
+        p_jobs[i].job_type = SHA256_JOB_TYPE_SHA256;
+        p_jobs[i].puzzle_id = (uint8_t)(i % jobs_per_worker);
+        p_jobs[i].sha256_input_variables.input_offset = (sha256_nonce_t)rand();
+        p_jobs[i].sha256_input_variables.target_solution_mask_offset = (uint8_t)(mask_bits - 1);
+        for (j = 0; j < SHA256_BYTE_DIGEST_SIZE; j++) p_jobs[i].sha256_input_variables.target_solution[j] = (uint8_t)rand();
+    }
+
+    _bench_pass_run(p_jobs, worker_count, bus_count, jobs_per_worker, speed_hz, 1, &serial_result);
+    _bench_pass_run(p_jobs, worker_count, bus_count, jobs_per_worker, speed_hz, 0, &pipelined_result);
+
+    printf("Workers: %d loopback on %d bus(es) at %lu Hz, %d jobs each, %d target bits\n", worker_count, bus_count, (unsigned long)speed_hz, jobs_per_worker, mask_bits);
+    _bench_result_print("One in flight:", &serial_result, job_count);
+    _bench_result_print("Pipelined:", &pipelined_result, job_count);
+    if ((0 != serial_result.seconds) && (0 != pipelined_result.seconds))
+    {
+        printf("Pipelined speedup: %.2fx\n", (pipelined_result.solved / pipelined_result.seconds) / (serial_result.solved / serial_result.seconds));
+    }
+
+    free(p_jobs);
+    free(_gp_bench_latencies);
+
+    return ((0 == serial_result.failed) && (0 == pipelined_result.failed) &&
+            (false == serial_result.b_stalled) && (false == pipelined_result.b_stalled)) ? 0 : 1;
+}
+
+/* ============================== PRIVATE FUNCTION DEFINITIONS */
+
+static long long _bench_param_get(const char *p_name, long long default_value)
+{
+    const char *p_value = getenv(p_name);
+
+    return (NULL != p_value) ? strtoll(p_value, NULL, 0) : default_value;
+}
+
+static double _bench_time_get(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + (now.tv_nsec / 1e9);
+}
+
+static void _bench_pass_run(const sha256_input_variables_queue_element_t *p_jobs, int worker_count, int bus_count, int jobs_per_worker, uint32_t speed_hz, uint8_t in_flight_max, master_bench_result_t *p_result)
+{
+    sha256_master_worker_config_t worker_configs[SHA256_MASTER_WORKERS_MAX];
+    int next_jobs[SHA256_MASTER_WORKERS_MAX] = {0};
+    sha256_master_completion_t completion;
+    const sha256_input_variables_queue_element_t *p_job = NULL;
+    long long job_count = (long long)worker_count * jobs_per_worker;
+    long long done = 0;
+    long long latency_count = 0;
+    long long job_index = 0;
+    double start = 0;
+    int i = 0;
+
+    memset(p_result, 0, sizeof(*p_result));
+    memset(worker_configs, 0, sizeof(worker_configs));
+    for (i = 0; i < worker_count; i++)
+    {
+        worker_configs[i].transport = SHA256_MASTER_TRANSPORT_LOOPBACK;
+        worker_configs[i].bus = (uint8_t)(i % bus_count);
+        worker_configs[i].speed_hz = speed_hz;
+        worker_configs[i].in_flight_max = in_flight_max;
+    }
+
+    if (false == sha256_master_init(worker_configs, worker_count))
+    {
+        fprintf(stderr, "Failed to initialize the master. Aborting!\n");
+        abort();
+    }
+
+    /* Identify sets the window of workers without a configured one */
+    if (false == _bench_query(worker_count, COMM_REQUEST_IDENTIFY, p_result))
+    {
+        p_result->b_stalled = true;
+        sha256_master_deinit();
+        return;
+    }
+
+    start = _bench_time_get();
+    while (done < job_count)
+    {
+        /* Keep the submission queue of every worker full, the master writes as the window allows */
+        for (i = 0; i < worker_count; i++)
+        {
+            while (next_jobs[i] < jobs_per_worker)
+            {
+                job_index = ((long long)i * jobs_per_worker) + next_jobs[i];
+                if (false == sha256_master_submit((uint8_t)i, (const comm_request_t *)&p_jobs[job_index], sizeof(p_jobs[job_index]), (uint64_t)job_index + 1)) break;
+                next_jobs[i]++;
+            }
+        }
+
+        if (false == sha256_master_completion_get(&completion, MASTER_STALL_TIMEOUT_MS))
+        {
+            fprintf(stderr, "No completion for %d ms, %lld of %lld jobs done!\n", MASTER_STALL_TIMEOUT_MS, done, job_count);
+            p_result->b_stalled = true;
+            break;
+        }
+
+        if ((0 == completion.tag) || (completion.tag > (uint64_t)job_count))
+        {
+            p_result->failed++;
+            continue;
+        }
+        p_job = &p_jobs[completion.tag - 1];
+        done++;
+
+        if (SHA256_MASTER_COMPLETION_SUPERSEDED == completion.kind)
+        {
+            p_result->superseded++;
+            continue;
+        }
+
+        if ((SHA256_MASTER_COMPLETION_RESPONSE != completion.kind) ||
+            (COMM_RESPONSE_SOLUTION != completion.response.message_type) ||
+            ((SHA256_SOLUTION_STATUS_FOUND == completion.response.solution.sha256_offset_solution_queue_element.status) &&
+             (false == _bench_solution_check(p_job, completion.response.solution.sha256_offset_solution_queue_element.sha256_offset_solution.offset_solution))))
+        {
+            p_result->failed++;
+            continue;
+        }
+
+        p_result->solved++;
+        _gp_bench_latencies[latency_count++] = completion.latency_us;
+    }
+    p_result->seconds = _bench_time_get() - start;
+
+    if (false == p_result->b_stalled) _bench_query(worker_count, COMM_REQUEST_STATUS, p_result);
+    sha256_master_get_status(&p_result->status);
+    sha256_master_deinit();
+
+    if (0 != latency_count)
+    {
+        qsort(_gp_bench_latencies, (size_t)latency_count, sizeof(*_gp_bench_latencies), _bench_latency_compare);
+        p_result->latency_p50_us = _gp_bench_latencies[latency_count / 2];
+        p_result->latency_p99_us = _gp_bench_latencies[(latency_count * 99) / 100];
+    }
+}
+
+static bool _bench_query(int worker_count, uint8_t message_type, master_bench_result_t *p_result)
+{
+    sha256_master_completion_t completion;
+    comm_request_t request;
+    int answered = 0;
+    int i = 0;
+
+    memset(&request, 0, sizeof(request));
+    request.message_type = message_type;
+
+    for (i = 0; i < worker_count; i++)
+    {
+        if (false == sha256_master_submit((uint8_t)i, &request, sizeof(request.message_type), MASTER_QUERY_TAG)) return false;
+    }
+
+    while (answered < worker_count)
+    {
+        if (false == sha256_master_completion_get(&completion, MASTER_STALL_TIMEOUT_MS)) return false;
+        if ((MASTER_QUERY_TAG != completion.tag) || (SHA256_MASTER_COMPLETION_RESPONSE != completion.kind)) continue;
+
+        if (COMM_RESPONSE_STATUS == completion.response.message_type)
+        {
+            p_result->worker_hashes += completion.response.status.sha256_calculator_status.hashes_total;
+        }
+        answered++;
+    }
+
+    return true;
+}
+
+static bool _bench_solution_check(const sha256_input_variables_queue_element_t *p_job, sha256_nonce_t offset_solution)
+{
+    uint32_t block[SHA256_KERNEL_BLOCK_WORDS] = {0};
+    uint32_t digest[SHA256_KERNEL_STATE_WORDS] = {0};
+    const uint8_t *p_target = p_job->sha256_input_variables.target_solution;
+    int mask_bits = p_job->sha256_input_variables.target_solution_mask_offset + 1;
+    int i = 0;
+
+    /* Nonce is hashed as its little endian bytes */
+    block[0] = __builtin_bswap32((uint32_t)offset_solution);
+#ifdef CONFIG_SHA256_CALC_NONCE_64BIT
+    block[1] = __builtin_bswap32((uint32_t)(offset_solution >> 32));
+#endif
+    block[sizeof(sha256_nonce_t) / sizeof(uint32_t)] = 0x80000000;
+    block[SHA256_KERNEL_BLOCK_WORDS - 1] = sizeof(sha256_nonce_t) * 8;
+    sha256_kernel_block_hash(block, digest);
+
+    for (i = 0; i < mask_bits; i++)
+    {
+        if (((digest[i / 32] >> (31 - (i % 32))) & 1) != ((p_target[i / 8] >> (7 - (i % 8))) & 1)) return false;
+    }
+
+    return true;
+}
+
+static int _bench_latency_compare(const void *p_a, const void *p_b)
+{
+    uint32_t a = *(const uint32_t *)p_a;
+    uint32_t b = *(const uint32_t *)p_b;
+
+    return (a > b) - (a < b);
+}
+
+static void _bench_result_print(const char *p_name, const master_bench_result_t *p_result, long long jobs)
+{
+    printf("%-15s %9.0f solved jobs/s, latency p50 %6lu us p99 %6lu us, %.2f responses per read batch\n",
+        p_name,
+        (0 != p_result->seconds) ? (p_result->solved / p_result->seconds) : 0.0,
+        (unsigned long)p_result->latency_p50_us,
+        (unsigned long)p_result->latency_p99_us,
+        (0 != p_result->status.read_batches) ? ((double)p_result->status.responses_read / p_result->status.read_batches) : 0.0);
+    printf("%-15s %lld of %lld solved, %lld superseded, %lld failed, %llu worker hashes, %llu bus errors\n",
+        "",
+        p_result->solved,
+        jobs,
+        p_result->superseded,
+        p_result->failed,
+        (unsigned long long)p_result->worker_hashes,
+        (unsigned long long)p_result->status.bus_errors);
+}
+
+/* ============================== INTERRUPT FUNCTION DEFINITIONS */
@@ -0,0 +1,964 @@
+/**
+ * @file sha256_master.c
+ * @author Iwan Ćulumović
+ * @brief Asynchronous master driver for Linux. Submissions are queued per worker and written by a thread per bus as
+ * soon as the worker has room for them, so several requests are in flight per worker. The worker searches one puzzle
+ * at a time, so only one job is in flight per worker and queries and writes are pipelined around it. Workers that signal a response
+ * are read together in one batch per bus and every response completes the request it answers.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/* ============================== INCLUDES */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+#include "sha256_master_transport.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Status poll period of polled transports in microseconds. */
+#define SHA256_MASTER_POLL_PERIOD_US            (1000)
+
+/** @brief Time the bus thread waits for the consumer when the completion ring is full in microseconds. */
+#define SHA256_MASTER_COMPLETION_FULL_WAIT_US   (100)
+
+/** @brief Size of the buffer event file descriptors are drained into, a multiple of the GPIO line event size. */
+#define SHA256_MASTER_DRAIN_BUF_SIZE            (16 * sizeof(struct gpio_v2_line_event))
+
+/** @brief GPIO consumer label of the interrupt out lines. */
+#define SHA256_MASTER_GPIO_CONSUMER             ("sha256_master")
+
+/* ============================== TYPE DEFINITIONS */
+
+/* ============================== PRIVATE FUNCTION DECLARATIONS */
+
+/**
+ * @brief Bus thread, waits for submissions and responses, reads the responses and writes the submissions.
+ * 
+ * @param p_arg Pointer to the bus.
+ * 
+ * @return void* NULL.
+ */
+static void *_sha256_master_bus_task(void *p_arg);
+
+/**
+ * @brief Waits until a submission arrives, a worker signals a response or the next status poll is due.
+ * 
+ * @param p_bus Pointer to the bus.
+ */
+static void _sha256_master_bus_wait(sha256_master_bus_t *p_bus);
+
+/**
+ * @brief Reads the responses of every worker of the bus that signalled one in a single transport call.
+ * 
+ * @param p_bus Pointer to the bus.
+ */
+static void _sha256_master_bus_read(sha256_master_bus_t *p_bus);
+
+/**
+ * @brief Writes queued submissions of every worker of the bus while the worker has room for them.
+ * 
+ * @param p_bus Pointer to the bus.
+ */
+static void _sha256_master_bus_write(sha256_master_bus_t *p_bus);
+
+/**
+ * @brief Completes the requests a response answers.
+ * 
+ * @param p_bus Pointer to the bus.
+ * @param p_worker Pointer to the worker the response was read from.
+ * @param p_response Pointer to the response.
+ * @param response_size Response size in bytes.
+ */
+static void _sha256_master_response_handle(sha256_master_bus_t *p_bus, sha256_master_worker_t *p_worker, const comm_response_t *p_response, size_t response_size);
+
+/**
+ * @brief Completes the job a result answers, older jobs still in flight were replaced by it.
+ * 
+ * @param p_bus Pointer to the bus.
+ * @param p_worker Pointer to the worker the result was read from.
+ * @param p_response Pointer to the result response.
+ * @param response_size Response size in bytes.
+ * @param puzzle_id Puzzle ID of the result.
+ * @param b_final Result finishes the job.
+ */
+static void _sha256_master_result_handle(sha256_master_bus_t *p_bus, sha256_master_worker_t *p_worker, const comm_response_t *p_response, size_t response_size, uint8_t puzzle_id, bool b_final);
+
+/**
+ * @brief Finds the oldest in flight entry of a kind.
+ * 
+ * @param p_worker Pointer to the worker.
+ * @param kind SHA256_MASTER_ENTRY_KIND_*.
+ * @param message_type Message type the entry must have, compared for queries only.
+ * @param puzzle_id Puzzle ID the entry must have, compared for jobs and streams only.
+ * 
+ * @return int Index of the entry, -1 if there is none.
+ */
+static int _sha256_master_in_flight_find(const sha256_master_worker_t *p_worker, uint8_t kind, uint8_t message_type, uint8_t puzzle_id);
+
+/**
+ * @brief Completes the streamed messages whose digests the worker dropped before a digest it sent.
+ * 
+ * @param p_bus Pointer to the bus.
+ * @param p_worker Pointer to the worker.
+ * @param dropped Number of digests dropped before the digest.
+ */
+static void _sha256_master_stream_dropped_complete(sha256_master_bus_t *p_bus, sha256_master_worker_t *p_worker, uint8_t dropped);
+
+/**
+ * @brief Checks if a job of the worker is in flight.
+ * 
+ * @param p_worker Pointer to the worker.
+ * 
+ * @return bool Returns true if a job waits for its result, else false.
+ */
+static bool _sha256_master_job_in_flight(const sha256_master_worker_t *p_worker);
+
+/**
+ * @brief Removes an in flight entry, keeping the order of the others.
+ * 
+ * @param p_worker Pointer to the worker.
+ * @param index Index of the entry.
+ */
+static void _sha256_master_in_flight_remove(sha256_master_worker_t *p_worker, int index);
+
+/**
+ * @brief Puts a completion into the completion ring of the bus and signals the consumer. Waits while the ring is full.
+ * 
+ * @param p_bus Pointer to the bus.
+ * @param p_worker Pointer to the worker.
+ * @param p_entry Pointer to the entry completed, NULL for an unsolicited response.
+ * @param kind SHA256_MASTER_COMPLETION_*.
+ * @param p_response Pointer to the response, NULL without a response.
+ * @param response_size Response size in bytes.
+ */
+static void _sha256_master_complete(sha256_master_bus_t *p_bus, sha256_master_worker_t *p_worker, const sha256_master_entry_t *p_entry, uint8_t kind, const comm_response_t *p_response, size_t response_size);
+
+/**
+ * @brief Sets the in flight entry of a submission from the first bytes of its frame.
+ * 
+ * @param p_submission Pointer to the submission, the frame must be set.
+ * @param tag Tag of the submission.
+ */
+static void _sha256_master_entry_prepare(sha256_master_submission_t *p_submission, uint64_t tag);
+
+/**
+ * @brief Takes a completion from any bus, starting at the bus after the one the last completion was taken from.
+ * 
+ * @param p_completion Pointer to where the completion will be written.
+ * 
+ * @return bool Returns true if a completion was taken, else false.
+ */
+static bool _sha256_master_completion_pop(sha256_master_completion_t *p_completion);
+
+/**
+ * @brief Reads an event file descriptor until it would block.
+ * 
+ * @param fd File descriptor, non-blocking.
+ */
+static void _sha256_master_fd_drain(int fd);
+
+/**
+ * @brief Adds one to an eventfd counter.
+ * 
+ * @param fd Eventfd file descriptor.
+ */
+static void _sha256_master_fd_signal(int fd);
+
+/* ============================== PRIVATE VARIABLES */
+
+/** @brief Transport of every SHA256_MASTER_TRANSPORT_* value. */
+static const sha256_master_transport_t *_gp_sha256_master_transports[SHA256_MASTER_TRANSPORT_COUNT] = {
+    &sha256_master_transport_spidev,
+    &sha256_master_transport_i2cdev,
+    &sha256_master_transport_i2c_regmap,
+    &sha256_master_transport_loopback,
+};
+
+static sha256_master_worker_t _g_sha256_master_workers[SHA256_MASTER_WORKERS_MAX];
+static sha256_master_bus_t _g_sha256_master_buses[SHA256_MASTER_BUSES_MAX];
+static int _g_sha256_master_worker_count = 0;
+static int _g_sha256_master_completion_fd = -1;
+static int _g_sha256_master_completion_bus = 0;
+
+/* ============================== PUBLIC VARIABLES */
+
+/* ============================== PUBLIC FUNCTION DEFINITIONS */
+
+bool sha256_master_init(const sha256_master_worker_config_t *p_worker_configs, int worker_count)
+{
+    sha256_master_worker_t *p_worker = NULL;
+    sha256_master_bus_t *p_bus = NULL;
+    int i = 0;
+
+    if ((worker_count < 1) || (worker_count > SHA256_MASTER_WORKERS_MAX))
+    {
+        fprintf(stderr, "sha256_master: %d workers, 1 to %d supported!\n", worker_count, SHA256_MASTER_WORKERS_MAX);
+        return false;
+    }
+
+    memset(_g_sha256_master_buses, 0, sizeof(_g_sha256_master_buses));
+    for (i = 0; i < SHA256_MASTER_BUSES_MAX; i++)
+    {
+        _g_sha256_master_buses[i].fd = -1;
+        _g_sha256_master_buses[i].wake_fd = -1;
+    }
+
+    for (i = 0; i < worker_count; i++)
+    {
+        if ((p_worker_configs[i].transport >= SHA256_MASTER_TRANSPORT_COUNT) ||
+            (p_worker_configs[i].bus >= SHA256_MASTER_BUSES_MAX) ||
+            (p_worker_configs[i].in_flight_max > SHA256_MASTER_IN_FLIGHT_MAX))
+        {
+            fprintf(stderr, "sha256_master: Invalid configuration of worker %d!\n", i);
+            return false;
+        }
+
+        p_bus = &_g_sha256_master_buses[p_worker_configs[i].bus];
+        if ((NULL != p_bus->p_transport) && (_gp_sha256_master_transports[p_worker_configs[i].transport] != p_bus->p_transport))
+        {
+            fprintf(stderr, "sha256_master: Worker %d uses another transport than its bus!\n", i);
+            return false;
+        }
+
+        p_worker = &_g_sha256_master_workers[i];
+        memset(p_worker, 0, sizeof(*p_worker));
+        p_worker->config = p_worker_configs[i];
+        p_worker->index = (uint8_t)i;
+        p_worker->fd = -1;
+        p_worker->interrupt_fd = -1;
+
+        /* One request at a time until identify reports the receive queue length */
+        p_worker->in_flight_max = (0 != p_worker->config.in_flight_max) ? p_worker->config.in_flight_max : 1;
+        spsc_ring_init(&p_worker->submit_ring, p_worker->submit_storage, SHA256_MASTER_SUBMIT_QUEUE_LENGTH, sizeof(sha256_master_submission_t));
+
+        p_bus->p_transport = _gp_sha256_master_transports[p_worker_configs[i].transport];
+        p_bus->p_workers[p_bus->worker_count++] = p_worker;
+    }
+    _g_sha256_master_worker_count = worker_count;
+    _g_sha256_master_completion_bus = 0;
+
+    _g_sha256_master_completion_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (_g_sha256_master_completion_fd < 0)
+    {
+        fprintf(stderr, "sha256_master: Failed to create the completion event: %s!\n", strerror(errno));
+        sha256_master_deinit();
+        return false;
+    }
+
+    for (i = 0; i < SHA256_MASTER_BUSES_MAX; i++)
+    {
+        p_bus = &_g_sha256_master_buses[i];
+        if (0 == p_bus->worker_count) continue;
+
+        atomic_init(&p_bus->b_stop, false);
+        spsc_ring_init(&p_bus->completion_ring, p_bus->completion_storage, SHA256_MASTER_COMPLETION_QUEUE_LENGTH, sizeof(sha256_master_completion_t));
+
+        p_bus->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if ((p_bus->wake_fd < 0) || (false == p_bus->p_transport->p_open(p_bus)))
+        {
+            fprintf(stderr, "sha256_master: Failed to open bus %d!\n", i);
+            sha256_master_deinit();
+            return false;
+        }
+
+        if (0 != pthread_create(&p_bus->thread, NULL, _sha256_master_bus_task, p_bus))
+        {
+            fprintf(stderr, "sha256_master: Failed to create the thread of bus %d!\n", i);
+            sha256_master_deinit();
+            return false;
+        }
+        p_bus->b_thread_started = true;
+    }
+
+    return true;
+}
+
+void sha256_master_deinit(void)
+{
+    sha256_master_bus_t *p_bus = NULL;
+    int i = 0;
+    int j = 0;
+
+    for (i = 0; i < SHA256_MASTER_BUSES_MAX; i++)
+    {
+        p_bus = &_g_sha256_master_buses[i];
+        if (0 == p_bus->worker_count) continue;
+
+        if (true == p_bus->b_thread_started)
+        {
+            atomic_store(&p_bus->b_stop, true);
+            _sha256_master_fd_signal(p_bus->wake_fd);
+            pthread_join(p_bus->thread, NULL);
+            p_bus->b_thread_started = false;
+        }
+
+        /* Transport stops its own state, the file descriptors are closed here */
+        if ((NULL != p_bus->p_transport) && (NULL != p_bus->p_transport->p_close)) p_bus->p_transport->p_close(p_bus);
+
+        for (j = 0; j < p_bus->worker_count; j++)
+        {
+            if (p_bus->p_workers[j]->fd >= 0) close(p_bus->p_workers[j]->fd);
+            if (p_bus->p_workers[j]->interrupt_fd >= 0) close(p_bus->p_workers[j]->interrupt_fd);
+            p_bus->p_workers[j]->fd = -1;
+            p_bus->p_workers[j]->interrupt_fd = -1;
+        }
+        if (p_bus->fd >= 0) close(p_bus->fd);
+        if (p_bus->wake_fd >= 0) close(p_bus->wake_fd);
+        p_bus->fd = -1;
+        p_bus->wake_fd = -1;
+        p_bus->worker_count = 0;
+        p_bus->p_transport = NULL;
+    }
+
+    if (_g_sha256_master_completion_fd >= 0) close(_g_sha256_master_completion_fd);
+    _g_sha256_master_completion_fd = -1;
+    _g_sha256_master_worker_count = 0;
+}
+
+bool sha256_master_submit(uint8_t worker, const comm_request_t *p_request, size_t request_size, uint64_t tag)
+{
+    sha256_master_submission_t submission;
+    sha256_master_worker_t *p_worker = NULL;
+
+    if ((worker >= _g_sha256_master_worker_count) || (0 == request_size) || (request_size > sizeof(comm_request_t))) return false;
+    p_worker = &_g_sha256_master_workers[worker];
+
+    /* Frames are always written whole, the workers read fixed size frames */
+    memset(submission.frame, 0, sizeof(comm_request_t));
+    memcpy(submission.frame, p_request, request_size);
+    submission.size = sizeof(comm_request_t);
+    submission.b_stream = false;
+    _sha256_master_entry_prepare(&submission, tag);
+
+    if (false == spsc_ring_push(&p_worker->submit_ring, &submission)) return false;
+
+    _sha256_master_fd_signal(_g_sha256_master_buses[p_worker->config.bus].wake_fd);
+
+    return true;
+}
+
+bool sha256_master_stream_submit(uint8_t worker, const comm_stream_frame_t *p_stream_frame, uint64_t tag)
+{
+    sha256_master_submission_t submission;
+    sha256_master_worker_t *p_worker = NULL;
+
+    if ((worker >= _g_sha256_master_worker_count) || (p_stream_frame->data_size > COMM_STREAM_FRAME_DATA_SIZE)) return false;
+    p_worker = &_g_sha256_master_workers[worker];
+
+    submission.size = (uint16_t)(offsetof(comm_stream_frame_t, data) + p_stream_frame->data_size);
+    memcpy(submission.frame, p_stream_frame, submission.size);
+    submission.b_stream = true;
+    _sha256_master_entry_prepare(&submission, tag);
+
+    if (false == spsc_ring_push(&p_worker->submit_ring, &submission)) return false;
+
+    _sha256_master_fd_signal(_g_sha256_master_buses[p_worker->config.bus].wake_fd);
+
+    return true;
+}
+
+bool sha256_master_completion_get(sha256_master_completion_t *p_completion, int timeout_ms)
+{
+    struct pollfd poll_fd = { .fd = _g_sha256_master_completion_fd, .events = POLLIN };
+    uint64_t deadline_us = sha256_master_time_us() + ((uint64_t)timeout_ms * 1000);
+    uint64_t now_us = 0;
+    int wait_ms = 0;
+    int i = 0;
+
+    while (1)
+    {
+        /* Event is cleared before the rings are checked, a completion pushed afterwards sets it again */
+        _sha256_master_fd_drain(_g_sha256_master_completion_fd);
+
+        if (true == _sha256_master_completion_pop(p_completion))
+        {
+            /* Keep the event set while completions are left for poll and epoll users */
+            for (i = 0; i < SHA256_MASTER_BUSES_MAX; i++)
+            {
+                if ((0 != _g_sha256_master_buses[i].worker_count) && (false == spsc_ring_is_empty(&_g_sha256_master_buses[i].completion_ring)))
+                {
+                    _sha256_master_fd_signal(_g_sha256_master_completion_fd);
+                    break;
+                }
+            }
+
+            return true;
+        }
+
+        if (0 == timeout_ms) return false;
+
+        if (timeout_ms < 0)
+        {
+            wait_ms = -1;
+        }
+        else
+        {
+            now_us = sha256_master_time_us();
+            if (now_us >= deadline_us) return false;
+            wait_ms = (int)((deadline_us - now_us + 999) / 1000);
+        }
+
+        poll(&poll_fd, 1, wait_ms);
+    }
+}
+
+int sha256_master_completion_fd(void)
+{
+    return _g_sha256_master_completion_fd;
+}
+
+void sha256_master_get_status(sha256_master_status_t *p_sha256_master_status)
+{
+    sha256_master_bus_t *p_bus = NULL;
+    int i = 0;
+
+    memset(p_sha256_master_status, 0, sizeof(*p_sha256_master_status));
+
+    for (i = 0; i < SHA256_MASTER_BUSES_MAX; i++)
+    {
+        p_bus = &_g_sha256_master_buses[i];
+        if (0 == p_bus->worker_count) continue;
+
+        p_sha256_master_status->requests_written += atomic_load(&p_bus->requests_written);
+        p_sha256_master_status->responses_read += atomic_load(&p_bus->responses_read);
+        p_sha256_master_status->read_batches += atomic_load(&p_bus->read_batches);
+        p_sha256_master_status->status_polls += atomic_load(&p_bus->status_polls);
+        p_sha256_master_status->bus_errors += atomic_load(&p_bus->bus_errors);
+        p_sha256_master_status->proofs_late += atomic_load(&p_bus->proofs_late);
+    }
+}
+
+size_t sha256_master_response_size(const uint8_t *p_header)
+{
+    size_t count = 0;
+
+    switch (p_header[0])
+    {
+        case COMM_RESPONSE_SOLUTION: return sizeof(comm_solution_response_t);
+        case COMM_RESPONSE_SOLUTION_BATCH:
+            count = (p_header[1] < COMM_RESULT_COALESCE_COUNT) ? p_header[1] : COMM_RESULT_COALESCE_COUNT;
+            return offsetof(comm_solution_batch_response_t, sha256_offset_solution_queue_elements) + (count * sizeof(sha256_offset_solution_queue_element_t));
+        case COMM_RESPONSE_PROGRESS: return sizeof(comm_progress_response_t);
+        case COMM_RESPONSE_DIGEST: return sizeof(comm_digest_response_t);
+        case COMM_RESPONSE_PROOF: return sizeof(comm_proof_response_t);
+        case COMM_RESPONSE_IDENTIFY: return sizeof(comm_identify_response_t);
+        case COMM_RESPONSE_STATUS: return sizeof(comm_status_response_t);
+        case COMM_RESPONSE_ESTIMATE: return sizeof(comm_estimate_response_t);
+        case COMM_RESPONSE_PROFILE: return sizeof(comm_profile_response_t);
+        case COMM_RESPONSE_PROFILE_RING: return sizeof(comm_profile_ring_response_t);
+        default: return 0;
+    }
+}
+
+uint64_t sha256_master_time_us(void)
+{
+    struct timespec time_spec;
+
+    clock_gettime(CLOCK_MONOTONIC, &time_spec);
+
+    return ((uint64_t)time_spec.tv_sec * 1000000) + ((uint64_t)time_spec.tv_nsec / 1000);
+}
+
+bool sha256_master_interrupt_open(sha256_master_worker_t *p_worker)
+{
+    struct gpio_v2_line_request line_request;
+    int chip_fd = -1;
+    int result = 0;
+
+    if (NULL == p_worker->config.p_gpio_chip) return true;
+
+    chip_fd = open(p_worker->config.p_gpio_chip, O_RDONLY | O_CLOEXEC);
+    if (chip_fd < 0)
+    {
+        fprintf(stderr, "sha256_master: Failed to open %s: %s!\n", p_worker->config.p_gpio_chip, strerror(errno));
+        return false;
+    }
+
+    /* Worker pulses the line high once a response is ready to be read */
+    memset(&line_request, 0, sizeof(line_request));
+    line_request.offsets[0] = p_worker->config.gpio_line;
+    line_request.num_lines = 1;
+    line_request.config.flags = GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_RISING;
+    strncpy(line_request.consumer, SHA256_MASTER_GPIO_CONSUMER, sizeof(line_request.consumer) - 1);
+
+    result = ioctl(chip_fd, GPIO_V2_GET_LINE_IOCTL, &line_request);
+    close(chip_fd);
+    if (result < 0)
+    {
+        fprintf(stderr, "sha256_master: Failed to request line %u of %s: %s!\n", (unsigned int)p_worker->config.gpio_line, p_worker->config.p_gpio_chip, strerror(errno));
+        return false;
+    }
+
+    p_worker->interrupt_fd = line_request.fd;
+    fcntl(p_worker->interrupt_fd, F_SETFL, fcntl(p_worker->interrupt_fd, F_GETFL) | O_NONBLOCK);
+
+    return true;
+}
+
+/* ============================== PRIVATE FUNCTION DEFINITIONS */
+
+static void *_sha256_master_bus_task(void *p_arg)
+{
+    sha256_master_bus_t *p_bus = (sha256_master_bus_t *)p_arg;
+    uint64_t now_us = 0;
+
+    while (false == atomic_load(&p_bus->b_stop))
+    {
+        _sha256_master_bus_wait(p_bus);
+
+        /* Polled transports report pending results and free job slots in a status register */
+        if (NULL != p_bus->p_transport->p_pending_poll)
+        {
+            now_us = sha256_master_time_us();
+            if (now_us >= p_bus->next_poll_us)
+            {
+                if (false == p_bus->p_transport->p_pending_poll(p_bus)) atomic_fetch_add(&p_bus->bus_errors, 1);
+                atomic_fetch_add(&p_bus->status_polls, 1);
+                p_bus->next_poll_us = now_us + SHA256_MASTER_POLL_PERIOD_US;
+            }
+        }
+
+        /* Read first, responses make room for the next requests */
+        _sha256_master_bus_read(p_bus);
+        _sha256_master_bus_write(p_bus);
+    }
+
+    return NULL;
+}
+
+static void _sha256_master_bus_wait(sha256_master_bus_t *p_bus)
+{
+    struct pollfd poll_fds[1 + SHA256_MASTER_WORKERS_MAX];
+    sha256_master_worker_t *p_poll_workers[1 + SHA256_MASTER_WORKERS_MAX];
+    uint64_t now_us = 0;
+    int poll_count = 1;
+    int timeout_ms = -1;
+    int i = 0;
+
+    poll_fds[0].fd = p_bus->wake_fd;
+    poll_fds[0].events = POLLIN;
+    p_poll_workers[0] = NULL;
+
+    for (i = 0; i < p_bus->worker_count; i++)
+    {
+        /* Responses left over from the last read are read without waiting */
+        if (true == p_bus->p_workers[i]->b_response_pending) timeout_ms = 0;
+
+        if (p_bus->p_workers[i]->interrupt_fd < 0) continue;
+
+        poll_fds[poll_count].fd = p_bus->p_workers[i]->interrupt_fd;
+        poll_fds[poll_count].events = POLLIN;
+        p_poll_workers[poll_count] = p_bus->p_workers[i];
+        poll_count++;
+    }
+
+    if ((0 != timeout_ms) && (NULL != p_bus->p_transport->p_pending_poll))
+    {
+        now_us = sha256_master_time_us();
+        timeout_ms = (now_us >= p_bus->next_poll_us) ? 0 : (int)((p_bus->next_poll_us - now_us + 999) / 1000);
+    }
+
+    if (poll(poll_fds, poll_count, timeout_ms) <= 0) return;
+
+    for (i = 0; i < poll_count; i++)
+    {
+        if (0 == (POLLIN & poll_fds[i].revents)) continue;
+
+        _sha256_master_fd_drain(poll_fds[i].fd);
+        if (NULL != p_poll_workers[i]) p_poll_workers[i]->b_response_pending = true;
+    }
+}
+
+static void _sha256_master_bus_read(sha256_master_bus_t *p_bus)
+{
+    sha256_master_worker_t *p_read_workers[SHA256_MASTER_WORKERS_MAX];
+    sha256_master_worker_t *p_worker = NULL;
+    int read_count = 0;
+    int operations = 0;
+    int i = 0;
+
+    for (i = 0; i < p_bus->worker_count; i++)
+    {
+        if (true == p_bus->p_workers[i]->b_response_pending) p_read_workers[read_count++] = p_bus->p_workers[i];
+    }
+    if (0 == read_count) return;
+
+    operations = p_bus->p_transport->p_read(p_bus, p_read_workers, read_count);
+    if (operations < 0)
+    {
+        /* Responses are read again on the next interrupt or poll */
+        atomic_fetch_add(&p_bus->bus_errors, 1);
+        for (i = 0; i < read_count; i++) p_read_workers[i]->b_response_pending = false;
+        return;
+    }
+    atomic_fetch_add(&p_bus->read_batches, (uint64_t)operations);
+
+    for (i = 0; i < read_count; i++)
+    {
+        p_worker = p_read_workers[i];
+
+        /* Polled workers are read until the result register is empty, interrupt driven ones signal every response */
+        p_worker->b_response_pending = ((NULL != p_bus->p_transport->p_pending_poll) && (0 != p_worker->response_size));
+        if (0 == p_worker->response_size) continue;
+
+        atomic_fetch_add(&p_bus->responses_read, 1);
+        _sha256_master_response_handle(p_bus, p_worker, &p_worker->response, p_worker->response_size);
+        p_worker->response_size = 0;
+    }
+}
+
+static void _sha256_master_bus_write(sha256_master_bus_t *p_bus)
+{
+    sha256_master_worker_t *p_worker = NULL;
+    sha256_master_entry_t *p_entry = NULL;
+    bool b_polled = (NULL != p_bus->p_transport->p_pending_poll);
+    int i = 0;
+
+    for (i = 0; i < p_bus->worker_count; i++)
+    {
+        p_worker = p_bus->p_workers[i];
+
+        while (1)
+        {
+            if ((false == p_worker->b_pending) && (false == spsc_ring_pop(&p_worker->submit_ring, &p_worker->pending))) break;
+            p_worker->b_pending = true;
+            p_entry = &p_worker->pending.entry;
+
+            /* Requests with a response wait for room in the window, every frame waits for a free job slot */
+            if ((SHA256_MASTER_ENTRY_KIND_WRITE != p_entry->kind) && (p_worker->in_flight_count >= p_worker->in_flight_max)) break;
+
+            /* The worker searches one puzzle and a job or Merkle leaves replace it, so they wait for the job in flight to
+               complete. Queries and stream frames are pipelined around it */
+            if (((SHA256_MASTER_ENTRY_KIND_JOB == p_entry->kind) ||
+                 ((false == p_worker->pending.b_stream) && (COMM_REQUEST_MERKLE_LEAVES == p_entry->message_type))) &&
+                (true == _sha256_master_job_in_flight(p_worker))) break;
+            if ((true == b_polled) && (0 == p_worker->write_credits)) break;
+
+            p_worker->b_pending = false;
+
+            if (false == p_bus->p_transport->p_write(p_bus, p_worker, p_worker->pending.frame, p_worker->pending.size, p_worker->pending.b_stream))
+            {
+                atomic_fetch_add(&p_bus->bus_errors, 1);
+                _sha256_master_complete(p_bus, p_worker, p_entry, SHA256_MASTER_COMPLETION_ERROR, NULL, 0);
+                continue;
+            }
+            atomic_fetch_add(&p_bus->requests_written, 1);
+            if (true == b_polled) p_worker->write_credits--;
+
+            if (SHA256_MASTER_ENTRY_KIND_WRITE == p_entry->kind)
+            {
+                _sha256_master_complete(p_bus, p_worker, p_entry, SHA256_MASTER_COMPLETION_WRITTEN, NULL, 0);
+            }
+            else
+            {
+                p_worker->in_flight[p_worker->in_flight_count++] = *p_entry;
+            }
+        }
+    }
+}
+
+static void _sha256_master_response_handle(sha256_master_bus_t *p_bus, sha256_master_worker_t *p_worker, const comm_response_t *p_response, size_t response_size)
+{
+    comm_response_t solution_response;
+    const sha256_offset_solution_queue_element_t *p_solution = NULL;
+    const sha256_progress_queue_element_t *p_progress = NULL;
+    uint8_t queue_length = 0;
+    int index = -1;
+    int count = 0;
+    int i = 0;
+
+    switch (p_response->message_type)
+    {
+        case COMM_RESPONSE_IDENTIFY:
+        case COMM_RESPONSE_STATUS:
+        case COMM_RESPONSE_ESTIMATE:
+        case COMM_RESPONSE_PROFILE:
+        case COMM_RESPONSE_PROFILE_RING:
+            /* Identify sets the window if it wasn't configured */
+            if ((COMM_RESPONSE_IDENTIFY == p_response->message_type) && (0 == p_worker->config.in_flight_max))
+            {
+                queue_length = p_response->identify.receive_queue_length;
+                if (0 == queue_length) queue_length = 1;
+                if (queue_length > SHA256_MASTER_IN_FLIGHT_MAX) queue_length = SHA256_MASTER_IN_FLIGHT_MAX;
+                p_worker->in_flight_max = queue_length;
+            }
+
+            index = _sha256_master_in_flight_find(p_worker, SHA256_MASTER_ENTRY_KIND_QUERY, p_response->message_type, 0);
+            break;
+
+        case COMM_RESPONSE_SOLUTION:
+            p_solution = &p_response->solution.sha256_offset_solution_queue_element;
+            _sha256_master_result_handle(p_bus, p_worker, p_response, response_size, p_solution->puzzle_id, true);
+            return;
+
+        case COMM_RESPONSE_SOLUTION_BATCH:
+            /* Every solution of the batch completes its own job */
+            count = (p_response->solution_batch.count < COMM_RESULT_COALESCE_COUNT) ? p_response->solution_batch.count : COMM_RESULT_COALESCE_COUNT;
+            for (i = 0; i < count; i++)
+            {
+                p_solution = &p_response->solution_batch.sha256_offset_solution_queue_elements[i];
+                memset(&solution_response, 0, sizeof(solution_response));
+                solution_response.solution.message_type = COMM_RESPONSE_SOLUTION;
+                solution_response.solution.sha256_offset_solution_queue_element = *p_solution;
+                _sha256_master_result_handle(p_bus, p_worker, &solution_response, sizeof(comm_solution_response_t), p_solution->puzzle_id, true);
+            }
+            return;
+
+        case COMM_RESPONSE_PROGRESS:
+            p_progress = &p_response->progress.sha256_progress_queue_element;
+            _sha256_master_result_handle(p_bus, p_worker, p_response, response_size,
+                p_progress->sha256_offset_solution_queue_element.puzzle_id,
+                (SHA256_SOLUTION_STATUS_CHAIN_CHECKPOINT != p_progress->sha256_offset_solution_queue_element.status));
+            return;
+
+        case COMM_RESPONSE_PROOF:
+            /* Worker sends every proof before the root, a proof without its job in flight came after the root */
+            if (_sha256_master_in_flight_find(p_worker, SHA256_MASTER_ENTRY_KIND_JOB, 0, p_response->proof.sha256_merkle_proof_queue_element.puzzle_id) < 0)
+            {
+                atomic_fetch_add(&p_bus->proofs_late, 1);
+            }
+            _sha256_master_result_handle(p_bus, p_worker, p_response, response_size, p_response->proof.sha256_merkle_proof_queue_element.puzzle_id, false);
+            return;
+
+        case COMM_RESPONSE_DIGEST:
+            _sha256_master_stream_dropped_complete(p_bus, p_worker, p_response->digest.sha256_stream_digest_queue_element.dropped);
+            index = _sha256_master_in_flight_find(p_worker, SHA256_MASTER_ENTRY_KIND_STREAM, 0, p_response->digest.sha256_stream_digest_queue_element.puzzle_id);
+            break;
+
+        default:
+            break;
+    }
+
+    if (index < 0)
+    {
+        _sha256_master_complete(p_bus, p_worker, NULL, SHA256_MASTER_COMPLETION_UNSOLICITED, p_response, response_size);
+        return;
+    }
+
+    _sha256_master_complete(p_bus, p_worker, &p_worker->in_flight[index], SHA256_MASTER_COMPLETION_RESPONSE, p_response, response_size);
+    _sha256_master_in_flight_remove(p_worker, index);
+}
+
+static void _sha256_master_result_handle(sha256_master_bus_t *p_bus, sha256_master_worker_t *p_worker, const comm_response_t *p_response, size_t response_size, uint8_t puzzle_id, bool b_final)
+{
+    int index = _sha256_master_in_flight_find(p_worker, SHA256_MASTER_ENTRY_KIND_JOB, 0, puzzle_id);
+    int i = 0;
+
+    if (index < 0)
+    {
+        _sha256_master_complete(p_bus, p_worker, NULL, SHA256_MASTER_COMPLETION_UNSOLICITED, p_response, response_size);
+        return;
+    }
+
+    if (false == b_final)
+    {
+        _sha256_master_complete(p_bus, p_worker, &p_worker->in_flight[index], SHA256_MASTER_COMPLETION_PARTIAL, p_response, response_size);
+        return;
+    }
+
+    /* The worker only answers its current puzzle, older jobs were replaced before they finished */
+    for (i = 0; i < index; )
+    {
+        if (SHA256_MASTER_ENTRY_KIND_JOB != p_worker->in_flight[i].kind)
+        {
+            i++;
+            continue;
+        }
+
+        _sha256_master_complete(p_bus, p_worker, &p_worker->in_flight[i], SHA256_MASTER_COMPLETION_SUPERSEDED, NULL, 0);
+        _sha256_master_in_flight_remove(p_worker, i);
+        index--;
+    }
+
+    _sha256_master_complete(p_bus, p_worker, &p_worker->in_flight[index], SHA256_MASTER_COMPLETION_RESPONSE, p_response, response_size);
+    _sha256_master_in_flight_remove(p_worker, index);
+}
+
+static int _sha256_master_in_flight_find(const sha256_master_worker_t *p_worker, uint8_t kind, uint8_t message_type, uint8_t puzzle_id)
+{
+    const sha256_master_entry_t *p_entry = NULL;
+    int i = 0;
+
+    for (i = 0; i < p_worker->in_flight_count; i++)
+    {
+        p_entry = &p_worker->in_flight[i];
+        if (kind != p_entry->kind) continue;
+        if ((SHA256_MASTER_ENTRY_KIND_QUERY == kind) && (message_type != p_entry->message_type)) continue;
+        if ((SHA256_MASTER_ENTRY_KIND_QUERY != kind) && (puzzle_id != p_entry->puzzle_id)) continue;
+
+        return i;
+    }
+
+    return -1;
+}
+
+static void _sha256_master_stream_dropped_complete(sha256_master_bus_t *p_bus, sha256_master_worker_t *p_worker, uint8_t dropped)
+{
+    int i = 0;
+
+    /* Digests come in the order the messages were streamed, the dropped ones belong to the oldest messages in flight */
+    for (i = 0; (i < p_worker->in_flight_count) && (dropped > 0); )
+    {
+        if (SHA256_MASTER_ENTRY_KIND_STREAM != p_worker->in_flight[i].kind)
+        {
+            i++;
+            continue;
+        }
+
+        _sha256_master_complete(p_bus, p_worker, &p_worker->in_flight[i], SHA256_MASTER_COMPLETION_DROPPED, NULL, 0);
+        _sha256_master_in_flight_remove(p_worker, i);
+        dropped--;
+    }
+}
+
+static bool _sha256_master_job_in_flight(const sha256_master_worker_t *p_worker)
+{
+    int i = 0;
+
+    for (i = 0; i < p_worker->in_flight_count; i++)
+    {
+        if (SHA256_MASTER_ENTRY_KIND_JOB == p_worker->in_flight[i].kind) return true;
+    }
+
+    return false;
+}
+
+static void _sha256_master_in_flight_remove(sha256_master_worker_t *p_worker, int index)
+{
+    memmove(&p_worker->in_flight[index], &p_worker->in_flight[index + 1], (p_worker->in_flight_count - index - 1) * sizeof(sha256_master_entry_t));
+    p_worker->in_flight_count--;
+}
+
+static void _sha256_master_complete(sha256_master_bus_t *p_bus, sha256_master_worker_t *p_worker, const sha256_master_entry_t *p_entry, uint8_t kind, const comm_response_t *p_response, size_t response_size)
+{
+    sha256_master_completion_t completion;
+
+    memset(&completion, 0, sizeof(completion));
+    completion.worker = p_worker->index;
+    completion.kind = kind;
+    completion.size = (uint16_t)response_size;
+    if (NULL != p_response) memcpy(&completion.response, p_response, response_size);
+    if (NULL != p_entry)
+    {
+        completion.tag = p_entry->tag;
+        completion.latency_us = (uint32_t)(sha256_master_time_us() - p_entry->submit_us);
+    }
+
+    while (false == spsc_ring_push(&p_bus->completion_ring, &completion))
+    {
+        if (true == atomic_load(&p_bus->b_stop)) return;
+        usleep(SHA256_MASTER_COMPLETION_FULL_WAIT_US);
+    }
+
+    _sha256_master_fd_signal(_g_sha256_master_completion_fd);
+}
+
+static void _sha256_master_entry_prepare(sha256_master_submission_t *p_submission, uint64_t tag)
+{
+    const comm_request_t *p_request = (const comm_request_t *)p_submission->frame;
+    const comm_stream_frame_t *p_stream_frame = (const comm_stream_frame_t *)p_submission->frame;
+    sha256_master_entry_t *p_entry = &p_submission->entry;
+
+    p_entry->tag = tag;
+    p_entry->submit_us = sha256_master_time_us();
+    p_entry->message_type = p_request->message_type;
+    p_entry->puzzle_id = 0;
+
+    /* Only the last frame of a streamed message is answered, by its digest */
+    if (true == p_submission->b_stream)
+    {
+        p_entry->kind = (0 != (SHA256_STREAM_FLAG_LAST & p_stream_frame->flags)) ? SHA256_MASTER_ENTRY_KIND_STREAM : SHA256_MASTER_ENTRY_KIND_WRITE;
+        p_entry->puzzle_id = p_stream_frame->puzzle_id;
+        return;
+    }
+
+    switch (p_request->message_type)
+    {
+        case COMM_REQUEST_IDENTIFY:
+        case COMM_REQUEST_STATUS:
+        case COMM_REQUEST_ESTIMATE:
+        case COMM_REQUEST_PROFILE:
+        case COMM_REQUEST_PROFILE_RING:
+            p_entry->kind = SHA256_MASTER_ENTRY_KIND_QUERY;
+            break;
+
+        case COMM_REQUEST_RESIDENT_JOB:
+            p_entry->kind = SHA256_MASTER_ENTRY_KIND_JOB;
+            p_entry->puzzle_id = p_request->resident_job.puzzle_id;
+            break;
+
+        case COMM_REQUEST_SHARD_JOB:
+            p_entry->kind = SHA256_MASTER_ENTRY_KIND_JOB;
+            p_entry->puzzle_id = p_request->shard_job.sha256_input_variables_queue_element.puzzle_id;
+            break;
+
+        default:
+            /* First byte below the request message types is a job type */
+            if (p_request->message_type < COMM_REQUEST_IDENTIFY)
+            {
+                p_entry->kind = SHA256_MASTER_ENTRY_KIND_JOB;
+                p_entry->puzzle_id = p_request->job.puzzle_id;
+            }
+            else
+            {
+                p_entry->kind = SHA256_MASTER_ENTRY_KIND_WRITE;
+            }
+            break;
+    }
+}
+
+static bool _sha256_master_completion_pop(sha256_master_completion_t *p_completion)
+{
+    sha256_master_bus_t *p_bus = NULL;
+    int bus = 0;
+    int i = 0;
+
+    for (i = 0; i < SHA256_MASTER_BUSES_MAX; i++)
+    {
+        bus = (_g_sha256_master_completion_bus + i) % SHA256_MASTER_BUSES_MAX;
+        p_bus = &_g_sha256_master_buses[bus];
+        if (0 == p_bus->worker_count) continue;
+
+        if (true == spsc_ring_pop(&p_bus->completion_ring, p_completion))
+        {
+            /* Next call starts at the next bus so a busy bus doesn't starve the others */
+            _g_sha256_master_completion_bus = (bus + 1) % SHA256_MASTER_BUSES_MAX;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void _sha256_master_fd_drain(int fd)
+{
+    uint8_t buf[SHA256_MASTER_DRAIN_BUF_SIZE];
+
+    while (read(fd, buf, sizeof(buf)) > 0)
+    {
+        /* Nothing to do */
+    }
+}
+
+static void _sha256_master_fd_signal(int fd)
+{
+    uint64_t value = 1;
+
+    if (sizeof(value) != write(fd, &value, sizeof(value)))
+    {
+        /* Counter is already set */
+    }
+}
+
+/* ============================== INTERRUPT FUNCTION DEFINITIONS */
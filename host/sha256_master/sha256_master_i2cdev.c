@@ -0,0 +1,323 @@
+/**
+ * @file sha256_master_i2cdev.c
+ * @author Iwan Ćulumović
+ * @brief I2C slave transports through i2c-dev, one device per bus shared by its workers. The plain slave of
+ * i2c_manager.c signals a response on its interrupt out line and is read in two parts, the header that gives the size
+ * and then the rest. The register map slave of i2c_regmap_manager.c is polled through its status register. Reads of
+ * every worker of a batch are combined into as few combined transfers as the adapter takes.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/* ============================== INCLUDES */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include "sha256_master_transport.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Response header size, the message type and the solution count of a batch. */
+#define I2CDEV_RESPONSE_HEADER_SIZE             (2)
+
+/** @brief Register address size of the register map slave. */
+#define I2CDEV_REGISTER_ADDRESS_SIZE            (1)
+
+/** @brief Largest number of messages in one combined transfer. */
+#define I2CDEV_MESSAGES_MAX                     (I2C_RDWR_IOCTL_MAX_MSGS)
+
+/* ============================== TYPE DEFINITIONS */
+
+/* ============================== PRIVATE FUNCTION DECLARATIONS */
+
+/**
+ * @brief Opens the i2c-dev device of the bus and the interrupt out line of every worker.
+ * 
+ * @param p_bus Pointer to the bus.
+ * 
+ * @return bool Returns true if opened, false on error.
+ */
+static bool _i2cdev_open(sha256_master_bus_t *p_bus);
+
+/**
+ * @brief Writes a whole request frame, the plain slave receives fixed size frames.
+ * 
+ * @param p_bus Pointer to the bus.
+ * @param p_worker Pointer to the worker.
+ * @param p_frame Pointer to the frame.
+ * @param size Frame size in bytes.
+ * @param b_stream Frame is a stream frame, not supported over I2C.
+ * 
+ * @return bool Returns true if written, false on error.
+ */
+static bool _i2cdev_write(sha256_master_bus_t *p_bus, sha256_master_worker_t *p_worker, const uint8_t *p_frame, size_t size, bool b_stream);
+
+/**
+ * @brief Reads the response of every worker given, the headers of all of them first and then the rest.
+ * 
+ * @param p_bus Pointer to the bus.
+ * @param pp_workers Pointer to the workers.
+ * @param worker_count Number of workers.
+ * 
+ * @return int Number of combined transfers, -1 on error.
+ */
+static int _i2cdev_read(sha256_master_bus_t *p_bus, sha256_master_worker_t **pp_workers, int worker_count);
+
+/**
+ * @brief Writes a frame into the job register.
+ * 
+ * @param p_bus Pointer to the bus.
+ * @param p_worker Pointer to the worker.
+ * @param p_frame Pointer to the frame.
+ * @param size Frame size in bytes.
+ * @param b_stream Frame is a stream frame, not supported over I2C.
+ * 
+ * @return bool Returns true if written, false on error.
+ */
+static bool _i2c_regmap_write(sha256_master_bus_t *p_bus, sha256_master_worker_t *p_worker, const uint8_t *p_frame, size_t size, bool b_stream);
+
+/**
+ * @brief Reads the status register of every worker of the bus, sets pending results and free job slots.
+ * 
+ * @param p_bus Pointer to the bus.
+ * 
+ * @return bool Returns true on success, false on error.
+ */
+static bool _i2c_regmap_pending_poll(sha256_master_bus_t *p_bus);
+
+/**
+ * @brief Reads the result register of every worker given.
+ * 
+ * @param p_bus Pointer to the bus.
+ * @param pp_workers Pointer to the workers.
+ * @param worker_count Number of workers.
+ * 
+ * @return int Number of combined transfers, -1 on error.
+ */
+static int _i2c_regmap_read(sha256_master_bus_t *p_bus, sha256_master_worker_t **pp_workers, int worker_count);
+
+/**
+ * @brief Runs the messages as combined transfers of up to I2CDEV_MESSAGES_MAX messages, register reads are never
+ * split from their register address write.
+ * 
+ * @param fd i2c-dev device.
+ * @param p_messages Pointer to the messages.
+ * @param message_count Number of messages.
+ * @param messages_per_group Messages that must stay in the same transfer.
+ * 
+ * @return int Number of combined transfers, -1 on error.
+ */
+static int _i2cdev_transfer(int fd, struct i2c_msg *p_messages, int message_count, int messages_per_group);
+
+/* ============================== PRIVATE VARIABLES */
+
+/** @brief Register address of the status register. */
+static uint8_t _g_i2c_regmap_status_register = COMM_I2C_REG_STATUS;
+
+/** @brief Register address of the result register. */
+static uint8_t _g_i2c_regmap_result_register = COMM_I2C_REG_RESULT;
+
+/* ============================== PUBLIC VARIABLES */
+
+const sha256_master_transport_t sha256_master_transport_i2cdev = {
+    .p_open = _i2cdev_open,
+    .p_close = NULL,
+    .p_write = _i2cdev_write,
+    .p_pending_poll = NULL,
+    .p_read = _i2cdev_read,
+};
+
+const sha256_master_transport_t sha256_master_transport_i2c_regmap = {
+    .p_open = _i2cdev_open,
+    .p_close = NULL,
+    .p_write = _i2c_regmap_write,
+    .p_pending_poll = _i2c_regmap_pending_poll,
+    .p_read = _i2c_regmap_read,
+};
+
+/* ============================== PUBLIC FUNCTION DEFINITIONS */
+
+/* ============================== PRIVATE FUNCTION DEFINITIONS */
+
+static bool _i2cdev_open(sha256_master_bus_t *p_bus)
+{
+    int i = 0;
+
+    /* Workers of a bus share the adapter, the address is set per message */
+    p_bus->fd = open(p_bus->p_workers[0]->config.p_device, O_RDWR | O_CLOEXEC);
+    if (p_bus->fd < 0)
+    {
+        fprintf(stderr, "sha256_master: Failed to open %s: %s!\n", p_bus->p_workers[0]->config.p_device, strerror(errno));
+        return false;
+    }
+
+    for (i = 0; i < p_bus->worker_count; i++)
+    {
+        if (false == sha256_master_interrupt_open(p_bus->p_workers[i])) return false;
+    }
+
+    return true;
+}
+
+static bool _i2cdev_write(sha256_master_bus_t *p_bus, sha256_master_worker_t *p_worker, const uint8_t *p_frame, size_t size, bool b_stream)
+{
+    uint8_t frame[sizeof(comm_request_t)] = {0};
+    struct i2c_msg message;
+
+    if ((true == b_stream) || (size > sizeof(frame))) return false;
+
+    memcpy(frame, p_frame, size);
+    message.addr = p_worker->config.address;
+    message.flags = 0;
+    message.len = sizeof(frame);
+    message.buf = frame;
+
+    return (_i2cdev_transfer(p_bus->fd, &message, 1, 1) >= 0);
+}
+
+static int _i2cdev_read(sha256_master_bus_t *p_bus, sha256_master_worker_t **pp_workers, int worker_count)
+{
+    struct i2c_msg messages[SHA256_MASTER_WORKERS_MAX];
+    uint8_t *p_response = NULL;
+    int message_count = 0;
+    int transfers = 0;
+    int result = 0;
+    int i = 0;
+
+    /* Headers of every worker first, each slave releases its response on the first read */
+    for (i = 0; i < worker_count; i++)
+    {
+        messages[i].addr = pp_workers[i]->config.address;
+        messages[i].flags = I2C_M_RD;
+        messages[i].len = I2CDEV_RESPONSE_HEADER_SIZE;
+        messages[i].buf = (uint8_t *)&pp_workers[i]->response;
+    }
+    transfers = _i2cdev_transfer(p_bus->fd, messages, worker_count, 1);
+    if (transfers < 0) return -1;
+
+    /* Then the rest of every response whose type is known, sized from its header */
+    for (i = 0; i < worker_count; i++)
+    {
+        p_response = (uint8_t *)&pp_workers[i]->response;
+        pp_workers[i]->response_size = sha256_master_response_size(p_response);
+        if (pp_workers[i]->response_size <= I2CDEV_RESPONSE_HEADER_SIZE) continue;
+
+        messages[message_count].addr = pp_workers[i]->config.address;
+        messages[message_count].flags = I2C_M_RD;
+        messages[message_count].len = (uint16_t)(pp_workers[i]->response_size - I2CDEV_RESPONSE_HEADER_SIZE);
+        messages[message_count].buf = &p_response[I2CDEV_RESPONSE_HEADER_SIZE];
+        message_count++;
+    }
+    if (0 == message_count) return transfers;
+
+    result = _i2cdev_transfer(p_bus->fd, messages, message_count, 1);
+    if (result < 0) return -1;
+
+    return transfers + result;
+}
+
+static bool _i2c_regmap_write(sha256_master_bus_t *p_bus, sha256_master_worker_t *p_worker, const uint8_t *p_frame, size_t size, bool b_stream)
+{
+    uint8_t frame[I2CDEV_REGISTER_ADDRESS_SIZE + sizeof(comm_request_t)] = {0};
+    struct i2c_msg message;
+
+    if ((true == b_stream) || (size > sizeof(comm_request_t))) return false;
+
+    frame[0] = COMM_I2C_REG_JOB;
+    memcpy(&frame[I2CDEV_REGISTER_ADDRESS_SIZE], p_frame, size);
+    message.addr = p_worker->config.address;
+    message.flags = 0;
+    message.len = (uint16_t)(I2CDEV_REGISTER_ADDRESS_SIZE + size);
+    message.buf = frame;
+
+    return (_i2cdev_transfer(p_bus->fd, &message, 1, 1) >= 0);
+}
+
+static bool _i2c_regmap_pending_poll(sha256_master_bus_t *p_bus)
+{
+    struct i2c_msg messages[2 * SHA256_MASTER_WORKERS_MAX];
+    comm_i2c_status_register_t status_registers[SHA256_MASTER_WORKERS_MAX];
+    sha256_master_worker_t *p_worker = NULL;
+    int i = 0;
+
+    /* Register address write and repeated start read per worker */
+    for (i = 0; i < p_bus->worker_count; i++)
+    {
+        messages[2 * i].addr = p_bus->p_workers[i]->config.address;
+        messages[2 * i].flags = 0;
+        messages[2 * i].len = I2CDEV_REGISTER_ADDRESS_SIZE;
+        messages[2 * i].buf = &_g_i2c_regmap_status_register;
+        messages[(2 * i) + 1].addr = p_bus->p_workers[i]->config.address;
+        messages[(2 * i) + 1].flags = I2C_M_RD;
+        messages[(2 * i) + 1].len = sizeof(comm_i2c_status_register_t);
+        messages[(2 * i) + 1].buf = (uint8_t *)&status_registers[i];
+    }
+
+    if (_i2cdev_transfer(p_bus->fd, messages, 2 * p_bus->worker_count, 2) < 0) return false;
+
+    for (i = 0; i < p_bus->worker_count; i++)
+    {
+        p_worker = p_bus->p_workers[i];
+        if (0 != status_registers[i].result_count) p_worker->b_response_pending = true;
+        p_worker->write_credits = status_registers[i].job_slots_free;
+    }
+
+    return true;
+}
+
+static int _i2c_regmap_read(sha256_master_bus_t *p_bus, sha256_master_worker_t **pp_workers, int worker_count)
+{
+    struct i2c_msg messages[2 * SHA256_MASTER_WORKERS_MAX];
+    int transfers = 0;
+    int i = 0;
+
+    for (i = 0; i < worker_count; i++)
+    {
+        messages[2 * i].addr = pp_workers[i]->config.address;
+        messages[2 * i].flags = 0;
+        messages[2 * i].len = I2CDEV_REGISTER_ADDRESS_SIZE;
+        messages[2 * i].buf = &_g_i2c_regmap_result_register;
+        messages[(2 * i) + 1].addr = pp_workers[i]->config.address;
+        messages[(2 * i) + 1].flags = I2C_M_RD;
+        messages[(2 * i) + 1].len = sizeof(comm_response_t);
+        messages[(2 * i) + 1].buf = (uint8_t *)&pp_workers[i]->response;
+    }
+
+    transfers = _i2cdev_transfer(p_bus->fd, messages, 2 * worker_count, 2);
+    if (transfers < 0) return -1;
+
+    /* Empty result FIFO reads as COMM_RESPONSE_NONE, which has no size */
+    for (i = 0; i < worker_count; i++)
+    {
+        pp_workers[i]->response_size = sha256_master_response_size((const uint8_t *)&pp_workers[i]->response);
+    }
+
+    return transfers;
+}
+
+static int _i2cdev_transfer(int fd, struct i2c_msg *p_messages, int message_count, int messages_per_group)
+{
+    struct i2c_rdwr_ioctl_data rdwr_data;
+    int chunk_messages = (I2CDEV_MESSAGES_MAX / messages_per_group) * messages_per_group;
+    int transfers = 0;
+    int i = 0;
+
+    for (i = 0; i < message_count; i += chunk_messages)
+    {
+        rdwr_data.msgs = &p_messages[i];
+        rdwr_data.nmsgs = (uint32_t)(((message_count - i) < chunk_messages) ? (message_count - i) : chunk_messages);
+        if (ioctl(fd, I2C_RDWR, &rdwr_data) < 0) return -1;
+        transfers++;
+    }
+
+    return transfers;
+}
+
+/* ============================== INTERRUPT FUNCTION DEFINITIONS */
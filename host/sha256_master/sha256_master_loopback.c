@@ -0,0 +1,538 @@
+/**
+ * @file sha256_master_loopback.c
+ * @author Iwan Ćulumović
+ * @brief Loopback transport, an in-process stand-in worker per configured worker for testing the master without
+ * hardware. It behaves like the firmware as seen from the bus: written frames wait in a receive queue, one response
+ * at a time is signalled on an event and held until the master reads it, and only the current puzzle is answered.
+ * SHA256 jobs are searched with the firmware kernel, other job types are rejected. A configured speed adds the time
+ * the frames would take on the bus.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/* ============================== INCLUDES */
+
+#include <errno.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include "sha256_kernel.h"
+#include "sha256_master_transport.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Number of frames buffered before the stand-in worker consumes them, must be a power of two. */
+#define LOOPBACK_RECEIVE_QUEUE_LENGTH           (8)
+
+/** @brief Number of candidates searched between two receive queue checks. */
+#define LOOPBACK_BATCH_HASHES                   (4096)
+
+/** @brief Bits clocked per byte when the bus time is modelled, data and acknowledge as on I2C. */
+#define LOOPBACK_BITS_PER_BYTE                  (9)
+
+/* ============================== TYPE DEFINITIONS */
+
+/**
+ * @brief Stand-in worker.
+ * 
+ */
+typedef struct {
+    sha256_master_worker_t *p_worker;
+    pthread_t thread;
+    bool b_thread_started;
+    atomic_bool b_stop;
+    spsc_ring_t receive_ring;                           //! Written frames, produced by the bus thread
+    comm_request_t receive_storage[LOOPBACK_RECEIVE_QUEUE_LENGTH];
+    sem_t sem_received;                                 //! Given for every written frame
+    sem_t sem_read;                                     //! Given once the master read the response
+    comm_response_t response;                           //! Response waiting to be read
+    size_t response_size;
+    bool b_job;                                         //! A job is being searched
+    uint8_t current_puzzle_id;                          //! Only results of the current puzzle are answered
+    sha256_kernel_w0_ctx_t kernel_ctx;
+    uint32_t block[SHA256_KERNEL_BLOCK_WORDS];
+    uint32_t mask_words[SHA256_KERNEL_STATE_WORDS];
+    uint32_t target_words[SHA256_KERNEL_STATE_WORDS];
+    int compare_words;
+    sha256_nonce_t start_offset;
+    sha256_nonce_t current_offset;
+    uint64_t job_hashes;
+    sha256_calculator_status_t status;
+} loopback_worker_t;
+
+/* ============================== PRIVATE FUNCTION DECLARATIONS */
+
+/**
+ * @brief Starts a stand-in worker for every worker of the bus, its response event is the interrupt of the worker.
+ * 
+ * @param p_bus Pointer to the bus.
+ * 
+ * @return bool Returns true if started, false on error.
+ */
+static bool _loopback_open(sha256_master_bus_t *p_bus);
+
+/**
+ * @brief Stops the stand-in workers of the bus.
+ * 
+ * @param p_bus Pointer to the bus.
+ */
+static void _loopback_close(sha256_master_bus_t *p_bus);
+
+/**
+ * @brief Puts a request frame into the receive queue of the stand-in worker.
+ * 
+ * @param p_bus Pointer to the bus.
+ * @param p_worker Pointer to the worker.
+ * @param p_frame Pointer to the frame.
+ * @param size Frame size in bytes.
+ * @param b_stream Frame is a stream frame, not supported.
+ * 
+ * @return bool Returns true if written, false if the receive queue is full or the frame is a stream frame.
+ */
+static bool _loopback_write(sha256_master_bus_t *p_bus, sha256_master_worker_t *p_worker, const uint8_t *p_frame, size_t size, bool b_stream);
+
+/**
+ * @brief Takes the response of every worker given and releases the stand-in workers.
+ * 
+ * @param p_bus Pointer to the bus.
+ * @param pp_workers Pointer to the workers.
+ * @param worker_count Number of workers.
+ * 
+ * @return int Number of bus operations, 1.
+ */
+static int _loopback_read(sha256_master_bus_t *p_bus, sha256_master_worker_t **pp_workers, int worker_count);
+
+/**
+ * @brief Waits as long as clocking the bytes over the bus would take.
+ * 
+ * @param speed_hz Bus speed, 0 for no wait.
+ * @param size Number of bytes.
+ */
+static void _loopback_bus_time_wait(uint32_t speed_hz, size_t size);
+
+/**
+ * @brief Stand-in worker thread, consumes frames and searches the current job in batches.
+ * 
+ * @param p_arg Pointer to the stand-in worker.
+ * 
+ * @return void* NULL.
+ */
+static void *_loopback_task(void *p_arg);
+
+/**
+ * @brief Handles a frame taken from the receive queue.
+ * 
+ * @param p_loopback Pointer to the stand-in worker.
+ * @param p_request Pointer to the frame.
+ */
+static void _loopback_request_handle(loopback_worker_t *p_loopback, const comm_request_t *p_request);
+
+/**
+ * @brief Prepares the kernel and the target of a SHA256 job.
+ * 
+ * @param p_loopback Pointer to the stand-in worker.
+ * @param p_sha256_input_variables Pointer to the input variables.
+ */
+static void _loopback_job_start(loopback_worker_t *p_loopback, const sha256_input_variables_t *p_sha256_input_variables);
+
+/**
+ * @brief Searches a batch of the current job and answers it once it is found or the nonce space is searched.
+ * 
+ * @param p_loopback Pointer to the stand-in worker.
+ */
+static void _loopback_job_search(loopback_worker_t *p_loopback);
+
+/**
+ * @brief Answers with a solution.
+ * 
+ * @param p_loopback Pointer to the stand-in worker.
+ * @param puzzle_id Puzzle ID.
+ * @param status SHA256_SOLUTION_STATUS_*.
+ * @param offset_solution Offset solution.
+ */
+static void _loopback_solution_respond(loopback_worker_t *p_loopback, uint8_t puzzle_id, uint8_t status, sha256_nonce_t offset_solution);
+
+/**
+ * @brief Signals a response and waits until the master read it, as the slave managers do.
+ * 
+ * @param p_loopback Pointer to the stand-in worker.
+ * @param p_response Pointer to the response.
+ * @param response_size Response size in bytes.
+ */
+static void _loopback_respond(loopback_worker_t *p_loopback, const comm_response_t *p_response, size_t response_size);
+
+/* ============================== PRIVATE VARIABLES */
+
+static loopback_worker_t _g_loopback_workers[SHA256_MASTER_WORKERS_MAX];
+
+/* ============================== PUBLIC VARIABLES */
+
+const sha256_master_transport_t sha256_master_transport_loopback = {
+    .p_open = _loopback_open,
+    .p_close = _loopback_close,
+    .p_write = _loopback_write,
+    .p_pending_poll = NULL,
+    .p_read = _loopback_read,
+};
+
+/* ============================== PUBLIC FUNCTION DEFINITIONS */
+
+/* ============================== PRIVATE FUNCTION DEFINITIONS */
+
+static bool _loopback_open(sha256_master_bus_t *p_bus)
+{
+    sha256_master_worker_t *p_worker = NULL;
+    loopback_worker_t *p_loopback = NULL;
+    int i = 0;
+
+    for (i = 0; i < p_bus->worker_count; i++)
+    {
+        p_worker = p_bus->p_workers[i];
+        p_loopback = &_g_loopback_workers[p_worker->index];
+        memset(p_loopback, 0, sizeof(*p_loopback));
+        p_loopback->p_worker = p_worker;
+        p_worker->p_transport_ctx = p_loopback;
+
+        atomic_init(&p_loopback->b_stop, false);
+        spsc_ring_init(&p_loopback->receive_ring, p_loopback->receive_storage, LOOPBACK_RECEIVE_QUEUE_LENGTH, sizeof(comm_request_t));
+        sem_init(&p_loopback->sem_received, 0, 0);
+        sem_init(&p_loopback->sem_read, 0, 0);
+
+        p_worker->interrupt_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (p_worker->interrupt_fd < 0)
+        {
+            fprintf(stderr, "sha256_master: Failed to create the loopback event of worker %d: %s!\n", p_worker->index, strerror(errno));
+            return false;
+        }
+
+        if (0 != pthread_create(&p_loopback->thread, NULL, _loopback_task, p_loopback))
+        {
+            fprintf(stderr, "sha256_master: Failed to create the loopback thread of worker %d!\n", p_worker->index);
+            return false;
+        }
+        p_loopback->b_thread_started = true;
+    }
+
+    return true;
+}
+
+static void _loopback_close(sha256_master_bus_t *p_bus)
+{
+    loopback_worker_t *p_loopback = NULL;
+    int i = 0;
+
+    for (i = 0; i < p_bus->worker_count; i++)
+    {
+        p_loopback = (loopback_worker_t *)p_bus->p_workers[i]->p_transport_ctx;
+        if (NULL == p_loopback) continue;
+
+        if (true == p_loopback->b_thread_started)
+        {
+            atomic_store(&p_loopback->b_stop, true);
+            sem_post(&p_loopback->sem_received);
+            sem_post(&p_loopback->sem_read);
+            pthread_join(p_loopback->thread, NULL);
+        }
+        sem_destroy(&p_loopback->sem_received);
+        sem_destroy(&p_loopback->sem_read);
+        p_bus->p_workers[i]->p_transport_ctx = NULL;
+    }
+}
+
+static bool _loopback_write(sha256_master_bus_t *p_bus, sha256_master_worker_t *p_worker, const uint8_t *p_frame, size_t size, bool b_stream)
+{
+    loopback_worker_t *p_loopback = (loopback_worker_t *)p_worker->p_transport_ctx;
+    comm_request_t request;
+
+    (void)p_bus;
+
+    if ((true == b_stream) || (size > sizeof(request))) return false;
+
+    _loopback_bus_time_wait(p_worker->config.speed_hz, size);
+
+    memset(&request, 0, sizeof(request));
+    memcpy(&request, p_frame, size);
+    if (false == spsc_ring_push(&p_loopback->receive_ring, &request)) return false;
+
+    sem_post(&p_loopback->sem_received);
+
+    return true;
+}
+
+static int _loopback_read(sha256_master_bus_t *p_bus, sha256_master_worker_t **pp_workers, int worker_count)
+{
+    loopback_worker_t *p_loopback = NULL;
+    int i = 0;
+
+    (void)p_bus;
+
+    for (i = 0; i < worker_count; i++)
+    {
+        p_loopback = (loopback_worker_t *)pp_workers[i]->p_transport_ctx;
+        _loopback_bus_time_wait(pp_workers[i]->config.speed_hz, p_loopback->response_size);
+
+        pp_workers[i]->response_size = p_loopback->response_size;
+        memcpy(&pp_workers[i]->response, &p_loopback->response, p_loopback->response_size);
+        p_loopback->response_size = 0;
+        sem_post(&p_loopback->sem_read);
+    }
+
+    return 1;
+}
+
+static void _loopback_bus_time_wait(uint32_t speed_hz, size_t size)
+{
+    if (0 == speed_hz) return;
+
+    usleep((useconds_t)(((uint64_t)size * LOOPBACK_BITS_PER_BYTE * 1000000) / speed_hz));
+}
+
+static void *_loopback_task(void *p_arg)
+{
+    loopback_worker_t *p_loopback = (loopback_worker_t *)p_arg;
+    comm_request_t request;
+    uint64_t idle_start_us = 0;
+
+    while (false == atomic_load(&p_loopback->b_stop))
+    {
+        /* Wait for a frame when idle, else take one frame between batches as the calculator checks its input queue */
+        if ((false == p_loopback->b_job) && (true == spsc_ring_is_empty(&p_loopback->receive_ring)))
+        {
+            idle_start_us = sha256_master_time_us();
+            sem_wait(&p_loopback->sem_received);
+            p_loopback->status.idle_us_total += sha256_master_time_us() - idle_start_us;
+        }
+
+        if (true == spsc_ring_pop(&p_loopback->receive_ring, &request)) _loopback_request_handle(p_loopback, &request);
+
+        if (true == p_loopback->b_job) _loopback_job_search(p_loopback);
+    }
+
+    return NULL;
+}
+
+static void _loopback_request_handle(loopback_worker_t *p_loopback, const comm_request_t *p_request)
+{
+    comm_response_t response;
+    sha256_calculator_capabilities_t *p_capabilities = &response.identify.sha256_calculator_capabilities;
+
+    memset(&response, 0, sizeof(response));
+
+    switch (p_request->message_type)
+    {
+        case COMM_REQUEST_IDENTIFY:
+            response.identify.message_type = COMM_RESPONSE_IDENTIFY;
+            response.identify.protocol_version = COMM_PROTOCOL_VERSION;
+            response.identify.transport = COMM_TRANSPORT_SIM;
+            response.identify.core_count = 1;
+            response.identify.max_write_size = sizeof(comm_request_t);
+            response.identify.max_read_size = sizeof(comm_response_t);
+            response.identify.receive_queue_length = LOOPBACK_RECEIVE_QUEUE_LENGTH;
+            p_capabilities->nonce_size = sizeof(sha256_nonce_t);
+            p_capabilities->job_types = (1 << SHA256_JOB_TYPE_SHA256);
+            p_capabilities->kernel_variant = SHA256_KERNEL_VARIANT_PRECOMPUTED;
+            p_capabilities->core_id = SHA256_CORE_ID_ANY;
+            p_capabilities->worker_count = 1;
+            p_capabilities->input_queue_length = LOOPBACK_RECEIVE_QUEUE_LENGTH;
+            p_capabilities->batch_size_max = LOOPBACK_BATCH_HASHES;
+            _loopback_respond(p_loopback, &response, sizeof(comm_identify_response_t));
+            break;
+
+        case COMM_REQUEST_STATUS:
+            response.status.message_type = COMM_RESPONSE_STATUS;
+            response.status.sha256_calculator_status = p_loopback->status;
+            _loopback_respond(p_loopback, &response, sizeof(comm_status_response_t));
+            break;
+
+        case COMM_REQUEST_ESTIMATE:
+            /* Loopback has no calibrated hash rate, it only reports the candidates tested */
+            response.estimate.message_type = COMM_RESPONSE_ESTIMATE;
+            response.estimate.sha256_calculator_estimate.puzzle_id = p_loopback->current_puzzle_id;
+            response.estimate.sha256_calculator_estimate.job_type = SHA256_JOB_TYPE_SHA256;
+            response.estimate.sha256_calculator_estimate.flags = SHA256_ESTIMATE_FLAG_SEARCH | ((true == p_loopback->b_job) ? SHA256_ESTIMATE_FLAG_ACTIVE : 0);
+            response.estimate.sha256_calculator_estimate.job_hashes = p_loopback->job_hashes;
+            _loopback_respond(p_loopback, &response, sizeof(comm_estimate_response_t));
+            break;
+
+        case COMM_REQUEST_PROFILE:
+            /* Loopback has no profiler */
+            response.profile.message_type = COMM_RESPONSE_PROFILE;
+            response.profile.stage = COMM_PROFILE_STAGE_NONE;
+            response.profile.first_bucket = p_request->profile.first_bucket;
+            _loopback_respond(p_loopback, &response, sizeof(comm_profile_response_t));
+            break;
+
+        case COMM_REQUEST_PROFILE_RING:
+            /* Loopback has no samples */
+            response.profile_ring.message_type = COMM_RESPONSE_PROFILE_RING;
+            response.profile_ring.first_index = p_request->profile_ring.first_index;
+            _loopback_respond(p_loopback, &response, sizeof(comm_profile_ring_response_t));
+            break;
+
+        case COMM_REQUEST_RESIDENT_JOB:
+            p_loopback->current_puzzle_id = p_request->resident_job.puzzle_id;
+            p_loopback->b_job = false;
+            _loopback_solution_respond(p_loopback, p_request->resident_job.puzzle_id, SHA256_SOLUTION_STATUS_INVALID_JOB, 0);
+            break;
+
+        case COMM_REQUEST_SHARD_JOB:
+            p_loopback->current_puzzle_id = p_request->shard_job.sha256_input_variables_queue_element.puzzle_id;
+            p_loopback->b_job = false;
+            _loopback_solution_respond(p_loopback, p_loopback->current_puzzle_id, SHA256_SOLUTION_STATUS_INVALID_JOB, 0);
+            break;
+
+        case COMM_REQUEST_MERKLE_LEAVES:
+            /* Replaces the current puzzle as on the worker, the leaves are dropped */
+            p_loopback->current_puzzle_id = p_request->merkle_leaves.puzzle_id;
+            if (true == p_loopback->b_job) p_loopback->status.hashes_superseded += p_loopback->job_hashes;
+            p_loopback->b_job = false;
+            break;
+
+        case SHA256_JOB_TYPE_SHA256:
+            /* New puzzle replaces the one being searched */
+            if (true == p_loopback->b_job) p_loopback->status.hashes_superseded += p_loopback->job_hashes;
+            p_loopback->current_puzzle_id = p_request->job.puzzle_id;
+            _loopback_job_start(p_loopback, &p_request->job.sha256_input_variables);
+            break;
+
+        default:
+            if (p_request->message_type < COMM_REQUEST_IDENTIFY)
+            {
+                p_loopback->current_puzzle_id = p_request->job.puzzle_id;
+                p_loopback->b_job = false;
+                _loopback_solution_respond(p_loopback, p_request->job.puzzle_id, SHA256_SOLUTION_STATUS_INVALID_JOB, 0);
+            }
+            break;
+    }
+}
+
+static void _loopback_job_start(loopback_worker_t *p_loopback, const sha256_input_variables_t *p_sha256_input_variables)
+{
+    uint32_t target_word = 0;
+    int mask_bits = p_sha256_input_variables->target_solution_mask_offset + 1;
+    int word_bits = 0;
+    int i = 0;
+
+    /* Compared bits counted from the most significant bit of the big endian digest words */
+    p_loopback->compare_words = 0;
+    for (i = 0; i < SHA256_KERNEL_STATE_WORDS; i++)
+    {
+        word_bits = mask_bits - (i * 32);
+        if (word_bits < 0) word_bits = 0;
+        if (word_bits > 32) word_bits = 32;
+
+        target_word = (((uint32_t)p_sha256_input_variables->target_solution[4 * i] << 24) |
+                       ((uint32_t)p_sha256_input_variables->target_solution[4 * i + 1] << 16) |
+                       ((uint32_t)p_sha256_input_variables->target_solution[4 * i + 2] << 8) |
+                       ((uint32_t)p_sha256_input_variables->target_solution[4 * i + 3]));
+        p_loopback->mask_words[i] = (0 == word_bits) ? 0 : (0xFFFFFFFF << (32 - word_bits));
+        p_loopback->target_words[i] = target_word & p_loopback->mask_words[i];
+        if (0 != word_bits) p_loopback->compare_words = i + 1;
+    }
+
+    /* Nonce block as the calculator hashes it, padding right after the nonce and the length in the last word */
+    memset(p_loopback->block, 0, sizeof(p_loopback->block));
+    p_loopback->block[sizeof(sha256_nonce_t) / sizeof(uint32_t)] = 0x80000000;
+    p_loopback->block[SHA256_KERNEL_BLOCK_WORDS - 1] = sizeof(sha256_nonce_t) * 8;
+#ifdef CONFIG_SHA256_CALC_NONCE_64BIT
+    p_loopback->block[1] = __builtin_bswap32((uint32_t)(p_sha256_input_variables->input_offset >> 32));
+#endif
+    sha256_kernel_w0_prepare(&p_loopback->kernel_ctx, sha256_kernel_initial_state, p_loopback->block);
+
+    p_loopback->start_offset = p_sha256_input_variables->input_offset;
+    p_loopback->current_offset = p_sha256_input_variables->input_offset;
+    p_loopback->job_hashes = 0;
+    p_loopback->b_job = true;
+}
+
+static void _loopback_job_search(loopback_worker_t *p_loopback)
+{
+    uint32_t digest[SHA256_KERNEL_STATE_WORDS];
+    uint64_t start_us = sha256_master_time_us();
+    uint64_t duration_us = 0;
+    bool b_match = false;
+    uint32_t hashes = 0;
+    int i = 0;
+
+    for (hashes = 0; hashes < LOOPBACK_BATCH_HASHES; hashes++)
+    {
+        sha256_kernel_w0_hash(&p_loopback->kernel_ctx, __builtin_bswap32((uint32_t)p_loopback->current_offset), digest);
+
+        b_match = true;
+        for (i = 0; i < p_loopback->compare_words; i++)
+        {
+            if ((digest[i] & p_loopback->mask_words[i]) != p_loopback->target_words[i])
+            {
+                b_match = false;
+                break;
+            }
+        }
+        if (true == b_match) break;
+
+        p_loopback->current_offset++;
+#ifdef CONFIG_SHA256_CALC_NONCE_64BIT
+        /* High nonce word is part of the prepared schedule */
+        if (0 == (uint32_t)p_loopback->current_offset)
+        {
+            p_loopback->block[1] = __builtin_bswap32((uint32_t)(p_loopback->current_offset >> 32));
+            sha256_kernel_w0_prepare(&p_loopback->kernel_ctx, sha256_kernel_initial_state, p_loopback->block);
+        }
+#endif
+        if (p_loopback->current_offset == p_loopback->start_offset) break;
+    }
+    if (true == b_match) hashes++;
+
+    p_loopback->job_hashes += hashes;
+    p_loopback->status.hashes_total += hashes;
+    p_loopback->status.batch_size = LOOPBACK_BATCH_HASHES;
+    p_loopback->status.batch_size_min = LOOPBACK_BATCH_HASHES;
+    p_loopback->status.batch_size_max = LOOPBACK_BATCH_HASHES;
+    duration_us = sha256_master_time_us() - start_us;
+    p_loopback->status.batch_duration_us = (uint32_t)duration_us;
+    if (0 != duration_us) p_loopback->status.hash_rate = (uint32_t)(((uint64_t)hashes * 1000000) / duration_us);
+
+    if (true == b_match)
+    {
+        p_loopback->b_job = false;
+        _loopback_solution_respond(p_loopback, p_loopback->current_puzzle_id, SHA256_SOLUTION_STATUS_FOUND, p_loopback->current_offset);
+    }
+    else if (p_loopback->current_offset == p_loopback->start_offset)
+    {
+        p_loopback->b_job = false;
+        _loopback_solution_respond(p_loopback, p_loopback->current_puzzle_id, SHA256_SOLUTION_STATUS_EXHAUSTED, 0);
+    }
+}
+
+static void _loopback_solution_respond(loopback_worker_t *p_loopback, uint8_t puzzle_id, uint8_t status, sha256_nonce_t offset_solution)
+{
+    comm_response_t response;
+
+    memset(&response, 0, sizeof(response));
+    response.solution.message_type = COMM_RESPONSE_SOLUTION;
+    response.solution.sha256_offset_solution_queue_element.sha256_offset_solution.offset_solution = offset_solution;
+    response.solution.sha256_offset_solution_queue_element.puzzle_id = puzzle_id;
+    response.solution.sha256_offset_solution_queue_element.status = status;
+
+    _loopback_respond(p_loopback, &response, sizeof(comm_solution_response_t));
+}
+
+static void _loopback_respond(loopback_worker_t *p_loopback, const comm_response_t *p_response, size_t response_size)
+{
+    uint64_t value = 1;
+
+    memcpy(&p_loopback->response, p_response, response_size);
+    p_loopback->response_size = response_size;
+
+    /* Signal data ready to the master, the event takes the place of the interrupt out line */
+    if (sizeof(value) != write(p_loopback->p_worker->interrupt_fd, &value, sizeof(value)))
+    {
+        /* Event is already set */
+    }
+
+    sem_wait(&p_loopback->sem_read);
+}
+
+/* ============================== INTERRUPT FUNCTION DEFINITIONS */
@@ -0,0 +1,218 @@
+/**
+ * @file sha256_master_spidev.c
+ * @author Iwan Ćulumović
+ * @brief SPI slave transport through spidev, one device per chip select. Mirrors the commands of spi_manager.c, every
+ * transaction starts with a command byte and the worker requeues its transaction after each one, so transactions to
+ * the same worker are spaced by a turnaround time. Reads of a batch are interleaved across the workers to hide it.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/* ============================== INCLUDES */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/spi/spidev.h>
+#include "sha256_master_transport.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Command, master writes a frame (spi_manager.c SPI_MASTER_CMD_DATA_WRITE). */
+#define SPIDEV_CMD_DATA_WRITE                   (0x22)
+
+/** @brief Command, master asks the worker to load its response (spi_manager.c SPI_MASTER_CMD_REQUEST_DATA_READ). */
+#define SPIDEV_CMD_REQUEST_DATA_READ            (0x33)
+
+/** @brief Command, master reads the loaded response (spi_manager.c SPI_MASTER_CMD_DATA_READ). */
+#define SPIDEV_CMD_DATA_READ                    (0x44)
+
+/** @brief Command, master writes a stream frame (spi_manager.c SPI_MASTER_CMD_STREAM_WRITE). */
+#define SPIDEV_CMD_STREAM_WRITE                 (0x55)
+
+/** @brief Command size in bytes. */
+#define SPIDEV_COMMAND_SIZE                     (1)
+
+/** @brief Transaction sizes are rounded up to this many bytes for the DMA of the worker. */
+#define SPIDEV_TRANSACTION_SIZE_ALIGNMENT       (4)
+
+/** @brief Largest transaction size in bytes. */
+#define SPIDEV_TRANSACTION_SIZE_MAX             (SPIDEV_COMMAND_SIZE + SHA256_MASTER_FRAME_SIZE_MAX + SPIDEV_TRANSACTION_SIZE_ALIGNMENT)
+
+/** @brief Time the worker needs to requeue its transaction after a transaction in microseconds. */
+#define SPIDEV_TURNAROUND_US                    (100)
+
+/** @brief SPI mode of the worker (CPOL = 0, CPHA = 0). */
+#define SPIDEV_MODE                             (SPI_MODE_0)
+
+/** @brief Bits per word. */
+#define SPIDEV_BITS_PER_WORD                    (8)
+
+/* ============================== TYPE DEFINITIONS */
+
+/* ============================== PRIVATE FUNCTION DECLARATIONS */
+
+/**
+ * @brief Opens and configures the spidev device and the interrupt out line of every worker of the bus.
+ * 
+ * @param p_bus Pointer to the bus.
+ * 
+ * @return bool Returns true if opened, false on error.
+ */
+static bool _spidev_open(sha256_master_bus_t *p_bus);
+
+/**
+ * @brief Writes a request frame or a stream frame after its command byte.
+ * 
+ * @param p_bus Pointer to the bus.
+ * @param p_worker Pointer to the worker.
+ * @param p_frame Pointer to the frame.
+ * @param size Frame size in bytes.
+ * @param b_stream Frame is a stream frame.
+ * 
+ * @return bool Returns true if written, false on error.
+ */
+static bool _spidev_write(sha256_master_bus_t *p_bus, sha256_master_worker_t *p_worker, const uint8_t *p_frame, size_t size, bool b_stream);
+
+/**
+ * @brief Reads the response of every worker given, a read request to each of them first and then the reads.
+ * 
+ * @param p_bus Pointer to the bus.
+ * @param pp_workers Pointer to the workers.
+ * @param worker_count Number of workers.
+ * 
+ * @return int Number of transactions, -1 on error.
+ */
+static int _spidev_read(sha256_master_bus_t *p_bus, sha256_master_worker_t **pp_workers, int worker_count);
+
+/**
+ * @brief Runs one full duplex transaction with a worker after its turnaround time.
+ * 
+ * @param p_worker Pointer to the worker.
+ * @param p_tx Pointer to the transmitted bytes.
+ * @param p_rx Pointer to where the received bytes will be written, NULL to drop them.
+ * @param size Transaction size in bytes.
+ * 
+ * @return bool Returns true on success, false on error.
+ */
+static bool _spidev_transfer(sha256_master_worker_t *p_worker, const uint8_t *p_tx, uint8_t *p_rx, size_t size);
+
+/* ============================== PRIVATE VARIABLES */
+
+/* ============================== PUBLIC VARIABLES */
+
+const sha256_master_transport_t sha256_master_transport_spidev = {
+    .p_open = _spidev_open,
+    .p_close = NULL,
+    .p_write = _spidev_write,
+    .p_pending_poll = NULL,
+    .p_read = _spidev_read,
+};
+
+/* ============================== PUBLIC FUNCTION DEFINITIONS */
+
+/* ============================== PRIVATE FUNCTION DEFINITIONS */
+
+static bool _spidev_open(sha256_master_bus_t *p_bus)
+{
+    sha256_master_worker_t *p_worker = NULL;
+    uint8_t mode = SPIDEV_MODE;
+    uint8_t bits_per_word = SPIDEV_BITS_PER_WORD;
+    int i = 0;
+
+    for (i = 0; i < p_bus->worker_count; i++)
+    {
+        p_worker = p_bus->p_workers[i];
+
+        p_worker->fd = open(p_worker->config.p_device, O_RDWR | O_CLOEXEC);
+        if (p_worker->fd < 0)
+        {
+            fprintf(stderr, "sha256_master: Failed to open %s: %s!\n", p_worker->config.p_device, strerror(errno));
+            return false;
+        }
+
+        if ((ioctl(p_worker->fd, SPI_IOC_WR_MODE, &mode) < 0) ||
+            (ioctl(p_worker->fd, SPI_IOC_WR_BITS_PER_WORD, &bits_per_word) < 0) ||
+            ((0 != p_worker->config.speed_hz) && (ioctl(p_worker->fd, SPI_IOC_WR_MAX_SPEED_HZ, &p_worker->config.speed_hz) < 0)))
+        {
+            fprintf(stderr, "sha256_master: Failed to configure %s: %s!\n", p_worker->config.p_device, strerror(errno));
+            return false;
+        }
+
+        if (false == sha256_master_interrupt_open(p_worker)) return false;
+    }
+
+    return true;
+}
+
+static bool _spidev_write(sha256_master_bus_t *p_bus, sha256_master_worker_t *p_worker, const uint8_t *p_frame, size_t size, bool b_stream)
+{
+    uint8_t tx[SPIDEV_TRANSACTION_SIZE_MAX] = {0};
+    size_t transaction_size = SPIDEV_COMMAND_SIZE + size;
+
+    (void)p_bus;
+
+    /* Command byte is followed by the frame, stream frames are only clocked up to the last data byte */
+    tx[0] = (true == b_stream) ? SPIDEV_CMD_STREAM_WRITE : SPIDEV_CMD_DATA_WRITE;
+    memcpy(&tx[SPIDEV_COMMAND_SIZE], p_frame, size);
+    transaction_size = (transaction_size + SPIDEV_TRANSACTION_SIZE_ALIGNMENT - 1) & ~(size_t)(SPIDEV_TRANSACTION_SIZE_ALIGNMENT - 1);
+
+    return _spidev_transfer(p_worker, tx, NULL, transaction_size);
+}
+
+static int _spidev_read(sha256_master_bus_t *p_bus, sha256_master_worker_t **pp_workers, int worker_count)
+{
+    uint8_t tx[SPIDEV_TRANSACTION_SIZE_MAX] = {0};
+    uint8_t rx[SPIDEV_TRANSACTION_SIZE_MAX] = {0};
+    size_t transaction_size = (sizeof(comm_response_t) + SPIDEV_TRANSACTION_SIZE_ALIGNMENT - 1) & ~(size_t)(SPIDEV_TRANSACTION_SIZE_ALIGNMENT - 1);
+    int i = 0;
+
+    (void)p_bus;
+
+    /* Every worker loads its response first, the turnaround of one worker passes while the others are asked */
+    tx[0] = SPIDEV_CMD_REQUEST_DATA_READ;
+    for (i = 0; i < worker_count; i++)
+    {
+        pp_workers[i]->response_size = 0;
+        if (false == _spidev_transfer(pp_workers[i], tx, NULL, SPIDEV_TRANSACTION_SIZE_ALIGNMENT)) return -1;
+    }
+
+    /* Response starts at the first byte, clocked out while the command byte is clocked in */
+    tx[0] = SPIDEV_CMD_DATA_READ;
+    for (i = 0; i < worker_count; i++)
+    {
+        if (false == _spidev_transfer(pp_workers[i], tx, rx, transaction_size)) return -1;
+
+        pp_workers[i]->response_size = sha256_master_response_size(rx);
+        memcpy(&pp_workers[i]->response, rx, pp_workers[i]->response_size);
+    }
+
+    return 2 * worker_count;
+}
+
+static bool _spidev_transfer(sha256_master_worker_t *p_worker, const uint8_t *p_tx, uint8_t *p_rx, size_t size)
+{
+    struct spi_ioc_transfer transfer;
+    uint64_t now_us = sha256_master_time_us();
+    int result = 0;
+
+    if (now_us < (p_worker->last_transfer_us + SPIDEV_TURNAROUND_US)) usleep((useconds_t)(p_worker->last_transfer_us + SPIDEV_TURNAROUND_US - now_us));
+
+    memset(&transfer, 0, sizeof(transfer));
+    transfer.tx_buf = (uintptr_t)p_tx;
+    transfer.rx_buf = (uintptr_t)p_rx;
+    transfer.len = (uint32_t)size;
+    transfer.speed_hz = p_worker->config.speed_hz;
+    transfer.bits_per_word = SPIDEV_BITS_PER_WORD;
+
+    result = ioctl(p_worker->fd, SPI_IOC_MESSAGE(1), &transfer);
+    p_worker->last_transfer_us = sha256_master_time_us();
+
+    return (result >= 0);
+}
+
+/* ============================== INTERRUPT FUNCTION DEFINITIONS */
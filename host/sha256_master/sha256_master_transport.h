@@ -0,0 +1,164 @@
+/**
+ * @file sha256_master_transport.h
+ * @author Iwan Ćulumović
+ * @brief Master internals shared by the core and the transports.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef __SHA256_MASTER_TRANSPORT_H__
+#define __SHA256_MASTER_TRANSPORT_H__
+
+/* ============================== INCLUDES */
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include "sha256_master.h"
+#include "spsc_ring.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Number of submissions queued per worker before they are written, must be a power of two. */
+#define SHA256_MASTER_SUBMIT_QUEUE_LENGTH       (16)
+
+/** @brief Number of completions queued per bus before the bus thread waits for the consumer, must be a power of two. */
+#define SHA256_MASTER_COMPLETION_QUEUE_LENGTH   (256)
+
+/** @brief Largest frame written to a worker, a request or a stream frame. */
+#define SHA256_MASTER_FRAME_SIZE_MAX            ((sizeof(comm_request_t) > sizeof(comm_stream_frame_t)) ? sizeof(comm_request_t) : sizeof(comm_stream_frame_t))
+
+/** @brief In flight entry, query answered by a response of the same message type (identify, status, estimate). */
+#define SHA256_MASTER_ENTRY_KIND_QUERY          (0x00)
+
+/** @brief In flight entry, job answered by a result with the same puzzle ID. */
+#define SHA256_MASTER_ENTRY_KIND_JOB            (0x01)
+
+/** @brief In flight entry, last stream frame of a message answered by its digest. */
+#define SHA256_MASTER_ENTRY_KIND_STREAM         (0x02)
+
+/** @brief In flight entry, request without a response, completed once written. */
+#define SHA256_MASTER_ENTRY_KIND_WRITE          (0x03)
+
+/* ============================== TYPE DEFINITIONS */
+
+/**
+ * @brief Request waiting for its response.
+ * 
+ */
+typedef struct {
+    uint64_t tag;                                       //! Tag of the submission
+    uint64_t submit_us;                                 //! Submission time
+    uint8_t kind;                                       //! SHA256_MASTER_ENTRY_KIND_*
+    uint8_t message_type;                               //! Request message type or job type
+    uint8_t puzzle_id;                                  //! Puzzle ID of jobs and streams
+} sha256_master_entry_t;
+
+/**
+ * @brief Submitted frame, queued until the worker has room for it.
+ * 
+ */
+typedef struct {
+    sha256_master_entry_t entry;
+    uint16_t size;                                      //! Frame size in bytes
+    bool b_stream;                                      //! Frame is a stream frame instead of a request
+    uint8_t frame[SHA256_MASTER_FRAME_SIZE_MAX];
+} sha256_master_submission_t;
+
+/**
+ * @brief Worker state, owned by the thread of its bus apart from the submission ring.
+ * 
+ */
+typedef struct {
+    sha256_master_worker_config_t config;
+    uint8_t index;                                      //! Worker index
+    int fd;                                             //! Device of the worker, -1 if the bus shares one device
+    int interrupt_fd;                                   //! Readable when the worker signals a response, -1 for polled transports
+    void *p_transport_ctx;                              //! Transport specific state
+    uint64_t last_transfer_us;                          //! End of the last transfer, the worker needs time to requeue
+    spsc_ring_t submit_ring;                            //! Submissions, produced by the submitting thread
+    sha256_master_submission_t submit_storage[SHA256_MASTER_SUBMIT_QUEUE_LENGTH];
+    sha256_master_submission_t pending;                 //! Submission taken from the ring but not written yet
+    bool b_pending;                                     //! Pending submission is valid
+    sha256_master_entry_t in_flight[SHA256_MASTER_IN_FLIGHT_MAX];   //! Oldest first
+    uint8_t in_flight_count;                            //! Requests waiting for their response
+    uint8_t in_flight_max;                              //! Requests kept in flight
+    uint8_t write_credits;                              //! Frames the worker takes before the next status poll (polled transports)
+    bool b_response_pending;                            //! Worker signalled a response that wasn't read yet
+    comm_response_t response;                           //! Response read by the transport
+    size_t response_size;                               //! Response size, 0 if nothing was read
+} sha256_master_worker_t;
+
+typedef struct sha256_master_transport sha256_master_transport_t;
+
+/**
+ * @brief Bus state, workers of a bus are served by one thread.
+ * 
+ */
+typedef struct {
+    const sha256_master_transport_t *p_transport;
+    sha256_master_worker_t *p_workers[SHA256_MASTER_WORKERS_MAX];
+    uint8_t worker_count;
+    int fd;                                             //! Device shared by the workers, -1 if every worker has its own
+    int wake_fd;                                        //! Event written on submission and deinitialization
+    pthread_t thread;
+    bool b_thread_started;
+    atomic_bool b_stop;
+    uint64_t next_poll_us;                              //! Next status poll of polled transports
+    spsc_ring_t completion_ring;                        //! Completions, consumed by sha256_master_completion_get
+    sha256_master_completion_t completion_storage[SHA256_MASTER_COMPLETION_QUEUE_LENGTH];
+    _Atomic uint64_t requests_written;
+    _Atomic uint64_t responses_read;
+    _Atomic uint64_t read_batches;
+    _Atomic uint64_t status_polls;
+    _Atomic uint64_t bus_errors;
+    _Atomic uint64_t proofs_late;
+} sha256_master_bus_t;
+
+/**
+ * @brief Transport operations. Every operation is called from the bus thread only, apart from open and close.
+ * 
+ */
+struct sha256_master_transport {
+    bool (*p_open)(sha256_master_bus_t *p_bus);                                                 //! Opens the devices of the bus and its workers
+    void (*p_close)(sha256_master_bus_t *p_bus);                                                //! Stops transport state, NULL if none, the core closes the devices
+    bool (*p_write)(sha256_master_bus_t *p_bus, sha256_master_worker_t *p_worker, const uint8_t *p_frame, size_t size, bool b_stream);  //! Writes a frame
+    bool (*p_pending_poll)(sha256_master_bus_t *p_bus);                                         //! Sets pending responses and write credits, NULL for interrupt driven transports
+    int (*p_read)(sha256_master_bus_t *p_bus, sha256_master_worker_t **pp_workers, int worker_count);  //! Reads a response of every worker given, returns the bus operations used or -1
+};
+
+/* ============================== PUBLIC VARIABLES */
+
+/** @brief SPI slave transport, see sha256_master_spidev.c. */
+extern const sha256_master_transport_t sha256_master_transport_spidev;
+
+/** @brief I2C slave transport, see sha256_master_i2cdev.c. */
+extern const sha256_master_transport_t sha256_master_transport_i2cdev;
+
+/** @brief I2C register map slave transport, see sha256_master_i2cdev.c. */
+extern const sha256_master_transport_t sha256_master_transport_i2c_regmap;
+
+/** @brief In-process stand-in worker transport, see sha256_master_loopback.c. */
+extern const sha256_master_transport_t sha256_master_transport_loopback;
+
+/* ============================== PUBLIC FUNCTION DECLARATIONS */
+
+/**
+ * @brief Monotonic time in microseconds.
+ * 
+ * @return uint64_t Time in microseconds.
+ */
+uint64_t sha256_master_time_us(void);
+
+/**
+ * @brief Opens the interrupt out line of a worker as a rising edge event file descriptor.
+ * 
+ * @param p_worker Pointer to the worker, the GPIO chip and line are taken from its configuration.
+ * 
+ * @return bool Returns true if opened or no GPIO chip is configured, false on error.
+ */
+bool sha256_master_interrupt_open(sha256_master_worker_t *p_worker);
+
+#endif
@@ -0,0 +1,291 @@
+/**
+ * @file spsc_ring_test.c
+ * @author Iwan Ćulumović
+ * @brief Ring buffer test. Checks the full and empty boundaries and the free running index wrap of the firmware ring
+ * buffer on one thread, then streams numbered items from a producer thread to a consumer thread and checks that every
+ * item arrives once, in order and not torn. The threads yield while waiting so the test also runs on one CPU.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/* ============================== INCLUDES */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "spsc_ring.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Default number of items streamed between the threads, RING_ITEMS. */
+#define RING_ITEMS_DEFAULT                      (2000000)
+
+/** @brief Default ring buffer capacity of the stream, RING_CAPACITY, small so both boundaries are hit often. */
+#define RING_CAPACITY_DEFAULT                   (16)
+
+/** @brief Capacity of the single thread boundary checks. */
+#define RING_BOUNDARY_CAPACITY                  (8)
+
+/** @brief Number of words in an item, more than one so torn copies are caught. */
+#define RING_ITEM_WORDS                         (6)
+
+/* ============================== TYPE DEFINITIONS */
+
+/**
+ * @brief Streamed item. Every word is derived from the sequence number.
+ * 
+ */
+typedef struct {
+    uint64_t sequence;                                  //! Item number, counts up from 0
+    uint32_t words[RING_ITEM_WORDS];                    //! Words derived from the sequence number
+} ring_test_item_t;
+
+/**
+ * @brief Stream state shared by the producer and the consumer thread.
+ * 
+ */
+typedef struct {
+    spsc_ring_t ring;                                   //! Ring buffer under test
+    uint64_t item_count;                                //! Number of items to stream
+    uint64_t full_count;                                //! Pushes refused because the ring was full, producer only
+    uint64_t over_capacity_count;                       //! Counts above the capacity seen by the producer
+    uint64_t empty_count;                               //! Pops refused because the ring was empty, consumer only
+    uint64_t received_count;                            //! Items popped, consumer only
+    uint64_t error_count;                               //! Items out of order, duplicated or torn, consumer only
+} ring_test_stream_t;
+
+/* ============================== PRIVATE FUNCTION DECLARATIONS */
+
+/**
+ * @brief Reads an integer parameter from the environment.
+ * 
+ * @param p_name Environment variable name.
+ * @param default_value Value if the variable isn't set.
+ * 
+ * @return long long Parameter value.
+ */
+static long long _test_param_get(const char *p_name, long long default_value);
+
+/**
+ * @brief Fills an item for a sequence number.
+ * 
+ * @param sequence Item number.
+ * @param p_item Pointer to the item.
+ */
+static void _test_item_fill(uint64_t sequence, ring_test_item_t *p_item);
+
+/**
+ * @brief Checks the full and empty boundaries and the index wrap on one thread.
+ * 
+ * @return size_t Number of failed checks.
+ */
+static size_t _test_boundaries(void);
+
+/**
+ * @brief Producer thread, pushes the numbered items and retries while the ring is full.
+ * 
+ * @param p_arg Pointer to the stream state.
+ * 
+ * @return void* NULL.
+ */
+static void *_test_producer(void *p_arg);
+
+/**
+ * @brief Consumer thread, pops the items while checking them and retries while the ring is empty.
+ * 
+ * @param p_arg Pointer to the stream state.
+ * 
+ * @return void* NULL.
+ */
+static void *_test_consumer(void *p_arg);
+
+/* ============================== PRIVATE VARIABLES */
+
+/* ============================== PUBLIC VARIABLES */
+
+/* ============================== PUBLIC FUNCTION DEFINITIONS */
+
+int main(void)
+{
+    long long capacity = _test_param_get("RING_CAPACITY", RING_CAPACITY_DEFAULT);
+    ring_test_stream_t stream = {0};
+    ring_test_item_t *p_storage = NULL;
+    pthread_t producer = {0};
+    pthread_t consumer = {0};
+    size_t failures = 0;
+
+    failures += _test_boundaries();
+
+    stream.item_count = (uint64_t)_test_param_get("RING_ITEMS", RING_ITEMS_DEFAULT);
+    p_storage = calloc((size_t)capacity, sizeof(*p_storage));
+    if ((NULL == p_storage) || (false == spsc_ring_init(&stream.ring, p_storage, (uint32_t)capacity, sizeof(*p_storage))))
+    {
+        fprintf(stderr, "Failed to create a ring of %lld items, the capacity must be a power of two. Aborting!\n", capacity);
+        abort();
+    }
+
+    if ((0 != pthread_create(&consumer, NULL, _test_consumer, &stream)) || (0 != pthread_create(&producer, NULL, _test_producer, &stream)))
+    {
+        fprintf(stderr, "Failed to start the test threads. Aborting!\n");
+        abort();
+    }
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+
+    printf("Stream: %llu of %llu items received through %lld slots, %llu full and %llu empty retries\n",
+           (unsigned long long)stream.received_count, (unsigned long long)stream.item_count, capacity,
+           (unsigned long long)stream.full_count, (unsigned long long)stream.empty_count);
+
+    if (stream.received_count != stream.item_count) failures++;
+    if (0 != stream.error_count) failures += stream.error_count;
+    if (0 != stream.over_capacity_count) failures += stream.over_capacity_count;
+    if (false == spsc_ring_is_empty(&stream.ring)) failures++;
+
+    free(p_storage);
+
+    printf("Failures: %zu\n", failures);
+
+    return (0 == failures) ? 0 : 1;
+}
+
+/* ============================== PRIVATE FUNCTION DEFINITIONS */
+
+static long long _test_param_get(const char *p_name, long long default_value)
+{
+    const char *p_value = getenv(p_name);
+
+    return (NULL != p_value) ? strtoll(p_value, NULL, 0) : default_value;
+}
+
+static void _test_item_fill(uint64_t sequence, ring_test_item_t *p_item)
+{
+    uint32_t i = 0;
+
+    p_item->sequence = sequence;
+    for (i = 0; i < RING_ITEM_WORDS; i++)
+    {
+        p_item->words[i] = (uint32_t)(sequence * 2654435761u) ^ (i * 0x9E3779B9u);
+    }
+}
+
+static size_t _test_boundaries(void)
+{
+    ring_test_item_t storage[RING_BOUNDARY_CAPACITY] = {0};
+    ring_test_item_t item = {0};
+    ring_test_item_t expected = {0};
+    spsc_ring_t ring = {0};
+    size_t failures = 0;
+    uint64_t pushed = 0;
+    uint64_t popped = 0;
+    uint32_t round = 0;
+    uint32_t i = 0;
+
+    if (true == spsc_ring_init(&ring, storage, 0, sizeof(item))) failures++;
+    if (true == spsc_ring_init(&ring, storage, RING_BOUNDARY_CAPACITY - 2, sizeof(item))) failures++;
+    if (false == spsc_ring_init(&ring, storage, RING_BOUNDARY_CAPACITY, sizeof(item))) failures++;
+
+    /* Start just below the index wrap so the free running indexes overflow while the ring is used */
+    atomic_store(&ring.head, UINT32_MAX - (2 * RING_BOUNDARY_CAPACITY));
+    atomic_store(&ring.tail, UINT32_MAX - (2 * RING_BOUNDARY_CAPACITY));
+    ring.head_cache = UINT32_MAX - (2 * RING_BOUNDARY_CAPACITY);
+    ring.tail_cache = UINT32_MAX - (2 * RING_BOUNDARY_CAPACITY);
+
+    for (round = 0; round < 6; round++)
+    {
+        if ((false == spsc_ring_is_empty(&ring)) || (0 != spsc_ring_count(&ring))) failures++;
+        if (true == spsc_ring_pop(&ring, &item)) failures++;
+
+        /* Fill to the last slot, the next push must be refused and leave the items alone */
+        for (i = 0; i < RING_BOUNDARY_CAPACITY; i++)
+        {
+            _test_item_fill(pushed, &item);
+            if (false == spsc_ring_push(&ring, &item)) failures++;
+            else pushed++;
+        }
+        _test_item_fill(UINT64_MAX, &item);
+        if (true == spsc_ring_push(&ring, &item)) failures++;
+        if ((true == spsc_ring_is_empty(&ring)) || (RING_BOUNDARY_CAPACITY != spsc_ring_count(&ring))) failures++;
+
+        /* One pop frees exactly one slot */
+        if (false == spsc_ring_pop(&ring, &item)) failures++;
+        _test_item_fill(popped++, &expected);
+        if (0 != memcmp(&item, &expected, sizeof(item))) failures++;
+        _test_item_fill(pushed, &item);
+        if (false == spsc_ring_push(&ring, &item)) failures++;
+        else pushed++;
+        if (true == spsc_ring_push(&ring, &item)) failures++;
+
+        /* Drain in order, the pop after the last item must be refused */
+        for (i = 0; i < RING_BOUNDARY_CAPACITY; i++)
+        {
+            if (false == spsc_ring_pop(&ring, &item)) failures++;
+            _test_item_fill(popped++, &expected);
+            if (0 != memcmp(&item, &expected, sizeof(item))) failures++;
+        }
+        if (true == spsc_ring_pop(&ring, &item)) failures++;
+    }
+
+    /* The head must have wrapped past zero */
+    if (UINT32_MAX - (2 * RING_BOUNDARY_CAPACITY) <= atomic_load(&ring.head)) failures++;
+
+    printf("Boundaries: %llu items through %u slots across the index wrap, %zu failed checks\n",
+           (unsigned long long)popped, RING_BOUNDARY_CAPACITY, failures);
+
+    return failures;
+}
+
+static void *_test_producer(void *p_arg)
+{
+    ring_test_stream_t *p_stream = (ring_test_stream_t *)p_arg;
+    ring_test_item_t item = {0};
+    uint64_t sequence = 0;
+
+    for (sequence = 0; sequence < p_stream->item_count; sequence++)
+    {
+        _test_item_fill(sequence, &item);
+        while (false == spsc_ring_push(&p_stream->ring, &item))
+        {
+            p_stream->full_count++;
+            if ((p_stream->ring.mask + 1) < spsc_ring_count(&p_stream->ring)) p_stream->over_capacity_count++;
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+static void *_test_consumer(void *p_arg)
+{
+    ring_test_stream_t *p_stream = (ring_test_stream_t *)p_arg;
+    ring_test_item_t item = {0};
+    ring_test_item_t expected = {0};
+
+    while (p_stream->received_count < p_stream->item_count)
+    {
+        if (false == spsc_ring_pop(&p_stream->ring, &item))
+        {
+            p_stream->empty_count++;
+            sched_yield();
+            continue;
+        }
+
+        /* A lost or duplicated item breaks the sequence, a torn copy breaks the words */
+        _test_item_fill(p_stream->received_count, &expected);
+        if (0 != memcmp(&item, &expected, sizeof(item)))
+        {
+            if (0 == p_stream->error_count)
+            {
+                fprintf(stderr, "Item %llu arrived as %llu\n", (unsigned long long)p_stream->received_count, (unsigned long long)item.sequence);
+            }
+            p_stream->error_count++;
+        }
+        p_stream->received_count++;
+    }
+
+    return NULL;
+}
+
+/* ============================== INTERRUPT FUNCTION DEFINITIONS */
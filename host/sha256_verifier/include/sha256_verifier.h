@@ -0,0 +1,128 @@
+/**
+ * @file sha256_verifier.h
+ * @author Iwan Ćulumović
+ * @brief See sha256_verifier.c file.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef __SHA256_VERIFIER_H__
+#define __SHA256_VERIFIER_H__
+
+/* ============================== INCLUDES */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "sha256_kernel.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Digest size in bytes. */
+#define SHA256_VERIFIER_DIGEST_SIZE             (32)
+
+/** @brief Job type, SHA256 of the nonce. Same value as SHA256_JOB_TYPE_SHA256 of the worker. */
+#define SHA256_VERIFIER_JOB_TYPE_SHA256         (0x00)
+
+/** @brief Job type, SHA256d of a prefix followed by the nonce. Same value as SHA256_JOB_TYPE_SHA256D of the worker. */
+#define SHA256_VERIFIER_JOB_TYPE_SHA256D        (0x01)
+
+/** @brief Job type, HMAC-SHA256 of the nonce with a per job key. Same value as SHA256_JOB_TYPE_HMAC of the worker. */
+#define SHA256_VERIFIER_JOB_TYPE_HMAC           (0x02)
+
+/** @brief SHA256d prefix maximum size in bytes. */
+#define SHA256_VERIFIER_PREFIX_MAX_SIZE         (128)
+
+/** @brief HMAC key maximum size in bytes. */
+#define SHA256_VERIFIER_KEY_MAX_SIZE            (64)
+
+/** @brief Match flag, masked bits of the digest must match the target solution. */
+#define SHA256_VERIFIER_MATCH_FLAG_TARGET       (0x01)
+
+/** @brief Match flag, the digest must be less than or equal to the threshold. */
+#define SHA256_VERIFIER_MATCH_FLAG_THRESHOLD    (0x02)
+
+/** @brief Match flag, the digest and the threshold are compared as little endian numbers. */
+#define SHA256_VERIFIER_MATCH_FLAG_THRESHOLD_LE (0x04)
+
+/* ============================== TYPE DEFINITIONS */
+
+/**
+ * @brief Job as the master sent it to the worker.
+ * 
+ */
+typedef struct {
+    uint8_t job_type;                                           //! SHA256_VERIFIER_JOB_TYPE_*
+    uint8_t nonce_size;                                         //! Nonce size of the worker in bytes, 4 or 8
+    uint8_t target_solution_mask_offset;                        //! Number of compared target bits minus one
+    uint8_t target_solution[SHA256_VERIFIER_DIGEST_SIZE];
+    uint8_t threshold[SHA256_VERIFIER_DIGEST_SIZE];             //! SHA256d only, byte order selected by the match flags
+    uint8_t match_flags;                                        //! SHA256d only, SHA256_VERIFIER_MATCH_FLAG_* flags
+    uint8_t prefix_size;                                        //! SHA256d only, prefix size in bytes
+    uint8_t prefix[SHA256_VERIFIER_PREFIX_MAX_SIZE];            //! SHA256d only
+    uint8_t key_size;                                           //! HMAC only, key size in bytes
+    uint8_t key[SHA256_VERIFIER_KEY_MAX_SIZE];                  //! HMAC only
+} sha256_verifier_job_t;
+
+/**
+ * @brief Job prepared for verification, shared by every offset of the job.
+ * 
+ */
+typedef struct {
+    uint32_t midstate[SHA256_KERNEL_STATE_WORDS];               //! Chaining state the last block is compressed into
+    uint32_t block[SHA256_KERNEL_BLOCK_WORDS];                  //! Last block with the nonce words cleared
+    uint32_t outer_midstate[SHA256_KERNEL_STATE_WORDS];         //! HMAC only, chaining state after the outer key pad block
+    uint32_t target_words[SHA256_KERNEL_STATE_WORDS];           //! Masked target solution as big endian words
+    uint32_t mask_words[SHA256_KERNEL_STATE_WORDS];             //! Bits of each word that are compared
+    uint32_t threshold_words[SHA256_KERNEL_STATE_WORDS];        //! Threshold as words, most significant word first
+    uint8_t compare_words;                                      //! Number of words that have compared bits
+    uint8_t job_type;                                           //! SHA256_VERIFIER_JOB_TYPE_*
+    uint8_t nonce_size;                                         //! Nonce size in bytes
+    uint8_t nonce_word;                                         //! Index of the low nonce word in the last block
+    uint8_t match_flags;                                        //! SHA256_VERIFIER_MATCH_FLAG_* flags
+} sha256_verifier_prepared_job_t;
+
+/**
+ * @brief Reported solution to verify.
+ * 
+ */
+typedef struct {
+    const sha256_verifier_prepared_job_t *p_job;                //! Prepared job the solution was reported for
+    uint64_t offset_solution;                                   //! Reported offset solution
+} sha256_verifier_item_t;
+
+/* ============================== PUBLIC FUNCTION DECLARATIONS */
+
+/**
+ * @brief Prepares a job for verification. Prefix blocks are compressed once here instead of once per offset.
+ * 
+ * @param p_prepared_job Pointer to the prepared job which will be filled.
+ * @param p_job Pointer to the job.
+ * 
+ * @return bool Returns true if the job is valid, else false (the worker rejects such a job too).
+ */
+bool sha256_verifier_job_prepare(sha256_verifier_prepared_job_t *p_prepared_job, const sha256_verifier_job_t *p_job);
+
+/**
+ * @brief Verifies a single reported solution.
+ * 
+ * @param p_item Pointer to the item.
+ * 
+ * @return bool Returns true if the offset solves the job, else false.
+ */
+bool sha256_verifier_verify_one(const sha256_verifier_item_t *p_item);
+
+/**
+ * @brief Verifies a batch of reported solutions. Items are hashed SHA256_KERNEL_LANES at a time, the batch is split
+ * between threads. Items of different jobs and job types may be mixed.
+ * 
+ * @param p_items Pointer to the items.
+ * @param item_count Number of items.
+ * @param p_b_valid Pointer to where the result of every item will be written, true if the offset solves the job.
+ * @param thread_count Number of threads, 0 uses every online CPU.
+ * 
+ * @return size_t Number of valid items.
+ */
+size_t sha256_verifier_verify(const sha256_verifier_item_t *p_items, size_t item_count, bool *p_b_valid, int thread_count);
+
+#endif
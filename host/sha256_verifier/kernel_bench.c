@@ -0,0 +1,269 @@
+/**
+ * @file kernel_bench.c
+ * @author Iwan Ćulumović
+ * @brief Search kernel benchmark. Hashes consecutive nonces with the precomputed schedule kernel of the worker and with
+ * the plain block kernel it replaced, checks that both produce the same digests, also against OpenSSL if it was found,
+ * and reports both hash rates.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/* ============================== INCLUDES */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef VERIFIER_BENCH_OPENSSL
+#include <openssl/sha.h>
+#endif
+#include "sha256_kernel.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Default number of hashed nonces per kernel, KERNEL_HASHES. */
+#define KERNEL_HASHES_DEFAULT                   (4000000)
+
+/** @brief Default number of nonces checked digest by digest, KERNEL_CHECKS. */
+#define KERNEL_CHECKS_DEFAULT                   (65536)
+
+/** @brief Default nonce size in bytes, KERNEL_NONCE_SIZE, 4 or 8 like the worker. */
+#define KERNEL_NONCE_SIZE_DEFAULT               (4)
+
+/** @brief Default first nonce, KERNEL_START. */
+#define KERNEL_START_DEFAULT                    (0x12345678)
+
+/** @brief Digest size in bytes. */
+#define KERNEL_DIGEST_SIZE                      (32)
+
+/* ============================== TYPE DEFINITIONS */
+
+/* ============================== PRIVATE FUNCTION DECLARATIONS */
+
+/**
+ * @brief Reads an integer parameter from the environment.
+ * 
+ * @param p_name Environment variable name.
+ * @param default_value Value if the variable isn't set.
+ * 
+ * @return long long Parameter value.
+ */
+static long long _bench_param_get(const char *p_name, long long default_value);
+
+/**
+ * @brief Monotonic time in seconds.
+ * 
+ * @return double Time in seconds.
+ */
+static double _bench_time_get(void);
+
+/**
+ * @brief Prepares the padded block of a nonce search the way the worker does, the first word is set per nonce.
+ * 
+ * @param p_block Pointer to where the block words will be written.
+ * @param nonce_size Nonce size in bytes, 4 or 8.
+ * @param start First nonce, its high word is the second message word of an 8 byte nonce.
+ */
+static void _bench_block_prepare(uint32_t *p_block, uint32_t nonce_size, uint64_t start);
+
+/**
+ * @brief Hashes nonces with the plain block kernel, which runs the whole schedule and all rounds per nonce.
+ * 
+ * @param p_block Pointer to the prepared block.
+ * @param start First nonce.
+ * @param hashes Number of nonces.
+ * @param p_fold Pointer to where the XOR of all digests will be written.
+ */
+static void _bench_block_kernel(const uint32_t *p_block, uint64_t start, long long hashes, uint32_t *p_fold);
+
+/**
+ * @brief Hashes nonces with the precomputed schedule kernel, which only redoes the first message word dependent part.
+ * 
+ * @param p_block Pointer to the prepared block.
+ * @param start First nonce.
+ * @param hashes Number of nonces.
+ * @param p_fold Pointer to where the XOR of all digests will be written.
+ */
+static void _bench_w0_kernel(const uint32_t *p_block, uint64_t start, long long hashes, uint32_t *p_fold);
+
+/**
+ * @brief Checks both kernels digest by digest, and against OpenSSL if it was found at configure time.
+ * 
+ * @param p_block Pointer to the prepared block.
+ * @param nonce_size Nonce size in bytes.
+ * @param start First nonce.
+ * @param checks Number of nonces.
+ * 
+ * @return size_t Number of mismatching digests.
+ */
+static size_t _bench_check(const uint32_t *p_block, uint32_t nonce_size, uint64_t start, long long checks);
+
+/* ============================== PRIVATE VARIABLES */
+
+/* ============================== PUBLIC VARIABLES */
+
+/* ============================== PUBLIC FUNCTION DEFINITIONS */
+
+int main(void)
+{
+    long long hash_count = _bench_param_get("KERNEL_HASHES", KERNEL_HASHES_DEFAULT);
+    long long check_count = _bench_param_get("KERNEL_CHECKS", KERNEL_CHECKS_DEFAULT);
+    uint32_t nonce_size = (uint32_t)_bench_param_get("KERNEL_NONCE_SIZE", KERNEL_NONCE_SIZE_DEFAULT);
+    uint64_t start = (uint64_t)_bench_param_get("KERNEL_START", KERNEL_START_DEFAULT);
+    uint32_t block[SHA256_KERNEL_BLOCK_WORDS] = {0};
+    uint32_t block_fold[SHA256_KERNEL_STATE_WORDS] = {0};
+    uint32_t w0_fold[SHA256_KERNEL_STATE_WORDS] = {0};
+    size_t mismatches = 0;
+    double block_s = 0;
+    double w0_s = 0;
+    double time_start = 0;
+
+    if ((4 != nonce_size) && (8 != nonce_size)) nonce_size = KERNEL_NONCE_SIZE_DEFAULT;
+    if (hash_count < 1) hash_count = 1;
+    if (check_count < 0) check_count = 0;
+
+    /* Both kernels stay within the low nonce word like the worker batches do */
+    if (4 == nonce_size) start = (uint32_t)start;
+    if (hash_count > ((long long)UINT32_MAX + 1 - (uint32_t)start)) hash_count = (long long)UINT32_MAX + 1 - (uint32_t)start;
+    if (check_count > hash_count) check_count = hash_count;
+
+    _bench_block_prepare(block, nonce_size, start);
+
+    mismatches += _bench_check(block, nonce_size, start, check_count);
+
+    time_start = _bench_time_get();
+    _bench_block_kernel(block, start, hash_count, block_fold);
+    block_s = _bench_time_get() - time_start;
+
+    time_start = _bench_time_get();
+    _bench_w0_kernel(block, start, hash_count, w0_fold);
+    w0_s = _bench_time_get() - time_start;
+
+    /* Timed runs only keep a fold of the digests, a single differing digest changes it */
+    if (0 != memcmp(block_fold, w0_fold, sizeof(block_fold))) mismatches++;
+
+#ifdef VERIFIER_BENCH_OPENSSL
+    printf("Nonces: %lld of %lu bytes from 0x%llX, %lld checked digest by digest and against OpenSSL\n",
+        hash_count, (unsigned long)nonce_size, (unsigned long long)start, check_count);
+#else
+    printf("Nonces: %lld of %lu bytes from 0x%llX, %lld checked digest by digest\n",
+        hash_count, (unsigned long)nonce_size, (unsigned long long)start, check_count);
+#endif
+    printf("Plain block kernel:          %10.0f hashes/s\n", hash_count / block_s);
+    printf("Precomputed schedule kernel: %10.0f hashes/s, %.2fx\n", hash_count / w0_s, block_s / w0_s);
+    printf("Mismatches: %zu\n", mismatches);
+
+    return (0 == mismatches) ? 0 : 1;
+}
+
+/* ============================== PRIVATE FUNCTION DEFINITIONS */
+
+static long long _bench_param_get(const char *p_name, long long default_value)
+{
+    const char *p_value = getenv(p_name);
+
+    return (NULL != p_value) ? strtoll(p_value, NULL, 0) : default_value;
+}
+
+static double _bench_time_get(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + (now.tv_nsec / 1e9);
+}
+
+static void _bench_block_prepare(uint32_t *p_block, uint32_t nonce_size, uint64_t start)
+{
+    memset(p_block, 0, SHA256_KERNEL_BLOCK_WORDS * sizeof(uint32_t));
+
+    /* Little endian nonce bytes, then the padding bit and the message length in bits */
+    if (8 == nonce_size) p_block[1] = __builtin_bswap32((uint32_t)(start >> 32));
+    p_block[nonce_size / sizeof(uint32_t)] = 0x80000000;
+    p_block[SHA256_KERNEL_BLOCK_WORDS - 1] = nonce_size * 8;
+}
+
+static void _bench_block_kernel(const uint32_t *p_block, uint64_t start, long long hashes, uint32_t *p_fold)
+{
+    uint32_t block[SHA256_KERNEL_BLOCK_WORDS] = {0};
+    uint32_t digest[SHA256_KERNEL_STATE_WORDS] = {0};
+    uint32_t nonce = (uint32_t)start;
+    long long h = 0;
+    int i = 0;
+
+    memcpy(block, p_block, sizeof(block));
+    memset(p_fold, 0, SHA256_KERNEL_STATE_WORDS * sizeof(uint32_t));
+
+    for (h = 0; h < hashes; h++)
+    {
+        block[0] = __builtin_bswap32(nonce++);
+        sha256_kernel_block_hash(block, digest);
+        for (i = 0; i < SHA256_KERNEL_STATE_WORDS; i++) p_fold[i] ^= digest[i];
+    }
+}
+
+static void _bench_w0_kernel(const uint32_t *p_block, uint64_t start, long long hashes, uint32_t *p_fold)
+{
+    sha256_kernel_w0_ctx_t kernel_ctx = {0};
+    uint32_t digest[SHA256_KERNEL_STATE_WORDS] = {0};
+    uint32_t nonce = (uint32_t)start;
+    long long h = 0;
+    int i = 0;
+
+    memset(p_fold, 0, SHA256_KERNEL_STATE_WORDS * sizeof(uint32_t));
+
+    /* Prepared once per job on the worker, so it is part of the measured time here too */
+    sha256_kernel_w0_prepare(&kernel_ctx, sha256_kernel_initial_state, p_block);
+
+    for (h = 0; h < hashes; h++)
+    {
+        sha256_kernel_w0_hash(&kernel_ctx, __builtin_bswap32(nonce++), digest);
+        for (i = 0; i < SHA256_KERNEL_STATE_WORDS; i++) p_fold[i] ^= digest[i];
+    }
+}
+
+static size_t _bench_check(const uint32_t *p_block, uint32_t nonce_size, uint64_t start, long long checks)
+{
+    sha256_kernel_w0_ctx_t kernel_ctx = {0};
+    uint32_t block[SHA256_KERNEL_BLOCK_WORDS] = {0};
+    uint32_t block_digest[SHA256_KERNEL_STATE_WORDS] = {0};
+    uint32_t w0_digest[SHA256_KERNEL_STATE_WORDS] = {0};
+#ifdef VERIFIER_BENCH_OPENSSL
+    uint8_t message[8] = {0};
+    uint8_t reference[KERNEL_DIGEST_SIZE] = {0};
+    uint8_t digest[KERNEL_DIGEST_SIZE] = {0};
+    uint64_t nonce = 0;
+#endif
+    size_t mismatches = 0;
+    long long c = 0;
+    int i = 0;
+
+    memcpy(block, p_block, sizeof(block));
+    sha256_kernel_w0_prepare(&kernel_ctx, sha256_kernel_initial_state, p_block);
+
+    for (c = 0; c < checks; c++)
+    {
+        block[0] = __builtin_bswap32((uint32_t)start + (uint32_t)c);
+        sha256_kernel_block_hash(block, block_digest);
+        sha256_kernel_w0_hash(&kernel_ctx, block[0], w0_digest);
+        if (0 != memcmp(block_digest, w0_digest, sizeof(block_digest))) mismatches++;
+
+#ifdef VERIFIER_BENCH_OPENSSL
+        /* The nonce is hashed as its little endian bytes, the carry never leaves the low word */
+        nonce = start + (uint64_t)c;
+        for (i = 0; i < (int)nonce_size; i++) message[i] = (uint8_t)(nonce >> (8 * i));
+        SHA256(message, nonce_size, reference);
+        for (i = 0; i < KERNEL_DIGEST_SIZE; i++) digest[i] = (uint8_t)(w0_digest[i / 4] >> (24 - (8 * (i % 4))));
+        if (0 != memcmp(digest, reference, KERNEL_DIGEST_SIZE)) mismatches++;
+#else
+        (void)nonce_size;
+        (void)i;
+#endif
+    }
+
+    return mismatches;
+}
+
+/* ============================== INTERRUPT FUNCTION DEFINITIONS */
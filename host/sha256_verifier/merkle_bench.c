@@ -0,0 +1,331 @@
+/**
+ * @file merkle_bench.c
+ * @author Iwan Ćulumović
+ * @brief Merkle reduction benchmark. Reduces random trees with the firmware Merkle module, checks the roots and proof
+ * paths against a reference built from whole message hashes and reports the node hash rate.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/* ============================== INCLUDES */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef VERIFIER_BENCH_OPENSSL
+#include <openssl/sha.h>
+#endif
+#include "sha256_merkle.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Default number of leaves of a tree, MERKLE_LEAVES. */
+#define MERKLE_LEAVES_DEFAULT                   (256)
+
+/** @brief Default number of reduced trees, MERKLE_TREES. */
+#define MERKLE_TREES_DEFAULT                    (4096)
+
+/** @brief Default Merkle flags, MERKLE_FLAGS. */
+#define MERKLE_FLAGS_DEFAULT                    (0)
+
+/** @brief Default number of node hashes per reduce call, MERKLE_BATCH, the batch size of the worker. */
+#define MERKLE_BATCH_DEFAULT                    (64)
+
+/** @brief Default random seed, MERKLE_SEED. */
+#define MERKLE_SEED_DEFAULT                     (1)
+
+/** @brief Number of proofs checked per tree. */
+#define MERKLE_PROOFS                           (4)
+
+/** @brief Largest tree depth, enough for any leaf count that fits memory. */
+#define MERKLE_DEPTH_MAX                        (32)
+
+/** @brief Digest size in bytes. */
+#define MERKLE_DIGEST_SIZE                      (32)
+
+/* ============================== TYPE DEFINITIONS */
+
+/* ============================== PRIVATE FUNCTION DECLARATIONS */
+
+/**
+ * @brief Reads an integer parameter from the environment.
+ * 
+ * @param p_name Environment variable name.
+ * @param default_value Value if the variable isn't set.
+ * 
+ * @return long long Parameter value.
+ */
+static long long _bench_param_get(const char *p_name, long long default_value);
+
+/**
+ * @brief Monotonic time in seconds.
+ * 
+ * @return double Time in seconds.
+ */
+static double _bench_time_get(void);
+
+/**
+ * @brief Hashes a message the naive way. Uses OpenSSL if it was found at configure time, else the firmware kernel,
+ * which only covers the 32 and 64 byte messages of a tree.
+ * 
+ * @param p_message Pointer to the message.
+ * @param message_size Message size, 32 or 64 bytes.
+ * @param p_digest Pointer to where the digest will be written.
+ */
+static void _bench_naive_hash(const uint8_t *p_message, size_t message_size, uint8_t *p_digest);
+
+/**
+ * @brief Builds the root and the proof paths of a tree the naive way, level by level into a separate buffer.
+ * 
+ * @param p_leaves Pointer to the leaves, 32 bytes each.
+ * @param leaf_count Number of leaves.
+ * @param flags SHA256_MERKLE_FLAG_* flags.
+ * @param p_proof_leaves Pointer to the leaf indices that get a proof path.
+ * @param p_proof_siblings Pointer to where the siblings of every proof will be written, MERKLE_DEPTH_MAX per proof.
+ * @param p_root Pointer to where the root will be written.
+ */
+static void _bench_naive_tree(const uint8_t *p_leaves, uint32_t leaf_count, uint8_t flags, const uint32_t *p_proof_leaves, uint8_t *p_proof_siblings, uint8_t *p_root);
+
+/**
+ * @brief Converts big endian digest words to digest bytes.
+ * 
+ * @param p_words Pointer to the digest words.
+ * @param p_bytes Pointer to where the digest bytes will be written.
+ */
+static void _bench_words_store(const uint32_t *p_words, uint8_t *p_bytes);
+
+/* ============================== PRIVATE VARIABLES */
+
+/* ============================== PUBLIC VARIABLES */
+
+/* ============================== PUBLIC FUNCTION DEFINITIONS */
+
+int main(void)
+{
+    uint32_t leaf_count = (uint32_t)_bench_param_get("MERKLE_LEAVES", MERKLE_LEAVES_DEFAULT);
+    long long tree_count = _bench_param_get("MERKLE_TREES", MERKLE_TREES_DEFAULT);
+    uint8_t flags = (uint8_t)(_bench_param_get("MERKLE_FLAGS", MERKLE_FLAGS_DEFAULT) & SHA256_MERKLE_FLAGS);
+    uint32_t batch = (uint32_t)_bench_param_get("MERKLE_BATCH", MERKLE_BATCH_DEFAULT);
+    uint32_t depth = 0;
+    uint32_t node_hashes = 0;
+    uint8_t *p_leaves = NULL;
+    sha256_merkle_node_t *p_nodes = NULL;
+    sha256_merkle_tree_t tree = {0};
+    sha256_merkle_proof_t proofs[MERKLE_PROOFS] = {0};
+    sha256_merkle_node_t proof_siblings[MERKLE_PROOFS][MERKLE_DEPTH_MAX] = {0};
+    uint32_t proof_leaves[MERKLE_PROOFS] = {0};
+    uint8_t naive_siblings[MERKLE_PROOFS * MERKLE_DEPTH_MAX * MERKLE_DIGEST_SIZE] = {0};
+    uint8_t naive_root[MERKLE_DIGEST_SIZE] = {0};
+    uint8_t root[MERKLE_DIGEST_SIZE] = {0};
+    uint8_t sibling[MERKLE_DIGEST_SIZE] = {0};
+    size_t mismatches = 0;
+    double naive_s = 0;
+    double reduce_s = 0;
+    double start = 0;
+    long long t = 0;
+    uint32_t i = 0;
+    uint32_t j = 0;
+    uint32_t k = 0;
+
+    srand((unsigned int)_bench_param_get("MERKLE_SEED", MERKLE_SEED_DEFAULT));
+
+    if (leaf_count < 1) leaf_count = 1;
+    if (tree_count < 1) tree_count = 1;
+    if (batch < 1) batch = 1;
+    depth = sha256_merkle_depth(leaf_count);
+    node_hashes = sha256_merkle_hashes(leaf_count, flags);
+
+    p_leaves = malloc((size_t)leaf_count * MERKLE_DIGEST_SIZE);
+    p_nodes = malloc((size_t)leaf_count * sizeof(*p_nodes));
+    if ((NULL == p_leaves) || (NULL == p_nodes))
+    {
+        fprintf(stderr, "Failed to allocate %lu leaves. Aborting!\n", (unsigned long)leaf_count);
+        abort();
+    }
+
+    for (i = 0; i < MERKLE_PROOFS; i++)
+    {
+        proofs[i].p_siblings = proof_siblings[i];
+    }
+
+    for (t = 0; t < tree_count; t++)
+    {
+        for (i = 0; i < (leaf_count * MERKLE_DIGEST_SIZE); i++) p_leaves[i] = (uint8_t)rand();
+        for (i = 0; i < MERKLE_PROOFS; i++) proof_leaves[i] = (0 == i) ? (leaf_count - 1) : ((uint32_t)rand() % leaf_count);
+
+        start = _bench_time_get();
+        _bench_naive_tree(p_leaves, leaf_count, flags, proof_leaves, naive_siblings, naive_root);
+        naive_s += _bench_time_get() - start;
+
+        /* Leaves are loaded as big endian words as the worker does when they arrive, outside the measured time */
+        for (i = 0; i < leaf_count; i++)
+        {
+            for (j = 0; j < SHA256_KERNEL_STATE_WORDS; j++)
+            {
+                k = (i * MERKLE_DIGEST_SIZE) + (j * 4);
+                p_nodes[i].words[j] = ((uint32_t)p_leaves[k] << 24) | ((uint32_t)p_leaves[k + 1] << 16) |
+                                      ((uint32_t)p_leaves[k + 2] << 8) | (uint32_t)p_leaves[k + 3];
+            }
+        }
+        for (i = 0; i < MERKLE_PROOFS; i++) proofs[i].leaf_index = proof_leaves[i];
+
+        start = _bench_time_get();
+        sha256_merkle_tree_init(&tree, p_nodes, leaf_count, flags, proofs, MERKLE_PROOFS);
+        while (false == sha256_merkle_tree_done(&tree))
+        {
+            sha256_merkle_tree_reduce(&tree, batch);
+        }
+        reduce_s += _bench_time_get() - start;
+
+        _bench_words_store(p_nodes[0].words, root);
+        if (0 != memcmp(root, naive_root, MERKLE_DIGEST_SIZE)) mismatches++;
+
+        for (i = 0; i < MERKLE_PROOFS; i++)
+        {
+            for (j = 0; j < depth; j++)
+            {
+                _bench_words_store(proof_siblings[i][j].words, sibling);
+                if (0 != memcmp(sibling, &naive_siblings[((i * MERKLE_DEPTH_MAX) + j) * MERKLE_DIGEST_SIZE], MERKLE_DIGEST_SIZE)) mismatches++;
+            }
+        }
+    }
+
+    printf("Trees: %lld of %lu leaves, depth %lu, flags 0x%02X, %lu node hashes per tree, batch %lu\n",
+        tree_count, (unsigned long)leaf_count, (unsigned long)depth, flags, (unsigned long)node_hashes, (unsigned long)batch);
+#ifdef VERIFIER_BENCH_OPENSSL
+    printf("Naive (OpenSSL, whole messages):   %10.0f node hashes/s\n", (tree_count * node_hashes) / naive_s);
+#else
+    printf("Naive (kernel, whole messages):    %10.0f node hashes/s\n", (tree_count * node_hashes) / naive_s);
+#endif
+    printf("In place reduction, pair kernel:   %10.0f node hashes/s, %.2fx\n", (tree_count * node_hashes) / reduce_s, naive_s / reduce_s);
+    printf("Mismatches: %zu\n", mismatches);
+
+    free(p_leaves);
+    free(p_nodes);
+
+    return (0 == mismatches) ? 0 : 1;
+}
+
+/* ============================== PRIVATE FUNCTION DEFINITIONS */
+
+static long long _bench_param_get(const char *p_name, long long default_value)
+{
+    const char *p_value = getenv(p_name);
+
+    return (NULL != p_value) ? strtoll(p_value, NULL, 0) : default_value;
+}
+
+static double _bench_time_get(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + (now.tv_nsec / 1e9);
+}
+
+static void _bench_naive_hash(const uint8_t *p_message, size_t message_size, uint8_t *p_digest)
+{
+#ifdef VERIFIER_BENCH_OPENSSL
+    SHA256(p_message, message_size, p_digest);
+#else
+    uint32_t block[SHA256_KERNEL_BLOCK_WORDS] = {0};
+    uint32_t state[SHA256_KERNEL_STATE_WORDS] = {0};
+    size_t i = 0;
+
+    /* Message and its padding fit two blocks, the length of a 64 byte message takes the second one */
+    memcpy(state, sha256_kernel_initial_state, sizeof(state));
+    for (i = 0; i < message_size; i++) block[i / 4] |= (uint32_t)p_message[i] << (24 - (8 * (i % 4)));
+    if (SHA256_KERNEL_BLOCK_SIZE == message_size)
+    {
+        sha256_kernel_compress(state, block);
+        memset(block, 0, sizeof(block));
+        block[0] = 0x80000000;
+    }
+    else
+    {
+        block[message_size / 4] |= 0x80000000 >> (8 * (message_size % 4));
+    }
+    block[SHA256_KERNEL_BLOCK_WORDS - 1] = (uint32_t)(message_size * 8);
+    sha256_kernel_compress(state, block);
+
+    _bench_words_store(state, p_digest);
+#endif
+}
+
+static void _bench_naive_tree(const uint8_t *p_leaves, uint32_t leaf_count, uint8_t flags, const uint32_t *p_proof_leaves, uint8_t *p_proof_siblings, uint8_t *p_root)
+{
+    uint8_t *p_level = malloc((size_t)leaf_count * MERKLE_DIGEST_SIZE);
+    uint8_t *p_parents = malloc((size_t)leaf_count * MERKLE_DIGEST_SIZE);
+    uint8_t *p_swap = NULL;
+    uint8_t pair[2 * MERKLE_DIGEST_SIZE] = {0};
+    uint32_t node_indices[MERKLE_PROOFS] = {0};
+    uint32_t node_count = leaf_count;
+    uint32_t level = 0;
+    uint32_t sibling = 0;
+    uint32_t right = 0;
+    uint32_t i = 0;
+
+    if ((NULL == p_level) || (NULL == p_parents))
+    {
+        fprintf(stderr, "Failed to allocate %lu leaves. Aborting!\n", (unsigned long)leaf_count);
+        abort();
+    }
+
+    memcpy(p_level, p_leaves, (size_t)leaf_count * MERKLE_DIGEST_SIZE);
+    memcpy(node_indices, p_proof_leaves, sizeof(node_indices));
+
+    if (0 != (SHA256_MERKLE_FLAG_HASH_LEAVES & flags))
+    {
+        for (i = 0; i < leaf_count; i++)
+        {
+            _bench_naive_hash(&p_level[i * MERKLE_DIGEST_SIZE], MERKLE_DIGEST_SIZE, &p_level[i * MERKLE_DIGEST_SIZE]);
+            if (0 != (SHA256_MERKLE_FLAG_SHA256D & flags)) _bench_naive_hash(&p_level[i * MERKLE_DIGEST_SIZE], MERKLE_DIGEST_SIZE, &p_level[i * MERKLE_DIGEST_SIZE]);
+        }
+    }
+
+    while (node_count > 1)
+    {
+        for (i = 0; i < MERKLE_PROOFS; i++)
+        {
+            sibling = node_indices[i] ^ 1;
+            if (sibling >= node_count) sibling = node_indices[i];
+            memcpy(&p_proof_siblings[((i * MERKLE_DEPTH_MAX) + level) * MERKLE_DIGEST_SIZE], &p_level[sibling * MERKLE_DIGEST_SIZE], MERKLE_DIGEST_SIZE);
+            node_indices[i] /= 2;
+        }
+
+        for (i = 0; i < ((node_count + 1) / 2); i++)
+        {
+            right = (((2 * i) + 1) < node_count) ? ((2 * i) + 1) : (2 * i);
+            memcpy(pair, &p_level[2 * i * MERKLE_DIGEST_SIZE], MERKLE_DIGEST_SIZE);
+            memcpy(&pair[MERKLE_DIGEST_SIZE], &p_level[right * MERKLE_DIGEST_SIZE], MERKLE_DIGEST_SIZE);
+            _bench_naive_hash(pair, sizeof(pair), &p_parents[i * MERKLE_DIGEST_SIZE]);
+            if (0 != (SHA256_MERKLE_FLAG_SHA256D & flags)) _bench_naive_hash(&p_parents[i * MERKLE_DIGEST_SIZE], MERKLE_DIGEST_SIZE, &p_parents[i * MERKLE_DIGEST_SIZE]);
+        }
+
+        p_swap = p_level;
+        p_level = p_parents;
+        p_parents = p_swap;
+        node_count = (node_count + 1) / 2;
+        level++;
+    }
+
+    memcpy(p_root, p_level, MERKLE_DIGEST_SIZE);
+
+    free(p_level);
+    free(p_parents);
+}
+
+static void _bench_words_store(const uint32_t *p_words, uint8_t *p_bytes)
+{
+    int i = 0;
+
+    for (i = 0; i < MERKLE_DIGEST_SIZE; i++)
+    {
+        p_bytes[i] = (uint8_t)(p_words[i / 4] >> (24 - (8 * (i % 4))));
+    }
+}
+
+/* ============================== INTERRUPT FUNCTION DEFINITIONS */
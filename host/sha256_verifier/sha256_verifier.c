@@ -0,0 +1,419 @@
+/**
+ * @file sha256_verifier.c
+ * @author Iwan Ćulumović
+ * @brief Host side verifier of reported offset solutions. Uses the worker SHA256 kernels, hashes
+ * SHA256_KERNEL_LANES solutions side by side and splits large batches between threads.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/* ============================== INCLUDES */
+
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "sha256_verifier.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Padding bit byte plus the 64 bit message length in bytes. */
+#define SHA256_VERIFIER_PADDING_SIZE            (9)
+
+/** @brief HMAC inner key pad byte. */
+#define SHA256_VERIFIER_HMAC_IPAD               (0x36)
+
+/** @brief HMAC outer key pad byte. */
+#define SHA256_VERIFIER_HMAC_OPAD               (0x5C)
+
+/** @brief Message length in bits of the HMAC outer hash, the outer key pad block followed by the inner digest. */
+#define SHA256_VERIFIER_HMAC_OUTER_BITS         ((SHA256_KERNEL_BLOCK_SIZE + SHA256_VERIFIER_DIGEST_SIZE) * 8)
+
+/** @brief Smallest number of items handed to a thread, smaller batches use fewer threads. */
+#define SHA256_VERIFIER_THREAD_MIN_ITEMS        (1024)
+
+/** @brief Largest number of threads. */
+#define SHA256_VERIFIER_THREAD_MAX              (64)
+
+/* ============================== TYPE DEFINITIONS */
+
+/**
+ * @brief Part of a batch verified by one thread.
+ * 
+ */
+typedef struct {
+    const sha256_verifier_item_t *p_items;                      //! First item of the part
+    size_t item_count;                                          //! Number of items of the part
+    bool *p_b_valid;                                            //! Results of the part
+    size_t valid_count;                                         //! Number of valid items, set by the thread
+} sha256_verifier_part_t;
+
+/* ============================== PRIVATE FUNCTION DECLARATIONS */
+
+/**
+ * @brief Verifies up to SHA256_KERNEL_LANES items with the lane kernels. Unused lanes repeat the first item.
+ * 
+ * @param p_items Pointer to the items.
+ * @param item_count Number of items, 1 to SHA256_KERNEL_LANES.
+ * @param p_b_valid Pointer to where the result of every item will be written.
+ * 
+ * @return size_t Number of valid items.
+ */
+static size_t _sha256_verifier_lanes_verify(const sha256_verifier_item_t *p_items, size_t item_count, bool *p_b_valid);
+
+/**
+ * @brief Verifies a part of a batch. Thread function.
+ * 
+ * @param p_arg Pointer to the part.
+ * 
+ * @return void* Always NULL.
+ */
+static void *_sha256_verifier_part_verify(void *p_arg);
+
+/**
+ * @brief Sets the nonce words of a block.
+ * 
+ * @param p_block Pointer to the block words.
+ * @param p_job Pointer to the prepared job.
+ * @param offset_solution Nonce.
+ */
+static inline void _sha256_verifier_nonce_set(uint32_t *p_block, const sha256_verifier_prepared_job_t *p_job, uint64_t offset_solution);
+
+/**
+ * @brief Compresses a key pad block of an HMAC job from the initial hash value.
+ * 
+ * @param p_state Pointer to where the chaining state words will be written.
+ * @param p_job Pointer to the job.
+ * @param pad Key pad byte.
+ */
+static void _sha256_verifier_key_pad_compress(uint32_t *p_state, const sha256_verifier_job_t *p_job, uint8_t pad);
+
+/**
+ * @brief Compares a digest with the target solution and the threshold of the job, same rules as the worker.
+ * 
+ * @param p_job Pointer to the prepared job.
+ * @param p_digest Pointer to the digest words.
+ * 
+ * @return bool Returns true on a match, else false.
+ */
+static bool _sha256_verifier_match(const sha256_verifier_prepared_job_t *p_job, const uint32_t *p_digest);
+
+/**
+ * @brief Loads big endian words from bytes.
+ * 
+ * @param p_words Pointer to where the words will be written.
+ * @param p_bytes Pointer to the bytes.
+ * @param words Number of words.
+ */
+static void _sha256_verifier_words_load(uint32_t *p_words, const uint8_t *p_bytes, int words);
+
+/* ============================== PRIVATE VARIABLES */
+
+/* ============================== PUBLIC VARIABLES */
+
+/* ============================== PUBLIC FUNCTION DEFINITIONS */
+
+bool sha256_verifier_job_prepare(sha256_verifier_prepared_job_t *p_prepared_job, const sha256_verifier_job_t *p_job)
+{
+    uint8_t last_block[SHA256_KERNEL_BLOCK_SIZE] = {0};
+    uint32_t target_words[SHA256_KERNEL_STATE_WORDS] = {0};
+    uint32_t threshold_words[SHA256_KERNEL_STATE_WORDS] = {0};
+    bool b_sha256d = (SHA256_VERIFIER_JOB_TYPE_SHA256D == p_job->job_type);
+    bool b_hmac = (SHA256_VERIFIER_JOB_TYPE_HMAC == p_job->job_type);
+    int prefix_size = (true == b_sha256d) ? p_job->prefix_size : 0;
+    int tail_size = prefix_size % SHA256_KERNEL_BLOCK_SIZE;
+    int mask_bits = p_job->target_solution_mask_offset + 1;
+    int word_bits = 0;
+    int i = 0;
+
+    memset(p_prepared_job, 0, sizeof(*p_prepared_job));
+
+    /* Same job checks as the worker, the nonce is word aligned and fits into the last block with the padding */
+    if (((SHA256_VERIFIER_JOB_TYPE_SHA256 != p_job->job_type) && (false == b_sha256d) && (false == b_hmac)) ||
+        ((sizeof(uint32_t) != p_job->nonce_size) && (sizeof(uint64_t) != p_job->nonce_size)) ||
+        ((true == b_hmac) && (p_job->key_size > SHA256_VERIFIER_KEY_MAX_SIZE)) ||
+        (prefix_size > SHA256_VERIFIER_PREFIX_MAX_SIZE) ||
+        (0 != (prefix_size % sizeof(uint32_t))) ||
+        ((tail_size + p_job->nonce_size + SHA256_VERIFIER_PADDING_SIZE) > SHA256_KERNEL_BLOCK_SIZE))
+    {
+        return false;
+    }
+
+    p_prepared_job->job_type = p_job->job_type;
+    p_prepared_job->nonce_size = p_job->nonce_size;
+    p_prepared_job->match_flags = (true == b_sha256d) ? p_job->match_flags : SHA256_VERIFIER_MATCH_FLAG_TARGET;
+    if (0 == (p_prepared_job->match_flags & (SHA256_VERIFIER_MATCH_FLAG_TARGET | SHA256_VERIFIER_MATCH_FLAG_THRESHOLD)))
+    {
+        return false;
+    }
+
+    /* Full prefix blocks are the same for every offset */
+    memcpy(p_prepared_job->midstate, sha256_kernel_initial_state, sizeof(p_prepared_job->midstate));
+    for (i = 0; (i + SHA256_KERNEL_BLOCK_SIZE) <= prefix_size; i += SHA256_KERNEL_BLOCK_SIZE)
+    {
+        _sha256_verifier_words_load(p_prepared_job->block, &p_job->prefix[i], SHA256_KERNEL_BLOCK_WORDS);
+        sha256_kernel_compress(p_prepared_job->midstate, p_prepared_job->block);
+    }
+
+    /* Last block holds the prefix tail, the nonce words, the padding bit and the message length */
+    memcpy(last_block, &p_job->prefix[prefix_size - tail_size], tail_size);
+    last_block[tail_size + p_job->nonce_size] = 0x80;
+    _sha256_verifier_words_load(p_prepared_job->block, last_block, SHA256_KERNEL_BLOCK_WORDS);
+    p_prepared_job->block[SHA256_KERNEL_BLOCK_WORDS - 1] = (prefix_size + p_job->nonce_size) * 8;
+    p_prepared_job->nonce_word = tail_size / sizeof(uint32_t);
+
+    /* HMAC inner hash continues from the inner key pad block, the outer hash from the outer key pad block */
+    if (true == b_hmac)
+    {
+        _sha256_verifier_key_pad_compress(p_prepared_job->midstate, p_job, SHA256_VERIFIER_HMAC_IPAD);
+        _sha256_verifier_key_pad_compress(p_prepared_job->outer_midstate, p_job, SHA256_VERIFIER_HMAC_OPAD);
+        p_prepared_job->block[SHA256_KERNEL_BLOCK_WORDS - 1] = (SHA256_KERNEL_BLOCK_SIZE + p_job->nonce_size) * 8;
+    }
+
+    _sha256_verifier_words_load(target_words, p_job->target_solution, SHA256_KERNEL_STATE_WORDS);
+    _sha256_verifier_words_load(threshold_words, p_job->threshold, SHA256_KERNEL_STATE_WORDS);
+    for (i = 0; i < SHA256_KERNEL_STATE_WORDS; i++)
+    {
+        /* Number of compared bits in this word, counted from the most significant bit */
+        word_bits = mask_bits - (i * 32);
+        if (word_bits < 0) word_bits = 0;
+        if (word_bits > 32) word_bits = 32;
+
+        p_prepared_job->mask_words[i] = (0 == word_bits) ? 0 : (0xFFFFFFFF << (32 - word_bits));
+        p_prepared_job->target_words[i] = target_words[i] & p_prepared_job->mask_words[i];
+        if (0 != word_bits) p_prepared_job->compare_words = i + 1;
+
+        /* Threshold words are stored most significant first, a little endian threshold starts at the last byte */
+        p_prepared_job->threshold_words[i] = (0 != (p_prepared_job->match_flags & SHA256_VERIFIER_MATCH_FLAG_THRESHOLD_LE)) ?
+            __builtin_bswap32(threshold_words[SHA256_KERNEL_STATE_WORDS - 1 - i]) : threshold_words[i];
+    }
+
+    return true;
+}
+
+bool sha256_verifier_verify_one(const sha256_verifier_item_t *p_item)
+{
+    const sha256_verifier_prepared_job_t *p_job = p_item->p_job;
+    uint32_t block[SHA256_KERNEL_BLOCK_WORDS];
+    uint32_t digest[SHA256_KERNEL_STATE_WORDS];
+
+    memcpy(block, p_job->block, sizeof(block));
+    memcpy(digest, p_job->midstate, sizeof(digest));
+    _sha256_verifier_nonce_set(block, p_job, p_item->offset_solution);
+
+    sha256_kernel_compress(digest, block);
+    if (SHA256_VERIFIER_JOB_TYPE_SHA256D == p_job->job_type) sha256_kernel_digest_hash(digest, digest);
+
+    if (SHA256_VERIFIER_JOB_TYPE_HMAC == p_job->job_type)
+    {
+        /* Outer block is the inner digest followed by constant padding */
+        memset(block, 0, sizeof(block));
+        memcpy(block, digest, sizeof(digest));
+        block[SHA256_KERNEL_STATE_WORDS] = 0x80000000;
+        block[SHA256_KERNEL_BLOCK_WORDS - 1] = SHA256_VERIFIER_HMAC_OUTER_BITS;
+        memcpy(digest, p_job->outer_midstate, sizeof(digest));
+        sha256_kernel_compress(digest, block);
+    }
+
+    return _sha256_verifier_match(p_job, digest);
+}
+
+size_t sha256_verifier_verify(const sha256_verifier_item_t *p_items, size_t item_count, bool *p_b_valid, int thread_count)
+{
+    pthread_t threads[SHA256_VERIFIER_THREAD_MAX];
+    sha256_verifier_part_t parts[SHA256_VERIFIER_THREAD_MAX];
+    size_t part_size = 0;
+    size_t first = 0;
+    size_t valid_count = 0;
+    int started = 0;
+    int i = 0;
+
+    if (thread_count <= 0) thread_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (thread_count > SHA256_VERIFIER_THREAD_MAX) thread_count = SHA256_VERIFIER_THREAD_MAX;
+    if ((size_t)thread_count > (item_count / SHA256_VERIFIER_THREAD_MIN_ITEMS)) thread_count = (int)(item_count / SHA256_VERIFIER_THREAD_MIN_ITEMS);
+    if (thread_count < 1) thread_count = 1;
+
+    /* Parts are whole lane groups, the last part takes the rest */
+    part_size = ((item_count / thread_count) / SHA256_KERNEL_LANES) * SHA256_KERNEL_LANES;
+    for (i = 0; i < thread_count; i++)
+    {
+        parts[i].p_items = &p_items[first];
+        parts[i].item_count = ((thread_count - 1) == i) ? (item_count - first) : part_size;
+        parts[i].p_b_valid = &p_b_valid[first];
+        parts[i].valid_count = 0;
+        first += parts[i].item_count;
+    }
+
+    /* The calling thread verifies the first part, a part whose thread fails to start is verified here too */
+    for (i = 1; i < thread_count; i++)
+    {
+        if (0 != pthread_create(&threads[i], NULL, _sha256_verifier_part_verify, &parts[i])) break;
+        started = i;
+    }
+    _sha256_verifier_part_verify(&parts[0]);
+    for (i = started + 1; i < thread_count; i++)
+    {
+        _sha256_verifier_part_verify(&parts[i]);
+    }
+
+    for (i = 0; i < thread_count; i++)
+    {
+        if ((0 != i) && (i <= started)) pthread_join(threads[i], NULL);
+        valid_count += parts[i].valid_count;
+    }
+
+    return valid_count;
+}
+
+/* ============================== PRIVATE FUNCTION DEFINITIONS */
+
+static size_t _sha256_verifier_lanes_verify(const sha256_verifier_item_t *p_items, size_t item_count, bool *p_b_valid)
+{
+    sha256_kernel_lanes_t state[SHA256_KERNEL_STATE_WORDS];
+    sha256_kernel_lanes_t block[SHA256_KERNEL_BLOCK_WORDS];
+    sha256_kernel_lanes_t outer_state[SHA256_KERNEL_STATE_WORDS];
+    sha256_kernel_lanes_t outer_block[SHA256_KERNEL_BLOCK_WORDS];
+    uint32_t lane_block[SHA256_KERNEL_BLOCK_WORDS];
+    uint32_t digest[SHA256_KERNEL_STATE_WORDS];
+    const sha256_verifier_item_t *p_item = NULL;
+    bool b_sha256d = false;
+    bool b_hmac = false;
+    size_t valid_count = 0;
+    int lane = 0;
+    int i = 0;
+
+    /* Gather the chaining state and the last block of every lane */
+    for (lane = 0; lane < SHA256_KERNEL_LANES; lane++)
+    {
+        p_item = &p_items[((size_t)lane < item_count) ? lane : 0];
+
+        memcpy(lane_block, p_item->p_job->block, sizeof(lane_block));
+        _sha256_verifier_nonce_set(lane_block, p_item->p_job, p_item->offset_solution);
+        for (i = 0; i < SHA256_KERNEL_BLOCK_WORDS; i++) block[i][lane] = lane_block[i];
+        for (i = 0; i < SHA256_KERNEL_STATE_WORDS; i++) state[i][lane] = p_item->p_job->midstate[i];
+
+        if (SHA256_VERIFIER_JOB_TYPE_SHA256D == p_item->p_job->job_type) b_sha256d = true;
+        if (SHA256_VERIFIER_JOB_TYPE_HMAC == p_item->p_job->job_type) b_hmac = true;
+    }
+
+    sha256_kernel_lanes_compress(state, block);
+
+    /* Second hash only if a lane needs it, SHA256 lanes keep the first digest */
+    if (true == b_sha256d) sha256_kernel_lanes_digest_hash(state, block);
+
+    /* HMAC outer hash compresses the first digest into the outer midstate of the lane, other lanes ignore it */
+    if (true == b_hmac)
+    {
+        for (lane = 0; lane < SHA256_KERNEL_LANES; lane++)
+        {
+            p_item = &p_items[((size_t)lane < item_count) ? lane : 0];
+            for (i = 0; i < SHA256_KERNEL_STATE_WORDS; i++) outer_state[i][lane] = p_item->p_job->outer_midstate[i];
+        }
+        for (i = 0; i < SHA256_KERNEL_BLOCK_WORDS; i++)
+        {
+            outer_block[i] = (i < SHA256_KERNEL_STATE_WORDS) ? state[i] : (sha256_kernel_lanes_t){0};
+        }
+        outer_block[SHA256_KERNEL_STATE_WORDS] += 0x80000000;
+        outer_block[SHA256_KERNEL_BLOCK_WORDS - 1] += SHA256_VERIFIER_HMAC_OUTER_BITS;
+
+        sha256_kernel_lanes_compress(outer_state, outer_block);
+    }
+
+    for (lane = 0; (size_t)lane < item_count; lane++)
+    {
+        p_item = &p_items[lane];
+        for (i = 0; i < SHA256_KERNEL_STATE_WORDS; i++)
+        {
+            if (SHA256_VERIFIER_JOB_TYPE_SHA256D == p_item->p_job->job_type) digest[i] = block[i][lane];
+            else if (SHA256_VERIFIER_JOB_TYPE_HMAC == p_item->p_job->job_type) digest[i] = outer_state[i][lane];
+            else digest[i] = state[i][lane];
+        }
+
+        p_b_valid[lane] = _sha256_verifier_match(p_item->p_job, digest);
+        if (true == p_b_valid[lane]) valid_count++;
+    }
+
+    return valid_count;
+}
+
+static void *_sha256_verifier_part_verify(void *p_arg)
+{
+    sha256_verifier_part_t *p_part = (sha256_verifier_part_t *)p_arg;
+    size_t group_size = 0;
+    size_t i = 0;
+
+    for (i = 0; i < p_part->item_count; i += group_size)
+    {
+        group_size = p_part->item_count - i;
+        if (group_size > SHA256_KERNEL_LANES) group_size = SHA256_KERNEL_LANES;
+
+        p_part->valid_count += _sha256_verifier_lanes_verify(&p_part->p_items[i], group_size, &p_part->p_b_valid[i]);
+    }
+
+    return NULL;
+}
+
+static inline void _sha256_verifier_nonce_set(uint32_t *p_block, const sha256_verifier_prepared_job_t *p_job, uint64_t offset_solution)
+{
+    /* Nonce is hashed as its little endian bytes, its words are big endian message words */
+    p_block[p_job->nonce_word] = __builtin_bswap32((uint32_t)offset_solution);
+    if (sizeof(uint64_t) == p_job->nonce_size) p_block[p_job->nonce_word + 1] = __builtin_bswap32((uint32_t)(offset_solution >> 32));
+}
+
+static void _sha256_verifier_key_pad_compress(uint32_t *p_state, const sha256_verifier_job_t *p_job, uint8_t pad)
+{
+    uint8_t pad_bytes[SHA256_KERNEL_BLOCK_SIZE] = {0};
+    uint32_t pad_block[SHA256_KERNEL_BLOCK_WORDS] = {0};
+    int i = 0;
+
+    memcpy(pad_bytes, p_job->key, p_job->key_size);
+    for (i = 0; i < SHA256_KERNEL_BLOCK_SIZE; i++) pad_bytes[i] ^= pad;
+
+    _sha256_verifier_words_load(pad_block, pad_bytes, SHA256_KERNEL_BLOCK_WORDS);
+    memcpy(p_state, sha256_kernel_initial_state, SHA256_KERNEL_STATE_WORDS * sizeof(uint32_t));
+    sha256_kernel_compress(p_state, pad_block);
+}
+
+static bool _sha256_verifier_match(const sha256_verifier_prepared_job_t *p_job, const uint32_t *p_digest)
+{
+    bool b_little_endian = (0 != (p_job->match_flags & SHA256_VERIFIER_MATCH_FLAG_THRESHOLD_LE));
+    uint32_t digest_word = 0;
+    int i = 0;
+
+    if (0 != (p_job->match_flags & SHA256_VERIFIER_MATCH_FLAG_TARGET))
+    {
+        for (i = 0; i < p_job->compare_words; i++)
+        {
+            if ((p_digest[i] & p_job->mask_words[i]) != p_job->target_words[i]) return false;
+        }
+    }
+
+    if (0 != (p_job->match_flags & SHA256_VERIFIER_MATCH_FLAG_THRESHOLD))
+    {
+        /* Compare from the most significant word, the first differing word decides */
+        for (i = 0; i < SHA256_KERNEL_STATE_WORDS; i++)
+        {
+            digest_word = (true == b_little_endian) ? __builtin_bswap32(p_digest[SHA256_KERNEL_STATE_WORDS - 1 - i]) : p_digest[i];
+
+            if (digest_word < p_job->threshold_words[i]) return true;
+            if (digest_word > p_job->threshold_words[i]) return false;
+        }
+    }
+
+    return true;
+}
+
+static void _sha256_verifier_words_load(uint32_t *p_words, const uint8_t *p_bytes, int words)
+{
+    int i = 0;
+
+    for (i = 0; i < words; i++)
+    {
+        p_words[i] = (((uint32_t)p_bytes[4 * i] << 24) |
+                      ((uint32_t)p_bytes[4 * i + 1] << 16) |
+                      ((uint32_t)p_bytes[4 * i + 2] << 8) |
+                      ((uint32_t)p_bytes[4 * i + 3]));
+    }
+}
+
+/* ============================== INTERRUPT FUNCTION DEFINITIONS */
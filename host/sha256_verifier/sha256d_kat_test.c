@@ -0,0 +1,285 @@
+/**
+ * @file sha256d_kat_test.c
+ * @author Iwan Ćulumović
+ * @brief SHA256d known answer test. Verifies SHA256d jobs of every prefix block layout and both nonce sizes against
+ * digests computed with an independent SHA256 implementation, and the Bitcoin genesis and first block headers
+ * against their little endian threshold, one at a time and in batches.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/* ============================== INCLUDES */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sha256_verifier.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Number of prefix vectors. */
+#define KAT_PREFIX_VECTOR_COUNT                 (sizeof(_g_kat_prefix_vectors) / sizeof(_g_kat_prefix_vectors[0]))
+
+/** @brief Number of header vectors. */
+#define KAT_HEADER_VECTOR_COUNT                 (sizeof(_g_kat_header_vectors) / sizeof(_g_kat_header_vectors[0]))
+
+/** @brief Bitcoin header size without the nonce in bytes. */
+#define KAT_HEADER_PREFIX_SIZE                  (76)
+
+/* ============================== TYPE DEFINITIONS */
+
+/**
+ * @brief SHA256d of a generated prefix followed by the nonce. Prefix byte i is (i * 7 + 3) & 0xFF.
+ * 
+ */
+typedef struct {
+    uint8_t prefix_size;                                //! Prefix size in bytes
+    uint8_t nonce_size;                                 //! Nonce size in bytes, 4 or 8
+    uint64_t nonce;                                     //! Nonce, hashed as its little endian bytes
+    const char *p_digest;                               //! Digest in hex, SHA256 byte order
+} kat_prefix_vector_t;
+
+/**
+ * @brief Bitcoin block header and its nonce.
+ * 
+ */
+typedef struct {
+    const char *p_prefix;                               //! Header without the nonce in hex
+    uint32_t nonce;                                     //! Nonce of the block
+    const char *p_threshold;                            //! Target of the header bits in hex, little endian
+} kat_header_vector_t;
+
+/* ============================== PRIVATE FUNCTION DECLARATIONS */
+
+/**
+ * @brief Converts hex digits to bytes.
+ * 
+ * @param p_hex Pointer to the hex digits, two per byte.
+ * @param p_bytes Pointer to where the bytes will be written.
+ * @param size Number of bytes.
+ */
+static void _test_hex_load(const char *p_hex, uint8_t *p_bytes, size_t size);
+
+/**
+ * @brief Verifies an offset one at a time and in a batch and checks that both give the expected result.
+ * 
+ * @param p_job Pointer to the job.
+ * @param offset Offset to verify.
+ * @param b_expected Expected result.
+ * 
+ * @return size_t Number of failed checks.
+ */
+static size_t _test_offset_check(const sha256_verifier_job_t *p_job, uint64_t offset, bool b_expected);
+
+/**
+ * @brief Checks the prefix vectors with the full digest as target and as big endian threshold.
+ * 
+ * @return size_t Number of failed checks.
+ */
+static size_t _test_prefix_vectors(void);
+
+/**
+ * @brief Checks the Bitcoin header vectors against the target of their bits.
+ * 
+ * @return size_t Number of failed checks.
+ */
+static size_t _test_header_vectors(void);
+
+/**
+ * @brief Checks that jobs the worker rejects are rejected.
+ * 
+ * @return size_t Number of failed checks.
+ */
+static size_t _test_invalid_jobs(void);
+
+/* ============================== PRIVATE VARIABLES */
+
+/** @brief Prefix vectors, every layout of the last block and prefixes of one and two full blocks. */
+static const kat_prefix_vector_t _g_kat_prefix_vectors[] = {
+    {0, 4, 0x89ABCDEF, "671a0ead3c76c5e4f7dbd74f778a91cfb0c92f99a90a7e05fd23c53c5fcc4b3a"},
+    {4, 4, 0x89ABCDEF, "b5953ec29a8ebc63f18b1c89af9d734fbd44a859aa70aedc21830dcf93d0ec49"},
+    {48, 4, 0x89ABCDEF, "5b281c7182e699ca3f29f506656b226a57590359372c88da2d9cb1f401c0d52e"},
+    {64, 4, 0x89ABCDEF, "258810c2850f91c3fcb86a5cf5d370530791f0c19cf068f0be8edaf057a27765"},
+    {76, 4, 0x89ABCDEF, "27a3cf1c6f9ef316fcf9d2c4c3a96ad28ad53461bdd9de5c3ac7c1aa6d40ae31"},
+    {112, 4, 0x89ABCDEF, "902d9b68f04e07d50aa9bce9207c82a63a02bb677e8fd53dc201ecdbd9b23654"},
+    {128, 4, 0x89ABCDEF, "34b4de777056993787ae173d08bc299f10f4ab129d4ba2606f518b4ee2d2555d"},
+    {44, 8, 0x0123456789ABCDEF, "16f8643196555316e3c664089229b4533c8137bc4784b9c2296cc0bfb84d11dd"},
+    {128, 8, 0x0123456789ABCDEF, "e21c7aa3960f5fce744069ed4afa0686d2490fb9f3b04b6e2363d40229a538d0"},
+};
+
+/** @brief Bitcoin genesis block and block 1, both with bits 0x1D00FFFF. */
+static const kat_header_vector_t _g_kat_header_vectors[] = {
+    {"01000000"
+     "0000000000000000000000000000000000000000000000000000000000000000"
+     "3ba3edfd7a7b12b27ac72c3e67768f617fc81bc3888a51323a9fb8aa4b1e5e4a"
+     "29ab5f49"
+     "ffff001d",
+     2083236893,
+     "0000000000000000000000000000000000000000000000000000ffff00000000"},
+    {"01000000"
+     "6fe28c0ab6f1b372c1a6a246ae63f74f931e8365e15a089c68d6190000000000"
+     "982051fd1e4ba744bbbe680e1fee14677ba1a3c3540bf7b1cdb606e857233e0e"
+     "61bc6649"
+     "ffff001d",
+     2573394689,
+     "0000000000000000000000000000000000000000000000000000ffff00000000"},
+};
+
+/* ============================== PUBLIC VARIABLES */
+
+/* ============================== PUBLIC FUNCTION DEFINITIONS */
+
+int main(void)
+{
+    size_t failures = 0;
+
+    failures += _test_prefix_vectors();
+    failures += _test_header_vectors();
+    failures += _test_invalid_jobs();
+
+    printf("Failures: %zu\n", failures);
+
+    return (0 == failures) ? 0 : 1;
+}
+
+/* ============================== PRIVATE FUNCTION DEFINITIONS */
+
+static void _test_hex_load(const char *p_hex, uint8_t *p_bytes, size_t size)
+{
+    unsigned int value = 0;
+    size_t i = 0;
+
+    for (i = 0; i < size; i++)
+    {
+        sscanf(&p_hex[2 * i], "%2x", &value);
+        p_bytes[i] = (uint8_t)value;
+    }
+}
+
+static size_t _test_offset_check(const sha256_verifier_job_t *p_job, uint64_t offset, bool b_expected)
+{
+    sha256_verifier_prepared_job_t prepared_job = {0};
+    sha256_verifier_item_t items[SHA256_KERNEL_LANES + 1] = {0};
+    bool b_valid[SHA256_KERNEL_LANES + 1] = {0};
+    size_t failures = 0;
+    size_t i = 0;
+
+    if (false == sha256_verifier_job_prepare(&prepared_job, p_job)) return 1;
+
+    if (b_expected != sha256_verifier_verify_one(&(sha256_verifier_item_t){&prepared_job, offset})) failures++;
+
+    /* The batch puts the offset into every lane once and leaves one item over for the single item path */
+    for (i = 0; i < (SHA256_KERNEL_LANES + 1); i++)
+    {
+        items[i].p_job = &prepared_job;
+        items[i].offset_solution = offset;
+    }
+    sha256_verifier_verify(items, SHA256_KERNEL_LANES + 1, b_valid, 1);
+    for (i = 0; i < (SHA256_KERNEL_LANES + 1); i++)
+    {
+        if (b_expected != b_valid[i]) failures++;
+    }
+
+    return failures;
+}
+
+static size_t _test_prefix_vectors(void)
+{
+    const kat_prefix_vector_t *p_vector = NULL;
+    sha256_verifier_job_t job = {0};
+    uint8_t digest[SHA256_VERIFIER_DIGEST_SIZE] = {0};
+    size_t failures = 0;
+    size_t i = 0;
+    int j = 0;
+
+    for (i = 0; i < KAT_PREFIX_VECTOR_COUNT; i++)
+    {
+        p_vector = &_g_kat_prefix_vectors[i];
+        _test_hex_load(p_vector->p_digest, digest, sizeof(digest));
+
+        memset(&job, 0, sizeof(job));
+        job.job_type = SHA256_VERIFIER_JOB_TYPE_SHA256D;
+        job.nonce_size = p_vector->nonce_size;
+        job.prefix_size = p_vector->prefix_size;
+        for (j = 0; j < p_vector->prefix_size; j++) job.prefix[j] = (uint8_t)((j * 7) + 3);
+
+        /* Every digest bit compared with the target */
+        job.match_flags = SHA256_VERIFIER_MATCH_FLAG_TARGET;
+        job.target_solution_mask_offset = (SHA256_VERIFIER_DIGEST_SIZE * 8) - 1;
+        memcpy(job.target_solution, digest, sizeof(digest));
+        failures += _test_offset_check(&job, p_vector->nonce, true);
+        failures += _test_offset_check(&job, p_vector->nonce + 1, false);
+
+        /* The digest is equal to itself as a big endian threshold and above the threshold one less */
+        job.match_flags = SHA256_VERIFIER_MATCH_FLAG_THRESHOLD;
+        memcpy(job.threshold, digest, sizeof(digest));
+        failures += _test_offset_check(&job, p_vector->nonce, true);
+        for (j = SHA256_VERIFIER_DIGEST_SIZE - 1; (j >= 0) && (0 == job.threshold[j]--); j--);
+        failures += _test_offset_check(&job, p_vector->nonce, false);
+    }
+
+    printf("Prefix vectors: %zu, %zu failed checks\n", KAT_PREFIX_VECTOR_COUNT, failures);
+
+    return failures;
+}
+
+static size_t _test_header_vectors(void)
+{
+    const kat_header_vector_t *p_vector = NULL;
+    sha256_verifier_job_t job = {0};
+    size_t failures = 0;
+    size_t i = 0;
+
+    for (i = 0; i < KAT_HEADER_VECTOR_COUNT; i++)
+    {
+        p_vector = &_g_kat_header_vectors[i];
+
+        memset(&job, 0, sizeof(job));
+        job.job_type = SHA256_VERIFIER_JOB_TYPE_SHA256D;
+        job.nonce_size = sizeof(uint32_t);
+        job.prefix_size = KAT_HEADER_PREFIX_SIZE;
+        job.match_flags = SHA256_VERIFIER_MATCH_FLAG_THRESHOLD | SHA256_VERIFIER_MATCH_FLAG_THRESHOLD_LE;
+        _test_hex_load(p_vector->p_prefix, job.prefix, KAT_HEADER_PREFIX_SIZE);
+        _test_hex_load(p_vector->p_threshold, job.threshold, sizeof(job.threshold));
+
+        failures += _test_offset_check(&job, p_vector->nonce, true);
+        failures += _test_offset_check(&job, p_vector->nonce - 1, false);
+        failures += _test_offset_check(&job, p_vector->nonce + 1, false);
+    }
+
+    printf("Header vectors: %zu, %zu failed checks\n", KAT_HEADER_VECTOR_COUNT, failures);
+
+    return failures;
+}
+
+static size_t _test_invalid_jobs(void)
+{
+    static const uint8_t invalid_prefix_sizes[] = {6, 52, 116, SHA256_VERIFIER_PREFIX_MAX_SIZE + 4};
+    sha256_verifier_prepared_job_t prepared_job = {0};
+    sha256_verifier_job_t job = {0};
+    size_t failures = 0;
+    size_t i = 0;
+
+    job.job_type = SHA256_VERIFIER_JOB_TYPE_SHA256D;
+    job.nonce_size = sizeof(uint32_t);
+    job.match_flags = SHA256_VERIFIER_MATCH_FLAG_TARGET;
+
+    /* Unaligned prefixes and tails that leave no room for the nonce and the padding */
+    for (i = 0; i < sizeof(invalid_prefix_sizes); i++)
+    {
+        job.prefix_size = invalid_prefix_sizes[i];
+        if (true == sha256_verifier_job_prepare(&prepared_job, &job)) failures++;
+    }
+
+    /* No match flag */
+    job.prefix_size = KAT_HEADER_PREFIX_SIZE;
+    job.match_flags = 0;
+    if (true == sha256_verifier_job_prepare(&prepared_job, &job)) failures++;
+
+    printf("Invalid jobs: %zu failed checks\n", failures);
+
+    return failures;
+}
+
+/* ============================== INTERRUPT FUNCTION DEFINITIONS */
@@ -0,0 +1,319 @@
+/**
+ * @file verifier_bench.c
+ * @author Iwan Ćulumović
+ * @brief Batch verifier benchmark. Verifies a synthetic set of reported solutions of mixed SHA256, SHA256d and HMAC jobs
+ * one at a time the naive way and with the batch verifier, checks that both agree and reports the rates.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/* ============================== INCLUDES */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef VERIFIER_BENCH_OPENSSL
+#include <openssl/sha.h>
+#include <openssl/hmac.h>
+#include <openssl/evp.h>
+#endif
+#include "sha256_verifier.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Default number of verified items, VERIFY_ITEMS. */
+#define VERIFY_ITEMS_DEFAULT                    (1 << 20)
+
+/** @brief Default number of distinct jobs the items belong to, VERIFY_JOBS. */
+#define VERIFY_JOBS_DEFAULT                     (256)
+
+/** @brief Default share of SHA256d jobs in percent, VERIFY_SHA256D_PERCENT. */
+#define VERIFY_SHA256D_PERCENT_DEFAULT          (50)
+
+/** @brief Default share of HMAC jobs in percent, VERIFY_HMAC_PERCENT. */
+#define VERIFY_HMAC_PERCENT_DEFAULT             (0)
+
+/** @brief Default nonce size in bytes, VERIFY_NONCE_SIZE. */
+#define VERIFY_NONCE_SIZE_DEFAULT               (4)
+
+/** @brief Default number of batch verifier threads, VERIFY_THREADS, 0 uses every online CPU. */
+#define VERIFY_THREADS_DEFAULT                  (0)
+
+/** @brief Default random seed, VERIFY_SEED. */
+#define VERIFY_SEED_DEFAULT                     (1)
+
+/** @brief Number of compared target bits, about one in 2^n random offsets is valid. */
+#define VERIFY_MASK_BITS                        (4)
+
+/** @brief SHA256d prefix size, a Bitcoin block header without the nonce. */
+#define VERIFY_SHA256D_PREFIX_SIZE              (76)
+
+/** @brief HMAC key size. */
+#define VERIFY_HMAC_KEY_SIZE                    (32)
+
+/* ============================== TYPE DEFINITIONS */
+
+/* ============================== PRIVATE FUNCTION DECLARATIONS */
+
+/**
+ * @brief Reads an integer parameter from the environment.
+ * 
+ * @param p_name Environment variable name.
+ * @param default_value Value if the variable isn't set.
+ * 
+ * @return long long Parameter value.
+ */
+static long long _bench_param_get(const char *p_name, long long default_value);
+
+/**
+ * @brief Monotonic time in seconds.
+ * 
+ * @return double Time in seconds.
+ */
+static double _bench_time_get(void);
+
+/**
+ * @brief Verifies a single item the naive way: hashes the whole message from scratch and compares the digest bytes.
+ * Uses OpenSSL if it was found at configure time, else the single item verifier.
+ * 
+ * @param p_job Pointer to the job as sent to the worker.
+ * @param p_item Pointer to the item.
+ * 
+ * @return bool Returns true if the offset solves the job, else false.
+ */
+static bool _bench_naive_verify(const sha256_verifier_job_t *p_job, const sha256_verifier_item_t *p_item);
+
+/* ============================== PRIVATE VARIABLES */
+
+/* ============================== PUBLIC VARIABLES */
+
+/* ============================== PUBLIC FUNCTION DEFINITIONS */
+
+int main(void)
+{
+    size_t item_count = (size_t)_bench_param_get("VERIFY_ITEMS", VERIFY_ITEMS_DEFAULT);
+    int job_count = (int)_bench_param_get("VERIFY_JOBS", VERIFY_JOBS_DEFAULT);
+    int sha256d_percent = (int)_bench_param_get("VERIFY_SHA256D_PERCENT", VERIFY_SHA256D_PERCENT_DEFAULT);
+    int hmac_percent = (int)_bench_param_get("VERIFY_HMAC_PERCENT", VERIFY_HMAC_PERCENT_DEFAULT);
+    int nonce_size = (int)_bench_param_get("VERIFY_NONCE_SIZE", VERIFY_NONCE_SIZE_DEFAULT);
+    int thread_count = (int)_bench_param_get("VERIFY_THREADS", VERIFY_THREADS_DEFAULT);
+    sha256_verifier_job_t *p_jobs = NULL;
+    sha256_verifier_prepared_job_t *p_prepared_jobs = NULL;
+    sha256_verifier_item_t *p_items = NULL;
+    int *p_item_jobs = NULL;
+    bool *p_b_naive = NULL;
+    bool *p_b_one = NULL;
+    bool *p_b_batch = NULL;
+    sha256_verifier_job_t *p_job = NULL;
+    size_t valid_naive = 0;
+    size_t valid_one = 0;
+    size_t valid_batch_1 = 0;
+    size_t valid_batch = 0;
+    size_t mismatches = 0;
+    double naive_s = 0;
+    double one_s = 0;
+    double batch_1_s = 0;
+    double batch_s = 0;
+    double start = 0;
+    size_t i = 0;
+    int j = 0;
+    int r = 0;
+
+    srand((unsigned int)_bench_param_get("VERIFY_SEED", VERIFY_SEED_DEFAULT));
+
+    if (job_count < 1) job_count = 1;
+    if ((int)sizeof(uint64_t) != nonce_size) nonce_size = sizeof(uint32_t);
+
+    p_jobs = calloc(job_count, sizeof(*p_jobs));
+    p_prepared_jobs = calloc(job_count, sizeof(*p_prepared_jobs));
+    p_items = calloc(item_count, sizeof(*p_items));
+    p_item_jobs = calloc(item_count, sizeof(*p_item_jobs));
+    p_b_naive = calloc(item_count, sizeof(bool));
+    p_b_one = calloc(item_count, sizeof(bool));
+    p_b_batch = calloc(item_count, sizeof(bool));
+    if ((NULL == p_jobs) || (NULL == p_prepared_jobs) || (NULL == p_items) || (NULL == p_item_jobs) ||
+        (NULL == p_b_naive) || (NULL == p_b_one) || (NULL == p_b_batch))
+    {
+        fprintf(stderr, "Failed to allocate %zu items. Aborting!\n", item_count);
+        abort();
+    }
+
+    /* SHA256 jobs compare a few target bits, SHA256d jobs a few target bits or a little endian threshold */
+    for (j = 0; j < job_count; j++)
+    {
+        p_job = &p_jobs[j];
+        r = rand() % 100;
+        p_job->job_type = (r < sha256d_percent) ? SHA256_VERIFIER_JOB_TYPE_SHA256D :
+                          (r < (sha256d_percent + hmac_percent)) ? SHA256_VERIFIER_JOB_TYPE_HMAC : SHA256_VERIFIER_JOB_TYPE_SHA256;
+        p_job->nonce_size = (uint8_t)nonce_size;
+        p_job->target_solution_mask_offset = VERIFY_MASK_BITS - 1;
+        for (i = 0; i < SHA256_VERIFIER_DIGEST_SIZE; i++) p_job->target_solution[i] = (uint8_t)rand();
+
+        if (SHA256_VERIFIER_JOB_TYPE_SHA256D == p_job->job_type)
+        {
+            p_job->prefix_size = VERIFY_SHA256D_PREFIX_SIZE;
+            for (i = 0; i < VERIFY_SHA256D_PREFIX_SIZE; i++) p_job->prefix[i] = (uint8_t)rand();
+
+            if (0 == (rand() % 2))
+            {
+                p_job->match_flags = SHA256_VERIFIER_MATCH_FLAG_TARGET;
+            }
+            else
+            {
+                p_job->match_flags = SHA256_VERIFIER_MATCH_FLAG_THRESHOLD | SHA256_VERIFIER_MATCH_FLAG_THRESHOLD_LE;
+                memset(p_job->threshold, 0xFF, sizeof(p_job->threshold));
+                p_job->threshold[SHA256_VERIFIER_DIGEST_SIZE - 1] = 0xFF >> VERIFY_MASK_BITS;
+            }
+        }
+        else if (SHA256_VERIFIER_JOB_TYPE_HMAC == p_job->job_type)
+        {
+            p_job->key_size = VERIFY_HMAC_KEY_SIZE;
+            for (i = 0; i < VERIFY_HMAC_KEY_SIZE; i++) p_job->key[i] = (uint8_t)rand();
+        }
+
+        if (false == sha256_verifier_job_prepare(&p_prepared_jobs[j], p_job))
+        {
+            fprintf(stderr, "Failed to prepare job %d. Aborting!\n", j);
+            abort();
+        }
+    }
+
+    for (i = 0; i < item_count; i++)
+    {
+        p_item_jobs[i] = rand() % job_count;
+        p_items[i].p_job = &p_prepared_jobs[p_item_jobs[i]];
+        p_items[i].offset_solution = ((uint64_t)rand() << 32) | (uint64_t)rand();
+        if (sizeof(uint32_t) == nonce_size) p_items[i].offset_solution &= 0xFFFFFFFF;
+    }
+
+    start = _bench_time_get();
+    for (i = 0; i < item_count; i++)
+    {
+        p_b_naive[i] = _bench_naive_verify(&p_jobs[p_item_jobs[i]], &p_items[i]);
+        if (true == p_b_naive[i]) valid_naive++;
+    }
+    naive_s = _bench_time_get() - start;
+
+    start = _bench_time_get();
+    for (i = 0; i < item_count; i++)
+    {
+        p_b_one[i] = sha256_verifier_verify_one(&p_items[i]);
+        if (true == p_b_one[i]) valid_one++;
+    }
+    one_s = _bench_time_get() - start;
+
+    start = _bench_time_get();
+    valid_batch_1 = sha256_verifier_verify(p_items, item_count, p_b_batch, 1);
+    batch_1_s = _bench_time_get() - start;
+
+    start = _bench_time_get();
+    valid_batch = sha256_verifier_verify(p_items, item_count, p_b_batch, thread_count);
+    batch_s = _bench_time_get() - start;
+
+    for (i = 0; i < item_count; i++)
+    {
+        if ((p_b_naive[i] != p_b_one[i]) || (p_b_naive[i] != p_b_batch[i])) mismatches++;
+    }
+
+    printf("Items: %zu of %d jobs (%d %% SHA256d, %d %% HMAC), nonce %d bytes, %d lanes, valid: %zu\n",
+        item_count, job_count, sha256d_percent, hmac_percent, nonce_size, SHA256_KERNEL_LANES, valid_naive);
+#ifdef VERIFIER_BENCH_OPENSSL
+    printf("Naive (OpenSSL, one at a time):    %10.0f items/s\n", item_count / naive_s);
+#else
+    printf("Naive (single item verifier):      %10.0f items/s\n", item_count / naive_s);
+#endif
+    printf("Single item verifier:              %10.0f items/s, %.2fx\n", item_count / one_s, naive_s / one_s);
+    printf("Batch verifier, 1 thread:          %10.0f items/s, %.2fx\n", item_count / batch_1_s, naive_s / batch_1_s);
+    printf("Batch verifier, %s threads:    %10.0f items/s, %.2fx\n", (0 == thread_count) ? "all" : "set", item_count / batch_s, naive_s / batch_s);
+    printf("Mismatches: %zu\n", mismatches);
+
+    free(p_jobs);
+    free(p_prepared_jobs);
+    free(p_items);
+    free(p_item_jobs);
+    free(p_b_naive);
+    free(p_b_one);
+    free(p_b_batch);
+
+    return ((0 == mismatches) && (valid_naive == valid_one) && (valid_naive == valid_batch_1) && (valid_naive == valid_batch)) ? 0 : 1;
+}
+
+/* ============================== PRIVATE FUNCTION DEFINITIONS */
+
+static long long _bench_param_get(const char *p_name, long long default_value)
+{
+    const char *p_value = getenv(p_name);
+
+    return (NULL != p_value) ? strtoll(p_value, NULL, 0) : default_value;
+}
+
+static double _bench_time_get(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + (now.tv_nsec / 1e9);
+}
+
+static bool _bench_naive_verify(const sha256_verifier_job_t *p_job, const sha256_verifier_item_t *p_item)
+{
+#ifdef VERIFIER_BENCH_OPENSSL
+    uint8_t message[SHA256_VERIFIER_PREFIX_MAX_SIZE + sizeof(uint64_t)] = {0};
+    uint8_t digest[SHA256_VERIFIER_DIGEST_SIZE] = {0};
+    size_t message_size = 0;
+    int mask_bits = p_job->target_solution_mask_offset + 1;
+    int bit = 0;
+    int i = 0;
+
+    /* Prefix followed by the little endian nonce bytes */
+    if (SHA256_VERIFIER_JOB_TYPE_SHA256D == p_job->job_type)
+    {
+        memcpy(message, p_job->prefix, p_job->prefix_size);
+        message_size = p_job->prefix_size;
+    }
+    for (i = 0; i < p_job->nonce_size; i++)
+    {
+        message[message_size++] = (uint8_t)(p_item->offset_solution >> (8 * i));
+    }
+
+    if (SHA256_VERIFIER_JOB_TYPE_HMAC == p_job->job_type)
+    {
+        HMAC(EVP_sha256(), p_job->key, p_job->key_size, message, message_size, digest, NULL);
+    }
+    else
+    {
+        SHA256(message, message_size, digest);
+    }
+    if (SHA256_VERIFIER_JOB_TYPE_SHA256D == p_job->job_type) SHA256(digest, sizeof(digest), digest);
+
+    if ((SHA256_VERIFIER_JOB_TYPE_SHA256D != p_job->job_type) || (0 != (p_job->match_flags & SHA256_VERIFIER_MATCH_FLAG_TARGET)))
+    {
+        for (bit = 0; bit < mask_bits; bit++)
+        {
+            if (((digest[bit / 8] ^ p_job->target_solution[bit / 8]) >> (7 - (bit % 8))) & 1) return false;
+        }
+    }
+
+    if ((SHA256_VERIFIER_JOB_TYPE_SHA256D == p_job->job_type) && (0 != (p_job->match_flags & SHA256_VERIFIER_MATCH_FLAG_THRESHOLD)))
+    {
+        for (i = 0; i < SHA256_VERIFIER_DIGEST_SIZE; i++)
+        {
+            bit = (0 != (p_job->match_flags & SHA256_VERIFIER_MATCH_FLAG_THRESHOLD_LE)) ? (SHA256_VERIFIER_DIGEST_SIZE - 1 - i) : i;
+
+            if (digest[bit] < p_job->threshold[bit]) return true;
+            if (digest[bit] > p_job->threshold[bit]) return false;
+        }
+    }
+
+    return true;
+#else
+    (void)p_job;
+
+    return sha256_verifier_verify_one(p_item);
+#endif
+}
+
+/* ============================== INTERRUPT FUNCTION DEFINITIONS */
@@ -1,7 +1,9 @@
 /**
  * @file comm_manager.c
  * @author Iwan Ćulumović
- * @brief Communication manager module.
+ * @brief Communication manager module. With I2C control and SPI data both slaves run, requests written on either bus
+ * are received in the same order of polling and replies to identify, status and estimate requests go out on I2C, while
+ * results go out on SPI.
  * 
  * @copyright Copyright (c) 2026
  * 
@@ -9,15 +11,27 @@
 
 /* ============================== INCLUDES */
 
+#include <stddef.h>
 #include "esp_log.h"
 #include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "comm/comm_manager.h"
+#include "comm/comm_protocol.h"
 #include "sha256_calculator.h"
+#include "sha256_stream.h"
 
-#ifdef CONFIG_COMM_PROTOCOL_I2C
+#ifdef CONFIG_I2C_REGISTER_MAP
+#include "comm/driver/i2c_regmap_manager.h"
+#elif CONFIG_COMM_PROTOCOL_I2C
 #include "comm/driver/i2c_manager.h"
 #elif CONFIG_COMM_PROTOCOL_SPI
 #include "comm/driver/spi_manager.h"
+#elif CONFIG_COMM_PROTOCOL_I2C_SPI
+#include "comm/driver/i2c_manager.h"
+#include "comm/driver/spi_manager.h"
+#elif CONFIG_COMM_PROTOCOL_SIM
+#include "comm/driver/sim_manager.h"
 #endif
 
 /* ============================== MACRO DEFINITIONS */
@@ -25,36 +39,128 @@
 /** @brief Log tag. */
 #define LOG_TAG                                 ("COMM_MANAGER")
 
-#ifdef CONFIG_COMM_PROTOCOL_I2C
-/** @brief I2C on receive queue length. */
-#define I2C_ON_RECEIVE_QUEUE_LENGTH             (10)
+#if defined(CONFIG_COMM_PROTOCOL_I2C) || defined(CONFIG_COMM_PROTOCOL_I2C_SPI)
+/** @brief I2C on receive queue length. Must be a power of two. */
+#define I2C_ON_RECEIVE_QUEUE_LENGTH             (16)
+
+/** @brief I2C register map result FIFO length. Must be a power of two. */
+#define I2C_REGMAP_RESULT_QUEUE_LENGTH          (8)
+#elif CONFIG_COMM_PROTOCOL_SIM
+/** @brief Simulated receive queue length. */
+#define SIM_RECEIVE_QUEUE_LENGTH                (16)
+#endif
+
+#ifdef CONFIG_I2C_REGISTER_MAP
+/** @brief Transport reported to the master. */
+#define COMM_TRANSPORT                          (COMM_TRANSPORT_I2C_REGISTER_MAP)
+
+/** @brief Receive queue length reported to the master. */
+#define COMM_RECEIVE_QUEUE_LENGTH               (I2C_ON_RECEIVE_QUEUE_LENGTH)
+#elif CONFIG_COMM_PROTOCOL_I2C
+/** @brief Transport reported to the master. */
+#define COMM_TRANSPORT                          (COMM_TRANSPORT_I2C)
+
+/** @brief Receive queue length reported to the master. */
+#define COMM_RECEIVE_QUEUE_LENGTH               (I2C_ON_RECEIVE_QUEUE_LENGTH)
+#elif CONFIG_COMM_PROTOCOL_SPI
+/** @brief Transport reported to the master. */
+#define COMM_TRANSPORT                          (COMM_TRANSPORT_SPI)
+
+/** @brief Receive queue length reported to the master, the SPI slave keeps only the last written frame. */
+#define COMM_RECEIVE_QUEUE_LENGTH               (1)
+#elif CONFIG_COMM_PROTOCOL_I2C_SPI
+/** @brief Transport reported to the master. */
+#define COMM_TRANSPORT                          (COMM_TRANSPORT_I2C_SPI)
+
+/** @brief Receive queue length reported to the master, of the SPI data plane that carries the jobs. */
+#define COMM_RECEIVE_QUEUE_LENGTH               (1)
+#elif CONFIG_COMM_PROTOCOL_SIM
+/** @brief Transport reported to the master. */
+#define COMM_TRANSPORT                          (COMM_TRANSPORT_SIM)
+
+/** @brief Receive queue length reported to the master. */
+#define COMM_RECEIVE_QUEUE_LENGTH               (SIM_RECEIVE_QUEUE_LENGTH)
 #endif
 
 /* ============================== TYPE DEFINITIONS */
 
 /* ============================== PRIVATE FUNCTION DECLARATIONS */
 
+/**
+ * @brief Sends the pending solutions in one solution batch frame.
+ * 
+ */
+static void _comm_manager_solution_batch_send(void);
+
+/**
+ * @brief Counts solutions sent in one frame.
+ * 
+ * @param results Number of solutions in the frame.
+ */
+static void _comm_manager_status_count(uint8_t results);
+
+#if defined(CONFIG_COMM_PROTOCOL_SPI) || defined(CONFIG_COMM_PROTOCOL_I2C_SPI)
+/**
+ * @brief Hands the message bytes of a stream frame to the stream, see spi_manager_stream_callback_t.
+ * 
+ * @param p_frame Pointer to the stream frame.
+ * @param frame_size Number of bytes received.
+ */
+static void _comm_manager_stream_frame(const uint8_t *p_frame, size_t frame_size);
+#endif
+
 /* ============================== PRIVATE VARIABLES */
 
+/** @brief Pending solutions, sent together once enough are pending or the oldest one timed out. */
+static comm_solution_batch_response_t _g_comm_solution_batch = {0};
+
+/** @brief Tick count when the oldest pending solution was put. */
+static TickType_t _g_comm_solution_batch_start_ticks = 0;
+
+/** @brief Communication manager status, only touched by the task that puts solutions. */
+static comm_manager_status_t _g_comm_manager_status = {0};
+
 /* ============================== PUBLIC VARIABLES */
 
 /* ============================== PUBLIC FUNCTION DEFINITIONS */
 
 void comm_manager_init(void)
 {
-#ifdef CONFIG_COMM_PROTOCOL_I2C
-    i2c_manager_slave_init(I2C_ON_RECEIVE_QUEUE_LENGTH, sizeof(sha256_input_variables_queue_element_t));
+#ifdef CONFIG_I2C_REGISTER_MAP
+    i2c_regmap_manager_slave_init(I2C_ON_RECEIVE_QUEUE_LENGTH, sizeof(comm_request_t), I2C_REGMAP_RESULT_QUEUE_LENGTH, sizeof(comm_response_t));
+#elif CONFIG_COMM_PROTOCOL_I2C
+    i2c_manager_slave_init(I2C_ON_RECEIVE_QUEUE_LENGTH, sizeof(comm_request_t));
 #elif CONFIG_COMM_PROTOCOL_SPI
-    spi_manager_slave_init();
+    spi_manager_slave_init(sizeof(comm_request_t), sizeof(comm_response_t), sizeof(comm_stream_frame_t), _comm_manager_stream_frame);
+#elif CONFIG_COMM_PROTOCOL_I2C_SPI
+    i2c_manager_slave_init(I2C_ON_RECEIVE_QUEUE_LENGTH, sizeof(comm_request_t));
+    spi_manager_slave_init(sizeof(comm_request_t), sizeof(comm_response_t), sizeof(comm_stream_frame_t), _comm_manager_stream_frame);
+#elif CONFIG_COMM_PROTOCOL_SIM
+    sim_manager_slave_init(SIM_RECEIVE_QUEUE_LENGTH, sizeof(comm_request_t), sizeof(comm_response_t));
 #endif
 }
 
 void comm_manager_set_data_to_be_read(uint8_t *p_buf, size_t buf_size)
 {
-#ifdef CONFIG_COMM_PROTOCOL_I2C
+#ifdef CONFIG_I2C_REGISTER_MAP
+    i2c_regmap_manager_slave_set_data_to_be_read(p_buf, buf_size);
+#elif CONFIG_COMM_PROTOCOL_I2C
     i2c_manager_slave_set_data_to_be_read(p_buf, buf_size);
 #elif CONFIG_COMM_PROTOCOL_SPI
     spi_manager_slave_set_data_to_be_read(p_buf, buf_size);
+#elif CONFIG_COMM_PROTOCOL_I2C_SPI
+    spi_manager_slave_set_data_to_be_read(p_buf, buf_size);
+#elif CONFIG_COMM_PROTOCOL_SIM
+    sim_manager_slave_set_data_to_be_read(p_buf, buf_size);
+#endif
+}
+
+void comm_manager_set_control_data_to_be_read(uint8_t *p_buf, size_t buf_size)
+{
+#ifdef CONFIG_COMM_PROTOCOL_I2C_SPI
+    i2c_manager_slave_set_data_to_be_read(p_buf, buf_size);
+#else
+    comm_manager_set_data_to_be_read(p_buf, buf_size);
 #endif
 }
 
@@ -62,14 +168,176 @@ bool comm_manager_receive_data(uint8_t *p_buf, size_t buf_size)
 {
     bool b_received_new_input = false;
 
-#ifdef CONFIG_COMM_PROTOCOL_I2C
+#ifdef CONFIG_I2C_REGISTER_MAP
+    b_received_new_input = i2c_regmap_manager_slave_receive_data(p_buf, buf_size);
+#elif CONFIG_COMM_PROTOCOL_I2C
     b_received_new_input = i2c_manager_slave_receive_data(p_buf, buf_size);
 #elif CONFIG_COMM_PROTOCOL_SPI
     b_received_new_input = spi_manager_slave_receive_data(p_buf, buf_size);
+#elif CONFIG_COMM_PROTOCOL_I2C_SPI
+    /* Control plane first, so a status poll isn't held up behind jobs written on the data plane */
+    b_received_new_input = i2c_manager_slave_receive_data(p_buf, buf_size);
+    if (false == b_received_new_input)
+    {
+        b_received_new_input = spi_manager_slave_receive_data(p_buf, buf_size);
+    }
+#elif CONFIG_COMM_PROTOCOL_SIM
+    b_received_new_input = sim_manager_slave_receive_data(p_buf, buf_size);
 #endif
     return b_received_new_input;
 }
 
+void comm_manager_solution_put(const sha256_offset_solution_queue_element_t *p_sha256_offset_solution_queue_element)
+{
+    comm_solution_response_t comm_solution_response = {0};
+
+    /* Without coalescing every solution is sent in its own frame */
+    if (1 == COMM_RESULT_COALESCE_COUNT)
+    {
+        comm_solution_response.message_type = COMM_RESPONSE_SOLUTION;
+        comm_solution_response.sha256_offset_solution_queue_element = *p_sha256_offset_solution_queue_element;
+
+        comm_manager_set_data_to_be_read((uint8_t *)&comm_solution_response, sizeof(comm_solution_response));
+        _comm_manager_status_count(1);
+        return;
+    }
+
+    if (0 == _g_comm_solution_batch.count)
+    {
+        _g_comm_solution_batch_start_ticks = xTaskGetTickCount();
+    }
+
+    _g_comm_solution_batch.sha256_offset_solution_queue_elements[_g_comm_solution_batch.count++] = *p_sha256_offset_solution_queue_element;
+
+    if (COMM_RESULT_COALESCE_COUNT <= _g_comm_solution_batch.count)
+    {
+        _comm_manager_solution_batch_send();
+    }
+}
+
+void comm_manager_progress_put(const sha256_progress_queue_element_t *p_sha256_progress_queue_element)
+{
+    comm_progress_response_t comm_progress_response = {0};
+
+    /* Keep the result order, pending solutions go out first */
+    if (0 != _g_comm_solution_batch.count)
+    {
+        _comm_manager_solution_batch_send();
+    }
+
+    comm_progress_response.message_type = COMM_RESPONSE_PROGRESS;
+    comm_progress_response.sha256_progress_queue_element = *p_sha256_progress_queue_element;
+
+    comm_manager_set_data_to_be_read((uint8_t *)&comm_progress_response, sizeof(comm_progress_response));
+    _comm_manager_status_count(1);
+}
+
+void comm_manager_digest_put(const sha256_stream_digest_queue_element_t *p_sha256_stream_digest_queue_element)
+{
+    comm_digest_response_t comm_digest_response = {0};
+
+    /* Keep the result order, pending solutions go out first */
+    if (0 != _g_comm_solution_batch.count)
+    {
+        _comm_manager_solution_batch_send();
+    }
+
+    comm_digest_response.message_type = COMM_RESPONSE_DIGEST;
+    comm_digest_response.sha256_stream_digest_queue_element = *p_sha256_stream_digest_queue_element;
+
+    comm_manager_set_data_to_be_read((uint8_t *)&comm_digest_response, sizeof(comm_digest_response));
+    _comm_manager_status_count(1);
+}
+
+void comm_manager_proof_put(const sha256_merkle_proof_queue_element_t *p_sha256_merkle_proof_queue_element)
+{
+    comm_proof_response_t comm_proof_response = {0};
+
+    /* Keep the result order, pending solutions go out first */
+    if (0 != _g_comm_solution_batch.count)
+    {
+        _comm_manager_solution_batch_send();
+    }
+
+    comm_proof_response.message_type = COMM_RESPONSE_PROOF;
+    comm_proof_response.sha256_merkle_proof_queue_element = *p_sha256_merkle_proof_queue_element;
+
+    comm_manager_set_data_to_be_read((uint8_t *)&comm_proof_response, sizeof(comm_proof_response));
+    _comm_manager_status_count(1);
+}
+
+void comm_manager_process(void)
+{
+    if ((0 != _g_comm_solution_batch.count) &&
+        ((xTaskGetTickCount() - _g_comm_solution_batch_start_ticks) >= pdMS_TO_TICKS(COMM_RESULT_COALESCE_TIMEOUT_MS)))
+    {
+        _comm_manager_solution_batch_send();
+    }
+}
+
+void comm_manager_get_status(comm_manager_status_t *p_comm_manager_status)
+{
+    *p_comm_manager_status = _g_comm_manager_status;
+}
+
+uint8_t comm_manager_get_transport(void)
+{
+    return COMM_TRANSPORT;
+}
+
+uint8_t comm_manager_get_receive_queue_length(void)
+{
+    return COMM_RECEIVE_QUEUE_LENGTH;
+}
+
 /* ============================== PRIVATE FUNCTION DEFINITIONS */
 
+static void _comm_manager_solution_batch_send(void)
+{
+    uint8_t count = _g_comm_solution_batch.count;
+
+    /* Only the pending solutions are sent, the master reads the count before the solutions */
+    _g_comm_solution_batch.message_type = COMM_RESPONSE_SOLUTION_BATCH;
+    comm_manager_set_data_to_be_read((uint8_t *)&_g_comm_solution_batch,
+        offsetof(comm_solution_batch_response_t, sha256_offset_solution_queue_elements) + (count * sizeof(sha256_offset_solution_queue_element_t)));
+
+    _g_comm_solution_batch.count = 0;
+    _comm_manager_status_count(count);
+}
+
+static void _comm_manager_status_count(uint8_t results)
+{
+    _g_comm_manager_status.results_sent += results;
+    _g_comm_manager_status.result_frames_sent++;
+    _g_comm_manager_status.results_per_frame_last = results;
+    if (results > _g_comm_manager_status.results_per_frame_max)
+    {
+        _g_comm_manager_status.results_per_frame_max = results;
+    }
+}
+
+#if defined(CONFIG_COMM_PROTOCOL_SPI) || defined(CONFIG_COMM_PROTOCOL_I2C_SPI)
+static void _comm_manager_stream_frame(const uint8_t *p_frame, size_t frame_size)
+{
+    const comm_stream_frame_t *p_comm_stream_frame = (const comm_stream_frame_t *)p_frame;
+    size_t header_size = offsetof(comm_stream_frame_t, data);
+
+    if (frame_size < header_size)
+    {
+        ESP_LOGW(LOG_TAG, "Stream frame of %u bytes has no header!", (unsigned int)frame_size);
+        return;
+    }
+
+    /* A frame shorter than its data size was cut off, the stream reports it as lost */
+    if ((p_comm_stream_frame->data_size > COMM_STREAM_FRAME_DATA_SIZE) || (p_comm_stream_frame->data_size > (frame_size - header_size)))
+    {
+        ESP_LOGW(LOG_TAG, "Stream frame %u cut off!", p_comm_stream_frame->sequence);
+        sha256_stream_frame(p_comm_stream_frame->puzzle_id, p_comm_stream_frame->flags, p_comm_stream_frame->sequence, NULL, 0);
+        return;
+    }
+
+    sha256_stream_frame(p_comm_stream_frame->puzzle_id, p_comm_stream_frame->flags, p_comm_stream_frame->sequence, p_comm_stream_frame->data, p_comm_stream_frame->data_size);
+}
+#endif
+
 /* ============================== INTERRUPT FUNCTION DEFINITIONS */
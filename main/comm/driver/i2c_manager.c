@@ -15,8 +15,9 @@
 #include "driver/i2c_slave.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
-#include "freertos/queue.h"
 #include "gpio/gpio_manager.h"
+#include "profiler.h"
+#include "spsc_ring.h"
 
 /* ============================== MACRO DEFINITIONS */
 
@@ -71,6 +72,9 @@ static i2c_slave_config_t _g_i2c_slave_config =
     .intr_priority = 3,                             //! Interrupt priority (highest)
     .i2c_port = I2C_NUM_0,                          //! I2C port 0
     .flags.enable_internal_pullup = 0,              //! Disable internal pullups
+#ifdef CONFIG_I2C_GENERAL_CALL
+    .flags.broadcast_en = 1,                        //! Accept general call writes
+#endif
 };
 
 /** @brief I2C slave handle. */
@@ -79,8 +83,11 @@ static i2c_slave_dev_handle_t _g_i2c_slave_handle = NULL;
 /** @brief I2C read done semaphore handle */
 static SemaphoreHandle_t _g_sem_i2c_on_request_done = NULL;
 
-/** @brief I2C on receive queue handle */
-static QueueHandle_t _g_queue_i2c_on_receive = NULL;
+/** @brief I2C on receive ring buffer, produced by the on receive ISR callback */
+static spsc_ring_t _g_ring_i2c_on_receive = {0};
+
+/** @brief I2C on receive ring buffer storage */
+static uint8_t *_gp_ring_i2c_on_receive_storage = NULL;
 
 /** @brief I2C on receive queue length */
 static int _g_queue_i2c_on_receive_length = 0;
@@ -111,10 +118,16 @@ void i2c_manager_slave_init(int on_receive_queue_length, int on_receive_queue_it
         abort();
     }
 
-    _g_queue_i2c_on_receive = xQueueCreate(_g_queue_i2c_on_receive_length, _g_queue_i2c_on_receive_item_size);
-    if (NULL == _g_queue_i2c_on_receive)
+    _gp_ring_i2c_on_receive_storage = malloc(_g_queue_i2c_on_receive_length * _g_queue_i2c_on_receive_item_size);
+    if (NULL == _gp_ring_i2c_on_receive_storage)
+    {
+        ESP_LOGE(LOG_TAG, "Failed to allocate ring buffer storage for I2C on receive. Aborting!");
+        abort();
+    }
+
+    if (false == spsc_ring_init(&_g_ring_i2c_on_receive, _gp_ring_i2c_on_receive_storage, _g_queue_i2c_on_receive_length, _g_queue_i2c_on_receive_item_size))
     {
-        ESP_LOGE(LOG_TAG, "Failed to create queue for I2C on receive. Aborting!");
+        ESP_LOGE(LOG_TAG, "Failed to create ring buffer for I2C on receive, length must be a power of two. Aborting!");
         abort();
     }
 
@@ -134,10 +147,16 @@ void i2c_manager_slave_set_data_to_be_read(uint8_t *p_buf, size_t buf_size)
     /* Send the data to the FIFO transmit buffer */
     ESP_ERROR_CHECK(i2c_slave_write(_g_i2c_slave_handle, p_buf, buf_size, &write_len, SEND_BUF_TRANSMIT_TIMEOUT_MS));
 
-    /* Signalize data ready to master */
+    /* Signalize data ready to master, as the control plane on its own line so the master reads this bus */
+#ifdef CONFIG_COMM_PROTOCOL_I2C_SPI
+    gpio_set_control_interrupt_out();
+    vTaskDelay(10 / portTICK_PERIOD_MS);
+    gpio_reset_control_interrupt_out();
+#else
     gpio_set_interrupt_out();
     vTaskDelay(10 / portTICK_PERIOD_MS);
     gpio_reset_interrupt_out();
+#endif
 
     /* Wait for ISR to signalize a master request */
     xSemaphoreTake(_g_sem_i2c_on_request_done, portMAX_DELAY);
@@ -146,7 +165,6 @@ void i2c_manager_slave_set_data_to_be_read(uint8_t *p_buf, size_t buf_size)
 bool i2c_manager_slave_receive_data(uint8_t *p_buf, size_t buf_size)
 {
     bool b_received_data = false;
-    BaseType_t ret = errQUEUE_EMPTY;
 
     if (buf_size != _g_queue_i2c_on_receive_item_size)
     {
@@ -155,8 +173,7 @@ bool i2c_manager_slave_receive_data(uint8_t *p_buf, size_t buf_size)
     }
 
     /* Check if ISR put data */
-    ret = xQueueReceive(_g_queue_i2c_on_receive, p_buf, 0);
-    if (pdPASS == ret) b_received_data = true;
+    b_received_data = spsc_ring_pop(&_g_ring_i2c_on_receive, p_buf);
 
     return b_received_data;
 }
@@ -169,6 +186,7 @@ static bool _i2c_slave_on_request_callback(i2c_slave_dev_handle_t i2c_slave_hand
 {
     BaseType_t higher_priority_task_woken = pdFALSE;
     bool b_require_context_switch = false;
+    PROFILER_START(start);
 
     xSemaphoreGiveFromISR(_g_sem_i2c_on_request_done, &higher_priority_task_woken);
 
@@ -177,20 +195,20 @@ static bool _i2c_slave_on_request_callback(i2c_slave_dev_handle_t i2c_slave_hand
         b_require_context_switch = true;
     }
 
+    PROFILER_STOP(PROFILER_STAGE_I2C_ON_REQUEST, start);
+
     return b_require_context_switch;
 }
 
 static bool _i2c_slave_on_receive_callback(i2c_slave_dev_handle_t i2c_slave_handle, const i2c_slave_rx_done_event_data_t *p_event_data, void *p_user_data)
 {
-    BaseType_t higher_priority_task_woken = pdFALSE;
     bool b_require_context_switch = false;
+    PROFILER_START(start);
 
-    xQueueSendToBackFromISR(_g_queue_i2c_on_receive, p_event_data->buffer, &higher_priority_task_woken);
+    /* Consumer polls the ring buffer, no task needs to be woken. Data is dropped if the ring buffer is full. */
+    spsc_ring_push(&_g_ring_i2c_on_receive, p_event_data->buffer);
 
-    if (higher_priority_task_woken == pdTRUE)
-    {
-        b_require_context_switch = true;
-    }
+    PROFILER_STOP(PROFILER_STAGE_I2C_ON_RECEIVE, start);
 
     return b_require_context_switch;
 }
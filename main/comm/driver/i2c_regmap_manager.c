@@ -0,0 +1,381 @@
+/**
+ * @file i2c_regmap_manager.c
+ * @author Iwan Ćulumović
+ * @brief I2C register map manager module. The master selects a register by writing its address and reads it in the
+ * same transaction after a repeated start, or in a later one. Writes to the job slot register carry a master frame.
+ * 
+ * The I2C slave driver write isn't ISR safe, so the on request callback only wakes a high priority responder task that
+ * copies the selected register into the send buffer while the master is held by clock stretching. Results are queued
+ * in a FIFO the master polls, no interrupt out GPIO is needed.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/* ============================== INCLUDES */
+
+#include <string.h>
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "comm/driver/i2c_regmap_manager.h"
+#include "comm/comm_protocol.h"
+#include "driver/i2c_slave.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "profiler.h"
+#include "spsc_ring.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Log tag. */
+#define LOG_TAG                                 ("I2C_REGMAP")
+
+/** @brief Send buffer depth. */
+#define SEND_BUF_DEPTH                          (256)
+
+/** @brief Receive buffer depth. */
+#define RECEIVE_BUF_DEPTH                       (256)
+
+/** @brief Send buffer transmit timeout. */
+#define SEND_BUF_TRANSMIT_TIMEOUT_MS            (10)
+
+/** @brief Register address size in bytes, the first byte of every master write. */
+#define REGISTER_ADDRESS_SIZE                   (1)
+
+/** @brief Value read from an unknown register. */
+#define REGISTER_UNKNOWN_VALUE                  (0xFF)
+
+/** @brief Ticks to wait before retrying a put into a full result FIFO. */
+#define RESULT_QUEUE_FULL_RETRY_TICKS           (1)
+
+/** @brief Responder task stack depth. */
+#define TASK_RESPONDER_STACK_DEPTH              (2048)
+
+/** @brief Responder task priority. Must be higher than other tasks. */
+#define TASK_RESPONDER_PRIORITY                 (1)
+
+/* ============================== TYPE DEFINITIONS */
+
+/**
+ * @brief Register map counters, each counter has a single writer.
+ * 
+ */
+typedef struct {
+    volatile uint32_t jobs_received;            //! Written by the on receive callback
+    volatile uint32_t jobs_dropped;             //! Written by the on receive callback
+    volatile uint32_t results_queued;           //! Written by the result FIFO producer
+    volatile uint32_t results_read;             //! Written by the responder task
+    volatile uint32_t register_reads;           //! Written by the responder task
+} i2c_regmap_counters_t;
+
+/* ============================== PRIVATE FUNCTION DECLARATIONS */
+
+/**
+ * @brief Task that writes the selected register into the send buffer on every master read request.
+ * 
+ * @param p_task_params Task parameters (not used).
+ */
+static void _i2c_regmap_responder_task(void *p_task_params);
+
+/**
+ * @brief Copies the value of a register into the staging buffer.
+ * 
+ * @param reg Register address.
+ * 
+ * @return size_t Number of bytes staged.
+ */
+static size_t _i2c_regmap_register_stage(uint8_t reg);
+
+/**
+ * @brief I2C on request callback.
+ * 
+ * @param i2c_slave_handle I2C slave handle of the I2C controller that caused the interrupt.
+ * @param p_event_data I2C slave capture event data.
+ * @param p_user_data User passed data on registration.
+ * @return bool Returns true if a context switch is needed.
+ */
+static bool _i2c_slave_on_request_callback(i2c_slave_dev_handle_t i2c_slave_handle, const i2c_slave_request_event_data_t *p_event_data, void *p_user_data);
+
+/**
+ * @brief I2C on receive callback.
+ * 
+ * @param i2c_slave_handle I2C slave handle of the I2C controller that caused the interrupt.
+ * @param p_event_data I2C slave capture event data.
+ * @param p_user_data User passed data on registration.
+ * @return bool Returns true if a context switch is needed.
+ */
+static bool _i2c_slave_on_receive_callback(i2c_slave_dev_handle_t i2c_slave_handle, const i2c_slave_rx_done_event_data_t *p_event_data, void *p_user_data);
+
+/* ============================== PRIVATE VARIABLES */
+
+/** @brief I2C slave configuration. */
+static i2c_slave_config_t _g_i2c_slave_config =
+{
+    .addr_bit_len = I2C_ADDR_BIT_LEN_7,             //! 7 bit address length
+    .slave_addr = CONFIG_I2C_SLAVE_ADDRESS,         //! Slave address
+    .sda_io_num = CONFIG_I2C_SDA_GPIO,              //! SDA GPIO
+    .scl_io_num = CONFIG_I2C_SCL_GPIO,              //! SCL GPIO
+    .clk_source = I2C_CLK_SRC_APB,                  //! APB clock source
+    .send_buf_depth = SEND_BUF_DEPTH,               //! Transmit buffer ring buffer depth
+    .receive_buf_depth = RECEIVE_BUF_DEPTH,         //! Receive buffer depth
+    .intr_priority = 3,                             //! Interrupt priority (highest)
+    .i2c_port = I2C_NUM_0,                          //! I2C port 0
+    .flags.enable_internal_pullup = 0,              //! Disable internal pullups
+#ifdef CONFIG_I2C_GENERAL_CALL
+    .flags.broadcast_en = 1,                        //! Accept general call writes
+#endif
+};
+
+/** @brief I2C slave handle. */
+static i2c_slave_dev_handle_t _g_i2c_slave_handle = NULL;
+
+/** @brief Responder task handle. */
+static TaskHandle_t _g_task_handle_responder = NULL;
+
+/** @brief Selected register, written by the on receive callback. */
+static volatile uint8_t _g_i2c_regmap_selected_register = COMM_I2C_REG_STATUS;
+
+/** @brief Job slots, produced by the on receive callback. */
+static spsc_ring_t _g_ring_i2c_regmap_jobs = {0};
+
+/** @brief Job slots storage. */
+static uint8_t *_gp_ring_i2c_regmap_jobs_storage = NULL;
+
+/** @brief Number of job slots. */
+static int _g_i2c_regmap_job_queue_length = 0;
+
+/** @brief Job slot size. */
+static int _g_i2c_regmap_job_size = 0;
+
+/** @brief Result FIFO, consumed by the responder task. */
+static spsc_ring_t _g_ring_i2c_regmap_results = {0};
+
+/** @brief Result FIFO storage. */
+static uint8_t *_gp_ring_i2c_regmap_results_storage = NULL;
+
+/** @brief Result frame size. */
+static int _g_i2c_regmap_result_size = 0;
+
+/** @brief Result frame being put into the result FIFO, producer side only. */
+static uint8_t *_gp_i2c_regmap_result_frame = NULL;
+
+/** @brief Register value staged for the send buffer, responder task only. */
+static uint8_t *_gp_i2c_regmap_staging_buf = NULL;
+
+/** @brief Register map counters. */
+static i2c_regmap_counters_t _g_i2c_regmap_counters = {0};
+
+/** @brief I2C slave event callbacks. */
+static i2c_slave_event_callbacks_t _g_i2c_slave_event_callbacks =
+{
+    .on_request = _i2c_slave_on_request_callback,
+    .on_receive = _i2c_slave_on_receive_callback,
+};
+
+/* ============================== PUBLIC VARIABLES */
+
+/* ============================== PUBLIC FUNCTION DEFINITIONS */
+
+void i2c_regmap_manager_slave_init(int job_queue_length, int job_size, int result_queue_length, int result_size)
+{
+    BaseType_t result = pdPASS;
+    size_t staging_size = 0;
+
+    _g_i2c_regmap_job_queue_length = job_queue_length;
+    _g_i2c_regmap_job_size = job_size;
+    _g_i2c_regmap_result_size = result_size;
+
+    /* Job slots are copied straight out of the receive buffer, after the register address */
+    if ((REGISTER_ADDRESS_SIZE + job_size) > RECEIVE_BUF_DEPTH)
+    {
+        ESP_LOGE(LOG_TAG, "Job size doesn't fit the receive buffer. Aborting!");
+        abort();
+    }
+
+    _gp_ring_i2c_regmap_jobs_storage = malloc(job_queue_length * job_size);
+    _gp_ring_i2c_regmap_results_storage = malloc(result_queue_length * result_size);
+    _gp_i2c_regmap_result_frame = calloc(1, result_size);
+    staging_size = ((size_t)result_size > sizeof(comm_i2c_counters_register_t)) ? (size_t)result_size : sizeof(comm_i2c_counters_register_t);
+    _gp_i2c_regmap_staging_buf = calloc(1, staging_size);
+    if ((NULL == _gp_ring_i2c_regmap_jobs_storage) || (NULL == _gp_ring_i2c_regmap_results_storage) ||
+        (NULL == _gp_i2c_regmap_result_frame) || (NULL == _gp_i2c_regmap_staging_buf))
+    {
+        ESP_LOGE(LOG_TAG, "Failed to allocate register map buffers. Aborting!");
+        abort();
+    }
+
+    if ((false == spsc_ring_init(&_g_ring_i2c_regmap_jobs, _gp_ring_i2c_regmap_jobs_storage, job_queue_length, job_size)) ||
+        (false == spsc_ring_init(&_g_ring_i2c_regmap_results, _gp_ring_i2c_regmap_results_storage, result_queue_length, result_size)))
+    {
+        ESP_LOGE(LOG_TAG, "Failed to create ring buffers for register map, lengths must be a power of two. Aborting!");
+        abort();
+    }
+
+    /* Responder must exist before the callbacks can wake it */
+    result = xTaskCreate(_i2c_regmap_responder_task, "I2C_RESPOND", TASK_RESPONDER_STACK_DEPTH, NULL, TASK_RESPONDER_PRIORITY, &_g_task_handle_responder);
+    if (pdPASS != result)
+    {
+        ESP_LOGE(LOG_TAG, "Failed to create task for I2C register map responder. Aborting!");
+        abort();
+    }
+
+    ESP_ERROR_CHECK(i2c_new_slave_device(&_g_i2c_slave_config, &_g_i2c_slave_handle));
+    ESP_ERROR_CHECK(i2c_slave_register_event_callbacks(_g_i2c_slave_handle, &_g_i2c_slave_event_callbacks, NULL));
+
+    ESP_LOGI(LOG_TAG, "Initialized register map slave with address %x, on GPIO SDA %d and SCL %d, %d job slots, %d result FIFO entries.",
+        CONFIG_I2C_SLAVE_ADDRESS,
+        CONFIG_I2C_SDA_GPIO,
+        CONFIG_I2C_SCL_GPIO,
+        job_queue_length,
+        result_queue_length);
+}
+
+void i2c_regmap_manager_slave_set_data_to_be_read(uint8_t *p_buf, size_t buf_size)
+{
+    if (buf_size > _g_i2c_regmap_result_size)
+    {
+        ESP_LOGE(LOG_TAG, "Buffer size to be written into is too small. Aborting!");
+        abort();
+    }
+
+    memset(_gp_i2c_regmap_result_frame, 0, _g_i2c_regmap_result_size);
+    memcpy(_gp_i2c_regmap_result_frame, p_buf, buf_size);
+
+    while (false == spsc_ring_push(&_g_ring_i2c_regmap_results, _gp_i2c_regmap_result_frame))
+    {
+        vTaskDelay(RESULT_QUEUE_FULL_RETRY_TICKS);
+    }
+
+    _g_i2c_regmap_counters.results_queued++;
+}
+
+bool i2c_regmap_manager_slave_receive_data(uint8_t *p_buf, size_t buf_size)
+{
+    if (buf_size != _g_i2c_regmap_job_size)
+    {
+        ESP_LOGE(LOG_TAG, "Buffer size to be read doesn't match. Aborting!");
+        abort();
+    }
+
+    /* Check if ISR put data */
+    return spsc_ring_pop(&_g_ring_i2c_regmap_jobs, p_buf);
+}
+
+/* ============================== PRIVATE FUNCTION DEFINITIONS */
+
+static void _i2c_regmap_responder_task(void *p_task_params)
+{
+    uint32_t write_len = 0;
+    size_t staged_size = 0;
+
+    while (1)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        staged_size = _i2c_regmap_register_stage(_g_i2c_regmap_selected_register);
+        _g_i2c_regmap_counters.register_reads++;
+
+        /* Master is waiting with the clock stretched, a full send buffer means it stopped reading */
+        if (ESP_OK != i2c_slave_write(_g_i2c_slave_handle, _gp_i2c_regmap_staging_buf, staged_size, &write_len, SEND_BUF_TRANSMIT_TIMEOUT_MS))
+        {
+            ESP_LOGW(LOG_TAG, "Failed to write register 0x%02X to the send buffer.", _g_i2c_regmap_selected_register);
+        }
+    }
+}
+
+static size_t _i2c_regmap_register_stage(uint8_t reg)
+{
+    comm_i2c_status_register_t status_register = {0};
+    comm_i2c_counters_register_t counters_register = {0};
+    uint32_t job_slots_used = 0;
+    size_t staged_size = 0;
+
+    switch (reg)
+    {
+        case COMM_I2C_REG_STATUS:
+            job_slots_used = spsc_ring_count(&_g_ring_i2c_regmap_jobs);
+            status_register.result_count = (uint8_t)spsc_ring_count(&_g_ring_i2c_regmap_results);
+            status_register.job_slots_free = (uint8_t)(_g_i2c_regmap_job_queue_length - job_slots_used);
+            memcpy(_gp_i2c_regmap_staging_buf, &status_register, sizeof(status_register));
+            staged_size = sizeof(status_register);
+            break;
+
+        case COMM_I2C_REG_RESULT:
+            if (true == spsc_ring_pop(&_g_ring_i2c_regmap_results, _gp_i2c_regmap_staging_buf))
+            {
+                _g_i2c_regmap_counters.results_read++;
+            }
+            else
+            {
+                memset(_gp_i2c_regmap_staging_buf, 0, _g_i2c_regmap_result_size);
+                _gp_i2c_regmap_staging_buf[0] = COMM_RESPONSE_NONE;
+            }
+            staged_size = _g_i2c_regmap_result_size;
+            break;
+
+        case COMM_I2C_REG_COUNTERS:
+            counters_register.jobs_received = _g_i2c_regmap_counters.jobs_received;
+            counters_register.jobs_dropped = _g_i2c_regmap_counters.jobs_dropped;
+            counters_register.results_queued = _g_i2c_regmap_counters.results_queued;
+            counters_register.results_read = _g_i2c_regmap_counters.results_read;
+            counters_register.register_reads = _g_i2c_regmap_counters.register_reads;
+            memcpy(_gp_i2c_regmap_staging_buf, &counters_register, sizeof(counters_register));
+            staged_size = sizeof(counters_register);
+            break;
+
+        default:
+            _gp_i2c_regmap_staging_buf[0] = REGISTER_UNKNOWN_VALUE;
+            staged_size = 1;
+            break;
+    }
+
+    return staged_size;
+}
+
+/* ============================== INTERRUPT FUNCTION DEFINITIONS */
+
+static bool _i2c_slave_on_request_callback(i2c_slave_dev_handle_t i2c_slave_handle, const i2c_slave_request_event_data_t *p_event_data, void *p_user_data)
+{
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    bool b_require_context_switch = false;
+    PROFILER_START(start);
+
+    vTaskNotifyGiveFromISR(_g_task_handle_responder, &higher_priority_task_woken);
+
+    if (higher_priority_task_woken == pdTRUE)
+    {
+        b_require_context_switch = true;
+    }
+
+    PROFILER_STOP(PROFILER_STAGE_I2C_ON_REQUEST, start);
+
+    return b_require_context_switch;
+}
+
+static bool _i2c_slave_on_receive_callback(i2c_slave_dev_handle_t i2c_slave_handle, const i2c_slave_rx_done_event_data_t *p_event_data, void *p_user_data)
+{
+    bool b_require_context_switch = false;
+    PROFILER_START(start);
+
+    if (REGISTER_ADDRESS_SIZE <= p_event_data->length)
+    {
+        _g_i2c_regmap_selected_register = p_event_data->buffer[0];
+
+        /* Anything after the job slot register address is a master frame, shorter frames are padded with stale bytes */
+        if ((COMM_I2C_REG_JOB == p_event_data->buffer[0]) && (REGISTER_ADDRESS_SIZE < p_event_data->length))
+        {
+            if (true == spsc_ring_push(&_g_ring_i2c_regmap_jobs, &p_event_data->buffer[REGISTER_ADDRESS_SIZE]))
+            {
+                _g_i2c_regmap_counters.jobs_received++;
+            }
+            else
+            {
+                _g_i2c_regmap_counters.jobs_dropped++;
+            }
+        }
+    }
+
+    PROFILER_STOP(PROFILER_STAGE_I2C_ON_RECEIVE, start);
+
+    return b_require_context_switch;
+}
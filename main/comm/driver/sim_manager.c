@@ -0,0 +1,149 @@
+/**
+ * @file sim_manager.c
+ * @author Iwan Ćulumović
+ * @brief Simulated transport manager module. Replaces the I2C and SPI slave with in memory queues on the Linux target,
+ * the master side is driven by the host benchmark.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/* ============================== INCLUDES */
+
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "comm/driver/sim_manager.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Log tag. */
+#define LOG_TAG                                 ("SIM_MANAGER")
+
+/* ============================== TYPE DEFINITIONS */
+
+/* ============================== PRIVATE FUNCTION DECLARATIONS */
+
+/* ============================== PRIVATE VARIABLES */
+
+/** @brief Master writes not yet read by the slave. */
+static QueueHandle_t _g_queue_sim_receive = NULL;
+
+/** @brief Data set to be read by the master. */
+static uint8_t *_gp_sim_send_buf = NULL;
+
+/** @brief Size of the data master writes. */
+static size_t _g_sim_receive_data_size = 0;
+
+/** @brief Size of the data master reads. */
+static size_t _g_sim_send_data_size = 0;
+
+/** @brief Data set to be read semaphore handle. */
+static SemaphoreHandle_t _g_sem_sim_data_ready = NULL;
+
+/** @brief Data read by master semaphore handle. */
+static SemaphoreHandle_t _g_sem_sim_data_read = NULL;
+
+/* ============================== PUBLIC VARIABLES */
+
+/* ============================== PUBLIC FUNCTION DEFINITIONS */
+
+void sim_manager_slave_init(int receive_queue_length, size_t receive_data_size, size_t send_data_size)
+{
+    _g_sim_receive_data_size = receive_data_size;
+    _g_sim_send_data_size = send_data_size;
+
+    _g_queue_sim_receive = xQueueCreate(receive_queue_length, receive_data_size);
+    if (NULL == _g_queue_sim_receive)
+    {
+        ESP_LOGE(LOG_TAG, "Failed to create queue for simulated receive. Aborting!");
+        abort();
+    }
+
+    _gp_sim_send_buf = calloc(1, send_data_size);
+    if (NULL == _gp_sim_send_buf)
+    {
+        ESP_LOGE(LOG_TAG, "Failed to allocate simulated send buffer. Aborting!");
+        abort();
+    }
+
+    _g_sem_sim_data_ready = xSemaphoreCreateBinary();
+    _g_sem_sim_data_read = xSemaphoreCreateBinary();
+    if ((NULL == _g_sem_sim_data_ready) || (NULL == _g_sem_sim_data_read))
+    {
+        ESP_LOGE(LOG_TAG, "Failed to create binary semaphores for simulated transport. Aborting!");
+        abort();
+    }
+
+    ESP_LOGI(LOG_TAG, "Initialized simulated slave.");
+}
+
+void sim_manager_slave_set_data_to_be_read(uint8_t *p_buf, size_t buf_size)
+{
+    if (buf_size > _g_sim_send_data_size)
+    {
+        ESP_LOGE(LOG_TAG, "Buffer size to be written into is too small. Aborting!");
+        abort();
+    }
+
+    memcpy(_gp_sim_send_buf, p_buf, buf_size);
+
+    /* Signalize data ready to master and wait until it's read, same as the interrupt out line and the read request */
+    xSemaphoreGive(_g_sem_sim_data_ready);
+    xSemaphoreTake(_g_sem_sim_data_read, portMAX_DELAY);
+}
+
+bool sim_manager_slave_receive_data(uint8_t *p_buf, size_t buf_size)
+{
+    if (buf_size != _g_sim_receive_data_size)
+    {
+        ESP_LOGE(LOG_TAG, "Buffer size to be read doesn't match. Aborting!");
+        abort();
+    }
+
+    return (pdTRUE == xQueueReceive(_g_queue_sim_receive, p_buf, 0));
+}
+
+void sim_manager_master_write(const uint8_t *p_buf, size_t buf_size)
+{
+    uint8_t *p_item = NULL;
+
+    if (buf_size > _g_sim_receive_data_size)
+    {
+        ESP_LOGE(LOG_TAG, "Buffer size to be written is too large. Aborting!");
+        abort();
+    }
+
+    /* Unused trailing bytes of the item are zero, as if the master wrote a shorter frame */
+    p_item = calloc(1, _g_sim_receive_data_size);
+    if (NULL == p_item)
+    {
+        ESP_LOGE(LOG_TAG, "Failed to allocate simulated write. Aborting!");
+        abort();
+    }
+
+    memcpy(p_item, p_buf, buf_size);
+    xQueueSend(_g_queue_sim_receive, p_item, portMAX_DELAY);
+    free(p_item);
+}
+
+bool sim_manager_master_read(uint8_t *p_buf, size_t buf_size, TickType_t timeout_ticks)
+{
+    if (pdTRUE != xSemaphoreTake(_g_sem_sim_data_ready, timeout_ticks))
+    {
+        return false;
+    }
+
+    memcpy(p_buf, _gp_sim_send_buf, (buf_size < _g_sim_send_data_size) ? buf_size : _g_sim_send_data_size);
+    xSemaphoreGive(_g_sem_sim_data_read);
+
+    return true;
+}
+
+/* ============================== PRIVATE FUNCTION DEFINITIONS */
+
+/* ============================== INTERRUPT FUNCTION DEFINITIONS */
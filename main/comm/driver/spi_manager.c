@@ -17,6 +17,7 @@
 #include "freertos/semphr.h"
 #include "freertos/queue.h"
 #include "gpio/gpio_manager.h"
+#include "profiler.h"
 
 /* ============================== MACRO DEFINITIONS */
 
@@ -26,14 +27,11 @@
 /** @brief SPI transaction queue size. */
 #define TRANSACTION_QUEUE_SIZE                          (32)
 
-/** @brief SPI transaction size. */
-#define TRANSACTION_SIZE                                (40)
+/** @brief SPI master command size, the first byte of every transaction. */
+#define COMMAND_SIZE                                    (1)
 
-/** @brief SPI receive buffer size. */
-#define RX_BUF_SIZE                                     (39)
-
-/** @brief SPI transmit buffer size. */
-#define TX_BUF_SIZE                                     (5)
+/** @brief SPI transaction size alignment required by DMA. */
+#define TRANSACTION_SIZE_ALIGNMENT                      (4)
 
 /** @brief SPI master command request data write. */
 #define SPI_MASTER_CMD_REQUEST_DATA_WRITE               (0x11)
@@ -47,8 +45,14 @@
 /** @brief SPI master command read data. */
 #define SPI_MASTER_CMD_DATA_READ                        (0x44)
 
-/** @brief SPI transaction enqueue task stack depth. */
-#define TRANSACTION_ENQUEUE_CONTROL_STACK_DEPTH         (2048)
+/** @brief SPI master command write stream frame. */
+#define SPI_MASTER_CMD_STREAM_WRITE                     (0x55)
+
+/** @brief Number of SPI receive buffers, the next stream frame is received into one while the other one is hashed. */
+#define RX_BUFFER_COUNT                                 (2)
+
+/** @brief SPI transaction enqueue task stack depth. Stream frames are hashed and logged in this task. */
+#define TRANSACTION_ENQUEUE_CONTROL_STACK_DEPTH         (3072)
 
 /** @brief SPI transaction enqueue task priority. Must be higher than other tasks. */
 #define TRANSACTION_ENQUEUE_CONTROL_PRIORITY            (1)
@@ -98,28 +102,35 @@ static spi_slave_interface_config_t _g_spi_slave_interface_config =
 /** @brief DMA channel for SPI. */
 static spi_dma_chan_t _g_spi_dma_chan = SPI_DMA_CH1;
 
-/** @brief SPI data receive buffer for transaction. */
-static volatile uint8_t *_gp_spi_rx_buf = NULL;
+/** @brief SPI data receive buffers for transactions. */
+static volatile uint8_t *_gp_spi_rx_bufs[RX_BUFFER_COUNT] = {NULL};
 
 /** @brief SPI data transmit buffer for transaction. */
 static volatile uint8_t *_gp_spi_tx_buf = NULL;
 
 /** @brief SPI data receive copy buffer. */
-static uint8_t _g_spi_rx_buf_copy[RX_BUF_SIZE] = {0};
+static uint8_t *_gp_spi_rx_buf_copy = NULL;
 
 /** @brief SPI data transmit copy buffer. */
-static uint8_t _g_spi_tx_buf_copy[TX_BUF_SIZE] = {0};
+static uint8_t *_gp_spi_tx_buf_copy = NULL;
 
-/** @brief SPI transaction. */
-static spi_slave_transaction_t _g_spi_slave_transaction =
-{
-    .flags = 0,                                     //! No specific flags
-    .length = 0,                                    //! Total data length in bits
-    .trans_len = 0,                                 //! Transaction data length in bits
-    .tx_buffer = NULL,                              //! Pointer to transmit buffer
-    .rx_buffer = NULL,                              //! Pointer to receive buffer
-    .user = NULL,                                   //! Pointer to user data
-};
+/** @brief SPI frame size, command byte and the larger of the receive and send data, aligned for DMA. */
+static size_t _g_spi_frame_size = 0;
+
+/** @brief SPI transaction size, the frame size or the command byte and a stream frame if larger, aligned for DMA. */
+static size_t _g_spi_transaction_size = 0;
+
+/** @brief Size of the data master writes. */
+static size_t _g_spi_receive_data_size = 0;
+
+/** @brief Size of the data master reads. */
+static size_t _g_spi_send_data_size = 0;
+
+/** @brief SPI transactions, one per receive buffer. They share the transmit buffer. */
+static spi_slave_transaction_t _g_spi_slave_transactions[RX_BUFFER_COUNT] = {0};
+
+/** @brief Stream frame callback. */
+static spi_manager_stream_callback_t _g_spi_stream_callback = NULL;
 
 /** @brief SPI enqueue transaction task handle. */
 static TaskHandle_t _g_task_handle_spi_transaction_enqueue = NULL;
@@ -134,29 +145,58 @@ static SemaphoreHandle_t _g_sem_spi_data_written = NULL;
 
 /* ============================== PUBLIC FUNCTION DEFINITIONS */
 
-void spi_manager_slave_init(void)
+void spi_manager_slave_init(size_t receive_data_size, size_t send_data_size, size_t stream_frame_size, spi_manager_stream_callback_t stream_callback)
 {
     BaseType_t result = pdPASS;
+    int i = 0;
+
+    _g_spi_receive_data_size = receive_data_size;
+    _g_spi_send_data_size = send_data_size;
+    _g_spi_stream_callback = stream_callback;
+
+    /* Both buffers span the whole transaction, DMA writes and reads the full transaction length */
+    _g_spi_frame_size = COMMAND_SIZE + ((receive_data_size > send_data_size) ? receive_data_size : send_data_size);
+    _g_spi_frame_size = (_g_spi_frame_size + TRANSACTION_SIZE_ALIGNMENT - 1) & ~(size_t)(TRANSACTION_SIZE_ALIGNMENT - 1);
+
+    /* Master clocks only as many bytes as it needs, so transactions are sized for the largest stream frame */
+    _g_spi_transaction_size = COMMAND_SIZE + stream_frame_size;
+    _g_spi_transaction_size = (_g_spi_transaction_size + TRANSACTION_SIZE_ALIGNMENT - 1) & ~(size_t)(TRANSACTION_SIZE_ALIGNMENT - 1);
+    if (_g_spi_transaction_size < _g_spi_frame_size) _g_spi_transaction_size = _g_spi_frame_size;
+    _g_spi_bus_config.max_transfer_sz = _g_spi_transaction_size;
 
     /* Allocate DMA capable transmit and receive buffers for SPI transactions */
-    _gp_spi_rx_buf = heap_caps_malloc(RX_BUF_SIZE, MALLOC_CAP_DMA);
-    if (NULL == _gp_spi_rx_buf)
+    for (i = 0; i < RX_BUFFER_COUNT; i++)
     {
-        ESP_LOGE(LOG_TAG, "Failed to allocate RX buffer for SPI transaction. Aborting!");
-        abort();
+        _gp_spi_rx_bufs[i] = heap_caps_malloc(_g_spi_transaction_size, MALLOC_CAP_DMA);
+        if (NULL == _gp_spi_rx_bufs[i])
+        {
+            ESP_LOGE(LOG_TAG, "Failed to allocate RX buffer for SPI transaction. Aborting!");
+            abort();
+        }
     }
 
-    _gp_spi_tx_buf = heap_caps_malloc(TX_BUF_SIZE, MALLOC_CAP_DMA);
+    _gp_spi_tx_buf = heap_caps_calloc(1, _g_spi_transaction_size, MALLOC_CAP_DMA);
     if (NULL == _gp_spi_tx_buf)
     {
         ESP_LOGE(LOG_TAG, "Failed to allocate TX buffer for SPI transaction. Aborting!");
         abort();
     }
 
+    _gp_spi_rx_buf_copy = calloc(1, _g_spi_frame_size);
+    _gp_spi_tx_buf_copy = calloc(1, _g_spi_frame_size);
+    if ((NULL == _gp_spi_rx_buf_copy) || (NULL == _gp_spi_tx_buf_copy))
+    {
+        ESP_LOGE(LOG_TAG, "Failed to allocate copy buffers for SPI transaction. Aborting!");
+        abort();
+    }
+
     /* Fill transaction information */
-    _g_spi_slave_transaction.length = TRANSACTION_SIZE * 8;             //! Total transaction length in bits
-    _g_spi_slave_transaction.tx_buffer = (void *)_gp_spi_tx_buf;        //! Pointer to transmit buffer
-    _g_spi_slave_transaction.rx_buffer = (void *)_gp_spi_rx_buf;        //! Pointer to receive buffer
+    for (i = 0; i < RX_BUFFER_COUNT; i++)
+    {
+        _g_spi_slave_transactions[i].length = _g_spi_transaction_size * 8;     //! Total transaction length in bits
+        _g_spi_slave_transactions[i].tx_buffer = (void *)_gp_spi_tx_buf;       //! Pointer to transmit buffer
+        _g_spi_slave_transactions[i].rx_buffer = (void *)_gp_spi_rx_bufs[i];   //! Pointer to receive buffer
+    }
 
     /* Initialize semaphores */
     _g_sem_spi_data_read = xSemaphoreCreateBinary();
@@ -177,19 +217,19 @@ void spi_manager_slave_init(void)
         abort();
     }
 
-    ESP_LOGI(LOG_TAG, "Initialized slave.");
+    ESP_LOGI(LOG_TAG, "Initialized slave with %u byte frames and %u byte transactions.", (unsigned int)_g_spi_frame_size, (unsigned int)_g_spi_transaction_size);
 }
 
 void spi_manager_slave_set_data_to_be_read(uint8_t *p_buf, size_t buf_size)
 {
-    if (buf_size > TX_BUF_SIZE)
+    if (buf_size > _g_spi_send_data_size)
     {
         ESP_LOGE(LOG_TAG, "Buffer size to be written into is too small. Aborting!");
         abort();
     }
 
     /* Prepare data to be read */
-    memcpy(_g_spi_tx_buf_copy, p_buf, buf_size);
+    memcpy(_gp_spi_tx_buf_copy, p_buf, buf_size);
 
     /* Signalize data ready to master */
     gpio_set_interrupt_out();
@@ -204,7 +244,7 @@ bool spi_manager_slave_receive_data(uint8_t *p_buf, size_t buf_size)
     bool b_received_data = false;
     BaseType_t ret = pdFALSE;
 
-    if (buf_size > (RX_BUF_SIZE - 1))
+    if (buf_size > _g_spi_receive_data_size)
     {
         ESP_LOGE(LOG_TAG, "Buffer size to be read from is too small. Aborting!");
         abort();
@@ -216,7 +256,7 @@ bool spi_manager_slave_receive_data(uint8_t *p_buf, size_t buf_size)
         b_received_data = true;
 
         /* Receive written data */
-        memcpy(p_buf, &_g_spi_rx_buf_copy[1], buf_size);
+        memcpy(p_buf, &_gp_spi_rx_buf_copy[COMMAND_SIZE], buf_size);
     }
 
     return b_received_data;
@@ -226,35 +266,68 @@ bool spi_manager_slave_receive_data(uint8_t *p_buf, size_t buf_size)
 
 static void _spi_transaction_enqueue_task(void *p_task_params)
 {
+    spi_slave_transaction_t *p_spi_slave_transaction = NULL;
+    volatile uint8_t *p_rx_buf = NULL;
+    size_t received_size = 0;
+    int current = 0;
+    bool b_queued = false;
+
     while (1)
     {
-        /* Queue an SPI transaction */
-        ESP_ERROR_CHECK(spi_slave_transmit(_g_spi_host_device, &_g_spi_slave_transaction, portMAX_DELAY));
+        /* Queue an SPI transaction, unless it was queued while the last stream frame was handled */
+        if (false == b_queued)
+        {
+            ESP_ERROR_CHECK(spi_slave_queue_trans(_g_spi_host_device, &_g_spi_slave_transactions[current], portMAX_DELAY));
+        }
+        ESP_ERROR_CHECK(spi_slave_get_trans_result(_g_spi_host_device, &p_spi_slave_transaction, portMAX_DELAY));
+        b_queued = false;
+
+        PROFILER_START(start);
+
+        p_rx_buf = p_spi_slave_transaction->rx_buffer;
+
+        /* If a stream frame was written */
+        if (SPI_MASTER_CMD_STREAM_WRITE == p_rx_buf[0])
+        {
+            /* Receive the next frame into the other buffer while this one is hashed. The transmit buffer isn't touched
+               while the next transaction is queued, the master reads only after a read request. */
+            current = (current + 1) % RX_BUFFER_COUNT;
+            ESP_ERROR_CHECK(spi_slave_queue_trans(_g_spi_host_device, &_g_spi_slave_transactions[current], portMAX_DELAY));
+            b_queued = true;
+
+            received_size = p_spi_slave_transaction->trans_len / 8;
+            if ((received_size > COMMAND_SIZE) && (NULL != _g_spi_stream_callback))
+            {
+                _g_spi_stream_callback((const uint8_t *)&p_rx_buf[COMMAND_SIZE], received_size - COMMAND_SIZE);
+            }
+        }
 
         /* If data needs to be written */
-        if (SPI_MASTER_CMD_REQUEST_DATA_WRITE == _gp_spi_rx_buf[0])
+        if (SPI_MASTER_CMD_REQUEST_DATA_WRITE == p_rx_buf[0])
         {
             /* Do nothing */
         }
 
         /* If data was written */
-        if (SPI_MASTER_CMD_DATA_WRITE == _gp_spi_rx_buf[0])
+        if (SPI_MASTER_CMD_DATA_WRITE == p_rx_buf[0])
         {
-            memcpy(_g_spi_rx_buf_copy, (void *)_gp_spi_rx_buf, RX_BUF_SIZE);
+            memcpy(_gp_spi_rx_buf_copy, (void *)p_rx_buf, _g_spi_frame_size);
             xSemaphoreGive(_g_sem_spi_data_written);
         }
 
         /* If data needs to be read */
-        if (SPI_MASTER_CMD_REQUEST_DATA_READ == _gp_spi_rx_buf[0])
+        if (SPI_MASTER_CMD_REQUEST_DATA_READ == p_rx_buf[0])
         {
-            memcpy((void *)_gp_spi_tx_buf, _g_spi_tx_buf_copy, TX_BUF_SIZE);
+            memcpy((void *)_gp_spi_tx_buf, _gp_spi_tx_buf_copy, _g_spi_frame_size);
         }
 
         /* If data was read */
-        if (SPI_MASTER_CMD_DATA_READ == _gp_spi_rx_buf[0])
+        if (SPI_MASTER_CMD_DATA_READ == p_rx_buf[0])
         {
             xSemaphoreGive(_g_sem_spi_data_read);
         }
+
+        PROFILER_STOP(PROFILER_STAGE_SPI_TRANSACTION, start);
     }
 }
 
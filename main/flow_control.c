@@ -9,13 +9,18 @@
 
 /* ============================== INCLUDES */
 
+#include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_log.h"
 #include "sdkconfig.h"
 #include "flow_control.h"
 #include "sha256_calculator.h"
+#include "sha256_stream.h"
+#include "log_deferred.h"
+#include "profiler.h"
 #include "comm/comm_manager.h"
+#include "comm/comm_protocol.h"
 
 /* ============================== MACRO DEFINITIONS */
 
@@ -23,11 +28,17 @@
 #define LOG_TAG                             ("FLOW_CONTROL")
 
 /** @brief Flow control task stack depth. */
-#define TASK_FLOW_CONTROL_STACK_DEPTH       (2048)
+#define TASK_FLOW_CONTROL_STACK_DEPTH       (3072)
 
 /** @brief Flow control task priority. */
 #define TASK_FLOW_CONTROL_PRIORITY          (0)
 
+/** @brief Calculator status log period in milliseconds, 0 disables the status log. */
+#define STATUS_LOG_PERIOD_MS                (CONFIG_SHA256_CALC_STATUS_LOG_PERIOD_MS)
+
+/** @brief Job type of a resident job that was never stored, the calculator answers it as an invalid job. */
+#define RESIDENT_JOB_EMPTY                  (0xFF)
+
 /* ============================== TYPE DEFINITIONS */
 
 /* ============================== PRIVATE FUNCTION DECLARATIONS */
@@ -39,11 +50,103 @@
  */
 static void _flow_control_task(void *p_task_params);
 
+/**
+ * @brief Logs the calculator status.
+ * 
+ */
+static void _flow_control_log_status(void);
+
+/**
+ * @brief Sends the identify response with the worker capabilities to master.
+ * 
+ */
+static void _flow_control_identify_send(void);
+
+/**
+ * @brief Sends the status response with the calculator status to master.
+ * 
+ */
+static void _flow_control_status_send(void);
+
+/**
+ * @brief Sends the estimate response with the estimate of the current job to master.
+ * 
+ * @param p_comm_estimate_request Pointer to the estimate request.
+ */
+static void _flow_control_estimate_send(const comm_estimate_request_t *p_comm_estimate_request);
+
+/**
+ * @brief Sends the profile response with the profiler statistics of a stage to master.
+ * 
+ * @param p_comm_profile_request Pointer to the profile request.
+ */
+static void _flow_control_profile_send(const comm_profile_request_t *p_comm_profile_request);
+
+/**
+ * @brief Sends samples of the profiler sample ring buffer to the master.
+ * 
+ * @param p_comm_profile_ring_request Pointer to the profile ring request.
+ */
+static void _flow_control_profile_ring_send(const comm_profile_ring_request_t *p_comm_profile_ring_request);
+
+/**
+ * @brief Keeps the job of a resident store request resident.
+ * 
+ * @param p_comm_resident_store_request Pointer to the resident store request.
+ */
+static void _flow_control_resident_store(const comm_resident_store_request_t *p_comm_resident_store_request);
+
+/**
+ * @brief Expands a resident job request into a full job. The flagged fields update the resident job first.
+ * 
+ * @param p_comm_resident_job_request Pointer to the resident job request.
+ * @param p_sha256_input_variables_queue_element Pointer to where the job will be written.
+ */
+static void _flow_control_resident_job_expand(const comm_resident_job_request_t *p_comm_resident_job_request, sha256_input_variables_queue_element_t *p_sha256_input_variables_queue_element);
+
+/**
+ * @brief Assigns the shard of the nonce space searched for shard jobs.
+ * 
+ * @param p_comm_shard_assign_request Pointer to the shard assign request.
+ */
+static void _flow_control_shard_assign(const comm_shard_assign_request_t *p_comm_shard_assign_request);
+
+/**
+ * @brief Limits a job to the shard of this worker, moving the input offset to the start of the shard and limiting the
+ * hash budget to the shard size. Hash chains and Merkle jobs are left unchanged.
+ * 
+ * @param p_sha256_input_variables_queue_element Pointer to the job which will be updated.
+ */
+static void _flow_control_shard_apply(sha256_input_variables_queue_element_t *p_sha256_input_variables_queue_element);
+
+/**
+ * @brief Writes the leaves of a Merkle leaves request into the leaf storage.
+ * 
+ * @param p_comm_merkle_leaves_request Pointer to the Merkle leaves request.
+ */
+static void _flow_control_merkle_leaves_put(const comm_merkle_leaves_request_t *p_comm_merkle_leaves_request);
+
+/**
+ * @brief Writes the prefix bytes of a SHA256d prefix request into the prefix storage.
+ * 
+ * @param p_comm_sha256d_prefix_request Pointer to the SHA256d prefix request.
+ */
+static void _flow_control_sha256d_prefix_put(const comm_sha256d_prefix_request_t *p_comm_sha256d_prefix_request);
+
 /* ============================== PRIVATE VARIABLES */
 
 /** @brief Flow control task handle. */
 static TaskHandle_t _g_task_handle_flow_control = NULL;
 
+/** @brief Resident jobs, only touched by the flow control task. */
+static sha256_input_variables_queue_element_t _g_resident_jobs[COMM_RESIDENT_JOB_COUNT] = {0};
+
+/** @brief Shard of this worker, only touched by the flow control task. */
+static uint8_t _g_shard_index = 0;
+
+/** @brief Number of shards the nonce space is split into, 1 searches the whole nonce space. */
+static uint8_t _g_shard_count = 1;
+
 /* ============================== PUBLIC VARIABLES */
 
 /* ============================== PUBLIC FUNCTION DEFINITIONS */
@@ -51,6 +154,12 @@ static TaskHandle_t _g_task_handle_flow_control = NULL;
 void flow_control_init(void)
 {
     BaseType_t result = pdPASS;
+    int i = 0;
+
+    for (i = 0; i < COMM_RESIDENT_JOB_COUNT; i++)
+    {
+        _g_resident_jobs[i].job_type = RESIDENT_JOB_EMPTY;
+    }
 
     result = xTaskCreate(_flow_control_task, "MAIN_CTRL", TASK_FLOW_CONTROL_STACK_DEPTH, NULL, TASK_FLOW_CONTROL_PRIORITY, &_g_task_handle_flow_control);
     if (pdPASS != result)
@@ -66,20 +175,113 @@ void flow_control_init(void)
 
 static void _flow_control_task(void *p_task_params)
 {
+    comm_request_t comm_request = {0};
     sha256_input_variables_queue_element_t sha256_input_variables_queue_element = {0};
     sha256_offset_solution_queue_element_t sha256_offset_solution_queue_element = {0};
+    sha256_progress_queue_element_t sha256_progress_queue_element = {0};
+    sha256_stream_digest_queue_element_t sha256_stream_digest_queue_element = {0};
+    sha256_merkle_proof_queue_element_t sha256_merkle_proof_queue_element = {0};
     uint8_t current_puzzle_id = 0;
     bool b_received_new_input = false;
     bool b_received_solution = false;
+    bool b_received_progress = false;
+    bool b_merkle_leaves_pending = false;
+    bool b_sha256d_prefix_pending = false;
+    TickType_t last_status_log_ticks = xTaskGetTickCount();
 
     while (1)
     {
+        /* Leaves wait until the calculator stopped reducing the leaf storage, a prefix until the SHA256d jobs queued before
+           compressed theirs. Results are still drained meanwhile, nothing else is received so later requests keep their
+           order */
+        if (true == b_merkle_leaves_pending)
+        {
+            b_received_new_input = false;
+            if (true == sha256_calculator_merkle_leaves_claim())
+            {
+                _flow_control_merkle_leaves_put(&comm_request.merkle_leaves);
+                b_merkle_leaves_pending = false;
+            }
+        }
+        else if (true == b_sha256d_prefix_pending)
+        {
+            b_received_new_input = false;
+            if (true == sha256_calculator_sha256d_prefix_claim())
+            {
+                _flow_control_sha256d_prefix_put(&comm_request.sha256d_prefix);
+                b_sha256d_prefix_pending = false;
+            }
+        }
         /* Check for new input and reset flag */
-        b_received_new_input = comm_manager_receive_data((uint8_t*)&sha256_input_variables_queue_element, sizeof(sha256_input_variables_queue_element));
+        else
+        {
+            b_received_new_input = comm_manager_receive_data((uint8_t*)&comm_request, sizeof(comm_request));
+        }
 
+        /* Requests are answered right away and don't replace the current puzzle */
+        if ((true == b_received_new_input) && (COMM_REQUEST_IDENTIFY == comm_request.message_type))
+        {
+            _flow_control_identify_send();
+        }
+        else if ((true == b_received_new_input) && (COMM_REQUEST_STATUS == comm_request.message_type))
+        {
+            _flow_control_status_send();
+        }
+        else if ((true == b_received_new_input) && (COMM_REQUEST_ESTIMATE == comm_request.message_type))
+        {
+            _flow_control_estimate_send(&comm_request.estimate);
+        }
+        else if ((true == b_received_new_input) && (COMM_REQUEST_PROFILE == comm_request.message_type))
+        {
+            _flow_control_profile_send(&comm_request.profile);
+        }
+        else if ((true == b_received_new_input) && (COMM_REQUEST_PROFILE_RING == comm_request.message_type))
+        {
+            _flow_control_profile_ring_send(&comm_request.profile_ring);
+        }
+        else if ((true == b_received_new_input) && (COMM_REQUEST_RESIDENT_STORE == comm_request.message_type))
+        {
+            _flow_control_resident_store(&comm_request.resident_store);
+        }
+        else if ((true == b_received_new_input) && (COMM_REQUEST_SHARD_ASSIGN == comm_request.message_type))
+        {
+            _flow_control_shard_assign(&comm_request.shard_assign);
+        }
+        else if ((true == b_received_new_input) && (COMM_REQUEST_SHA256D_PREFIX == comm_request.message_type))
+        {
+            b_sha256d_prefix_pending = (false == sha256_calculator_sha256d_prefix_claim());
+            if (false == b_sha256d_prefix_pending)
+            {
+                _flow_control_sha256d_prefix_put(&comm_request.sha256d_prefix);
+            }
+        }
+        /* Leaves replace the current puzzle, a Merkle job that still holds the leaf storage is stopped first */
+        else if ((true == b_received_new_input) && (COMM_REQUEST_MERKLE_LEAVES == comm_request.message_type))
+        {
+            current_puzzle_id = comm_request.merkle_leaves.puzzle_id;
+            b_merkle_leaves_pending = (false == sha256_calculator_merkle_leaves_claim());
+            if (false == b_merkle_leaves_pending)
+            {
+                _flow_control_merkle_leaves_put(&comm_request.merkle_leaves);
+            }
+        }
         /* If input received */
-        if (true == b_received_new_input)
+        else if (true == b_received_new_input)
         {
+            if (COMM_REQUEST_RESIDENT_JOB == comm_request.message_type)
+            {
+                _flow_control_resident_job_expand(&comm_request.resident_job, &sha256_input_variables_queue_element);
+            }
+            else if (COMM_REQUEST_SHARD_JOB == comm_request.message_type)
+            {
+                sha256_input_variables_queue_element = comm_request.shard_job.sha256_input_variables_queue_element;
+                _flow_control_shard_apply(&sha256_input_variables_queue_element);
+            }
+            else
+            {
+                sha256_input_variables_queue_element = comm_request.job;
+            }
+
             ESP_LOGI(LOG_TAG, "Received new input! Puzzle ID: %d", sha256_input_variables_queue_element.puzzle_id);
 
             /* Set new puzzle id */
@@ -92,15 +294,361 @@ static void _flow_control_task(void *p_task_params)
         /* Check for solution */
         b_received_solution = sha256_calculator_queue_solution_get(&sha256_offset_solution_queue_element);
 
+        /* Proofs of a Merkle job are queued before its root, so once the root was taken every one of its proofs is in the
+           proof queue. Drained before the root is sent, a tree can have more proof elements than one pass would take */
+        while (true == sha256_calculator_queue_proof_get(&sha256_merkle_proof_queue_element))
+        {
+            if (current_puzzle_id != sha256_merkle_proof_queue_element.puzzle_id)
+            {
+                continue;
+            }
+
+            ESP_LOGI(LOG_TAG, "Merkle proof, leaf index: %d, siblings: %d from level %d",
+                sha256_merkle_proof_queue_element.leaf_index,
+                sha256_merkle_proof_queue_element.sibling_count,
+                sha256_merkle_proof_queue_element.first_level);
+
+            comm_manager_proof_put(&sha256_merkle_proof_queue_element);
+        }
+
+        /* A solution of a job whose budget ran out, of a hash chain or of a Merkle job comes with a progress record, taken
+           even if the puzzle was replaced */
+        b_received_progress = ((true == b_received_solution) &&
+                               (true == sha256_calculator_status_has_progress(sha256_offset_solution_queue_element.status)) &&
+                               (true == sha256_calculator_queue_progress_get(&sha256_progress_queue_element)));
+
         /* If received solution and puzzle ID matches */
         if ((true == b_received_solution) && (current_puzzle_id == sha256_offset_solution_queue_element.puzzle_id))
         {
-            ESP_LOGI(LOG_TAG, "Offset solution: %d", sha256_offset_solution_queue_element.sha256_offset_solution.offset_solution);
+            if ((true == b_received_progress) && (SHA256_SOLUTION_STATUS_MERKLE_ROOT == sha256_offset_solution_queue_element.status))
+            {
+                ESP_LOGI(LOG_TAG, "Merkle root, node hashes: %llu", (unsigned long long)sha256_progress_queue_element.hashes);
 
-            /* Set data to be read and set flag */
-            comm_manager_set_data_to_be_read((uint8_t *)&sha256_offset_solution_queue_element, sizeof(sha256_offset_solution_queue_element));
+                comm_manager_progress_put(&sha256_progress_queue_element);
+            }
+            else if ((true == b_received_progress) && (SHA256_SOLUTION_STATUS_BUDGET_EXHAUSTED != sha256_offset_solution_queue_element.status))
+            {
+                ESP_LOGI(LOG_TAG, "Hash chain %s, chain index: %llu, iterations: %llu",
+                    (SHA256_SOLUTION_STATUS_CHAIN_DONE == sha256_offset_solution_queue_element.status) ? "done" : "checkpoint",
+                    (unsigned long long)sha256_offset_solution_queue_element.sha256_offset_solution.offset_solution,
+                    (unsigned long long)sha256_progress_queue_element.hashes);
+
+                comm_manager_progress_put(&sha256_progress_queue_element);
+            }
+            else if (true == b_received_progress)
+            {
+                ESP_LOGI(LOG_TAG, "Budget exhausted, next offset: %llu, hashes: %llu",
+                    (unsigned long long)sha256_offset_solution_queue_element.sha256_offset_solution.offset_solution,
+                    (unsigned long long)sha256_progress_queue_element.hashes);
+
+                /* Progress record is sent in place of the solution */
+                comm_manager_progress_put(&sha256_progress_queue_element);
+            }
+            else
+            {
+                if (SHA256_SOLUTION_STATUS_EXHAUSTED == sha256_offset_solution_queue_element.status)
+                {
+                    ESP_LOGW(LOG_TAG, "Nonce space exhausted, no offset solution!");
+                }
+                else
+                {
+                    ESP_LOGI(LOG_TAG, "Offset solution: %llu", (unsigned long long)sha256_offset_solution_queue_element.sha256_offset_solution.offset_solution);
+                }
+
+                /* Set data to be read and set flag */
+                comm_manager_solution_put(&sha256_offset_solution_queue_element);
+            }
+        }
+
+        /* Digests of streamed messages are independent of the current puzzle */
+        if (true == sha256_stream_queue_digest_get(&sha256_stream_digest_queue_element))
+        {
+            ESP_LOGI(LOG_TAG, "Stream digest, puzzle ID: %d, status: %d, size: %llu, dropped before: %d",
+                sha256_stream_digest_queue_element.puzzle_id,
+                sha256_stream_digest_queue_element.status,
+                (unsigned long long)sha256_stream_digest_queue_element.message_size,
+                sha256_stream_digest_queue_element.dropped);
+
+            comm_manager_digest_put(&sha256_stream_digest_queue_element);
+        }
+
+        /* Send coalesced solutions that waited long enough */
+        comm_manager_process();
+
+        /* Periodic calculator status log */
+        if ((0 != STATUS_LOG_PERIOD_MS) && ((xTaskGetTickCount() - last_status_log_ticks) >= pdMS_TO_TICKS(STATUS_LOG_PERIOD_MS)))
+        {
+            last_status_log_ticks = xTaskGetTickCount();
+            _flow_control_log_status();
         }
     }
 }
 
+static void _flow_control_log_status(void)
+{
+    sha256_calculator_status_t sha256_calculator_status = {0};
+    comm_manager_status_t comm_manager_status = {0};
+    sha256_calculator_estimate_t sha256_calculator_estimate = {0};
+#ifdef CONFIG_LOG_DEFERRED_ENABLE
+    log_deferred_stats_t log_deferred_stats = {0};
+#endif
+
+    sha256_calculator_get_status(&sha256_calculator_status);
+    sha256_calculator_get_estimate(STATUS_LOG_PERIOD_MS, &sha256_calculator_estimate);
+    comm_manager_get_status(&comm_manager_status);
+#ifdef CONFIG_LOG_DEFERRED_ENABLE
+    log_deferred_get_stats(&log_deferred_stats);
+#endif
+
+    ESP_LOGI(LOG_TAG, "Hash rate: %lu H/s, batch size: %lu (min %lu, max %lu), batch duration: %lu us, control overhead: %lu ppm, cache hits: %lu, cache range hits: %lu, cache misses: %lu, idle: %llu ms, superseded hashes: %llu",
+        (unsigned long)sha256_calculator_status.hash_rate,
+        (unsigned long)sha256_calculator_status.batch_size,
+        (unsigned long)sha256_calculator_status.batch_size_min,
+        (unsigned long)sha256_calculator_status.batch_size_max,
+        (unsigned long)sha256_calculator_status.batch_duration_us,
+        (unsigned long)sha256_calculator_status.control_overhead_ppm,
+        (unsigned long)sha256_calculator_status.cache_hits,
+        (unsigned long)sha256_calculator_status.cache_range_hits,
+        (unsigned long)sha256_calculator_status.cache_misses,
+        (unsigned long long)(sha256_calculator_status.idle_us_total / 1000),
+        (unsigned long long)sha256_calculator_status.hashes_superseded);
+
+    ESP_LOGI(LOG_TAG, "Results sent: %lu in %lu frames, results per frame: %u (max %u)",
+        (unsigned long)comm_manager_status.results_sent,
+        (unsigned long)comm_manager_status.result_frames_sent,
+        comm_manager_status.results_per_frame_last,
+        comm_manager_status.results_per_frame_max);
+
+    ESP_LOGI(LOG_TAG, "Job puzzle ID: %d, type: %d, flags: 0x%02X, hashes: %llu of %llu expected, elapsed: %lu ms, ETA: %lu ms, hash rate: %lu H/s (expected %lu)",
+        sha256_calculator_estimate.puzzle_id,
+        sha256_calculator_estimate.job_type,
+        sha256_calculator_estimate.flags,
+        (unsigned long long)sha256_calculator_estimate.job_hashes,
+        (unsigned long long)sha256_calculator_estimate.expected_hashes,
+        (unsigned long)sha256_calculator_estimate.elapsed_ms,
+        (unsigned long)sha256_calculator_estimate.eta_ms,
+        (unsigned long)sha256_calculator_estimate.hash_rate,
+        (unsigned long)sha256_calculator_estimate.hash_rate_expected);
+
+#ifdef CONFIG_LOG_DEFERRED_ENABLE
+    ESP_LOGI(LOG_TAG, "Log lines written: %lu, dropped: %lu (ring buffer full), %lu (rate limit), truncated: %lu",
+        (unsigned long)log_deferred_stats.written,
+        (unsigned long)log_deferred_stats.dropped_full,
+        (unsigned long)log_deferred_stats.dropped_rate_limit,
+        (unsigned long)log_deferred_stats.truncated);
+#endif
+}
+
+static void _flow_control_identify_send(void)
+{
+    comm_identify_response_t comm_identify_response = {0};
+
+    comm_identify_response.message_type = COMM_RESPONSE_IDENTIFY;
+    comm_identify_response.protocol_version = COMM_PROTOCOL_VERSION;
+    comm_identify_response.transport = comm_manager_get_transport();
+    comm_identify_response.core_count = portNUM_PROCESSORS;
+    comm_identify_response.max_write_size = sizeof(comm_request_t);
+    comm_identify_response.max_read_size = sizeof(comm_response_t);
+    comm_identify_response.receive_queue_length = comm_manager_get_receive_queue_length();
+    comm_identify_response.max_stream_frame_data_size = COMM_STREAM_FRAME_DATA_SIZE;
+    sha256_calculator_get_capabilities(&comm_identify_response.sha256_calculator_capabilities);
+
+    ESP_LOGI(LOG_TAG, "Received identify request!");
+
+    comm_manager_set_control_data_to_be_read((uint8_t *)&comm_identify_response, sizeof(comm_identify_response));
+}
+
+static void _flow_control_status_send(void)
+{
+    comm_status_response_t comm_status_response = {0};
+
+    comm_status_response.message_type = COMM_RESPONSE_STATUS;
+    sha256_calculator_get_status(&comm_status_response.sha256_calculator_status);
+    comm_manager_get_status(&comm_status_response.comm_manager_status);
+
+    comm_manager_set_control_data_to_be_read((uint8_t *)&comm_status_response, sizeof(comm_status_response));
+}
+
+static void _flow_control_estimate_send(const comm_estimate_request_t *p_comm_estimate_request)
+{
+    comm_estimate_response_t comm_estimate_response = {0};
+
+    comm_estimate_response.message_type = COMM_RESPONSE_ESTIMATE;
+    sha256_calculator_get_estimate(p_comm_estimate_request->lease_ms, &comm_estimate_response.sha256_calculator_estimate);
+
+    comm_manager_set_control_data_to_be_read((uint8_t *)&comm_estimate_response, sizeof(comm_estimate_response));
+}
+
+static void _flow_control_profile_send(const comm_profile_request_t *p_comm_profile_request)
+{
+    comm_profile_response_t comm_profile_response = {0};
+    profiler_stage_stats_t profiler_stage_stats = {0};
+    int i = 0;
+
+    comm_profile_response.message_type = COMM_RESPONSE_PROFILE;
+    comm_profile_response.stage = COMM_PROFILE_STAGE_NONE;
+    comm_profile_response.first_bucket = p_comm_profile_request->first_bucket;
+
+    if (true == profiler_stage_stats_get((profiler_stage_t)p_comm_profile_request->stage, &profiler_stage_stats))
+    {
+        comm_profile_response.stage = p_comm_profile_request->stage;
+        comm_profile_response.count = profiler_stage_stats.count;
+        comm_profile_response.min_cycles = profiler_stage_stats.min_cycles;
+        comm_profile_response.max_cycles = profiler_stage_stats.max_cycles;
+        comm_profile_response.total_cycles = profiler_stage_stats.total_cycles;
+
+        for (i = 0; (i < COMM_PROFILE_BUCKETS_PER_RESPONSE) && ((p_comm_profile_request->first_bucket + i) < PROFILER_HISTOGRAM_BUCKETS); i++)
+        {
+            comm_profile_response.histogram[i] = profiler_stage_stats.histogram[p_comm_profile_request->first_bucket + i];
+        }
+    }
+
+    comm_manager_set_control_data_to_be_read((uint8_t *)&comm_profile_response, sizeof(comm_profile_response));
+}
+
+static void _flow_control_profile_ring_send(const comm_profile_ring_request_t *p_comm_profile_ring_request)
+{
+    comm_profile_ring_response_t comm_profile_ring_response = {0};
+    uint32_t first_index = p_comm_profile_ring_request->first_index;
+    uint32_t written = 0;
+
+    comm_profile_ring_response.message_type = COMM_RESPONSE_PROFILE_RING;
+    comm_profile_ring_response.count = (uint8_t)profiler_ring_copy(&first_index, comm_profile_ring_response.samples, COMM_PROFILE_SAMPLES_PER_RESPONSE, &written);
+    comm_profile_ring_response.written = written;
+    comm_profile_ring_response.first_index = first_index;
+
+    comm_manager_set_control_data_to_be_read((uint8_t *)&comm_profile_ring_response, sizeof(comm_profile_ring_response));
+}
+
+static void _flow_control_resident_store(const comm_resident_store_request_t *p_comm_resident_store_request)
+{
+    if (COMM_RESIDENT_JOB_COUNT <= p_comm_resident_store_request->index)
+    {
+        ESP_LOGW(LOG_TAG, "Resident job index %d out of range!", p_comm_resident_store_request->index);
+        return;
+    }
+
+    _g_resident_jobs[p_comm_resident_store_request->index] = p_comm_resident_store_request->sha256_input_variables_queue_element;
+
+    ESP_LOGI(LOG_TAG, "Stored resident job %d.", p_comm_resident_store_request->index);
+}
+
+static void _flow_control_resident_job_expand(const comm_resident_job_request_t *p_comm_resident_job_request, sha256_input_variables_queue_element_t *p_sha256_input_variables_queue_element)
+{
+    sha256_input_variables_queue_element_t *p_resident_job = NULL;
+    const uint8_t *p_field = p_comm_resident_job_request->field_data;
+
+    /* Unknown index runs as a never stored job, so the master still gets an invalid job solution */
+    if (COMM_RESIDENT_JOB_COUNT <= p_comm_resident_job_request->index)
+    {
+        ESP_LOGW(LOG_TAG, "Resident job index %d out of range!", p_comm_resident_job_request->index);
+        memset(p_sha256_input_variables_queue_element, 0, sizeof(*p_sha256_input_variables_queue_element));
+        p_sha256_input_variables_queue_element->job_type = RESIDENT_JOB_EMPTY;
+        p_sha256_input_variables_queue_element->puzzle_id = p_comm_resident_job_request->puzzle_id;
+        return;
+    }
+
+    p_resident_job = &_g_resident_jobs[p_comm_resident_job_request->index];
+
+    /* Input offset is the first input variable of every job type */
+    if (0 != (COMM_RESIDENT_JOB_FIELD_INPUT & p_comm_resident_job_request->fields))
+    {
+        memcpy(&p_resident_job->sha256_input_variables.input_offset, p_field, sizeof(sha256_nonce_t));
+        p_field += sizeof(sha256_nonce_t);
+    }
+
+    if (0 != (COMM_RESIDENT_JOB_FIELD_TIME & p_comm_resident_job_request->fields))
+    {
+        memcpy(&p_resident_job->job_budget.time_budget_ms, p_field, sizeof(uint32_t));
+        p_field += sizeof(uint32_t);
+    }
+
+    if (0 != (COMM_RESIDENT_JOB_FIELD_HASHES & p_comm_resident_job_request->fields))
+    {
+        memcpy(&p_resident_job->job_budget.hash_budget, p_field, sizeof(uint64_t));
+    }
+
+    *p_sha256_input_variables_queue_element = *p_resident_job;
+    p_sha256_input_variables_queue_element->puzzle_id = p_comm_resident_job_request->puzzle_id;
+
+    /* Shard is applied to the started job only, the resident job keeps the input offset of the whole fleet */
+    if (0 != (COMM_RESIDENT_JOB_FIELD_SHARD & p_comm_resident_job_request->fields))
+    {
+        _flow_control_shard_apply(p_sha256_input_variables_queue_element);
+    }
+}
+
+static void _flow_control_shard_assign(const comm_shard_assign_request_t *p_comm_shard_assign_request)
+{
+    if ((0 == p_comm_shard_assign_request->shard_count) || (p_comm_shard_assign_request->shard_count <= p_comm_shard_assign_request->shard_index))
+    {
+        ESP_LOGW(LOG_TAG, "Invalid shard %d of %d!", p_comm_shard_assign_request->shard_index, p_comm_shard_assign_request->shard_count);
+        return;
+    }
+
+    _g_shard_index = p_comm_shard_assign_request->shard_index;
+    _g_shard_count = p_comm_shard_assign_request->shard_count;
+
+    ESP_LOGI(LOG_TAG, "Assigned shard %d of %d.", _g_shard_index, _g_shard_count);
+}
+
+static void _flow_control_shard_apply(sha256_input_variables_queue_element_t *p_sha256_input_variables_queue_element)
+{
+    /* Nonce space minus one fits 64 bits for either nonce size, sizes are computed modulo 2^64 */
+    uint64_t nonce_space_last = (sha256_nonce_t)-1;
+    uint64_t shard_size = (nonce_space_last / _g_shard_count) + 1;
+    uint64_t shard_start = shard_size * _g_shard_index;
+    uint64_t hash_budget = p_sha256_input_variables_queue_element->job_budget.hash_budget;
+
+    /* A hash chain is sequential and a Merkle job reduces the local leaves, every shard runs them whole */
+    if ((SHA256_JOB_TYPE_CHAIN == p_sha256_input_variables_queue_element->job_type) ||
+        (SHA256_JOB_TYPE_MERKLE == p_sha256_input_variables_queue_element->job_type))
+    {
+        return;
+    }
+
+    /* Last shard takes the rest of the nonce space, 0 for a whole 64 bit nonce space means no limit */
+    if ((_g_shard_index + 1) == _g_shard_count)
+    {
+        shard_size = nonce_space_last - shard_start + 1;
+    }
+
+    /* Input offset is the first input variable of every job type */
+    p_sha256_input_variables_queue_element->sha256_input_variables.input_offset += (sha256_nonce_t)shard_start;
+
+    if ((0 != shard_size) && ((0 == hash_budget) || (hash_budget > shard_size)))
+    {
+        p_sha256_input_variables_queue_element->job_budget.hash_budget = shard_size;
+    }
+}
+
+static void _flow_control_merkle_leaves_put(const comm_merkle_leaves_request_t *p_comm_merkle_leaves_request)
+{
+    if ((COMM_MERKLE_LEAVES_PER_REQUEST < p_comm_merkle_leaves_request->leaf_count) ||
+        (false == sha256_calculator_merkle_leaves_put(p_comm_merkle_leaves_request->first_leaf_index, p_comm_merkle_leaves_request->leaf_count, &p_comm_merkle_leaves_request->leaves[0][0])))
+    {
+        ESP_LOGW(LOG_TAG, "Merkle leaves %d from leaf index %d out of range!", p_comm_merkle_leaves_request->leaf_count,
+            p_comm_merkle_leaves_request->first_leaf_index);
+        return;
+    }
+
+    /* Debug level, a tree takes many requests */
+    ESP_LOGD(LOG_TAG, "Stored %d Merkle leaves from leaf index %d.", p_comm_merkle_leaves_request->leaf_count,
+        p_comm_merkle_leaves_request->first_leaf_index);
+}
+
+static void _flow_control_sha256d_prefix_put(const comm_sha256d_prefix_request_t *p_comm_sha256d_prefix_request)
+{
+    if ((COMM_SHA256D_PREFIX_PER_REQUEST < p_comm_sha256d_prefix_request->size) ||
+        (false == sha256_calculator_sha256d_prefix_put(p_comm_sha256d_prefix_request->offset, p_comm_sha256d_prefix_request->size, p_comm_sha256d_prefix_request->prefix)))
+    {
+        ESP_LOGW(LOG_TAG, "SHA256d prefix bytes %d from offset %d out of range!", p_comm_sha256d_prefix_request->size,
+            p_comm_sha256d_prefix_request->offset);
+        return;
+    }
+
+    ESP_LOGD(LOG_TAG, "Stored %d SHA256d prefix bytes from offset %d.", p_comm_sha256d_prefix_request->size,
+        p_comm_sha256d_prefix_request->offset);
+}
+
 /* ============================== INTERRUPT FUNCTION DEFINITIONS */
@@ -20,7 +20,11 @@
 #define LOG_TAG                                 ("GPIO_MANAGER")
 
 /** @brief GPIO interrupt out pin mask. */
+#ifdef CONFIG_COMM_PROTOCOL_I2C_SPI
+#define GPIO_INTERRUPT_OUT_MASK                 ((1ULL << CONFIG_GPIO_INTERRUPT_OUT) | (1ULL << CONFIG_GPIO_INTERRUPT_OUT_CONTROL))
+#else
 #define GPIO_INTERRUPT_OUT_MASK                 (1ULL << CONFIG_GPIO_INTERRUPT_OUT)
+#endif
 
 /* ============================== TYPE DEFINITIONS */
 
@@ -59,6 +63,18 @@ void gpio_reset_interrupt_out(void)
     gpio_set_level(CONFIG_GPIO_INTERRUPT_OUT, 0);
 }
 
+#ifdef CONFIG_COMM_PROTOCOL_I2C_SPI
+void gpio_set_control_interrupt_out(void)
+{
+    gpio_set_level(CONFIG_GPIO_INTERRUPT_OUT_CONTROL, 1);
+}
+
+void gpio_reset_control_interrupt_out(void)
+{
+    gpio_set_level(CONFIG_GPIO_INTERRUPT_OUT_CONTROL, 0);
+}
+#endif
+
 /* ============================== PRIVATE FUNCTION DEFINITIONS */
 
 /* ============================== INTERRUPT FUNCTION DEFINITIONS */
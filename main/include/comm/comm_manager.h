@@ -14,11 +14,24 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
+#include "sha256_calculator.h"
+#include "sha256_stream.h"
 
 /* ============================== MACRO DEFINITIONS */
 
 /* ============================== TYPE DEFINITIONS */
 
+/**
+ * @brief Communication manager status.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t results_sent;                      //! Solutions sent to master since boot
+    uint32_t result_frames_sent;                //! Frames (interrupts) the solutions were sent in since boot
+    uint8_t results_per_frame_last;             //! Solutions carried by the last frame
+    uint8_t results_per_frame_max;              //! Most solutions carried by a single frame since boot
+} comm_manager_status_t;
+
 /* ============================== PUBLIC FUNCTION DECLARATIONS */
 
 /**
@@ -35,6 +48,59 @@ void comm_manager_init(void);
  */
 void comm_manager_set_data_to_be_read(uint8_t *p_buf, size_t buf_size);
 
+/**
+ * @brief Send a reply to an identify, status or estimate request to master, on the control plane if the worker has one.
+ * Blocking function.
+ * 
+ * @param p_buf Pointer to the buffer from where the data will be copied to the send buffer.
+ * @param buf_size Size of the buffer.
+ */
+void comm_manager_set_control_data_to_be_read(uint8_t *p_buf, size_t buf_size);
+
+/**
+ * @brief Sends a solution to master. With result coalescing the solution is kept pending until enough solutions are
+ * pending or the oldest one timed out. Blocks while a frame is sent.
+ * 
+ * @param p_sha256_offset_solution_queue_element Pointer to the offset solution queue element.
+ */
+void comm_manager_solution_put(const sha256_offset_solution_queue_element_t *p_sha256_offset_solution_queue_element);
+
+/**
+ * @brief Sends the progress record of a job whose budget ran out to master, after any pending solutions. Blocks while
+ * a frame is sent.
+ * 
+ * @param p_sha256_progress_queue_element Pointer to the progress queue element.
+ */
+void comm_manager_progress_put(const sha256_progress_queue_element_t *p_sha256_progress_queue_element);
+
+/**
+ * @brief Sends the digest of a streamed message to master, after any pending solutions. Blocks while a frame is sent.
+ * 
+ * @param p_sha256_stream_digest_queue_element Pointer to the stream digest queue element.
+ */
+void comm_manager_digest_put(const sha256_stream_digest_queue_element_t *p_sha256_stream_digest_queue_element);
+
+/**
+ * @brief Sends a part of a Merkle proof path to master, after any pending solutions. Blocks while a frame is sent.
+ * 
+ * @param p_sha256_merkle_proof_queue_element Pointer to the proof queue element.
+ */
+void comm_manager_proof_put(const sha256_merkle_proof_queue_element_t *p_sha256_merkle_proof_queue_element);
+
+/**
+ * @brief Sends the pending solutions if the oldest one timed out. Must be called periodically from the same task that
+ * puts solutions.
+ * 
+ */
+void comm_manager_process(void);
+
+/**
+ * @brief Gets a snapshot of the communication manager status.
+ * 
+ * @param p_comm_manager_status Pointer to where the status will be copied.
+ */
+void comm_manager_get_status(comm_manager_status_t *p_comm_manager_status);
+
 /**
  * @brief Receive data from master.
  * 
@@ -45,4 +111,18 @@ void comm_manager_set_data_to_be_read(uint8_t *p_buf, size_t buf_size);
  */
 bool comm_manager_receive_data(uint8_t *p_buf, size_t buf_size);
 
+/**
+ * @brief Gets the transport the worker was built with.
+ * 
+ * @return uint8_t Transport, one of COMM_TRANSPORT_* (see comm_protocol.h).
+ */
+uint8_t comm_manager_get_transport(void);
+
+/**
+ * @brief Gets the number of frames from master buffered before they are received.
+ * 
+ * @return uint8_t Receive queue length.
+ */
+uint8_t comm_manager_get_receive_queue_length(void);
+
 #endif
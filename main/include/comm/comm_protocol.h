@@ -0,0 +1,452 @@
+/**
+ * @file comm_protocol.h
+ * @author Iwan Ćulumović
+ * @brief Communication protocol frames exchanged with the master.
+ * 
+ * The first byte of a master frame is either a job type (see sha256_calculator.h) or a request message type. The first
+ * byte of a worker frame is always the response message type, so a solution and a request response can be told apart.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef __COMM_PROTOCOL_H__
+#define __COMM_PROTOCOL_H__
+
+/* ============================== INCLUDES */
+#include <stdint.h>
+#include "sdkconfig.h"
+#include "sha256_calculator.h"
+#include "sha256_stream.h"
+#include "profiler.h"
+#include "comm/comm_manager.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Protocol version reported by the identify response. */
+#define COMM_PROTOCOL_VERSION               (16)
+
+/** @brief Request message type, master asks for the worker capabilities. */
+#define COMM_REQUEST_IDENTIFY               (0x80)
+
+/** @brief Request message type, master asks for the calculator status. */
+#define COMM_REQUEST_STATUS                 (0x81)
+
+/** @brief Request message type, master keeps a job resident on the worker without starting it. */
+#define COMM_REQUEST_RESIDENT_STORE         (0x82)
+
+/** @brief Request message type, master starts a resident job, sending only the changed fields. */
+#define COMM_REQUEST_RESIDENT_JOB           (0x83)
+
+/** @brief Request message type, master assigns the shard of the nonce space the worker searches for shard jobs. */
+#define COMM_REQUEST_SHARD_ASSIGN           (0x84)
+
+/** @brief Request message type, master starts a job of which the worker searches only its shard. */
+#define COMM_REQUEST_SHARD_JOB              (0x85)
+
+/** @brief Request message type, master writes leaves into the Merkle leaf storage for the next Merkle job. */
+#define COMM_REQUEST_MERKLE_LEAVES          (0x86)
+
+/** @brief Request message type, master asks for the estimate of the current job. */
+#define COMM_REQUEST_ESTIMATE               (0x87)
+
+/** @brief Request message type, master writes a part of the prefix of the next SHA256d jobs. */
+#define COMM_REQUEST_SHA256D_PREFIX         (0x88)
+
+/** @brief Request message type, master asks for the profiler statistics of a stage. */
+#define COMM_REQUEST_PROFILE                (0x89)
+
+/** @brief Request message type, master reads samples of the profiler sample ring buffer. */
+#define COMM_REQUEST_PROFILE_RING           (0x8A)
+
+/** @brief Resident job field flag, the input offset follows. */
+#define COMM_RESIDENT_JOB_FIELD_INPUT       (0x01)
+
+/** @brief Resident job field flag, the time budget follows. */
+#define COMM_RESIDENT_JOB_FIELD_TIME        (0x02)
+
+/** @brief Resident job field flag, the hash budget follows. */
+#define COMM_RESIDENT_JOB_FIELD_HASHES      (0x04)
+
+/** @brief Resident job field flag, the worker searches only its shard, no field follows. */
+#define COMM_RESIDENT_JOB_FIELD_SHARD       (0x08)
+
+/** @brief Response message type, offset solution of a job. */
+#define COMM_RESPONSE_SOLUTION              (0x00)
+
+/** @brief Response message type, offset solutions of several jobs sent with one interrupt. */
+#define COMM_RESPONSE_SOLUTION_BATCH        (0x01)
+
+/** @brief Response message type, progress of a job whose budget ran out or of a hash chain. */
+#define COMM_RESPONSE_PROGRESS              (0x02)
+
+/** @brief Response message type, digest of a streamed message. */
+#define COMM_RESPONSE_DIGEST                (0x03)
+
+/** @brief Response message type, Merkle proof path of a leaf, or a part of it. */
+#define COMM_RESPONSE_PROOF                 (0x04)
+
+/** @brief Response message type, worker capabilities. */
+#define COMM_RESPONSE_IDENTIFY              (0x80)
+
+/** @brief Response message type, calculator status. */
+#define COMM_RESPONSE_STATUS                (0x81)
+
+/** @brief Response message type, estimate of the current job. */
+#define COMM_RESPONSE_ESTIMATE              (0x87)
+
+/** @brief Response message type, profiler statistics of a stage. */
+#define COMM_RESPONSE_PROFILE               (0x89)
+
+/** @brief Response message type, samples of the profiler sample ring buffer. */
+#define COMM_RESPONSE_PROFILE_RING          (0x8A)
+
+/** @brief Response message type, nothing to read (I2C register map result register with an empty result FIFO). */
+#define COMM_RESPONSE_NONE                  (0xFF)
+
+/** @brief Transport, I2C slave. */
+#define COMM_TRANSPORT_I2C                  (0x00)
+
+/** @brief Transport, SPI slave. */
+#define COMM_TRANSPORT_SPI                  (0x01)
+
+/** @brief Transport, simulated in process (Linux target). */
+#define COMM_TRANSPORT_SIM                  (0x02)
+
+/** @brief Transport, I2C slave with a register map. */
+#define COMM_TRANSPORT_I2C_REGISTER_MAP     (0x03)
+
+/** @brief Transport, I2C slave for identify, status and estimate requests and SPI slave for jobs and results. */
+#define COMM_TRANSPORT_I2C_SPI              (0x04)
+
+/** @brief I2C register map, status register (read only, comm_i2c_status_register_t). */
+#define COMM_I2C_REG_STATUS                 (0x00)
+
+/** @brief I2C register map, result register (read only, comm_response_t). Reading it takes the oldest result frame. */
+#define COMM_I2C_REG_RESULT                 (0x01)
+
+/** @brief I2C register map, counters register (read only, comm_i2c_counters_register_t). */
+#define COMM_I2C_REG_COUNTERS               (0x02)
+
+/** @brief I2C register map, job slot register (write only, a master frame). */
+#define COMM_I2C_REG_JOB                    (0x10)
+
+/** @brief Number of pending results sent with one interrupt, 1 disables coalescing. */
+#ifdef CONFIG_COMM_RESULT_COALESCE_COUNT
+#define COMM_RESULT_COALESCE_COUNT          (CONFIG_COMM_RESULT_COALESCE_COUNT)
+#else
+#define COMM_RESULT_COALESCE_COUNT          (1)
+#endif
+
+/** @brief Longest time a pending result waits for more results in milliseconds. */
+#ifdef CONFIG_COMM_RESULT_COALESCE_TIMEOUT_MS
+#define COMM_RESULT_COALESCE_TIMEOUT_MS     (CONFIG_COMM_RESULT_COALESCE_TIMEOUT_MS)
+#else
+#define COMM_RESULT_COALESCE_TIMEOUT_MS     (10)
+#endif
+
+/** @brief Number of resident jobs the master can keep on the worker. */
+#ifdef CONFIG_COMM_RESIDENT_JOB_COUNT
+#define COMM_RESIDENT_JOB_COUNT             (CONFIG_COMM_RESIDENT_JOB_COUNT)
+#else
+#define COMM_RESIDENT_JOB_COUNT             (8)
+#endif
+
+/** @brief Largest number of leaves in a Merkle leaves request, the request stays within the size of a job. */
+#define COMM_MERKLE_LEAVES_PER_REQUEST      (3)
+
+/** @brief Largest number of prefix bytes in a SHA256d prefix request, a Bitcoin header prefix fits into one request. */
+#define COMM_SHA256D_PREFIX_PER_REQUEST     (96)
+
+/** @brief Number of histogram buckets in a profile response, the master reads a histogram with several requests. */
+#define COMM_PROFILE_BUCKETS_PER_RESPONSE   (8)
+
+/** @brief Profile response stage if the profiler is disabled or the stage is unknown. */
+#define COMM_PROFILE_STAGE_NONE             (0xFF)
+
+/** @brief Number of samples in a profile ring response, the master reads the ring buffer with several requests. */
+#define COMM_PROFILE_SAMPLES_PER_RESPONSE   (6)
+
+/** @brief Largest number of message bytes in a stream frame, 0 if the transport doesn't stream. */
+#ifdef CONFIG_SPI_STREAM_FRAME_SIZE
+#define COMM_STREAM_FRAME_DATA_SIZE         (CONFIG_SPI_STREAM_FRAME_SIZE)
+#else
+#define COMM_STREAM_FRAME_DATA_SIZE         (0)
+#endif
+
+/* ============================== TYPE DEFINITIONS */
+
+/**
+ * @brief Resident store request, the job isn't started until a resident job request names its index.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t message_type;                                                   //! COMM_REQUEST_RESIDENT_STORE
+    uint8_t index;                                                          //! Resident job index, below COMM_RESIDENT_JOB_COUNT
+    sha256_input_variables_queue_element_t sha256_input_variables_queue_element;    //! Resident job, the puzzle ID is ignored
+} comm_resident_store_request_t;
+
+/**
+ * @brief Resident job request. Flagged fields follow in flag order and replace the fields of the resident job for
+ * this and later requests, the master only writes the request up to the last flagged field.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t message_type;                                                   //! COMM_REQUEST_RESIDENT_JOB
+    uint8_t puzzle_id;
+    uint8_t index;                                                          //! Resident job index, below COMM_RESIDENT_JOB_COUNT
+    uint8_t fields;                                                         //! COMM_RESIDENT_JOB_FIELD_* flags of the fields that follow
+    uint8_t field_data[sizeof(sha256_nonce_t) + sizeof(sha256_job_budget_t)];   //! Flagged fields, little endian
+} comm_resident_job_request_t;
+
+/**
+ * @brief Shard assign request. The nonce space is split into shard count equal shards, the last one takes the rest.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t message_type;                                                   //! COMM_REQUEST_SHARD_ASSIGN
+    uint8_t shard_index;                                                    //! Shard of this worker, below the shard count
+    uint8_t shard_count;                                                    //! Number of shards, at least 1
+} comm_shard_assign_request_t;
+
+/**
+ * @brief Shard job request. The worker searches its shard starting at the input offset of the job plus the shard
+ * index times the shard size, the hash budget is limited to the shard size.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t message_type;                                                   //! COMM_REQUEST_SHARD_JOB
+    sha256_input_variables_queue_element_t sha256_input_variables_queue_element;
+} comm_shard_job_request_t;
+
+/**
+ * @brief Merkle leaves request. The master only writes the request up to the last leaf.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t message_type;                                                   //! COMM_REQUEST_MERKLE_LEAVES
+    uint8_t puzzle_id;                                                      //! Puzzle ID of the Merkle job the leaves are for
+    uint16_t first_leaf_index;                                              //! Leaf index of the first leaf
+    uint8_t leaf_count;                                                     //! Number of leaves, up to COMM_MERKLE_LEAVES_PER_REQUEST
+    uint8_t leaves[COMM_MERKLE_LEAVES_PER_REQUEST][SHA256_BYTE_DIGEST_SIZE];
+} comm_merkle_leaves_request_t;
+
+/**
+ * @brief SHA256d prefix request. The master only writes the request up to the last prefix byte.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t message_type;                                                   //! COMM_REQUEST_SHA256D_PREFIX
+    uint8_t offset;                                                         //! Byte offset of the first prefix byte
+    uint8_t size;                                                           //! Number of prefix bytes, up to COMM_SHA256D_PREFIX_PER_REQUEST
+    uint8_t prefix[COMM_SHA256D_PREFIX_PER_REQUEST];
+} comm_sha256d_prefix_request_t;
+
+/**
+ * @brief Estimate request.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t message_type;                                                   //! COMM_REQUEST_ESTIMATE
+    uint32_t lease_ms;                                                      //! Lease time the lease hashes are sized for
+} comm_estimate_request_t;
+
+/**
+ * @brief Profile request.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t message_type;                                                   //! COMM_REQUEST_PROFILE
+    uint8_t stage;                                                          //! Profiled stage, see profiler_stage_t
+    uint8_t first_bucket;                                                   //! First histogram bucket of the response
+} comm_profile_request_t;
+
+/**
+ * @brief Profile ring request.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t message_type;                                                   //! COMM_REQUEST_PROFILE_RING
+    uint32_t first_index;                                                   //! Index of the first sample, the number of samples written before it
+} comm_profile_ring_request_t;
+
+/**
+ * @brief Any master frame, sized for the largest request. The first byte is a job type or a request message type.
+ * 
+ */
+typedef union __attribute__((packed)) {
+    uint8_t message_type;
+    sha256_input_variables_queue_element_t job;
+    comm_resident_store_request_t resident_store;
+    comm_resident_job_request_t resident_job;
+    comm_shard_assign_request_t shard_assign;
+    comm_shard_job_request_t shard_job;
+    comm_merkle_leaves_request_t merkle_leaves;
+    comm_estimate_request_t estimate;
+    comm_sha256d_prefix_request_t sha256d_prefix;
+    comm_profile_request_t profile;
+    comm_profile_ring_request_t profile_ring;
+} comm_request_t;
+
+/**
+ * @brief Stream frame, written with its own SPI command instead of a master frame. The master only clocks the frame up
+ * to the last data byte, rounded up for DMA.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t flags;                                                          //! SHA256_STREAM_FLAG_* flags
+    uint8_t puzzle_id;                                                      //! Puzzle ID of the message, same in every frame
+    uint16_t sequence;                                                      //! 0 for the first frame, one more for every following frame
+    uint16_t data_size;                                                     //! Number of message bytes in the frame
+    uint8_t data[COMM_STREAM_FRAME_DATA_SIZE];
+} comm_stream_frame_t;
+
+/**
+ * @brief Solution response.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t message_type;                                                   //! COMM_RESPONSE_SOLUTION
+    sha256_offset_solution_queue_element_t sha256_offset_solution_queue_element;
+} comm_solution_response_t;
+
+/**
+ * @brief Solution batch response, only the first count solutions are sent.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t message_type;                                                   //! COMM_RESPONSE_SOLUTION_BATCH
+    uint8_t count;                                                          //! Number of solutions in the batch
+    sha256_offset_solution_queue_element_t sha256_offset_solution_queue_elements[COMM_RESULT_COALESCE_COUNT];
+} comm_solution_batch_response_t;
+
+/**
+ * @brief Progress response, sent in place of the solution of a job whose budget ran out or of a hash chain.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t message_type;                                                   //! COMM_RESPONSE_PROGRESS
+    sha256_progress_queue_element_t sha256_progress_queue_element;
+} comm_progress_response_t;
+
+/**
+ * @brief Digest response, sent once the last frame of a streamed message was hashed.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t message_type;                                                   //! COMM_RESPONSE_DIGEST
+    sha256_stream_digest_queue_element_t sha256_stream_digest_queue_element;
+} comm_digest_response_t;
+
+/**
+ * @brief Proof response, sent for every proof of a Merkle job before its root.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t message_type;                                                   //! COMM_RESPONSE_PROOF
+    sha256_merkle_proof_queue_element_t sha256_merkle_proof_queue_element;
+} comm_proof_response_t;
+
+/**
+ * @brief Identify response. The layout up to and including the maximum sizes is kept across protocol versions.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t message_type;                                                   //! COMM_RESPONSE_IDENTIFY
+    uint8_t protocol_version;                                               //! COMM_PROTOCOL_VERSION
+    uint8_t transport;                                                      //! COMM_TRANSPORT_*
+    uint8_t core_count;                                                     //! Number of CPU cores of the worker
+    uint16_t max_write_size;                                                //! Maximum frame size the master may write
+    uint16_t max_read_size;                                                 //! Maximum frame size the master may read
+    uint8_t receive_queue_length;                                           //! Number of frames buffered before the worker consumes them
+    sha256_calculator_capabilities_t sha256_calculator_capabilities;
+    uint16_t max_stream_frame_data_size;                                    //! COMM_STREAM_FRAME_DATA_SIZE
+} comm_identify_response_t;
+
+/**
+ * @brief Status response.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t message_type;                                                   //! COMM_RESPONSE_STATUS
+    sha256_calculator_status_t sha256_calculator_status;
+    comm_manager_status_t comm_manager_status;
+} comm_status_response_t;
+
+/**
+ * @brief Estimate response.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t message_type;                                                   //! COMM_RESPONSE_ESTIMATE
+    sha256_calculator_estimate_t sha256_calculator_estimate;
+} comm_estimate_response_t;
+
+/**
+ * @brief Profile response. Counts are since boot, or since the last reset of the profiler.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t message_type;                                                   //! COMM_RESPONSE_PROFILE
+    uint8_t stage;                                                          //! Profiled stage, COMM_PROFILE_STAGE_NONE without statistics
+    uint32_t count;                                                         //! Number of records
+    uint32_t min_cycles;                                                    //! Minimum cycles
+    uint32_t max_cycles;                                                    //! Maximum cycles
+    uint64_t total_cycles;                                                  //! Sum of all cycles
+    uint8_t first_bucket;                                                   //! Histogram bucket of the first count
+    uint32_t histogram[COMM_PROFILE_BUCKETS_PER_RESPONSE];                  //! Bucket n counts records with cycles in [2^(n-1), 2^n), 0 past the last bucket
+} comm_profile_response_t;
+
+/**
+ * @brief Profile ring response. An overwritten first index is moved on to the oldest sample still kept, the master
+ * continues at the first index plus the count until it reaches the written count.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t message_type;                                                   //! COMM_RESPONSE_PROFILE_RING
+    uint32_t written;                                                       //! Samples written since boot or the last reset of the profiler, 0 if the profiler is disabled
+    uint32_t first_index;                                                   //! Index of the first sample in the response
+    uint8_t count;                                                          //! Number of samples in the response
+    profiler_sample_t samples[COMM_PROFILE_SAMPLES_PER_RESPONSE];           //! Samples, oldest first
+} comm_profile_ring_response_t;
+
+/**
+ * @brief Any worker frame, sized for the largest response.
+ * 
+ */
+typedef union __attribute__((packed)) {
+    uint8_t message_type;
+    comm_solution_response_t solution;
+    comm_solution_batch_response_t solution_batch;
+    comm_progress_response_t progress;
+    comm_digest_response_t digest;
+    comm_proof_response_t proof;
+    comm_identify_response_t identify;
+    comm_status_response_t status;
+    comm_estimate_response_t estimate;
+    comm_profile_response_t profile;
+    comm_profile_ring_response_t profile_ring;
+} comm_response_t;
+
+/**
+ * @brief I2C register map status register.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t result_count;                                                   //! Result frames waiting in the result FIFO
+    uint8_t job_slots_free;                                                 //! Master frames that can be written without being dropped
+} comm_i2c_status_register_t;
+
+/**
+ * @brief I2C register map counters register, every counter counts since boot.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t jobs_received;                                                 //! Master frames written into a job slot
+    uint32_t jobs_dropped;                                                  //! Master frames dropped because every job slot was taken
+    uint32_t results_queued;                                                //! Result frames put into the result FIFO
+    uint32_t results_read;                                                  //! Result frames taken by the master
+    uint32_t register_reads;                                                //! Register reads of the master
+} comm_i2c_counters_register_t;
+
+#endif
@@ -24,7 +24,7 @@
 /**
  * @brief Initialize I2C slave.
  * 
- * @param on_receive_queue_length On receive queue length.
+ * @param on_receive_queue_length On receive queue length, must be a power of two.
  * @param on_receive_queue_item_size On receive queue item size.
  */
 void i2c_manager_slave_init(int on_receive_queue_length, int on_receive_queue_item_size);
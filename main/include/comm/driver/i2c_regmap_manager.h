@@ -0,0 +1,53 @@
+/**
+ * @file i2c_regmap_manager.h
+ * @author Iwan Ćulumović
+ * @brief See i2c_regmap_manager.c file.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef __I2C_REGMAP_MANAGER_H__
+#define __I2C_REGMAP_MANAGER_H__
+
+/* ============================== INCLUDES */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/* ============================== MACRO DEFINITIONS */
+
+/* ============================== TYPE DEFINITIONS */
+
+/* ============================== PUBLIC FUNCTION DECLARATIONS */
+
+/**
+ * @brief Initialize I2C slave with a register map.
+ * 
+ * @param job_queue_length Number of job slots, must be a power of two.
+ * @param job_size Size of a master frame written into a job slot.
+ * @param result_queue_length Number of result FIFO entries, must be a power of two.
+ * @param result_size Size of a result frame read from the result register.
+ */
+void i2c_regmap_manager_slave_init(int job_queue_length, int job_size, int result_queue_length, int result_size);
+
+/**
+ * @brief Puts data into the result FIFO that will be read when master reads the result register. Blocks only while the
+ * result FIFO is full.
+ * 
+ * @param p_buf Pointer to the buffer from where the data will be copied to the result FIFO.
+ * @param buf_size Size of the buffer, the rest of the result frame is zero filled.
+ */
+void i2c_regmap_manager_slave_set_data_to_be_read(uint8_t *p_buf, size_t buf_size);
+
+/**
+ * @brief Reads the oldest master frame written into a job slot. Non-blocking function.
+ * 
+ * @param p_buf Pointer to the buffer to where the data will be copied from the job slot.
+ * @param buf_size Size of the buffer.
+ * 
+ * @return bool Returns true if new data came from master, else false.
+ */
+bool i2c_regmap_manager_slave_receive_data(uint8_t *p_buf, size_t buf_size);
+
+#endif
@@ -0,0 +1,71 @@
+/**
+ * @file sim_manager.h
+ * @author Iwan Ćulumović
+ * @brief See sim_manager.c file.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef __SIM_MANAGER_H__
+#define __SIM_MANAGER_H__
+
+/* ============================== INCLUDES */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/* ============================== TYPE DEFINITIONS */
+
+/* ============================== PUBLIC FUNCTION DECLARATIONS */
+
+/**
+ * @brief Initialize simulated slave.
+ * 
+ * @param receive_queue_length Number of master writes buffered until the slave reads them.
+ * @param receive_data_size Size of the data master writes.
+ * @param send_data_size Size of the data master reads.
+ */
+void sim_manager_slave_init(int receive_queue_length, size_t receive_data_size, size_t send_data_size);
+
+/**
+ * @brief Sets data that will be read when master issues a read. Blocking function, returns after master read it.
+ * 
+ * @param p_buf Pointer to the buffer from where the data will be copied to the send buffer.
+ * @param buf_size Size of the buffer.
+ */
+void sim_manager_slave_set_data_to_be_read(uint8_t *p_buf, size_t buf_size);
+
+/**
+ * @brief Reads new data if master wrote it. Non-blocking function.
+ * 
+ * @param p_buf Pointer to the buffer to where the data will be copied from the receive buffer.
+ * @param buf_size Size of the buffer.
+ * 
+ * @return bool Returns true if new data came from master, else false.
+ */
+bool sim_manager_slave_receive_data(uint8_t *p_buf, size_t buf_size);
+
+/**
+ * @brief Writes data to the slave as the master. Blocking function if the receive queue is full.
+ * 
+ * @param p_buf Pointer to the data.
+ * @param buf_size Size of the data, at most the receive data size.
+ */
+void sim_manager_master_write(const uint8_t *p_buf, size_t buf_size);
+
+/**
+ * @brief Reads data the slave set to be read as the master.
+ * 
+ * @param p_buf Pointer to where the data will be copied.
+ * @param buf_size Size of the buffer, at most the send data size.
+ * @param timeout_ticks Ticks to wait for the slave to set data.
+ * 
+ * @return bool Returns true if data was read, false on timeout.
+ */
+bool sim_manager_master_read(uint8_t *p_buf, size_t buf_size, TickType_t timeout_ticks);
+
+#endif
@@ -19,13 +19,25 @@
 
 /* ============================== TYPE DEFINITIONS */
 
+/**
+ * @brief Stream frame callback, called from the SPI transaction task while the next frame is received.
+ * 
+ * @param p_frame Pointer to the stream frame, valid until the callback returns.
+ * @param frame_size Number of bytes the master clocked after the command byte, may include DMA alignment padding.
+ */
+typedef void (*spi_manager_stream_callback_t)(const uint8_t *p_frame, size_t frame_size);
+
 /* ============================== PUBLIC FUNCTION DECLARATIONS */
 
 /**
  * @brief Initialize SPI slave.
  * 
+ * @param receive_data_size Size of the data master writes.
+ * @param send_data_size Size of the data master reads.
+ * @param stream_frame_size Largest stream frame master writes, transactions are sized for it.
+ * @param stream_callback Callback every stream frame is handed to.
  */
-void spi_manager_slave_init(void);
+void spi_manager_slave_init(size_t receive_data_size, size_t send_data_size, size_t stream_frame_size, spi_manager_stream_callback_t stream_callback);
 
 /**
  * @brief Sets data in the send ring buffer that will be read when master issues a read request. Blocking function.
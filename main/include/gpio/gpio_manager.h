@@ -11,6 +11,7 @@
 #define __GPIO_MANAGER_H__
 
 /* ============================== INCLUDES */
+#include "sdkconfig.h"
 
 /* ============================== MACRO DEFINITIONS */
 
@@ -40,4 +41,18 @@ void gpio_set_interrupt_out(void);
  */
 void gpio_reset_interrupt_out(void);
 
+#ifdef CONFIG_COMM_PROTOCOL_I2C_SPI
+/**
+ * @brief Activates control plane interrupt line.
+ * 
+ */
+void gpio_set_control_interrupt_out(void);
+
+/**
+ * @brief Deactivates control plane interrupt line.
+ * 
+ */
+void gpio_reset_control_interrupt_out(void);
+#endif
+
 #endif
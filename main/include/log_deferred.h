@@ -0,0 +1,72 @@
+/**
+ * @file log_deferred.h
+ * @author Iwan Ćulumović
+ * @brief See log_deferred.c file.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef __LOG_DEFERRED_H__
+#define __LOG_DEFERRED_H__
+
+/* ============================== INCLUDES */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "sdkconfig.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+#ifndef CONFIG_LOG_DEFERRED_ENABLE
+
+#define log_deferred_init()
+#define log_deferred_get_stats(p_stats)         ((void)(p_stats))
+#define log_deferred_direct_printf(...)         printf(__VA_ARGS__)
+
+#endif
+
+/* ============================== TYPE DEFINITIONS */
+
+/**
+ * @brief Deferred log statistics.
+ * 
+ */
+typedef struct {
+    uint32_t written;                           //! Records written to the console by the drain task
+    uint32_t dropped_full;                      //! Records dropped because the ring buffer was full
+    uint32_t dropped_rate_limit;                //! Records dropped by the per tag rate limit
+    uint32_t truncated;                         //! Records truncated to the record size
+} log_deferred_stats_t;
+
+/* ============================== PUBLIC FUNCTION DECLARATIONS */
+
+#ifdef CONFIG_LOG_DEFERRED_ENABLE
+
+/**
+ * @brief Initialize deferred logging. From here on every log line is formatted into the ring buffer by the caller and
+ * written to the console by the drain task, error lines are still written directly.
+ * 
+ */
+void log_deferred_init(void);
+
+/**
+ * @brief Gets deferred log statistics.
+ * 
+ * @param p_stats Pointer to where the statistics will be written.
+ */
+void log_deferred_get_stats(log_deferred_stats_t *p_stats);
+
+/**
+ * @brief Writes a line directly to the console, past the ring buffer and the rate limit. For bulk dumps that were
+ * asked for, the calling task waits on the UART.
+ * 
+ * @param p_format Format string of the line.
+ * 
+ * @return int Line length in bytes.
+ */
+int log_deferred_direct_printf(const char *p_format, ...);
+
+#endif
+
+#endif
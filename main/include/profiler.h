@@ -0,0 +1,146 @@
+/**
+ * @file profiler.h
+ * @author Iwan Ćulumović
+ * @brief See profiler.c file.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+/* ============================== INCLUDES */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "sdkconfig.h"
+
+#ifdef CONFIG_PROFILER_ENABLE
+#include "esp_cpu.h"
+#endif
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Number of log2 cycle histogram buckets per stage. */
+#define PROFILER_HISTOGRAM_BUCKETS              (32)
+
+#ifdef CONFIG_PROFILER_ENABLE
+
+/** @brief Declares a local variable and stores the current CPU cycle count into it. */
+#define PROFILER_START(start)                   uint32_t start = (uint32_t)esp_cpu_get_cycle_count()
+
+/** @brief Records the cycles elapsed since PROFILER_START for the given stage. */
+#define PROFILER_STOP(stage, start)             profiler_record((stage), (uint32_t)esp_cpu_get_cycle_count() - (start))
+
+#else
+
+#define PROFILER_START(start)
+#define PROFILER_STOP(stage, start)
+
+#define profiler_init()
+#define profiler_record(stage, cycles)
+#define profiler_reset()
+#define profiler_dump()
+#define profiler_ring_copy(p_index, p_samples, max_samples, p_written)   (0)
+#define profiler_stage_stats_get(stage, p_stats)        (false)
+
+#endif
+
+/* ============================== TYPE DEFINITIONS */
+
+/**
+ * @brief Profiled stages.
+ * 
+ */
+typedef enum {
+    PROFILER_STAGE_KERNEL = 0,                  //! SHA256 kernel of a single candidate
+    PROFILER_STAGE_COMPARE,                     //! Hash to target comparison
+    PROFILER_STAGE_QUEUE_PUT,                   //! Calculator queue put
+    PROFILER_STAGE_QUEUE_GET,                   //! Calculator queue get
+    PROFILER_STAGE_SPI_TRANSACTION,             //! SPI transaction handling after completion
+    PROFILER_STAGE_I2C_ON_REQUEST,              //! I2C on request ISR callback
+    PROFILER_STAGE_I2C_ON_RECEIVE,              //! I2C on receive ISR callback
+    PROFILER_STAGE_COUNT,
+} profiler_stage_t;
+
+/**
+ * @brief Per stage statistics.
+ * 
+ */
+typedef struct {
+    uint32_t count;                                     //! Number of records
+    uint32_t min_cycles;                                //! Minimum cycles
+    uint32_t max_cycles;                                //! Maximum cycles
+    uint64_t total_cycles;                              //! Sum of all cycles
+    uint32_t histogram[PROFILER_HISTOGRAM_BUCKETS];     //! Bucket n counts records with cycles in [2^(n-1), 2^n)
+} profiler_stage_stats_t;
+
+/**
+ * @brief Profiler ring buffer sample.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t timestamp;                         //! Cycle count when the sample was recorded
+    uint32_t cycles;                            //! Cycles spent in the stage
+    uint8_t stage;                              //! Stage, see profiler_stage_t
+    uint8_t core_id;                            //! Core that recorded the sample
+} profiler_sample_t;
+
+/* ============================== PUBLIC FUNCTION DECLARATIONS */
+
+#ifdef CONFIG_PROFILER_ENABLE
+
+/**
+ * @brief Initialize profiler.
+ * 
+ */
+void profiler_init(void);
+
+/**
+ * @brief Records a stage duration into the stage histogram and the sample ring buffer. Can be called from ISR.
+ * 
+ * @param stage Profiled stage.
+ * @param cycles Cycles spent in the stage.
+ */
+void profiler_record(profiler_stage_t stage, uint32_t cycles);
+
+/**
+ * @brief Clears all histograms and the sample ring buffer.
+ * 
+ */
+void profiler_reset(void);
+
+/**
+ * @brief Dumps stage histograms and the sample ring buffer to the console. The calling task writes the lines itself,
+ * past deferred logging, so the whole ring buffer is written.
+ * 
+ */
+void profiler_dump(void);
+
+/**
+ * @brief Copies samples of the ring buffer, oldest sample first. Samples are indexed by the number of samples written
+ * before them, an index that was already overwritten starts the copy at the oldest sample still kept.
+ * 
+ * @param p_index Pointer to the index of the first sample to copy, the index of the first copied sample is written back.
+ * @param p_samples Pointer to the buffer where the samples will be copied.
+ * @param max_samples Maximum number of samples that fit into the buffer.
+ * @param p_written Pointer to where the number of samples written since the last reset will be written.
+ * 
+ * @return size_t Number of copied samples.
+ */
+size_t profiler_ring_copy(uint32_t *p_index, profiler_sample_t *p_samples, size_t max_samples, uint32_t *p_written);
+
+/**
+ * @brief Copies the statistics of a stage.
+ * 
+ * @param stage Profiled stage.
+ * @param p_stats Pointer to where the statistics will be copied.
+ * 
+ * @return bool Returns true if copied, false if the stage is unknown.
+ */
+bool profiler_stage_stats_get(profiler_stage_t stage, profiler_stage_stats_t *p_stats);
+
+#endif
+
+#endif
@@ -13,31 +13,200 @@
 /* ============================== INCLUDES */
 #include <stdbool.h>
 #include <stdint.h>
+#include "sdkconfig.h"
+#include "sha256_merkle.h"
 
 /* ============================== MACRO DEFINITIONS */
 
 /** @brief SHA256 byte digest size */
-#define SHA256_BYTE_DIGEST_SIZE         (32)
+#define SHA256_BYTE_DIGEST_SIZE             (32)
+
+/** @brief Solution status, a matching offset was found. */
+#define SHA256_SOLUTION_STATUS_FOUND        (0x00)
+
+/** @brief Solution status, every offset of the nonce space was searched without a match. */
+#define SHA256_SOLUTION_STATUS_EXHAUSTED    (0x01)
+
+/** @brief Solution status, the job was rejected (unknown job type or invalid job parameters). */
+#define SHA256_SOLUTION_STATUS_INVALID_JOB  (0x02)
+
+/** @brief Solution status, the job budget ran out before a match. The offset solution is the first offset not searched. */
+#define SHA256_SOLUTION_STATUS_BUDGET_EXHAUSTED (0x03)
+
+/** @brief Solution status, a hash chain reached its last iteration. The offset solution is the chain index of the digest. */
+#define SHA256_SOLUTION_STATUS_CHAIN_DONE   (0x04)
+
+/** @brief Solution status, a hash chain reached a checkpoint and continues. */
+#define SHA256_SOLUTION_STATUS_CHAIN_CHECKPOINT (0x05)
+
+/** @brief Solution status, a Merkle tree was reduced to its root. The offset solution is the input offset of the job. */
+#define SHA256_SOLUTION_STATUS_MERKLE_ROOT  (0x06)
+
+/** @brief Job type, SHA256 of the nonce. */
+#define SHA256_JOB_TYPE_SHA256              (0x00)
+
+/** @brief Job type, SHA256d (SHA256 of the SHA256) of a prefix followed by the nonce. */
+#define SHA256_JOB_TYPE_SHA256D             (0x01)
+
+/** @brief Job type, HMAC-SHA256 of the nonce with a per job key. */
+#define SHA256_JOB_TYPE_HMAC                (0x02)
+
+/** @brief Job type, iterated SHA256 of a 32 byte seed, every iteration hashes the digest of the previous one. */
+#define SHA256_JOB_TYPE_CHAIN               (0x03)
+
+/** @brief Job type, Merkle root of the leaves written before the job. */
+#define SHA256_JOB_TYPE_MERKLE              (0x04)
+
+/** @brief Kernel variant, mbedtls SHA256 of the nonce bytes (hardware accelerated if enabled in mbedtls). */
+#define SHA256_KERNEL_VARIANT_MBEDTLS       (0x00)
+
+/** @brief Kernel variant, single block kernel with the nonce independent message schedule precomputed per job. */
+#define SHA256_KERNEL_VARIANT_PRECOMPUTED   (0x01)
+
+/** @brief Kernel variant, plain single block kernel. */
+#define SHA256_KERNEL_VARIANT_PLAIN         (0x02)
+
+/** @brief Number of kernel variants. */
+#define SHA256_KERNEL_VARIANT_COUNT         (3)
+
+/** @brief Core ID of a calculator task that isn't pinned to a core. */
+#define SHA256_CORE_ID_ANY                  (0xFF)
+
+/** @brief SHA256d prefix storage size in bytes, the largest prefix of a SHA256d job. */
+#define SHA256D_PREFIX_MAX_SIZE             (128)
+
+/** @brief SHA256d match flag, masked bits of the digest must match the target solution. */
+#define SHA256D_MATCH_FLAG_TARGET           (0x01)
+
+/** @brief SHA256d match flag, the digest must be less than or equal to the threshold. */
+#define SHA256D_MATCH_FLAG_THRESHOLD        (0x02)
+
+/** @brief SHA256d match flag, the digest and the threshold are compared as little endian numbers (Bitcoin order). */
+#define SHA256D_MATCH_FLAG_THRESHOLD_LE     (0x04)
+
+/** @brief HMAC key maximum size in bytes, one block. Longer keys are replaced by their SHA256 by the master. */
+#define SHA256_HMAC_KEY_MAX_SIZE            (64)
+
+/** @brief Merkle tree depth limit, the leaf storage holds two to the power of the depth leaves. */
+#ifdef CONFIG_SHA256_CALC_MERKLE_DEPTH_MAX
+#define SHA256_MERKLE_DEPTH_MAX             (CONFIG_SHA256_CALC_MERKLE_DEPTH_MAX)
+#else
+#define SHA256_MERKLE_DEPTH_MAX             (8)
+#endif
+
+/** @brief Merkle leaf storage size in leaves. */
+#define SHA256_MERKLE_LEAVES_MAX            (1 << SHA256_MERKLE_DEPTH_MAX)
+
+/** @brief Largest number of leaves of a Merkle job that get a proof path. */
+#define SHA256_MERKLE_PROOFS_MAX            (4)
+
+/** @brief Largest number of siblings in a proof queue element, deeper proofs take several elements. */
+#define SHA256_MERKLE_PROOF_SIBLINGS_MAX    (2)
+
+/** @brief Estimate flag, a job is being searched. */
+#define SHA256_ESTIMATE_FLAG_ACTIVE         (0x01)
+
+/** @brief Estimate flag, the job ends at its first match, so its hashes are expected values rather than exact ones. */
+#define SHA256_ESTIMATE_FLAG_SEARCH         (0x02)
+
+/** @brief Estimate flag, the measured hash rate of the job is below the slow share of the calibrated hash rate. */
+#define SHA256_ESTIMATE_FLAG_SLOW           (0x04)
 
 /* ============================== TYPE DEFINITIONS */
 
+/**
+ * @brief Nonce (offset) of a candidate, hashed as its little endian bytes.
+ * 
+ */
+#ifdef CONFIG_SHA256_CALC_NONCE_64BIT
+typedef uint64_t sha256_nonce_t;
+#else
+typedef uint32_t sha256_nonce_t;
+#endif
+
 /**
  * @brief Calculator input variables.
  * 
  */
 typedef struct __attribute__((packed)) {
-    uint32_t input_offset;
+    sha256_nonce_t input_offset;
     uint8_t target_solution_mask_offset;
     uint8_t target_solution[SHA256_BYTE_DIGEST_SIZE];
 } sha256_input_variables_t;
 
 /**
- * @brief Calculator input variables queue element.
+ * @brief Calculator SHA256d input variables. The hashed message is the prefix followed by the nonce, the prefix is
+ * written into the prefix storage before the job.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    sha256_nonce_t input_offset;
+    uint8_t target_solution_mask_offset;
+    uint8_t target_solution[SHA256_BYTE_DIGEST_SIZE];
+    uint8_t threshold[SHA256_BYTE_DIGEST_SIZE];         //! Big endian number, little endian with SHA256D_MATCH_FLAG_THRESHOLD_LE
+    uint8_t match_flags;                                //! SHA256D_MATCH_FLAG_* flags, at least one match flag must be set
+    uint8_t prefix_size;                                //! Prefix size in bytes from the start of the prefix storage, must be a multiple of 4
+} sha256d_input_variables_t;
+
+/**
+ * @brief Calculator HMAC input variables. The hashed message is the nonce, keyed with the key.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    sha256_nonce_t input_offset;
+    uint8_t target_solution_mask_offset;
+    uint8_t target_solution[SHA256_BYTE_DIGEST_SIZE];
+    uint8_t key_size;                                   //! Key size in bytes
+    uint8_t key[SHA256_HMAC_KEY_MAX_SIZE];
+} sha256_hmac_input_variables_t;
+
+/**
+ * @brief Calculator hash chain input variables. The input offset takes the place of the nonce, it counts iterations.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    sha256_nonce_t input_offset;                        //! Chain index of the seed, the reported offset is the chain index of the digest
+    uint64_t iterations;                                //! Number of iterations, must not be 0
+    uint32_t checkpoint_interval;                       //! Iterations between two checkpoints, 0 for none
+    uint8_t seed[SHA256_BYTE_DIGEST_SIZE];
+} sha256_chain_input_variables_t;
+
+/**
+ * @brief Calculator Merkle input variables. The leaves are written before the job, the job reduces them in place.
  * 
  */
 typedef struct __attribute__((packed)) {
-    sha256_input_variables_t sha256_input_variables;
+    sha256_nonce_t input_offset;                        //! Reported back as the offset solution of the root
+    uint16_t leaf_count;                                //! Number of leaves from leaf index 0, 1 to SHA256_MERKLE_LEAVES_MAX
+    uint8_t flags;                                      //! SHA256_MERKLE_FLAG_* flags
+    uint8_t proof_count;                                //! Number of leaves that get a proof path, up to SHA256_MERKLE_PROOFS_MAX
+    uint16_t proof_leaf_indices[SHA256_MERKLE_PROOFS_MAX];
+} sha256_merkle_input_variables_t;
+
+/**
+ * @brief Job budget, the search stops with a progress record once either limit is reached.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t time_budget_ms;                            //! Search time limit from the job arrival, 0 for no limit
+    uint64_t hash_budget;                               //! Number of candidates to test, 0 for no limit
+} sha256_job_budget_t;
+
+/**
+ * @brief Calculator input variables queue element, the job type selects the input variables.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t job_type;
     uint8_t puzzle_id;
+    union __attribute__((packed)) {
+        sha256_input_variables_t sha256_input_variables;
+        sha256d_input_variables_t sha256d_input_variables;
+        sha256_hmac_input_variables_t sha256_hmac_input_variables;
+        sha256_chain_input_variables_t sha256_chain_input_variables;
+        sha256_merkle_input_variables_t sha256_merkle_input_variables;
+    };
+    sha256_job_budget_t job_budget;                     //! Zero for a job that runs until a match
 } sha256_input_variables_queue_element_t;
 
 /**
@@ -45,7 +214,7 @@ typedef struct __attribute__((packed)) {
  * 
  */
 typedef struct __attribute__((packed)) {
-    uint32_t offset_solution;
+    sha256_nonce_t offset_solution;
 } sha256_offset_solution_t;
 
 /**
@@ -55,8 +224,92 @@ typedef struct __attribute__((packed)) {
 typedef struct __attribute__((packed)) {
     sha256_offset_solution_t sha256_offset_solution;
     uint8_t puzzle_id;
+    uint8_t status;
 } sha256_offset_solution_queue_element_t;
 
+/**
+ * @brief Calculator progress of a job whose budget ran out, of a hash chain or the root of a Merkle job.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    sha256_offset_solution_queue_element_t sha256_offset_solution_queue_element;    //! First offset not searched, SHA256_SOLUTION_STATUS_BUDGET_EXHAUSTED or a chain status
+    uint64_t hashes;                                    //! Candidates tested, iterations for a hash chain, node hashes for a Merkle job
+    uint8_t best_digest[SHA256_BYTE_DIGEST_SIZE];       //! Lowest digest in threshold order for SHA256d threshold jobs, chain digest for hash chains, root for Merkle jobs, else zero
+} sha256_progress_queue_element_t;
+
+/**
+ * @brief Calculator Merkle proof path of a leaf, or a part of it if the tree is deeper than the siblings of an element.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t puzzle_id;
+    uint16_t leaf_index;                                //! Leaf the proof is for
+    uint8_t depth;                                      //! Tree depth, the number of siblings of the whole proof
+    uint8_t first_level;                                //! Level of the first sibling, 0 for the sibling of the leaf
+    uint8_t sibling_count;                              //! Number of siblings in this element
+    uint8_t siblings[SHA256_MERKLE_PROOF_SIBLINGS_MAX][SHA256_BYTE_DIGEST_SIZE];    //! Siblings from the lowest level up
+} sha256_merkle_proof_queue_element_t;
+
+/**
+ * @brief Calculator status.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t batch_size;                        //! Number of candidates searched between two input queue checks
+    uint32_t batch_size_min;                    //! Smallest batch size chosen since boot
+    uint32_t batch_size_max;                    //! Largest batch size chosen since boot
+    uint32_t batch_duration_us;                 //! Duration of the last batch
+    uint32_t control_overhead_ppm;              //! Share of the last batch period spent on the input queue check, in ppm
+    uint32_t hash_rate;                         //! Hashes per second measured over the last batch
+    uint64_t hashes_total;                      //! Hashes calculated since boot
+    uint32_t cache_hits;                        //! Puzzles answered from the result cache without searching
+    uint32_t cache_range_hits;                  //! Puzzles answered from the result cache after searching up to a cached range
+    uint32_t cache_misses;                      //! Puzzles not found in the result cache
+    uint64_t idle_us_total;                     //! Time spent waiting for input variables since boot
+    uint64_t hashes_superseded;                 //! Hashes calculated for puzzles replaced by new input variables before a solution
+} sha256_calculator_status_t;
+
+/**
+ * @brief Calculator capabilities, fixed after initialization.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t nonce_size;                         //! Nonce size in bytes
+    uint8_t job_types;                          //! Supported job types, bit n set if job type n is supported
+    uint8_t kernel_variant;                     //! SHA256 job kernel variant, SHA256_KERNEL_VARIANT_*
+    uint8_t core_id;                            //! Core the calculator task runs on, SHA256_CORE_ID_ANY if not pinned
+    uint8_t worker_count;                       //! Number of calculator tasks searching in parallel
+    uint8_t input_queue_length;                 //! Number of jobs queued before the calculator picks them up
+    uint32_t batch_size_max;                    //! Largest number of candidates searched between two input queue checks
+    uint32_t hash_rate_sha256;                  //! SHA256 hashes per second measured at initialization
+    uint32_t hash_rate_sha256d;                 //! SHA256d hashes per second measured at initialization
+    uint32_t kernel_hash_rates[SHA256_KERNEL_VARIANT_COUNT];    //! SHA256 hashes per second of each kernel variant on the core, 0 if not autotuned
+    uint32_t hash_rate_hmac;                    //! HMAC-SHA256 hashes per second measured at initialization
+    uint32_t hash_rate_chain;                   //! Hash chain iterations per second measured at initialization
+    uint32_t hash_rate_merkle;                  //! Merkle node hashes per second measured at initialization
+    uint16_t merkle_leaves_max;                 //! Merkle leaf storage size in leaves
+} sha256_calculator_capabilities_t;
+
+/**
+ * @brief Calculator estimate of the current job, or of the last one if none is being searched. The expected hashes of
+ * a search follow from the mask width and the range it may search, the remaining time is refined from the candidates
+ * tested so far and the hash rate measured over the job.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t puzzle_id;
+    uint8_t job_type;                           //! SHA256_JOB_TYPE_*
+    uint8_t flags;                              //! SHA256_ESTIMATE_FLAG_* flags
+    uint64_t expected_hashes;                   //! Expected candidates of the whole job, iterations or node hashes of a chain or Merkle job
+    uint64_t job_hashes;                        //! Candidates tested so far
+    uint32_t elapsed_ms;                        //! Time since the job arrived, until its end once it ended
+    uint32_t eta_ms;                            //! Expected time until the job ends, 0 once it ended
+    uint32_t hash_rate;                         //! Hashes per second measured over the job, the calibrated hash rate before the first batch
+    uint32_t hash_rate_expected;                //! Calibrated hashes per second of the job type
+    uint64_t lease_hashes;                      //! Candidates tested within the lease time at the measured hash rate
+    uint32_t lease_solve_ppm;                   //! Probability that the job ends within the lease time, in ppm
+} sha256_calculator_estimate_t;
+
 /* ============================== PUBLIC FUNCTION DECLARATIONS */
 
 /**
@@ -81,4 +334,97 @@ void sha256_calculator_queue_input_put(sha256_input_variables_queue_element_t *p
  */
 bool sha256_calculator_queue_solution_get(sha256_offset_solution_queue_element_t *p_sha256_offset_solution_queue_element);
 
+/**
+ * @brief Gets the progress record of a job whose budget ran out, of a hash chain or of a Merkle job. Every solution
+ * with status SHA256_SOLUTION_STATUS_BUDGET_EXHAUSTED, a chain status or SHA256_SOLUTION_STATUS_MERKLE_ROOT has one,
+ * queued before the solution. Non-blocking function.
+ * 
+ * @param p_sha256_progress_queue_element Pointer to the progress queue element which will be copied from the queue.
+ * 
+ * @return bool Returns true if a progress record was taken, else false.
+ */
+bool sha256_calculator_queue_progress_get(sha256_progress_queue_element_t *p_sha256_progress_queue_element);
+
+/**
+ * @brief Gets a part of a Merkle proof path. Every proof of a Merkle job is queued before its root. Non-blocking
+ * function.
+ * 
+ * @param p_sha256_merkle_proof_queue_element Pointer to the proof queue element which will be copied from the queue.
+ * 
+ * @return bool Returns true if a proof was taken, else false.
+ */
+bool sha256_calculator_queue_proof_get(sha256_merkle_proof_queue_element_t *p_sha256_merkle_proof_queue_element);
+
+/**
+ * @brief Claims the Merkle leaf storage for writing leaves. If a Merkle job is queued or reduces the leaf storage, the
+ * calculator is asked to stop it without a result and false is returned, the caller keeps draining results and calls
+ * again until true is returned. No Merkle job may be queued between the claim and the leaves put. Non-blocking function.
+ * 
+ * @return bool Returns true if the leaf storage is free, else false.
+ */
+bool sha256_calculator_merkle_leaves_claim(void);
+
+/**
+ * @brief Writes Merkle leaves into the leaf storage, which must be claimed first.
+ * 
+ * @param first_leaf_index Leaf index of the first leaf.
+ * @param leaf_count Number of leaves.
+ * @param p_leaves Pointer to the leaves, 32 bytes each.
+ * 
+ * @return bool Returns true if the leaves were written, false if they don't fit the leaf storage.
+ */
+bool sha256_calculator_merkle_leaves_put(uint16_t first_leaf_index, uint8_t leaf_count, const uint8_t *p_leaves);
+
+/**
+ * @brief Claims the SHA256d prefix storage for writing prefix bytes. If a SHA256d job queued before hasn't compressed
+ * the prefix it was queued with yet, false is returned, the caller keeps draining results and calls again until true
+ * is returned. No SHA256d job may be queued between the claim and the prefix put. Non-blocking function.
+ * 
+ * @return bool Returns true if the prefix storage is free, else false.
+ */
+bool sha256_calculator_sha256d_prefix_claim(void);
+
+/**
+ * @brief Writes a part of the SHA256d prefix into the prefix storage, which must be claimed first. Used by SHA256d jobs
+ * queued afterwards.
+ * 
+ * @param offset Byte offset of the first prefix byte.
+ * @param size Number of prefix bytes.
+ * @param p_prefix Pointer to the prefix bytes.
+ * 
+ * @return bool Returns true if the prefix bytes were written, false if they don't fit the prefix storage.
+ */
+bool sha256_calculator_sha256d_prefix_put(uint8_t offset, uint8_t size, const uint8_t *p_prefix);
+
+/**
+ * @brief Gets a snapshot of the calculator status. Non-blocking function.
+ * 
+ * @param p_sha256_calculator_status Pointer to where the status will be copied.
+ */
+void sha256_calculator_get_status(sha256_calculator_status_t *p_sha256_calculator_status);
+
+/**
+ * @brief Gets the calculator capabilities. Non-blocking function.
+ * 
+ * @param p_sha256_calculator_capabilities Pointer to where the capabilities will be copied.
+ */
+void sha256_calculator_get_capabilities(sha256_calculator_capabilities_t *p_sha256_calculator_capabilities);
+
+/**
+ * @brief Gets the estimate of the current job. Non-blocking function.
+ * 
+ * @param lease_ms Lease time the lease hashes and the lease solve probability are given for, in milliseconds.
+ * @param p_sha256_calculator_estimate Pointer to where the estimate will be written.
+ */
+void sha256_calculator_get_estimate(uint32_t lease_ms, sha256_calculator_estimate_t *p_sha256_calculator_estimate);
+
+/**
+ * @brief Checks if a solution status comes with a progress record.
+ * 
+ * @param status Solution status.
+ * 
+ * @return bool Returns true if a progress record is queued before the solution, else false.
+ */
+bool sha256_calculator_status_has_progress(uint8_t status);
+
 #endif
@@ -0,0 +1,137 @@
+/**
+ * @file sha256_kernel.h
+ * @author Iwan Ćulumović
+ * @brief See sha256_kernel.c file.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef __SHA256_KERNEL_H__
+#define __SHA256_KERNEL_H__
+
+/* ============================== INCLUDES */
+#include <stdint.h>
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief SHA256 state size in words. */
+#define SHA256_KERNEL_STATE_WORDS               (8)
+
+/** @brief SHA256 block size in words. */
+#define SHA256_KERNEL_BLOCK_WORDS               (16)
+
+/** @brief SHA256 message schedule size in words. */
+#define SHA256_KERNEL_SCHEDULE_WORDS            (64)
+
+/** @brief SHA256 block size in bytes. */
+#define SHA256_KERNEL_BLOCK_SIZE                (SHA256_KERNEL_BLOCK_WORDS * 4)
+
+/** @brief Number of independent messages hashed side by side by the lane kernels. */
+#define SHA256_KERNEL_LANES                     (8)
+
+/* ============================== TYPE DEFINITIONS */
+
+/**
+ * @brief Precomputed state for hashing single blocks where only the first message word changes between candidates.
+ * 
+ */
+typedef struct {
+    uint32_t initial_state[SHA256_KERNEL_STATE_WORDS];      //! Chaining state the block is compressed into
+    uint32_t round_1_state[SHA256_KERNEL_STATE_WORDS];      //! State after round 0 without the first message word
+    uint32_t k_w[SHA256_KERNEL_BLOCK_WORDS];                //! Round constant plus message word for rounds 1 to 15
+    uint32_t w[SHA256_KERNEL_SCHEDULE_WORDS];               //! First message word independent part of the schedule
+} sha256_kernel_w0_ctx_t;
+
+/**
+ * @brief One word of every lane. Operators apply lane by lane and map to SIMD instructions where the target has them.
+ * 
+ */
+typedef uint32_t sha256_kernel_lanes_t __attribute__((vector_size(SHA256_KERNEL_LANES * sizeof(uint32_t))));
+
+/* ============================== PUBLIC VARIABLES */
+
+/** @brief SHA256 initial hash value. */
+extern const uint32_t sha256_kernel_initial_state[SHA256_KERNEL_STATE_WORDS];
+
+/* ============================== PUBLIC FUNCTION DECLARATIONS */
+
+/**
+ * @brief Compresses a single block into the chaining state.
+ * 
+ * @param p_state Pointer to the chaining state which will be updated.
+ * @param p_block Pointer to the block as big endian message words.
+ */
+void sha256_kernel_compress(uint32_t *p_state, const uint32_t *p_block);
+
+/**
+ * @brief Hashes a single, already padded block from the initial hash value.
+ * 
+ * @param p_block Pointer to the padded block as big endian message words.
+ * @param p_digest Pointer to where the digest words will be written.
+ */
+void sha256_kernel_block_hash(const uint32_t *p_block, uint32_t *p_digest);
+
+/**
+ * @brief Precomputes everything in a single block compression that doesn't depend on the first message word.
+ * 
+ * @param p_ctx Pointer to the context which will be filled.
+ * @param p_state Pointer to the chaining state the block is compressed into.
+ * @param p_block Pointer to the block as big endian message words, the first word is ignored.
+ */
+void sha256_kernel_w0_prepare(sha256_kernel_w0_ctx_t *p_ctx, const uint32_t *p_state, const uint32_t *p_block);
+
+/**
+ * @brief Compresses the prepared block with the given first message word.
+ * 
+ * @param p_ctx Pointer to the prepared context.
+ * @param w0 First message word.
+ * @param p_digest Pointer to where the resulting chaining state words will be written.
+ */
+void sha256_kernel_w0_hash(const sha256_kernel_w0_ctx_t *p_ctx, uint32_t w0, uint32_t *p_digest);
+
+/**
+ * @brief Hashes a digest again from the initial hash value, the second hash of SHA256d. The digest fills the first
+ * half of the block, the padding in the second half is constant.
+ * 
+ * @param p_digest_in Pointer to the digest words which will be hashed.
+ * @param p_digest Pointer to where the digest words will be written, may be the same as the input.
+ */
+void sha256_kernel_digest_hash(const uint32_t *p_digest_in, uint32_t *p_digest);
+
+/**
+ * @brief Hashes a digest again from the initial hash value a number of times, see sha256_kernel_digest_hash. The
+ * digest stays in the message schedule between iterations, the padding is set up once.
+ * 
+ * @param p_digest Pointer to the digest words which will be replaced by the digest after the last iteration.
+ * @param iterations Number of iterations.
+ */
+void sha256_kernel_digest_chain(uint32_t *p_digest, uint32_t iterations);
+
+/**
+ * @brief Hashes two digests as one 64 byte message from the initial hash value, the interior node of a Merkle tree.
+ * The message fills the first block, the padding block is constant and its rounds use precomputed message words.
+ * 
+ * @param p_left Pointer to the digest words of the first half of the message.
+ * @param p_right Pointer to the digest words of the second half of the message.
+ * @param p_digest Pointer to where the digest words will be written, may be the same as either half.
+ */
+void sha256_kernel_pair_hash(const uint32_t *p_left, const uint32_t *p_right, uint32_t *p_digest);
+
+/**
+ * @brief Compresses one block of every lane into the chaining state of the lane.
+ * 
+ * @param p_state Pointer to the chaining state words of the lanes which will be updated.
+ * @param p_block Pointer to the block words of the lanes as big endian message words.
+ */
+void sha256_kernel_lanes_compress(sha256_kernel_lanes_t *p_state, const sha256_kernel_lanes_t *p_block);
+
+/**
+ * @brief Hashes the digest of every lane again from the initial hash value, see sha256_kernel_digest_hash.
+ * 
+ * @param p_digest_in Pointer to the digest words of the lanes which will be hashed.
+ * @param p_digest Pointer to where the digest words of the lanes will be written, may be the same as the input.
+ */
+void sha256_kernel_lanes_digest_hash(const sha256_kernel_lanes_t *p_digest_in, sha256_kernel_lanes_t *p_digest);
+
+#endif
@@ -0,0 +1,116 @@
+/**
+ * @file sha256_merkle.h
+ * @author Iwan Ćulumović
+ * @brief See sha256_merkle.c file.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef __SHA256_MERKLE_H__
+#define __SHA256_MERKLE_H__
+
+/* ============================== INCLUDES */
+#include <stdbool.h>
+#include <stdint.h>
+#include "sha256_kernel.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Merkle flag, every leaf is a 32 byte value that is hashed first instead of a leaf hash. */
+#define SHA256_MERKLE_FLAG_HASH_LEAVES          (0x01)
+
+/** @brief Merkle flag, nodes and hashed leaves are SHA256d (SHA256 of the SHA256) as in Bitcoin. */
+#define SHA256_MERKLE_FLAG_SHA256D              (0x02)
+
+/** @brief Every Merkle flag. */
+#define SHA256_MERKLE_FLAGS                     (SHA256_MERKLE_FLAG_HASH_LEAVES | SHA256_MERKLE_FLAG_SHA256D)
+
+/* ============================== TYPE DEFINITIONS */
+
+/**
+ * @brief Merkle tree node, a digest as big endian words.
+ * 
+ */
+typedef struct {
+    uint32_t words[SHA256_KERNEL_STATE_WORDS];
+} sha256_merkle_node_t;
+
+/**
+ * @brief Proof path of a leaf, collected while the tree is reduced.
+ * 
+ */
+typedef struct {
+    uint32_t leaf_index;                                //! Leaf the proof is for
+    uint32_t node_index;                                //! Ancestor of the leaf on the level being reduced
+    sha256_merkle_node_t *p_siblings;                   //! One sibling per level from the leaves up, tree depth entries
+} sha256_merkle_proof_t;
+
+/**
+ * @brief Merkle tree being reduced. A level with an odd number of nodes pairs its last node with itself.
+ * 
+ */
+typedef struct {
+    sha256_merkle_node_t *p_nodes;                      //! Leaves, reduced in place, the root ends up in the first node
+    uint32_t node_count;                                //! Number of nodes on the level being reduced
+    uint32_t node_index;                                //! Next node written on the level being reduced
+    uint32_t level;                                     //! Level being reduced, 0 for the leaves
+    uint8_t flags;                                      //! SHA256_MERKLE_FLAG_* flags
+    bool b_leaves_pending;                              //! Leaves aren't hashed yet
+    sha256_merkle_proof_t *p_proofs;                    //! Proofs collected while reducing
+    uint32_t proof_count;                               //! Number of proofs
+} sha256_merkle_tree_t;
+
+/* ============================== PUBLIC FUNCTION DECLARATIONS */
+
+/**
+ * @brief Gets the depth of a tree, the number of levels above the leaves and the number of siblings in a proof.
+ * 
+ * @param leaf_count Number of leaves, at least 1.
+ * 
+ * @return uint32_t Tree depth.
+ */
+uint32_t sha256_merkle_depth(uint32_t leaf_count);
+
+/**
+ * @brief Gets the number of node hashes needed to reduce a tree, hashed leaves count as node hashes.
+ * 
+ * @param leaf_count Number of leaves, at least 1.
+ * @param flags SHA256_MERKLE_FLAG_* flags.
+ * 
+ * @return uint32_t Number of node hashes.
+ */
+uint32_t sha256_merkle_hashes(uint32_t leaf_count, uint8_t flags);
+
+/**
+ * @brief Starts reducing a tree. The leaf index and the sibling storage of every proof must be set.
+ * 
+ * @param p_tree Pointer to the tree which will be set up.
+ * @param p_nodes Pointer to the leaves, they are overwritten by the reduction.
+ * @param leaf_count Number of leaves, at least 1.
+ * @param flags SHA256_MERKLE_FLAG_* flags.
+ * @param p_proofs Pointer to the proofs, NULL if proof_count is 0.
+ * @param proof_count Number of proofs.
+ */
+void sha256_merkle_tree_init(sha256_merkle_tree_t *p_tree, sha256_merkle_node_t *p_nodes, uint32_t leaf_count, uint8_t flags, sha256_merkle_proof_t *p_proofs, uint32_t proof_count);
+
+/**
+ * @brief Reduces the tree by up to the given number of node hashes, level by level.
+ * 
+ * @param p_tree Pointer to the tree.
+ * @param max_hashes Largest number of node hashes.
+ * 
+ * @return uint32_t Number of node hashes done, less than max_hashes once the root is reached.
+ */
+uint32_t sha256_merkle_tree_reduce(sha256_merkle_tree_t *p_tree, uint32_t max_hashes);
+
+/**
+ * @brief Checks if the tree is reduced to its root.
+ * 
+ * @param p_tree Pointer to the tree.
+ * 
+ * @return bool Returns true if the first node is the root, else false.
+ */
+bool sha256_merkle_tree_done(const sha256_merkle_tree_t *p_tree);
+
+#endif
@@ -0,0 +1,64 @@
+/**
+ * @file sha256_result_cache.h
+ * @author Iwan Ćulumović
+ * @brief See sha256_result_cache.c file.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef __SHA256_RESULT_CACHE_H__
+#define __SHA256_RESULT_CACHE_H__
+
+/* ============================== INCLUDES */
+#include <stdbool.h>
+#include <stdint.h>
+#include "sha256_calculator.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/* ============================== TYPE DEFINITIONS */
+
+/**
+ * @brief Result cache lookup outcome.
+ * 
+ */
+typedef enum {
+    SHA256_RESULT_CACHE_MISS = 0,               //! Nothing known about the puzzle
+    SHA256_RESULT_CACHE_HIT,                    //! Solution is known for the start offset
+    SHA256_RESULT_CACHE_RANGE,                  //! Solution is known once the search reaches a later start offset
+} sha256_result_cache_lookup_t;
+
+/* ============================== PUBLIC FUNCTION DECLARATIONS */
+
+/**
+ * @brief Initialize result cache.
+ * 
+ */
+void sha256_result_cache_init(void);
+
+/**
+ * @brief Looks up a puzzle in the result cache. Must be called from the calculator task only.
+ * 
+ * A cached entry of a search that started at offset S and found solution X proves that no offset in [S, X) matches.
+ * A puzzle starting inside [S, X] is solved by X (hit). A puzzle starting before S is solved by X as soon as the
+ * search reaches S without a match (range).
+ * 
+ * @param p_sha256_input_variables Pointer to the input variables of the puzzle.
+ * @param p_range_start Pointer to where the offset the search can stop at will be written on a range outcome.
+ * @param p_solution Pointer to where the cached solution will be written on a hit or range outcome.
+ * 
+ * @return sha256_result_cache_lookup_t Lookup outcome.
+ */
+sha256_result_cache_lookup_t sha256_result_cache_lookup(const sha256_input_variables_t *p_sha256_input_variables, sha256_nonce_t *p_range_start, sha256_nonce_t *p_solution);
+
+/**
+ * @brief Stores a solved puzzle into the result cache, evicting the least recently used entry if the cache is full.
+ * Must be called from the calculator task only.
+ * 
+ * @param p_sha256_input_variables Pointer to the input variables of the solved puzzle.
+ * @param solution Offset solution of the puzzle.
+ */
+void sha256_result_cache_insert(const sha256_input_variables_t *p_sha256_input_variables, sha256_nonce_t solution);
+
+#endif
@@ -0,0 +1,77 @@
+/**
+ * @file sha256_stream.h
+ * @author Iwan Ćulumović
+ * @brief See sha256_stream.c file.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef __SHA256_STREAM_H__
+#define __SHA256_STREAM_H__
+
+/* ============================== INCLUDES */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "sha256_calculator.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Stream frame flag, the frame starts a new message. A stream that wasn't finished yet is dropped. */
+#define SHA256_STREAM_FLAG_FIRST            (0x01)
+
+/** @brief Stream frame flag, the frame ends the message and its digest is sent. */
+#define SHA256_STREAM_FLAG_LAST             (0x02)
+
+/** @brief Stream status, the digest covers every frame of the message. */
+#define SHA256_STREAM_STATUS_DONE           (0x00)
+
+/** @brief Stream status, a frame was lost or came out of order, the digest is zero. */
+#define SHA256_STREAM_STATUS_FRAME_LOST     (0x01)
+
+/* ============================== TYPE DEFINITIONS */
+
+/**
+ * @brief Stream digest queue element, one per finished message.
+ * 
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t puzzle_id;                                  //! Puzzle ID of the first frame
+    uint8_t status;                                     //! SHA256_STREAM_STATUS_*
+    uint8_t dropped;                                    //! Digests of earlier messages dropped since the previous digest
+    uint64_t message_size;                              //! Message size in bytes
+    uint32_t duration_us;                               //! Time from the first frame to the last frame
+    uint8_t digest[SHA256_BYTE_DIGEST_SIZE];
+} sha256_stream_digest_queue_element_t;
+
+/* ============================== PUBLIC FUNCTION DECLARATIONS */
+
+/**
+ * @brief Initialize SHA256 stream.
+ * 
+ */
+void sha256_stream_init(void);
+
+/**
+ * @brief Hashes a frame of the streamed message. Must be called from a single task, the transport task that receives
+ * the frames. The digest of the last frame is put into the digest queue, or dropped if the queue is full. Never blocks.
+ * 
+ * @param puzzle_id Puzzle ID of the message.
+ * @param flags SHA256_STREAM_FLAG_* flags.
+ * @param sequence Frame sequence number, 0 for the first frame and one more for every following frame.
+ * @param p_data Pointer to the frame data, NULL if the frame was damaged and the message is lost.
+ * @param data_size Size of the frame data.
+ */
+void sha256_stream_frame(uint8_t puzzle_id, uint8_t flags, uint16_t sequence, const uint8_t *p_data, size_t data_size);
+
+/**
+ * @brief Gets the digest of a finished message from the digest queue if there is any. Non-blocking function.
+ * 
+ * @param p_sha256_stream_digest_queue_element Pointer to the digest queue element which will be copied from the queue.
+ * 
+ * @return bool Returns true if a digest was taken, else false.
+ */
+bool sha256_stream_queue_digest_get(sha256_stream_digest_queue_element_t *p_sha256_stream_digest_queue_element);
+
+#endif
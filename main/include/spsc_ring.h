@@ -0,0 +1,101 @@
+/**
+ * @file spsc_ring.h
+ * @author Iwan Ćulumović
+ * @brief See spsc_ring.c file.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#ifndef __SPSC_RING_H__
+#define __SPSC_RING_H__
+
+/* ============================== INCLUDES */
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Cache line size the producer and consumer indexes are separated by. */
+#ifdef ESP_PLATFORM
+#define SPSC_RING_CACHE_LINE_SIZE               (32)
+#else
+#define SPSC_RING_CACHE_LINE_SIZE               (64)
+#endif
+
+/* ============================== TYPE DEFINITIONS */
+
+/**
+ * @brief Single producer single consumer ring buffer of fixed size items.
+ * 
+ * Indexes are free running and only masked on access. The producer owns head, the consumer owns tail, each of them
+ * keeps a cached copy of the other index on its own cache line so the shared line is only touched when the cached
+ * copy says the ring is full (producer) or empty (consumer).
+ * 
+ */
+typedef struct {
+    _Alignas(SPSC_RING_CACHE_LINE_SIZE) _Atomic uint32_t head;              //! Next slot to write, written by producer
+    uint32_t tail_cache;                                                    //! Producer copy of tail
+    _Alignas(SPSC_RING_CACHE_LINE_SIZE) _Atomic uint32_t tail;              //! Next slot to read, written by consumer
+    uint32_t head_cache;                                                    //! Consumer copy of head
+    _Alignas(SPSC_RING_CACHE_LINE_SIZE) uint8_t *p_storage;                 //! Item storage, capacity * item_size bytes
+    uint32_t mask;                                                          //! Capacity - 1
+    size_t item_size;                                                       //! Item size in bytes
+} spsc_ring_t;
+
+/* ============================== PUBLIC FUNCTION DECLARATIONS */
+
+/**
+ * @brief Initialize ring buffer.
+ * 
+ * @param p_ring Pointer to the ring buffer.
+ * @param p_storage Pointer to the item storage of at least capacity * item_size bytes.
+ * @param capacity Number of items, must be a power of two.
+ * @param item_size Item size in bytes.
+ * 
+ * @return bool Returns true if initialized, false if capacity isn't a power of two.
+ */
+bool spsc_ring_init(spsc_ring_t *p_ring, void *p_storage, uint32_t capacity, size_t item_size);
+
+/**
+ * @brief Copies an item to the back of the ring buffer. Non-blocking function, producer side only, can be called from ISR.
+ * 
+ * @param p_ring Pointer to the ring buffer.
+ * @param p_item Pointer to the item which will be copied to the ring buffer.
+ * 
+ * @return bool Returns true if the item was copied, false if the ring buffer is full.
+ */
+bool spsc_ring_push(spsc_ring_t *p_ring, const void *p_item);
+
+/**
+ * @brief Copies an item from the front of the ring buffer. Non-blocking function, consumer side only.
+ * 
+ * @param p_ring Pointer to the ring buffer.
+ * @param p_item Pointer to where the item will be copied from the ring buffer.
+ * 
+ * @return bool Returns true if an item was copied, false if the ring buffer is empty.
+ */
+bool spsc_ring_pop(spsc_ring_t *p_ring, void *p_item);
+
+/**
+ * @brief Checks if the ring buffer is empty. Consumer side only.
+ * 
+ * @param p_ring Pointer to the ring buffer.
+ * 
+ * @return bool Returns true if the ring buffer is empty.
+ */
+bool spsc_ring_is_empty(spsc_ring_t *p_ring);
+
+/**
+ * @brief Gets the number of items in the ring buffer. Can be called from either side, the count can be stale by the
+ * time it is used.
+ * 
+ * @param p_ring Pointer to the ring buffer.
+ * 
+ * @return uint32_t Number of items in the ring buffer.
+ */
+uint32_t spsc_ring_count(spsc_ring_t *p_ring);
+
+#endif
@@ -0,0 +1,395 @@
+/**
+ * @file log_deferred.c
+ * @author Iwan Ćulumović
+ * @brief Deferred logging module. Replaces the log output function, so the task that logs only formats the line into a
+ * lock-free ring buffer of fixed size records and a low priority drain task writes them to the console. A task never
+ * waits on the UART, a full ring buffer drops the line and counts it. Lines of each tag are rate limited per period.
+ * Error lines are still written directly, they are rare and mostly followed by an abort. Bulk dumps that were asked for,
+ * like the profiler dump, are written directly too, so the rate limit and the ring buffer don't cut them short.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/* ============================== INCLUDES */
+
+#include <stdarg.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "log_deferred.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Log tag. */
+#define LOG_TAG                                 ("LOG_DEFERRED")
+
+/** @brief Record ring buffer size. Must be a power of two. */
+#define LOG_DEFERRED_RING_SIZE                  (CONFIG_LOG_DEFERRED_RING_SIZE)
+
+/** @brief Record size in bytes, longer lines are truncated. */
+#define LOG_DEFERRED_RECORD_SIZE                (CONFIG_LOG_DEFERRED_RECORD_SIZE)
+
+/** @brief Lines per tag per rate limit period, 0 disables the rate limit. */
+#define LOG_DEFERRED_TAG_RATE_LIMIT             (CONFIG_LOG_DEFERRED_TAG_RATE_LIMIT)
+
+/** @brief Rate limit period in milliseconds. */
+#define LOG_DEFERRED_TAG_RATE_PERIOD_MS         (CONFIG_LOG_DEFERRED_TAG_RATE_PERIOD_MS)
+
+/** @brief Number of tags that are rate limited, further tags are not limited. Must be a power of two. */
+#define LOG_DEFERRED_TAG_SLOTS                  (16)
+
+/** @brief Time the drain task sleeps when the ring buffer is empty in milliseconds. */
+#define LOG_DEFERRED_DRAIN_PERIOD_MS            (10)
+
+/** @brief FNV-1a offset basis of the tag hash. */
+#define LOG_DEFERRED_FNV_OFFSET_BASIS           (2166136261UL)
+
+/** @brief FNV-1a prime of the tag hash. */
+#define LOG_DEFERRED_FNV_PRIME                  (16777619UL)
+
+/** @brief Drain task stack depth. */
+#define TASK_LOG_DEFERRED_DRAIN_STACK_DEPTH     (3072)
+
+/** @brief Drain task priority. */
+#define TASK_LOG_DEFERRED_DRAIN_PRIORITY        (0)
+
+_Static_assert(0 == (LOG_DEFERRED_RING_SIZE & (LOG_DEFERRED_RING_SIZE - 1)), "Deferred log ring buffer size must be a power of two");
+_Static_assert(0 == (LOG_DEFERRED_TAG_SLOTS & (LOG_DEFERRED_TAG_SLOTS - 1)), "Deferred log tag slots must be a power of two");
+
+/* ============================== TYPE DEFINITIONS */
+
+/**
+ * @brief Ring buffer record.
+ * 
+ * The sequence number tells whose turn the record is. It equals the write position when the record is free for the
+ * producer that claimed that position, write position + 1 when it holds a line for the drain task and write position
+ * + ring size once the drain task released it for the next lap.
+ * 
+ */
+typedef struct {
+    _Atomic uint32_t sequence;                  //! Record sequence number
+    uint32_t length;                            //! Line length in bytes
+    char text[LOG_DEFERRED_RECORD_SIZE];        //! Formatted line
+} log_deferred_record_t;
+
+/**
+ * @brief Rate limit state of a tag.
+ * 
+ */
+typedef struct {
+    _Atomic uint32_t tag_hash;                  //! Hash of the tag, 0 while the slot is free
+    _Atomic uint32_t window_start;              //! Tick count when the current period started
+    _Atomic uint32_t count;                     //! Lines in the current period
+} log_deferred_tag_t;
+
+/* ============================== PRIVATE FUNCTION DECLARATIONS */
+
+/**
+ * @brief Log output function. Formats the line into a free record of the ring buffer, never blocks.
+ * 
+ * @param p_format Format string of the line.
+ * @param args Format arguments.
+ * 
+ * @return int Line length in bytes.
+ */
+static int _log_deferred_vprintf(const char *p_format, va_list args);
+
+/**
+ * @brief Skips the color prefix of a line format string.
+ * 
+ * @param p_format Format string of the line.
+ * 
+ * @return const char* Pointer to the level letter.
+ */
+static const char *_log_deferred_level_get(const char *p_format);
+
+/**
+ * @brief Gets the tag of a line from its arguments, before the line is formatted.
+ * 
+ * @param p_format Format string of the line, starting after the level letter.
+ * @param args Format arguments.
+ * 
+ * @return const char* Tag, NULL if the format string doesn't start with the log prefix.
+ */
+static const char *_log_deferred_tag_get(const char *p_format, va_list args);
+
+/**
+ * @brief Counts a line against the rate limit of its tag.
+ * 
+ * @param p_tag Tag of the line.
+ * 
+ * @return bool Returns true if the line can be written, false if the tag is over its rate limit.
+ */
+static bool _log_deferred_rate_check(const char *p_tag);
+
+/**
+ * @brief Task that writes the ring buffer records to the console and reports dropped records.
+ * 
+ * @param p_task_params Task parameters (not used).
+ */
+static void _log_deferred_drain_task(void *p_task_params);
+
+/* ============================== PRIVATE VARIABLES */
+
+/** @brief Record ring buffer. */
+static log_deferred_record_t _g_log_deferred_ring[LOG_DEFERRED_RING_SIZE];
+
+/** @brief Next write position, claimed by the producers. */
+static _Atomic uint32_t _g_log_deferred_head = 0;
+
+/** @brief Next read position, owned by the drain task. */
+static uint32_t _g_log_deferred_tail = 0;
+
+/** @brief Rate limit state per tag. */
+static log_deferred_tag_t _g_log_deferred_tags[LOG_DEFERRED_TAG_SLOTS];
+
+/** @brief Records written to the console. */
+static _Atomic uint32_t _g_log_deferred_written = 0;
+
+/** @brief Records dropped because the ring buffer was full. */
+static _Atomic uint32_t _g_log_deferred_dropped_full = 0;
+
+/** @brief Records dropped by the rate limit. */
+static _Atomic uint32_t _g_log_deferred_dropped_rate_limit = 0;
+
+/** @brief Records truncated to the record size. */
+static _Atomic uint32_t _g_log_deferred_truncated = 0;
+
+/** @brief Log output function replaced by the deferred one, used for error lines. */
+static vprintf_like_t _gp_log_deferred_vprintf_direct = NULL;
+
+/** @brief Drain task handle. */
+static TaskHandle_t _g_task_handle_log_deferred_drain = NULL;
+
+/* ============================== PUBLIC VARIABLES */
+
+/* ============================== PUBLIC FUNCTION DEFINITIONS */
+
+void log_deferred_init(void)
+{
+    BaseType_t result = pdPASS;
+    uint32_t i = 0;
+
+    for (i = 0; i < LOG_DEFERRED_RING_SIZE; i++)
+    {
+        atomic_init(&_g_log_deferred_ring[i].sequence, i);
+    }
+
+    result = xTaskCreate(_log_deferred_drain_task, "LOG_DRAIN", TASK_LOG_DEFERRED_DRAIN_STACK_DEPTH, NULL, TASK_LOG_DEFERRED_DRAIN_PRIORITY, &_g_task_handle_log_deferred_drain);
+    if (pdPASS != result)
+    {
+        ESP_LOGE(LOG_TAG, "Failed to create task for log drain. Aborting!");
+        abort();
+    }
+
+    _gp_log_deferred_vprintf_direct = esp_log_set_vprintf(_log_deferred_vprintf);
+
+    ESP_LOGI(LOG_TAG, "Initialized deferred logging with %d records of %d bytes.", LOG_DEFERRED_RING_SIZE, LOG_DEFERRED_RECORD_SIZE);
+}
+
+void log_deferred_get_stats(log_deferred_stats_t *p_stats)
+{
+    p_stats->written = atomic_load_explicit(&_g_log_deferred_written, memory_order_relaxed);
+    p_stats->dropped_full = atomic_load_explicit(&_g_log_deferred_dropped_full, memory_order_relaxed);
+    p_stats->dropped_rate_limit = atomic_load_explicit(&_g_log_deferred_dropped_rate_limit, memory_order_relaxed);
+    p_stats->truncated = atomic_load_explicit(&_g_log_deferred_truncated, memory_order_relaxed);
+}
+
+int log_deferred_direct_printf(const char *p_format, ...)
+{
+    va_list args;
+    int length = 0;
+
+    va_start(args, p_format);
+    length = (NULL != _gp_log_deferred_vprintf_direct) ? _gp_log_deferred_vprintf_direct(p_format, args) : vprintf(p_format, args);
+    va_end(args);
+
+    return length;
+}
+
+/* ============================== PRIVATE FUNCTION DEFINITIONS */
+
+static int _log_deferred_vprintf(const char *p_format, va_list args)
+{
+    log_deferred_record_t *p_record = NULL;
+    const char *p_level = _log_deferred_level_get(p_format);
+    const char *p_tag = NULL;
+    uint32_t position = 0;
+    uint32_t sequence = 0;
+    int length = 0;
+
+    if ('E' == *p_level) return _gp_log_deferred_vprintf_direct(p_format, args);
+
+    /* Rate limit is checked before a record is claimed, so dropped lines don't take up the ring buffer */
+    p_tag = _log_deferred_tag_get(p_level + 1, args);
+    if ((NULL != p_tag) && (false == _log_deferred_rate_check(p_tag)))
+    {
+        atomic_fetch_add_explicit(&_g_log_deferred_dropped_rate_limit, 1, memory_order_relaxed);
+        return 0;
+    }
+
+    /* Claim the record at the write position, a producer that lost the race retries at the next position */
+    position = atomic_load_explicit(&_g_log_deferred_head, memory_order_relaxed);
+    while (1)
+    {
+        p_record = &_g_log_deferred_ring[position & (LOG_DEFERRED_RING_SIZE - 1)];
+        sequence = atomic_load_explicit(&p_record->sequence, memory_order_acquire);
+
+        if (sequence == position)
+        {
+            if (atomic_compare_exchange_weak_explicit(&_g_log_deferred_head, &position, position + 1, memory_order_relaxed, memory_order_relaxed)) break;
+        }
+        else if ((int32_t)(sequence - position) < 0)
+        {
+            /* Record of the previous lap isn't drained yet */
+            atomic_fetch_add_explicit(&_g_log_deferred_dropped_full, 1, memory_order_relaxed);
+            return 0;
+        }
+        else
+        {
+            position = atomic_load_explicit(&_g_log_deferred_head, memory_order_relaxed);
+        }
+    }
+
+    /* Line is formatted straight into the record, the stack of the logging task isn't grown by a line buffer */
+    length = vsnprintf(p_record->text, LOG_DEFERRED_RECORD_SIZE, p_format, args);
+    if (length >= LOG_DEFERRED_RECORD_SIZE)
+    {
+        /* Truncated line still ends the console line */
+        length = LOG_DEFERRED_RECORD_SIZE - 1;
+        p_record->text[length - 1] = '\n';
+        atomic_fetch_add_explicit(&_g_log_deferred_truncated, 1, memory_order_relaxed);
+    }
+
+    /* Claimed record can't be given back, a failed format is published empty and skipped by the drain task */
+    p_record->length = (length > 0) ? (uint32_t)length : 0;
+    atomic_store_explicit(&p_record->sequence, position + 1, memory_order_release);
+
+    return length;
+}
+
+static const char *_log_deferred_level_get(const char *p_format)
+{
+    /* Color prefix is an escape sequence ending with 'm' */
+    if ('\033' == *p_format)
+    {
+        while (('\0' != *p_format) && ('m' != *p_format)) p_format++;
+        if ('\0' != *p_format) p_format++;
+    }
+
+    return p_format;
+}
+
+static const char *_log_deferred_tag_get(const char *p_format, va_list args)
+{
+    static const char rtos_prefix[] = " (%" PRIu32 ") %s: ";
+    static const char system_prefix[] = " (%s) %s: ";
+    const char *p_tag = NULL;
+    va_list args_copy;
+
+    /* Timestamp is the first argument and the tag the second one, for both timestamp sources */
+    va_copy(args_copy, args);
+    if (0 == strncmp(p_format, rtos_prefix, sizeof(rtos_prefix) - 1))
+    {
+        (void)va_arg(args_copy, uint32_t);
+        p_tag = va_arg(args_copy, const char *);
+    }
+    else if (0 == strncmp(p_format, system_prefix, sizeof(system_prefix) - 1))
+    {
+        (void)va_arg(args_copy, const char *);
+        p_tag = va_arg(args_copy, const char *);
+    }
+    va_end(args_copy);
+
+    return p_tag;
+}
+
+static bool _log_deferred_rate_check(const char *p_tag)
+{
+    log_deferred_tag_t *p_slot = NULL;
+    uint32_t hash = LOG_DEFERRED_FNV_OFFSET_BASIS;
+    uint32_t expected = 0;
+    uint32_t now = 0;
+    uint32_t window_start = 0;
+    uint32_t i = 0;
+
+    if (0 == LOG_DEFERRED_TAG_RATE_LIMIT) return true;
+
+    for (; '\0' != *p_tag; p_tag++)
+    {
+        hash = (hash ^ (uint8_t)*p_tag) * LOG_DEFERRED_FNV_PRIME;
+    }
+    if (0 == hash) hash = 1;
+
+    /* Tag keeps the first free slot from its hash on, tags beyond the last slot aren't limited */
+    for (i = 0; i < LOG_DEFERRED_TAG_SLOTS; i++)
+    {
+        p_slot = &_g_log_deferred_tags[(hash + i) & (LOG_DEFERRED_TAG_SLOTS - 1)];
+        expected = 0;
+        if (atomic_compare_exchange_strong(&p_slot->tag_hash, &expected, hash) || (hash == expected)) break;
+    }
+    if (LOG_DEFERRED_TAG_SLOTS == i) return true;
+
+    /* Only the producer that moves the window on clears the count, a concurrent line may count in either period */
+    now = (uint32_t)xTaskGetTickCount();
+    window_start = atomic_load_explicit(&p_slot->window_start, memory_order_relaxed);
+    if ((now - window_start) >= (LOG_DEFERRED_TAG_RATE_PERIOD_MS / portTICK_PERIOD_MS))
+    {
+        if (atomic_compare_exchange_strong(&p_slot->window_start, &window_start, now)) atomic_store(&p_slot->count, 0);
+    }
+
+    return (atomic_fetch_add(&p_slot->count, 1) < LOG_DEFERRED_TAG_RATE_LIMIT);
+}
+
+static void _log_deferred_drain_task(void *p_task_params)
+{
+    static char text[LOG_DEFERRED_RECORD_SIZE];
+    log_deferred_record_t *p_record = NULL;
+    uint32_t length = 0;
+    uint32_t dropped = 0;
+    uint32_t dropped_reported = 0;
+
+    while (1)
+    {
+        p_record = &_g_log_deferred_ring[_g_log_deferred_tail & (LOG_DEFERRED_RING_SIZE - 1)];
+
+        if ((_g_log_deferred_tail + 1) != atomic_load_explicit(&p_record->sequence, memory_order_acquire))
+        {
+            /* Drops are reported once the ring buffer is drained, a dropped report isn't reported again */
+            dropped = atomic_load_explicit(&_g_log_deferred_dropped_full, memory_order_relaxed) +
+                atomic_load_explicit(&_g_log_deferred_dropped_rate_limit, memory_order_relaxed);
+            if (dropped != dropped_reported)
+            {
+                ESP_LOGW(LOG_TAG, "Dropped %lu lines, ring buffer full: %lu, rate limit: %lu",
+                    (unsigned long)(dropped - dropped_reported),
+                    (unsigned long)atomic_load_explicit(&_g_log_deferred_dropped_full, memory_order_relaxed),
+                    (unsigned long)atomic_load_explicit(&_g_log_deferred_dropped_rate_limit, memory_order_relaxed));
+                dropped_reported = atomic_load_explicit(&_g_log_deferred_dropped_full, memory_order_relaxed) +
+                    atomic_load_explicit(&_g_log_deferred_dropped_rate_limit, memory_order_relaxed);
+                continue;
+            }
+
+            vTaskDelay(LOG_DEFERRED_DRAIN_PERIOD_MS / portTICK_PERIOD_MS);
+            continue;
+        }
+
+        /* Record is released before the slow console write */
+        length = p_record->length;
+        memcpy(text, p_record->text, length);
+        atomic_store_explicit(&p_record->sequence, _g_log_deferred_tail + LOG_DEFERRED_RING_SIZE, memory_order_release);
+        _g_log_deferred_tail++;
+
+        if (0 == length) continue;
+
+        fwrite(text, 1, length, stdout);
+        atomic_fetch_add_explicit(&_g_log_deferred_written, 1, memory_order_relaxed);
+    }
+}
+
+/* ============================== INTERRUPT FUNCTION DEFINITIONS */
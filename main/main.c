@@ -15,8 +15,11 @@
 #include "esp_log.h"
 #include "comm/comm_manager.h"
 #include "sha256_calculator.h"
+#include "sha256_stream.h"
 #include "gpio/gpio_manager.h"
 #include "flow_control.h"
+#include "profiler.h"
+#include "log_deferred.h"
 
 /* ============================== MACRO DEFINITIONS */
 
@@ -35,8 +38,11 @@
 
 void app_main(void)
 {
+    log_deferred_init();
     ESP_LOGI(LOG_TAG, "Initializing.");
+    profiler_init();
     gpio_manager_init();
+    sha256_stream_init();
     comm_manager_init();
     sha256_calculator_init();
     flow_control_init();
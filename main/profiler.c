@@ -0,0 +1,256 @@
+/**
+ * @file profiler.c
+ * @author Iwan Ćulumović
+ * @brief Hot path profiler module. Records CPU cycle counts per stage into log2 histograms and a fixed-size sample ring buffer.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/* ============================== INCLUDES */
+
+#include <string.h>
+#include "esp_log.h"
+#include "esp_attr.h"
+#include "sdkconfig.h"
+#include "profiler.h"
+#include "log_deferred.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Log tag. */
+#define LOG_TAG                                 ("PROFILER")
+
+/** @brief Sample ring buffer size. */
+#define PROFILER_RING_SIZE                      (CONFIG_PROFILER_RING_SIZE)
+
+/** @brief Every n-th record of a stage is stored into the sample ring buffer, histograms count all of them. */
+#define PROFILER_RING_DECIMATION                (CONFIG_PROFILER_RING_DECIMATION)
+
+/** @brief Periodic dump period in milliseconds, 0 disables periodic dumps. */
+#define PROFILER_DUMP_PERIOD_MS                 (CONFIG_PROFILER_DUMP_PERIOD_MS)
+
+/** @brief Writes a dump line in the log line format, past the deferred log ring buffer and its per tag rate limit. */
+#define PROFILER_DUMP_LINE(format, ...)         log_deferred_direct_printf("I (%lu) %s: " format "\n", (unsigned long)esp_log_timestamp(), LOG_TAG, ##__VA_ARGS__)
+
+/** @brief Profiler dump task stack depth. */
+#define TASK_PROFILER_DUMP_STACK_DEPTH          (3072)
+
+/** @brief Profiler dump task priority. */
+#define TASK_PROFILER_DUMP_PRIORITY             (0)
+
+/* ============================== TYPE DEFINITIONS */
+
+/* ============================== PRIVATE FUNCTION DECLARATIONS */
+
+/**
+ * @brief Task that periodically dumps the profiler state to the console.
+ * 
+ * @param p_task_params Task parameters (not used).
+ */
+static void _profiler_dump_task(void *p_task_params);
+
+/* ============================== PRIVATE VARIABLES */
+
+/** @brief Stage names used when dumping. */
+static const char *_g_profiler_stage_names[PROFILER_STAGE_COUNT] =
+{
+    [PROFILER_STAGE_KERNEL] = "kernel",
+    [PROFILER_STAGE_COMPARE] = "compare",
+    [PROFILER_STAGE_QUEUE_PUT] = "queue_put",
+    [PROFILER_STAGE_QUEUE_GET] = "queue_get",
+    [PROFILER_STAGE_SPI_TRANSACTION] = "spi_transaction",
+    [PROFILER_STAGE_I2C_ON_REQUEST] = "i2c_on_request",
+    [PROFILER_STAGE_I2C_ON_RECEIVE] = "i2c_on_receive",
+};
+
+/** @brief Profiler spinlock, records come from tasks on both cores and from ISRs. */
+static portMUX_TYPE _g_profiler_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+/** @brief Per stage statistics. */
+static profiler_stage_stats_t _g_profiler_stage_stats[PROFILER_STAGE_COUNT] = {0};
+
+/** @brief Sample ring buffer. */
+static profiler_sample_t _g_profiler_ring[PROFILER_RING_SIZE] = {0};
+
+/** @brief Total number of samples written into the ring buffer. */
+static uint32_t _g_profiler_ring_written = 0;
+
+/** @brief Profiler dump task handle. */
+static TaskHandle_t _g_task_handle_profiler_dump = NULL;
+
+/* ============================== PUBLIC VARIABLES */
+
+/* ============================== PUBLIC FUNCTION DEFINITIONS */
+
+void profiler_init(void)
+{
+    BaseType_t result = pdPASS;
+
+    profiler_reset();
+
+    if (0 != PROFILER_DUMP_PERIOD_MS)
+    {
+        result = xTaskCreate(_profiler_dump_task, "PROFILER", TASK_PROFILER_DUMP_STACK_DEPTH, NULL, TASK_PROFILER_DUMP_PRIORITY, &_g_task_handle_profiler_dump);
+        if (pdPASS != result)
+        {
+            ESP_LOGE(LOG_TAG, "Failed to create task for profiler dump. Aborting!");
+            abort();
+        }
+    }
+
+    ESP_LOGI(LOG_TAG, "Initialized profiler with %d ring samples.", PROFILER_RING_SIZE);
+}
+
+void IRAM_ATTR profiler_record(profiler_stage_t stage, uint32_t cycles)
+{
+    profiler_stage_stats_t *p_stats = &_g_profiler_stage_stats[stage];
+    profiler_sample_t *p_sample = NULL;
+    uint32_t bucket = 0;
+
+    /* Bucket is the bit length of the cycle count */
+    bucket = (0 == cycles) ? 0 : (32 - __builtin_clz(cycles));
+    if (bucket >= PROFILER_HISTOGRAM_BUCKETS) bucket = PROFILER_HISTOGRAM_BUCKETS - 1;
+
+    portENTER_CRITICAL_SAFE(&_g_profiler_spinlock);
+
+    p_stats->count++;
+    p_stats->total_cycles += cycles;
+    if (cycles < p_stats->min_cycles) p_stats->min_cycles = cycles;
+    if (cycles > p_stats->max_cycles) p_stats->max_cycles = cycles;
+    p_stats->histogram[bucket]++;
+
+    if (0 == (p_stats->count % PROFILER_RING_DECIMATION))
+    {
+        p_sample = &_g_profiler_ring[_g_profiler_ring_written % PROFILER_RING_SIZE];
+        p_sample->timestamp = (uint32_t)esp_cpu_get_cycle_count();
+        p_sample->cycles = cycles;
+        p_sample->stage = (uint8_t)stage;
+        p_sample->core_id = (uint8_t)xPortGetCoreID();
+        _g_profiler_ring_written++;
+    }
+
+    portEXIT_CRITICAL_SAFE(&_g_profiler_spinlock);
+}
+
+void profiler_reset(void)
+{
+    int stage = 0;
+
+    portENTER_CRITICAL(&_g_profiler_spinlock);
+
+    memset(_g_profiler_stage_stats, 0, sizeof(_g_profiler_stage_stats));
+    for (stage = 0; stage < PROFILER_STAGE_COUNT; stage++)
+    {
+        _g_profiler_stage_stats[stage].min_cycles = UINT32_MAX;
+    }
+    _g_profiler_ring_written = 0;
+
+    portEXIT_CRITICAL(&_g_profiler_spinlock);
+}
+
+void profiler_dump(void)
+{
+    static profiler_stage_stats_t stats[PROFILER_STAGE_COUNT] = {0};
+    static profiler_sample_t samples[PROFILER_RING_SIZE] = {0};
+    uint32_t sample_index = 0;
+    uint32_t written = 0;
+    size_t sample_count = 0;
+    size_t i = 0;
+    int stage = 0;
+    int bucket = 0;
+
+    /* Take a consistent snapshot first, console output is slow */
+    portENTER_CRITICAL(&_g_profiler_spinlock);
+    memcpy(stats, _g_profiler_stage_stats, sizeof(stats));
+    portEXIT_CRITICAL(&_g_profiler_spinlock);
+
+    sample_count = profiler_ring_copy(&sample_index, samples, PROFILER_RING_SIZE, &written);
+
+    for (stage = 0; stage < PROFILER_STAGE_COUNT; stage++)
+    {
+        if (0 == stats[stage].count) continue;
+
+        PROFILER_DUMP_LINE("%s: count %lu, min %lu, avg %lu, max %lu cycles",
+            _g_profiler_stage_names[stage],
+            (unsigned long)stats[stage].count,
+            (unsigned long)stats[stage].min_cycles,
+            (unsigned long)(stats[stage].total_cycles / stats[stage].count),
+            (unsigned long)stats[stage].max_cycles);
+
+        for (bucket = 0; bucket < PROFILER_HISTOGRAM_BUCKETS; bucket++)
+        {
+            if (0 == stats[stage].histogram[bucket]) continue;
+
+            PROFILER_DUMP_LINE("  < 2^%d cycles: %lu", bucket, (unsigned long)stats[stage].histogram[bucket]);
+        }
+    }
+
+    /* One line per sample: timestamp, core, stage and cycles */
+    for (i = 0; i < sample_count; i++)
+    {
+        PROFILER_DUMP_LINE("sample %lu %u %s %lu",
+            (unsigned long)samples[i].timestamp,
+            samples[i].core_id,
+            _g_profiler_stage_names[samples[i].stage],
+            (unsigned long)samples[i].cycles);
+    }
+}
+
+bool profiler_stage_stats_get(profiler_stage_t stage, profiler_stage_stats_t *p_stats)
+{
+    if (PROFILER_STAGE_COUNT <= stage)
+    {
+        return false;
+    }
+
+    portENTER_CRITICAL(&_g_profiler_spinlock);
+    *p_stats = _g_profiler_stage_stats[stage];
+    portEXIT_CRITICAL(&_g_profiler_spinlock);
+
+    return true;
+}
+
+size_t profiler_ring_copy(uint32_t *p_index, profiler_sample_t *p_samples, size_t max_samples, uint32_t *p_written)
+{
+    uint32_t written = 0;
+    uint32_t kept = 0;
+    size_t count = 0;
+    size_t i = 0;
+
+    portENTER_CRITICAL(&_g_profiler_spinlock);
+
+    written = _g_profiler_ring_written;
+    kept = (written < PROFILER_RING_SIZE) ? written : PROFILER_RING_SIZE;
+
+    /* Index counts up freely, an overwritten or never written index starts at the oldest sample still kept */
+    if ((written - *p_index) > kept) *p_index = written - kept;
+    count = written - *p_index;
+    if (count > max_samples) count = max_samples;
+
+    for (i = 0; i < count; i++)
+    {
+        p_samples[i] = _g_profiler_ring[(*p_index + i) % PROFILER_RING_SIZE];
+    }
+
+    portEXIT_CRITICAL(&_g_profiler_spinlock);
+
+    *p_written = written;
+
+    return count;
+}
+
+/* ============================== PRIVATE FUNCTION DEFINITIONS */
+
+static void _profiler_dump_task(void *p_task_params)
+{
+    while (1)
+    {
+        vTaskDelay(PROFILER_DUMP_PERIOD_MS / portTICK_PERIOD_MS);
+        profiler_dump();
+    }
+}
+
+/* ============================== INTERRUPT FUNCTION DEFINITIONS */
@@ -9,178 +9,2387 @@
 
 /* ============================== INCLUDES */
 
+#include <float.h>
+#include <math.h>
 #include <stdio.h>
+#include <string.h>
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_chip_info.h"
 #include "sdkconfig.h"
 #include "sha256_calculator.h"
+#include "profiler.h"
 #include "freertos/FreeRTOS.h"
-#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "spsc_ring.h"
+#include "sha256_kernel.h"
+#include "sha256_merkle.h"
+#include "sha256_result_cache.h"
 #include "mbedtls/sha256.h"
+#ifdef CONFIG_SHA256_CALC_AUTOTUNE
+#include "nvs_flash.h"
+#include "nvs.h"
+#endif
 
 /* ============================== MACRO DEFINITIONS */
 
 /** @brief Log tag. */
 #define LOG_TAG                                 ("SHA256_CALC")
 
-/** @brief SHA256 input queue size. */
+/** @brief SHA256 input queue size. Must be a power of two. */
 #define SHA256_INPUT_QUEUE_SIZE                 (1)
 
-/** @brief SHA256 solution queue size. */
+/** @brief SHA256 solution queue size. Must be a power of two. */
 #define SHA256_SOLUTION_QUEUE_SIZE              (1)
 
+/** @brief SHA256 progress queue size. Must be a power of two. */
+#define SHA256_PROGRESS_QUEUE_SIZE              (1)
+
+/** @brief SHA256 Merkle proof queue size. Must be a power of two. */
+#define SHA256_PROOF_QUEUE_SIZE                 (4)
+
+/** @brief Ticks to wait before retrying a put into a full queue. */
+#define SHA256_QUEUE_FULL_RETRY_TICKS           (1)
+
+/** @brief Control latency bound in microseconds, new input variables are picked up at least this often. */
+#define SHA256_CONTROL_LATENCY_US               (CONFIG_SHA256_CALC_CONTROL_LATENCY_US)
+
+/** @brief Targeted batch duration. Half of the latency bound leaves headroom for preemption. */
+#define SHA256_BATCH_TARGET_US                  (SHA256_CONTROL_LATENCY_US / 2)
+
+/** @brief Minimum number of candidates between control checks. */
+#define SHA256_BATCH_SIZE_MIN                   (1)
+
+/** @brief Maximum number of candidates between control checks. */
+#define SHA256_BATCH_SIZE_MAX                   (1 << 20)
+
+/** @brief Batch size of the first batch after boot. */
+#define SHA256_BATCH_SIZE_INITIAL               (64)
+
+/** @brief Nonce size in bytes, the message hashed per candidate. */
+#define SHA256_NONCE_SIZE                       (sizeof(sha256_nonce_t))
+
+/** @brief Number of candidates hashed per job type at initialization to measure the reported hash rate. */
+#define SHA256_CALIBRATION_HASHES               (4096)
+
+/** @brief Candidates of the whole nonce space, the range a search without a hash budget may test. */
+#ifdef CONFIG_SHA256_CALC_NONCE_64BIT
+#define SHA256_NONCE_SPACE_HASHES               (UINT64_MAX)
+#else
+#define SHA256_NONCE_SPACE_HASHES               ((uint64_t)UINT32_MAX + 1)
+#endif
+
+/** @brief Largest mask width the expected candidates per match are estimated for, wider masks stay within a float. */
+#define SHA256_ESTIMATE_MASK_BITS_MAX           (120)
+
+/** @brief A job is flagged slow if its measured hash rate is below this share of the calibrated hash rate in percent. */
+#define SHA256_ESTIMATE_SLOW_PERCENT            (80)
+
+/** @brief Time each kernel variant is measured for on each core by the autotuner in microseconds. */
+#define SHA256_AUTOTUNE_MEASURE_US              (5000)
+
+/** @brief Number of candidates hashed between two time checks of the autotuner. */
+#define SHA256_AUTOTUNE_BATCH_HASHES            (64)
+
+/** @brief NVS namespace of the autotuner. */
+#define SHA256_AUTOTUNE_NVS_NAMESPACE           ("sha256_calc")
+
+/** @brief NVS key of the autotuner record. */
+#define SHA256_AUTOTUNE_NVS_KEY                 ("autotune")
+
+/** @brief Autotuner record version, stored records of another version are measured again. */
+#define SHA256_AUTOTUNE_RECORD_VERSION          (1)
+
+/** @brief Autotune task stack depth. */
+#define TASK_SHA256_AUTOTUNE_STACK_DEPTH        (4096)
+
+/** @brief Autotune task priority, above the idle task so the measurement isn't time sliced with it. */
+#define TASK_SHA256_AUTOTUNE_PRIORITY           (1)
+
+/** @brief Number of candidates hashed per kernel in the startup benchmark. */
+#define SHA256_BENCHMARK_HASHES                 (20000)
+
+/** @brief SHA256d prefix size in the startup benchmark, a Bitcoin block header without the nonce. */
+#define SHA256D_BENCHMARK_PREFIX_SIZE           (76)
+
+/** @brief SHA256 padding size in bytes, the padding bit byte and the 64 bit message length. */
+#define SHA256_PADDING_SIZE                     (9)
+
+/** @brief HMAC inner key pad byte. */
+#define SHA256_HMAC_IPAD                        (0x36)
+
+/** @brief HMAC outer key pad byte. */
+#define SHA256_HMAC_OPAD                        (0x5C)
+
 /** @brief Calculate SHA256 task stack depth. */
-#define TASK_SHA256_CALC_STACK_DEPTH            (2048)
+#define TASK_SHA256_CALC_STACK_DEPTH            (6144)
+
+/** @brief Calculate SHA256 task priority. */
+#define TASK_SHA256_CALC_PRIORITY               (0)
+
+/* ============================== TYPE DEFINITIONS */
+
+/**
+ * @brief Target solution prepared for comparison with digest words.
+ * 
+ */
+typedef struct {
+    uint32_t target_words[SHA256_KERNEL_STATE_WORDS];   //! Masked target solution as big endian words
+    uint32_t mask_words[SHA256_KERNEL_STATE_WORDS];     //! Bits of each word that are compared
+    uint8_t compare_words;                              //! Number of words that have compared bits
+} sha256_target_t;
+
+/**
+ * @brief SHA256d job prepared for candidate search.
+ * 
+ */
+typedef struct {
+    uint32_t midstate[SHA256_KERNEL_STATE_WORDS];       //! Chaining state after the full prefix blocks
+    uint32_t block[SHA256_KERNEL_BLOCK_WORDS];          //! Last block with the prefix tail, the nonce and the padding
+    uint8_t nonce_word;                                 //! Index of the low nonce word in the last block
+    uint8_t match_flags;                                //! SHA256D_MATCH_FLAG_* flags
+    sha256_target_t target;                             //! Target solution of the second digest
+    uint32_t threshold_words[SHA256_KERNEL_STATE_WORDS];    //! Threshold as words, most significant word first
+    bool b_best_track;                                  //! Track the lowest digest, threshold jobs with a budget
+    uint32_t best_words[SHA256_KERNEL_STATE_WORDS];     //! Lowest digest in threshold order, most significant word first
+    uint32_t best_digest[SHA256_KERNEL_STATE_WORDS];    //! Lowest digest words, zero until a digest was tracked
+} sha256d_job_t;
+
+/**
+ * @brief HMAC job prepared for candidate search. Both key pad blocks are compressed once per job.
+ * 
+ */
+typedef struct {
+    uint32_t inner_midstate[SHA256_KERNEL_STATE_WORDS]; //! Chaining state after the inner key pad block
+    uint32_t inner_block[SHA256_KERNEL_BLOCK_WORDS];    //! Inner block with the nonce words, the padding and the message length
+    sha256_kernel_w0_ctx_t inner_kernel_ctx;            //! Inner block compression with the nonce independent part precomputed
+    uint32_t outer_midstate[SHA256_KERNEL_STATE_WORDS]; //! Chaining state after the outer key pad block
+    uint32_t outer_block[SHA256_KERNEL_BLOCK_WORDS];    //! Inner digest words set per candidate, then constant padding
+    sha256_target_t target;                             //! Target solution of the outer digest
+} sha256_hmac_job_t;
+
+/**
+ * @brief Hash chain job prepared for iteration.
+ * 
+ */
+typedef struct {
+    uint32_t digest[SHA256_KERNEL_STATE_WORDS];         //! Digest words at the current chain index, the seed at first
+    uint64_t iterations_left;                           //! Iterations until the end of the chain
+    uint32_t checkpoint_interval;                       //! Iterations between two checkpoints, 0 for none
+    uint32_t checkpoint_left;                           //! Iterations until the next checkpoint
+} sha256_chain_job_t;
+
+/**
+ * @brief Estimate state of a job, written by the calculate task and read when the estimate is asked for.
+ * 
+ */
+typedef struct {
+    bool b_active;                                      //! Job is being searched
+    bool b_search;                                      //! Job ends at its first match, else after a known number of hashes
+    uint8_t puzzle_id;
+    uint8_t job_type;                                   //! SHA256_JOB_TYPE_*
+    float match_hashes;                                 //! Expected candidates per match of a search
+    uint64_t range_hashes;                              //! Candidates until the job ends without a match
+    uint32_t time_budget_ms;                            //! Time budget of the job, 0 for none
+    int64_t start_us;                                   //! Arrival of the job, 0 before the first job
+    int64_t end_us;                                     //! End of the job, once it ended
+    uint64_t job_hashes;                                //! Candidates tested so far
+} sha256_job_estimate_t;
+
+/**
+ * @brief SHA256 job batch search, one per kernel variant.
+ * 
+ */
+typedef uint32_t (*sha256_batch_search_t)(const sha256_kernel_w0_ctx_t *p_kernel_ctx, const uint32_t *p_block, const sha256_target_t *p_target, sha256_nonce_t *p_offset, uint32_t batch_hashes, bool *p_b_solution_found);
+
+#ifdef CONFIG_SHA256_CALC_AUTOTUNE
+/**
+ * @brief Autotuner record, stored in NVS.
+ * 
+ */
+typedef struct {
+    uint8_t version;                                    //! SHA256_AUTOTUNE_RECORD_VERSION
+    uint8_t kernel_variant;                             //! Fastest kernel variant
+    uint8_t core_id;                                    //! Core the fastest kernel variant was measured on
+    uint16_t chip_revision;                             //! Chip revision the record was measured on
+    uint16_t cpu_freq_mhz;                              //! CPU frequency the record was measured at
+    uint32_t hash_rates[portNUM_PROCESSORS][SHA256_KERNEL_VARIANT_COUNT];   //! Measured hash rates per core and kernel variant
+} sha256_autotune_record_t;
+
+/**
+ * @brief Autotune task parameters.
+ * 
+ */
+typedef struct {
+    TaskHandle_t task_handle_caller;                    //! Task notified when the measurement is done
+    uint32_t *p_hash_rates;                             //! Where the hash rate of each kernel variant will be written
+} sha256_autotune_params_t;
+#endif
+
+/* ============================== PRIVATE FUNCTION DECLARATIONS */
+
+/**
+ * @brief Task that calculates SHA256 given the input variables.
+ * 
+ * @param p_task_params Task parameters (not used).
+ */
+static void _calculate_sha256_task(void *p_task_params);
+
+/**
+ * @brief Calculates the next batch size from the duration of the last batch and updates the status.
+ * 
+ * @param batch_size Batch size of the last batch.
+ * @param hashes Number of candidates hashed in the last batch, smaller than batch size if a solution was found.
+ * @param batch_us Duration of the last batch in microseconds.
+ * @param control_us Duration of the control check before the last batch in microseconds.
+ * 
+ * @return uint32_t Next batch size.
+ */
+static uint32_t _sha256_batch_size_update(uint32_t batch_size, uint32_t hashes, int64_t batch_us, int64_t control_us);
+
+/**
+ * @brief Fills the padded single message block of a nonce, the first word is set per candidate.
+ * 
+ * @param p_block Pointer to the block which will be filled.
+ */
+static void _sha256_nonce_block_prepare(uint32_t *p_block);
+
+/**
+ * @brief Prepares the kernel for candidates that share the upper nonce words with the given nonce.
+ * 
+ * @param p_kernel_ctx Pointer to the kernel context which will be prepared.
+ * @param p_block Pointer to the padded nonce block, the upper nonce words will be set.
+ * @param nonce Nonce whose upper words are set.
+ */
+static void _sha256_kernel_prepare(sha256_kernel_w0_ctx_t *p_kernel_ctx, uint32_t *p_block, sha256_nonce_t nonce);
+
+/**
+ * @brief Limits the number of candidates of a batch so the search stops at the given distance.
+ * 
+ * @param batch_hashes Number of candidates of the batch.
+ * @param distance Number of candidates until the search has to stop, 0 means the whole nonce space.
+ * 
+ * @return uint32_t Limited number of candidates of the batch.
+ */
+static inline uint32_t _sha256_batch_limit(uint32_t batch_hashes, sha256_nonce_t distance);
+
+/**
+ * @brief Searches a batch of SHA256 job candidates with the precomputed kernel.
+ * 
+ * @param p_kernel_ctx Pointer to the prepared kernel context.
+ * @param p_block Pointer to the prepared nonce block (not used).
+ * @param p_target Pointer to the prepared target.
+ * @param p_offset Pointer to the current offset, advanced past the searched candidates or left at the solution.
+ * @param batch_hashes Number of candidates to search.
+ * @param p_b_solution_found Pointer to where the match result will be written.
+ * 
+ * @return uint32_t Number of candidates hashed.
+ */
+static uint32_t _sha256_batch_search(const sha256_kernel_w0_ctx_t *p_kernel_ctx, const uint32_t *p_block, const sha256_target_t *p_target, sha256_nonce_t *p_offset, uint32_t batch_hashes, bool *p_b_solution_found);
+
+/**
+ * @brief Searches a batch of SHA256 job candidates with the plain single block kernel. Same parameters as
+ * _sha256_batch_search, the kernel context is not used.
+ * 
+ */
+static uint32_t _sha256_batch_search_plain(const sha256_kernel_w0_ctx_t *p_kernel_ctx, const uint32_t *p_block, const sha256_target_t *p_target, sha256_nonce_t *p_offset, uint32_t batch_hashes, bool *p_b_solution_found);
+
+/**
+ * @brief Searches a batch of SHA256 job candidates with mbedtls. Same parameters as _sha256_batch_search, the kernel
+ * context and the nonce block are not used.
+ * 
+ */
+static uint32_t _sha256_batch_search_mbedtls(const sha256_kernel_w0_ctx_t *p_kernel_ctx, const uint32_t *p_block, const sha256_target_t *p_target, sha256_nonce_t *p_offset, uint32_t batch_hashes, bool *p_b_solution_found);
+
+/**
+ * @brief Searches a batch of SHA256d job candidates.
+ * 
+ * @param p_sha256d_job Pointer to the prepared SHA256d job.
+ * @param p_offset Pointer to the current offset, advanced past the searched candidates or left at the solution.
+ * @param batch_hashes Number of candidates to search, must not cross a low nonce word wrap.
+ * @param p_b_solution_found Pointer to where the match result will be written.
+ * 
+ * @return uint32_t Number of candidates hashed.
+ */
+static uint32_t _sha256d_batch_search(sha256d_job_t *p_sha256d_job, sha256_nonce_t *p_offset, uint32_t batch_hashes, bool *p_b_solution_found);
+
+/**
+ * @brief Prepares a SHA256d job, compresses the full prefix blocks into the midstate and pads the last block.
+ * 
+ * @param p_sha256d_job Pointer to the job which will be filled.
+ * @param p_sha256d_input_variables Pointer to the SHA256d input variables.
+ * @param p_prefix Pointer to the prefix, SHA256D_PREFIX_MAX_SIZE bytes.
+ * 
+ * @return bool Returns true if the job is valid, false if the prefix or the match flags can't be searched.
+ */
+static bool _sha256d_job_prepare(sha256d_job_t *p_sha256d_job, const sha256d_input_variables_t *p_sha256d_input_variables, const uint8_t *p_prefix);
+
+/**
+ * @brief Searches a batch of HMAC candidates. Every candidate costs one inner and one outer block compression.
+ * 
+ * @param p_sha256_hmac_job Pointer to the prepared HMAC job.
+ * @param p_offset Pointer to the current offset, advanced past the searched candidates or left at the solution.
+ * @param batch_hashes Number of candidates to search, must not cross a low nonce word wrap.
+ * @param p_b_solution_found Pointer to where the match result will be written.
+ * 
+ * @return uint32_t Number of candidates hashed.
+ */
+static uint32_t _sha256_hmac_batch_search(sha256_hmac_job_t *p_sha256_hmac_job, sha256_nonce_t *p_offset, uint32_t batch_hashes, bool *p_b_solution_found);
+
+/**
+ * @brief Prepares an HMAC job, compresses the inner and outer key pad blocks into their midstates.
+ * 
+ * @param p_sha256_hmac_job Pointer to the job which will be filled.
+ * @param p_sha256_hmac_input_variables Pointer to the HMAC input variables.
+ * 
+ * @return bool Returns true if the job is valid, false if the key is too long.
+ */
+static bool _sha256_hmac_job_prepare(sha256_hmac_job_t *p_sha256_hmac_job, const sha256_hmac_input_variables_t *p_sha256_hmac_input_variables);
+
+/**
+ * @brief Prepares the inner block compression of an HMAC job for a nonce, only the high nonce word is taken from it.
+ * 
+ * @param p_sha256_hmac_job Pointer to the prepared HMAC job.
+ * @param nonce Nonce whose high word is hashed by the following candidates.
+ */
+static void _sha256_hmac_kernel_prepare(sha256_hmac_job_t *p_sha256_hmac_job, sha256_nonce_t nonce);
+
+/**
+ * @brief Iterates a hash chain for a batch. The batch is iterated by the fused digest chain kernel in one call, so its
+ * iterations are not profiled one by one.
+ * 
+ * @param p_sha256_chain_job Pointer to the prepared hash chain job.
+ * @param p_offset Pointer to the current chain index, advanced past the iterations.
+ * @param batch_hashes Number of iterations, must not cross the end of the chain or the next checkpoint.
+ * 
+ * @return uint32_t Number of iterations.
+ */
+static uint32_t _sha256_chain_batch_search(sha256_chain_job_t *p_sha256_chain_job, sha256_nonce_t *p_offset, uint32_t batch_hashes);
+
+/**
+ * @brief Limits the number of iterations of a batch so the chain stops at its end and at the next checkpoint.
+ * 
+ * @param p_sha256_chain_job Pointer to the prepared hash chain job.
+ * @param batch_hashes Number of iterations of the batch.
+ * 
+ * @return uint32_t Limited number of iterations of the batch.
+ */
+static inline uint32_t _sha256_chain_batch_limit(const sha256_chain_job_t *p_sha256_chain_job, uint32_t batch_hashes);
+
+/**
+ * @brief Prepares a hash chain job, loads the seed as digest words.
+ * 
+ * @param p_sha256_chain_job Pointer to the job which will be filled.
+ * @param p_sha256_chain_input_variables Pointer to the hash chain input variables.
+ * 
+ * @return bool Returns true if the job is valid, false if it has no iterations.
+ */
+static bool _sha256_chain_job_prepare(sha256_chain_job_t *p_sha256_chain_job, const sha256_chain_input_variables_t *p_sha256_chain_input_variables);
+
+/**
+ * @brief Prepares a Merkle job, sets up the reduction of the leaf storage and the proofs.
+ * 
+ * @param p_merkle_tree Pointer to the tree which will be set up.
+ * @param p_sha256_merkle_input_variables Pointer to the Merkle input variables.
+ * 
+ * @return bool Returns true if the job is valid, false if the leaf count, the flags or a proof leaf index is invalid.
+ */
+static bool _sha256_merkle_job_prepare(sha256_merkle_tree_t *p_merkle_tree, const sha256_merkle_input_variables_t *p_sha256_merkle_input_variables);
+
+/**
+ * @brief Puts the proof paths of a reduced Merkle tree into the proof queue, split into as many elements as needed.
+ * Blocking function.
+ * 
+ * @param p_merkle_tree Pointer to the reduced tree.
+ * @param puzzle_id Puzzle ID of the job.
+ */
+static void _sha256_merkle_proofs_put(const sha256_merkle_tree_t *p_merkle_tree, uint8_t puzzle_id);
+
+/**
+ * @brief Compares the second digest words of a SHA256d job with its target solution and threshold.
+ * 
+ * @param p_sha256d_job Pointer to the prepared SHA256d job.
+ * @param p_digest Pointer to the digest words.
+ * 
+ * @return bool Returns true if the digest satisfies every enabled match.
+ */
+static inline bool _sha256d_job_match(const sha256d_job_t *p_sha256d_job, const uint32_t *p_digest);
+
+/**
+ * @brief Prepares the target solution and its mask for comparison with digest words.
+ * 
+ * @param p_target Pointer to the target which will be filled.
+ * @param target_solution_mask_offset Index of the last compared bit of the target solution.
+ * @param p_target_solution Pointer to the target solution bytes.
+ */
+static void _sha256_target_prepare(sha256_target_t *p_target, uint8_t target_solution_mask_offset, const uint8_t *p_target_solution);
+
+/**
+ * @brief Loads big endian message words from bytes.
+ * 
+ * @param p_words Pointer to where the words will be written.
+ * @param p_bytes Pointer to the bytes.
+ * @param words Number of words.
+ */
+static void _sha256_words_load(uint32_t *p_words, const uint8_t *p_bytes, int words);
+
+/**
+ * @brief Compares digest words with the target solution.
+ * 
+ * @param p_target Pointer to the prepared target.
+ * @param p_digest Pointer to the digest words.
+ * 
+ * @return bool Returns true if all masked bits match.
+ */
+static inline bool _sha256_target_match(const sha256_target_t *p_target, const uint32_t *p_digest);
+
+/**
+ * @brief Updates the lowest digest of a SHA256d job if the digest is lower in threshold order.
+ * 
+ * @param p_sha256d_job Pointer to the prepared SHA256d job.
+ * @param p_digest Pointer to the second digest words.
+ */
+static inline void _sha256d_best_update(sha256d_job_t *p_sha256d_job, const uint32_t *p_digest);
+
+/**
+ * @brief Checks if the job budget is spent.
+ * 
+ * @param p_job_budget Pointer to the job budget.
+ * @param job_hashes Candidates tested for the job.
+ * @param job_us Time since the job arrival in microseconds.
+ * 
+ * @return bool Returns true if a limit of the budget is reached, else false.
+ */
+static inline bool _sha256_job_budget_spent(const sha256_job_budget_t *p_job_budget, uint64_t job_hashes, int64_t job_us);
+
+/**
+ * @brief Puts the progress record of a job whose budget ran out or of a hash chain into the progress queue, followed by
+ * its solution with the same status into the solution queue. Blocking function.
+ * 
+ * @param next_offset First offset not searched.
+ * @param puzzle_id Puzzle ID of the job.
+ * @param status Solution status, SHA256_SOLUTION_STATUS_BUDGET_EXHAUSTED or a chain status.
+ * @param job_hashes Candidates tested for the job.
+ * @param p_digest Pointer to the reported digest words (lowest SHA256d digest or chain digest), NULL to report zero.
+ */
+static void _sha256_progress_put(sha256_nonce_t next_offset, uint8_t puzzle_id, uint8_t status, uint64_t job_hashes, const uint32_t *p_digest);
+
+/**
+ * @brief Puts a solution into the solution queue. Blocking function.
+ * 
+ * @param offset_solution Offset solution, the start offset if the nonce space was exhausted.
+ * @param puzzle_id Puzzle ID of the solution.
+ * @param status Solution status.
+ */
+static void _sha256_solution_put(sha256_nonce_t offset_solution, uint8_t puzzle_id, uint8_t status);
+
+/**
+ * @brief Adds idle time and superseded hashes to the status.
+ * 
+ * @param idle_us Time spent waiting for input variables in microseconds.
+ * @param hashes_superseded Hashes calculated for a puzzle replaced before a solution.
+ */
+static void _sha256_status_job_count(int64_t idle_us, uint64_t hashes_superseded);
+
+/**
+ * @brief Counts a result cache lookup outcome in the status.
+ * 
+ * @param lookup Result cache lookup outcome.
+ */
+static void _sha256_status_cache_count(sha256_result_cache_lookup_t lookup);
+
+/**
+ * @brief Releases the Merkle leaf storage held by the Merkle job of the calculate task, if it holds it.
+ * 
+ * @param p_b_merkle_held Pointer to the flag of the calculate task that its job holds the leaf storage, cleared.
+ */
+static void _sha256_merkle_storage_release(bool *p_b_merkle_held);
+
+/**
+ * @brief Checks if flow control asked for the Merkle leaf storage.
+ * 
+ * @return bool Returns true if Merkle jobs have to stop, else false.
+ */
+static bool _sha256_merkle_storage_stop_requested(void);
+
+/**
+ * @brief Releases the SHA256d prefix storage held by the SHA256d job the calculate task just prepared.
+ * 
+ */
+static void _sha256d_prefix_release(void);
+
+/**
+ * @brief Starts the estimate of a new job. The expected candidates per match follow from the mask width and the
+ * threshold, the range from the nonce space, the iterations or the tree size, limited by the hash budget.
+ * 
+ * @param p_sha256_input_variables_queue_element Pointer to the input variables of the job.
+ * @param p_sha256d_job Pointer to the prepared SHA256d job, used for the threshold of a SHA256d job.
+ * @param p_job_budget Pointer to the budget the job is searched with.
+ * @param start_us Arrival of the job.
+ * @param b_active Job is searched, false if it was rejected or answered from the result cache.
+ */
+static void _sha256_estimate_start(const sha256_input_variables_queue_element_t *p_sha256_input_variables_queue_element, const sha256d_job_t *p_sha256d_job,
+                                   const sha256_job_budget_t *p_job_budget, int64_t start_us, bool b_active);
+
+/**
+ * @brief Updates the estimate with the candidates tested so far.
+ * 
+ * @param job_hashes Candidates tested for the job.
+ * @param b_job_done Job ended with this batch.
+ * @param now_us Time of the update.
+ */
+static void _sha256_estimate_count(uint64_t job_hashes, bool b_job_done, int64_t now_us);
+
+/**
+ * @brief Calculates the expected candidates per match of a target solution mask.
+ * 
+ * @param target_solution_mask_offset Mask offset, the mask has one more bit.
+ * 
+ * @return float Two to the power of the mask width.
+ */
+static float _sha256_estimate_mask_hashes(uint8_t target_solution_mask_offset);
+
+/**
+ * @brief Converts an estimated number of hashes into an integer, saturated at the largest value.
+ * 
+ * @param hashes Estimated number of hashes.
+ * 
+ * @return uint64_t Number of hashes.
+ */
+static uint64_t _sha256_estimate_hashes_to_u64(float hashes);
+
+#ifdef CONFIG_SHA256_CALC_AUTOTUNE
+/**
+ * @brief Selects the kernel variant and the core of the calculator task, from the NVS record or by measuring every
+ * kernel variant on every core.
+ * 
+ */
+static void _sha256_autotune(void);
+
+/**
+ * @brief Task that measures every kernel variant on the core it is pinned to and deletes itself.
+ * 
+ * @param p_task_params Pointer to the autotune task parameters.
+ */
+static void _sha256_autotune_task(void *p_task_params);
+
+/**
+ * @brief Loads the autotuner record from NVS.
+ * 
+ * @param p_record Pointer to where the record will be copied.
+ * 
+ * @return bool Returns true if a record was loaded, else false.
+ */
+static bool _sha256_autotune_load(sha256_autotune_record_t *p_record);
+
+/**
+ * @brief Stores the autotuner record into NVS.
+ * 
+ * @param p_record Pointer to the record.
+ */
+static void _sha256_autotune_store(const sha256_autotune_record_t *p_record);
+
+/**
+ * @brief Measures the SHA256 job hash rate of a kernel variant for a fixed time with a puzzle that never matches.
+ * 
+ * @param kernel_variant Kernel variant, SHA256_KERNEL_VARIANT_*.
+ * @param measure_us Measurement time in microseconds.
+ * 
+ * @return uint32_t Hashes per second.
+ */
+static uint32_t _sha256_kernel_measure(uint8_t kernel_variant, int64_t measure_us);
+#endif
+
+/**
+ * @brief Measures the SHA256 and SHA256d hash rates of the candidate search with puzzles that never match and stores
+ * them into the capabilities.
+ * 
+ */
+static void _sha256_hash_rate_calibrate(void);
+
+#ifdef CONFIG_SHA256_CALC_BENCHMARK
+/**
+ * @brief Measures and logs the hash rate of mbedtls, the plain single block kernel, the precomputed kernel and SHA256d
+ * of a Bitcoin header sized prefix.
+ * 
+ */
+static void _sha256_benchmark(void);
+#endif
+
+/* ============================== PRIVATE VARIABLES */
+
+/** @brief SHA256 input queue, produced by flow control and consumed by the calculate task. */
+static spsc_ring_t _g_queue_sha256_input = {0};
+
+/** @brief SHA256 input queue storage. */
+static sha256_input_variables_queue_element_t _g_queue_sha256_input_storage[SHA256_INPUT_QUEUE_SIZE] = {0};
+
+/** @brief SHA256 solution queue, produced by the calculate task and consumed by flow control. */
+static spsc_ring_t _g_queue_sha256_solution = {0};
+
+/** @brief SHA256 solution queue storage. */
+static sha256_offset_solution_queue_element_t _g_queue_sha256_solution_storage[SHA256_SOLUTION_QUEUE_SIZE] = {0};
+
+/** @brief SHA256 progress queue, produced by the calculate task and consumed by flow control. */
+static spsc_ring_t _g_queue_sha256_progress = {0};
+
+/** @brief SHA256 progress queue storage. */
+static sha256_progress_queue_element_t _g_queue_sha256_progress_storage[SHA256_PROGRESS_QUEUE_SIZE] = {0};
+
+/** @brief SHA256 Merkle proof queue, produced by the calculate task and consumed by flow control. */
+static spsc_ring_t _g_queue_sha256_proof = {0};
+
+/** @brief SHA256 Merkle proof queue storage. */
+static sha256_merkle_proof_queue_element_t _g_queue_sha256_proof_storage[SHA256_PROOF_QUEUE_SIZE] = {0};
+
+/** @brief Merkle leaf storage in internal RAM, written by flow control and reduced in place by the calculate task. */
+static sha256_merkle_node_t _g_sha256_merkle_nodes[SHA256_MERKLE_LEAVES_MAX] = {0};
+
+/** @brief Merkle jobs queued or reducing the leaf storage, leaves are only written while there are none. */
+static uint32_t _g_sha256_merkle_storage_holders = 0;
+
+/** @brief Flow control waits for the leaf storage, Merkle jobs stop without a result. */
+static bool _g_b_sha256_merkle_storage_stop = false;
+
+/** @brief SHA256d prefix storage, written by flow control and compressed into the midstate when a SHA256d job starts. */
+static uint8_t _g_sha256d_prefix[SHA256D_PREFIX_MAX_SIZE] = {0};
+
+/** @brief SHA256d jobs queued that didn't compress the prefix yet, the prefix is only written while there are none. */
+static uint32_t _g_sha256d_prefix_holders = 0;
+
+/** @brief Proofs of the Merkle job being reduced. */
+static sha256_merkle_proof_t _g_sha256_merkle_proofs[SHA256_MERKLE_PROOFS_MAX] = {0};
+
+/** @brief Proof siblings of the Merkle job being reduced, one per level for every proof. */
+static sha256_merkle_node_t _g_sha256_merkle_proof_siblings[SHA256_MERKLE_PROOFS_MAX][SHA256_MERKLE_DEPTH_MAX] = {0};
+
+/** @brief SHA256 calculate task handle. */
+static TaskHandle_t _g_task_handle_sha256_calc = NULL;
+
+/** @brief Calculator status, written by the calculate task once per batch. */
+static sha256_calculator_status_t _g_sha256_calculator_status = {0};
+
+/** @brief Calculator status spinlock, also guards the job estimate. */
+static portMUX_TYPE _g_sha256_calculator_status_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+/** @brief Estimate state of the current job, written by the calculate task on job start and once per batch. */
+static sha256_job_estimate_t _g_sha256_job_estimate = {0};
+
+/** @brief SHA256 job batch search of each kernel variant. */
+static const sha256_batch_search_t _g_sha256_batch_search[SHA256_KERNEL_VARIANT_COUNT] = {
+    [SHA256_KERNEL_VARIANT_MBEDTLS] = _sha256_batch_search_mbedtls,
+    [SHA256_KERNEL_VARIANT_PRECOMPUTED] = _sha256_batch_search,
+    [SHA256_KERNEL_VARIANT_PLAIN] = _sha256_batch_search_plain,
+};
+
+/** @brief Core the calculator task is pinned to. */
+static BaseType_t _g_sha256_calc_core_id = tskNO_AFFINITY;
+
+/** @brief Calculator capabilities, kernel selection and hash rates are written once at initialization. */
+static sha256_calculator_capabilities_t _g_sha256_calculator_capabilities = {
+    .nonce_size = SHA256_NONCE_SIZE,
+    .job_types = (1 << SHA256_JOB_TYPE_SHA256) | (1 << SHA256_JOB_TYPE_SHA256D) | (1 << SHA256_JOB_TYPE_HMAC) | (1 << SHA256_JOB_TYPE_CHAIN) |
+                 (1 << SHA256_JOB_TYPE_MERKLE),
+    .kernel_variant = SHA256_KERNEL_VARIANT_PRECOMPUTED,
+    .core_id = SHA256_CORE_ID_ANY,
+    .worker_count = 1,
+    .input_queue_length = SHA256_INPUT_QUEUE_SIZE,
+    .batch_size_max = SHA256_BATCH_SIZE_MAX,
+    .hash_rate_sha256 = 0,
+    .hash_rate_sha256d = 0,
+    .hash_rate_hmac = 0,
+    .hash_rate_chain = 0,
+    .hash_rate_merkle = 0,
+    .merkle_leaves_max = SHA256_MERKLE_LEAVES_MAX,
+};
+
+/* ============================== PUBLIC VARIABLES */
+
+/* ============================== PUBLIC FUNCTION DEFINITIONS */
+
+void sha256_calculator_init(void)
+{
+    BaseType_t result = pdPASS;
+
+#ifdef CONFIG_SHA256_CALC_BENCHMARK
+    _sha256_benchmark();
+#endif
+
+#ifdef CONFIG_SHA256_CALC_AUTOTUNE
+    _sha256_autotune();
+#endif
+
+    _sha256_hash_rate_calibrate();
+
+    sha256_result_cache_init();
+
+    if (false == spsc_ring_init(&_g_queue_sha256_input, _g_queue_sha256_input_storage, SHA256_INPUT_QUEUE_SIZE, sizeof(sha256_input_variables_queue_element_t)))
+    {
+        ESP_LOGE(LOG_TAG, "Failed to create queue for SHA256 input. Aborting!");
+        abort();
+    }
+
+    if (false == spsc_ring_init(&_g_queue_sha256_solution, _g_queue_sha256_solution_storage, SHA256_SOLUTION_QUEUE_SIZE, sizeof(sha256_offset_solution_queue_element_t)))
+    {
+        ESP_LOGE(LOG_TAG, "Failed to create queue for SHA256 solution. Aborting!");
+        abort();
+    }
+
+    if (false == spsc_ring_init(&_g_queue_sha256_progress, _g_queue_sha256_progress_storage, SHA256_PROGRESS_QUEUE_SIZE, sizeof(sha256_progress_queue_element_t)))
+    {
+        ESP_LOGE(LOG_TAG, "Failed to create queue for SHA256 progress. Aborting!");
+        abort();
+    }
+
+    if (false == spsc_ring_init(&_g_queue_sha256_proof, _g_queue_sha256_proof_storage, SHA256_PROOF_QUEUE_SIZE, sizeof(sha256_merkle_proof_queue_element_t)))
+    {
+        ESP_LOGE(LOG_TAG, "Failed to create queue for SHA256 proof. Aborting!");
+        abort();
+    }
+
+    result = xTaskCreatePinnedToCore(_calculate_sha256_task, "SHA256_CALC", TASK_SHA256_CALC_STACK_DEPTH, NULL, TASK_SHA256_CALC_PRIORITY, &_g_task_handle_sha256_calc, _g_sha256_calc_core_id);
+    if (pdPASS != result)
+    {
+        ESP_LOGE(LOG_TAG, "Failed to create task for SHA256 calculation. Aborting!");
+        abort();
+    }
+
+    ESP_LOGI(LOG_TAG, "Initialized calculator.");
+}
+
+void sha256_calculator_queue_input_put(sha256_input_variables_queue_element_t *p_sha256_input_variables_queue_element)
+{
+    PROFILER_START(start);
+
+    /* A Merkle job holds the leaf storage from here until it ends, even if it is rejected or replaced in the queue */
+    if (SHA256_JOB_TYPE_MERKLE == p_sha256_input_variables_queue_element->job_type)
+    {
+        portENTER_CRITICAL(&_g_sha256_calculator_status_spinlock);
+        _g_sha256_merkle_storage_holders++;
+        portEXIT_CRITICAL(&_g_sha256_calculator_status_spinlock);
+    }
+
+    /* A SHA256d job holds the prefix storage until it compressed the prefix */
+    if (SHA256_JOB_TYPE_SHA256D == p_sha256_input_variables_queue_element->job_type)
+    {
+        portENTER_CRITICAL(&_g_sha256_calculator_status_spinlock);
+        _g_sha256d_prefix_holders++;
+        portEXIT_CRITICAL(&_g_sha256_calculator_status_spinlock);
+    }
+
+    while (false == spsc_ring_push(&_g_queue_sha256_input, p_sha256_input_variables_queue_element))
+    {
+        vTaskDelay(SHA256_QUEUE_FULL_RETRY_TICKS);
+    }
+
+    PROFILER_STOP(PROFILER_STAGE_QUEUE_PUT, start);
+
+    /* Wake up the calculate task if it waits for new input variables */
+    xTaskNotifyGive(_g_task_handle_sha256_calc);
+}
+
+bool sha256_calculator_queue_solution_get(sha256_offset_solution_queue_element_t *p_sha256_offset_solution_queue_element)
+{
+    bool b_received_data = false;
+    PROFILER_START(start);
+
+    b_received_data = spsc_ring_pop(&_g_queue_sha256_solution, p_sha256_offset_solution_queue_element);
+
+    PROFILER_STOP(PROFILER_STAGE_QUEUE_GET, start);
+
+    return b_received_data;
+}
+
+bool sha256_calculator_queue_progress_get(sha256_progress_queue_element_t *p_sha256_progress_queue_element)
+{
+    return spsc_ring_pop(&_g_queue_sha256_progress, p_sha256_progress_queue_element);
+}
+
+bool sha256_calculator_queue_proof_get(sha256_merkle_proof_queue_element_t *p_sha256_merkle_proof_queue_element)
+{
+    return spsc_ring_pop(&_g_queue_sha256_proof, p_sha256_merkle_proof_queue_element);
+}
+
+bool sha256_calculator_merkle_leaves_claim(void)
+{
+    bool b_free = false;
+
+    portENTER_CRITICAL(&_g_sha256_calculator_status_spinlock);
+    b_free = (0 == _g_sha256_merkle_storage_holders);
+    _g_b_sha256_merkle_storage_stop = !b_free;
+    portEXIT_CRITICAL(&_g_sha256_calculator_status_spinlock);
+
+    return b_free;
+}
+
+bool sha256_calculator_merkle_leaves_put(uint16_t first_leaf_index, uint8_t leaf_count, const uint8_t *p_leaves)
+{
+    int i = 0;
+
+    if (((uint32_t)first_leaf_index + leaf_count) > SHA256_MERKLE_LEAVES_MAX)
+    {
+        return false;
+    }
+
+    for (i = 0; i < leaf_count; i++)
+    {
+        _sha256_words_load(_g_sha256_merkle_nodes[first_leaf_index + i].words, &p_leaves[i * SHA256_BYTE_DIGEST_SIZE], SHA256_KERNEL_STATE_WORDS);
+    }
+
+    return true;
+}
+
+bool sha256_calculator_sha256d_prefix_claim(void)
+{
+    bool b_free = false;
+
+    /* SHA256d jobs queued before compress the prefix they were queued with first */
+    portENTER_CRITICAL(&_g_sha256_calculator_status_spinlock);
+    b_free = (0 == _g_sha256d_prefix_holders);
+    portEXIT_CRITICAL(&_g_sha256_calculator_status_spinlock);
+
+    return b_free;
+}
+
+bool sha256_calculator_sha256d_prefix_put(uint8_t offset, uint8_t size, const uint8_t *p_prefix)
+{
+    if (((uint32_t)offset + size) > SHA256D_PREFIX_MAX_SIZE)
+    {
+        return false;
+    }
+
+    memcpy(&_g_sha256d_prefix[offset], p_prefix, size);
+
+    return true;
+}
+
+void sha256_calculator_get_status(sha256_calculator_status_t *p_sha256_calculator_status)
+{
+    portENTER_CRITICAL(&_g_sha256_calculator_status_spinlock);
+    *p_sha256_calculator_status = _g_sha256_calculator_status;
+    portEXIT_CRITICAL(&_g_sha256_calculator_status_spinlock);
+}
+
+void sha256_calculator_get_capabilities(sha256_calculator_capabilities_t *p_sha256_calculator_capabilities)
+{
+    *p_sha256_calculator_capabilities = _g_sha256_calculator_capabilities;
+}
+
+void sha256_calculator_get_estimate(uint32_t lease_ms, sha256_calculator_estimate_t *p_sha256_calculator_estimate)
+{
+    sha256_job_estimate_t job_estimate = {0};
+    int64_t elapsed_us = 0;
+    uint64_t range_left = 0;
+    float expected_hashes = 0.0f;
+    float hashes_left = 0.0f;
+    float hash_rate = 0.0f;
+    float lease_hashes = 0.0f;
+    float eta_ms = 0.0f;
+
+    portENTER_CRITICAL(&_g_sha256_calculator_status_spinlock);
+    job_estimate = _g_sha256_job_estimate;
+    portEXIT_CRITICAL(&_g_sha256_calculator_status_spinlock);
+
+    memset(p_sha256_calculator_estimate, 0, sizeof(*p_sha256_calculator_estimate));
+    if (0 == job_estimate.start_us)
+    {
+        return;
+    }
+
+    p_sha256_calculator_estimate->puzzle_id = job_estimate.puzzle_id;
+    p_sha256_calculator_estimate->job_type = job_estimate.job_type;
+    p_sha256_calculator_estimate->job_hashes = job_estimate.job_hashes;
+
+    switch (job_estimate.job_type)
+    {
+        case SHA256_JOB_TYPE_SHA256D: p_sha256_calculator_estimate->hash_rate_expected = _g_sha256_calculator_capabilities.hash_rate_sha256d; break;
+        case SHA256_JOB_TYPE_HMAC: p_sha256_calculator_estimate->hash_rate_expected = _g_sha256_calculator_capabilities.hash_rate_hmac; break;
+        case SHA256_JOB_TYPE_CHAIN: p_sha256_calculator_estimate->hash_rate_expected = _g_sha256_calculator_capabilities.hash_rate_chain; break;
+        case SHA256_JOB_TYPE_MERKLE: p_sha256_calculator_estimate->hash_rate_expected = _g_sha256_calculator_capabilities.hash_rate_merkle; break;
+        default: p_sha256_calculator_estimate->hash_rate_expected = _g_sha256_calculator_capabilities.hash_rate_sha256; break;
+    }
+
+    /* Hash rate is measured over the whole job, including its control and queue waits, the calibrated one before the first batch */
+    elapsed_us = ((true == job_estimate.b_active) ? esp_timer_get_time() : job_estimate.end_us) - job_estimate.start_us;
+    p_sha256_calculator_estimate->elapsed_ms = (uint32_t)(elapsed_us / 1000);
+    hash_rate = ((0 != job_estimate.job_hashes) && (elapsed_us > 0)) ?
+        ((float)job_estimate.job_hashes * 1000000.0f / (float)elapsed_us) : (float)p_sha256_calculator_estimate->hash_rate_expected;
+    p_sha256_calculator_estimate->hash_rate = (uint32_t)hash_rate;
+
+    /* A search that hasn't matched after some candidates still expects the same candidates per match in the rest of its
+       range, only the range shrinks. Hashes of a chain or a Merkle job are known */
+    range_left = (job_estimate.range_hashes > job_estimate.job_hashes) ? (job_estimate.range_hashes - job_estimate.job_hashes) : 0;
+    if (true == job_estimate.b_search)
+    {
+        expected_hashes = -job_estimate.match_hashes * expm1f(-(float)job_estimate.range_hashes / job_estimate.match_hashes);
+        hashes_left = -job_estimate.match_hashes * expm1f(-(float)range_left / job_estimate.match_hashes);
+    }
+    else
+    {
+        expected_hashes = (float)job_estimate.range_hashes;
+        hashes_left = (float)range_left;
+    }
+    p_sha256_calculator_estimate->expected_hashes = _sha256_estimate_hashes_to_u64(expected_hashes);
+
+    if (true == job_estimate.b_active)
+    {
+        p_sha256_calculator_estimate->flags |= SHA256_ESTIMATE_FLAG_ACTIVE;
+
+        /* Time budget ends the job at the latest */
+        eta_ms = (hash_rate > 0.0f) ? (hashes_left * 1000.0f / hash_rate) : (float)UINT32_MAX;
+        if ((0 != job_estimate.time_budget_ms) && (eta_ms > (float)job_estimate.time_budget_ms - (float)elapsed_us / 1000.0f))
+        {
+            eta_ms = (float)job_estimate.time_budget_ms - (float)elapsed_us / 1000.0f;
+        }
+        if (eta_ms < 0.0f) eta_ms = 0.0f;
+        p_sha256_calculator_estimate->eta_ms = (eta_ms >= (float)UINT32_MAX) ? UINT32_MAX : (uint32_t)eta_ms;
+    }
+    if (true == job_estimate.b_search)
+    {
+        p_sha256_calculator_estimate->flags |= SHA256_ESTIMATE_FLAG_SEARCH;
+    }
+    if ((0 != job_estimate.job_hashes) &&
+        (((uint64_t)p_sha256_calculator_estimate->hash_rate * 100) < ((uint64_t)p_sha256_calculator_estimate->hash_rate_expected * SHA256_ESTIMATE_SLOW_PERCENT)))
+    {
+        p_sha256_calculator_estimate->flags |= SHA256_ESTIMATE_FLAG_SLOW;
+    }
+
+    /* Lease sized at the measured hash rate, so the master can pack jobs of similar length onto the worker */
+    lease_hashes = hash_rate * (float)lease_ms / 1000.0f;
+    p_sha256_calculator_estimate->lease_hashes = _sha256_estimate_hashes_to_u64(lease_hashes);
+    if (lease_hashes >= (float)range_left)
+    {
+        p_sha256_calculator_estimate->lease_solve_ppm = 1000000;
+    }
+    else if (true == job_estimate.b_search)
+    {
+        p_sha256_calculator_estimate->lease_solve_ppm = (uint32_t)(-expm1f(-lease_hashes / job_estimate.match_hashes) * 1000000.0f);
+    }
+}
+
+bool sha256_calculator_status_has_progress(uint8_t status)
+{
+    return ((SHA256_SOLUTION_STATUS_BUDGET_EXHAUSTED == status) ||
+            (SHA256_SOLUTION_STATUS_CHAIN_DONE == status) ||
+            (SHA256_SOLUTION_STATUS_CHAIN_CHECKPOINT == status) ||
+            (SHA256_SOLUTION_STATUS_MERKLE_ROOT == status));
+}
+
+/* ============================== PRIVATE FUNCTION DEFINITIONS */
+
+static void _calculate_sha256_task(void *p_task_params)
+{
+    sha256_input_variables_queue_element_t sha256_input_variables_queue_element = {0};
+    sha256_input_variables_t *p_sha256_input_variables = &sha256_input_variables_queue_element.sha256_input_variables;
+    sha256d_input_variables_t *p_sha256d_input_variables = &sha256_input_variables_queue_element.sha256d_input_variables;
+    sha256_hmac_input_variables_t *p_sha256_hmac_input_variables = &sha256_input_variables_queue_element.sha256_hmac_input_variables;
+    sha256_chain_input_variables_t *p_sha256_chain_input_variables = &sha256_input_variables_queue_element.sha256_chain_input_variables;
+    sha256_merkle_input_variables_t *p_sha256_merkle_input_variables = &sha256_input_variables_queue_element.sha256_merkle_input_variables;
+    bool b_received_input = false;
+    uint32_t block[SHA256_KERNEL_BLOCK_WORDS] = {0};
+    sha256_kernel_w0_ctx_t kernel_ctx = {0};
+    sha256_target_t target = {0};
+    sha256d_job_t sha256d_job = {0};
+    sha256_hmac_job_t sha256_hmac_job = {0};
+    sha256_chain_job_t sha256_chain_job = {0};
+    sha256_merkle_tree_t merkle_tree = {0};
+    uint32_t merkle_root[SHA256_KERNEL_STATE_WORDS] = {0};
+    bool b_merkle_held = false;
+    sha256_batch_search_t sha256_batch_search = _g_sha256_batch_search[_g_sha256_calculator_capabilities.kernel_variant];
+    sha256_result_cache_lookup_t cache_lookup = SHA256_RESULT_CACHE_MISS;
+    sha256_nonce_t cache_range_start = 0;
+    sha256_nonce_t cache_solution = 0;
+    bool b_wait_for_input = true;
+    bool b_solution_found = false;
+    bool b_job_valid = false;
+    uint32_t batch_size = SHA256_BATCH_SIZE_INITIAL;
+    uint32_t batch_hashes = 0;
+    uint32_t hashes = 0;
+    uint64_t job_hashes = 0;
+    sha256_job_budget_t job_budget = {0};
+    int64_t job_start_us = 0;
+    int64_t control_start_us = 0;
+    int64_t idle_start_us = 0;
+    int64_t batch_start_us = 0;
+    int64_t batch_end_us = 0;
+
+    sha256_nonce_t start_offset = 0;
+    sha256_nonce_t current_offset = 0;
+    uint8_t current_puzzle_id = 0;
+    uint8_t current_job_type = SHA256_JOB_TYPE_SHA256;
+
+    _g_sha256_calculator_status.batch_size = batch_size;
+    _g_sha256_calculator_status.batch_size_min = batch_size;
+    _g_sha256_calculator_status.batch_size_max = batch_size;
+
+    /* Every candidate is the same padded block that only differs in the nonce words */
+    _sha256_nonce_block_prepare(block);
+
+    while (1)
+    {
+        control_start_us = esp_timer_get_time();
+
+        /* Read inputs from queue, blocking call immediately after a solution found, else non-blocking call */
+        if (true == b_wait_for_input)
+        {
+            idle_start_us = control_start_us;
+
+            while (false == spsc_ring_pop(&_g_queue_sha256_input, &sha256_input_variables_queue_element))
+            {
+                ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            }
+            b_received_input = true;
+
+            /* Time spent idle isn't control overhead */
+            control_start_us = esp_timer_get_time();
+            _sha256_status_job_count(control_start_us - idle_start_us, 0);
+        }
+        else
+        {
+            PROFILER_START(queue_get_start);
+
+            b_received_input = spsc_ring_pop(&_g_queue_sha256_input, &sha256_input_variables_queue_element);
+
+            PROFILER_STOP(PROFILER_STAGE_QUEUE_GET, queue_get_start);
+
+            /* New input variables replace the puzzle being searched, its hashes were wasted */
+            if (true == b_received_input)
+            {
+                _sha256_status_job_count(0, job_hashes);
+            }
+        }
+
+        /* If new inputs read, recalculate parameters */
+        if (true == b_received_input)
+        {
+            /* Set new puzzle ID and job type */
+            current_puzzle_id = sha256_input_variables_queue_element.puzzle_id;
+            current_job_type = sha256_input_variables_queue_element.job_type;
+
+            /* A replaced Merkle job stops reducing, the new one took over the leaf storage when it was queued */
+            _sha256_merkle_storage_release(&b_merkle_held);
+            b_merkle_held = (SHA256_JOB_TYPE_MERKLE == current_job_type);
+
+            /* Set next reads from input queue as non-blocking calls */
+            b_wait_for_input = false;
+
+            job_hashes = 0;
+            job_budget = sha256_input_variables_queue_element.job_budget;
+            job_start_us = control_start_us;
+            cache_lookup = SHA256_RESULT_CACHE_MISS;
+            b_job_valid = false;
+
+            if (SHA256_JOB_TYPE_SHA256 == current_job_type)
+            {
+                start_offset = p_sha256_input_variables->input_offset;
+                b_job_valid = true;
+
+                _sha256_target_prepare(&target, p_sha256_input_variables->target_solution_mask_offset, p_sha256_input_variables->target_solution);
+                _sha256_kernel_prepare(&kernel_ctx, block, start_offset);
+
+                /* Check if the puzzle, or a part of its range, was already solved */
+                cache_lookup = sha256_result_cache_lookup(p_sha256_input_variables, &cache_range_start, &cache_solution);
+
+                /* A cached solution past the hash budget, which covers the shard of a shard job, isn't a match of this
+                   job, it has to run out of budget instead */
+                if ((0 != job_budget.hash_budget) && ((sha256_nonce_t)(cache_solution - start_offset) >= job_budget.hash_budget))
+                {
+                    cache_lookup = SHA256_RESULT_CACHE_MISS;
+                }
+                _sha256_status_cache_count(cache_lookup);
+            }
+            else if (SHA256_JOB_TYPE_SHA256D == current_job_type)
+            {
+                start_offset = p_sha256d_input_variables->input_offset;
+                b_job_valid = _sha256d_job_prepare(&sha256d_job, p_sha256d_input_variables, _g_sha256d_prefix);
+                _sha256d_prefix_release();
+
+                /* The lowest digest is only reported in the progress record of a threshold job with a budget */
+                sha256d_job.b_best_track = ((0 != (sha256d_job.match_flags & SHA256D_MATCH_FLAG_THRESHOLD)) &&
+                                            ((0 != job_budget.time_budget_ms) || (0 != job_budget.hash_budget)));
+            }
+            else if (SHA256_JOB_TYPE_HMAC == current_job_type)
+            {
+                start_offset = p_sha256_hmac_input_variables->input_offset;
+                b_job_valid = _sha256_hmac_job_prepare(&sha256_hmac_job, p_sha256_hmac_input_variables);
+                if (true == b_job_valid) _sha256_hmac_kernel_prepare(&sha256_hmac_job, start_offset);
+            }
+            else if (SHA256_JOB_TYPE_CHAIN == current_job_type)
+            {
+                start_offset = p_sha256_chain_input_variables->input_offset;
+                b_job_valid = _sha256_chain_job_prepare(&sha256_chain_job, p_sha256_chain_input_variables);
+            }
+            else if (SHA256_JOB_TYPE_MERKLE == current_job_type)
+            {
+                start_offset = p_sha256_merkle_input_variables->input_offset;
+                b_job_valid = _sha256_merkle_job_prepare(&merkle_tree, p_sha256_merkle_input_variables);
+
+                /* A tree is bounded by the leaf storage and can't be continued elsewhere, so it ignores the budget */
+                memset(&job_budget, 0, sizeof(job_budget));
+            }
+
+            /* Set new offset */
+            current_offset = start_offset;
+
+            _sha256_estimate_start(&sha256_input_variables_queue_element, &sha256d_job, &job_budget, job_start_us,
+                                   (true == b_job_valid) && (SHA256_RESULT_CACHE_HIT != cache_lookup));
+
+            /* Reject jobs that can't be searched */
+            if (false == b_job_valid)
+            {
+                ESP_LOGW(LOG_TAG, "Invalid job of type %d. Puzzle ID: %d", current_job_type, current_puzzle_id);
+                _sha256_merkle_storage_release(&b_merkle_held);
+                _sha256_solution_put(start_offset, current_puzzle_id, SHA256_SOLUTION_STATUS_INVALID_JOB);
+                b_wait_for_input = true;
+                continue;
+            }
+
+            /* Answer repeated puzzles without searching */
+            if (SHA256_RESULT_CACHE_HIT == cache_lookup)
+            {
+                current_offset = cache_solution;
+                _sha256_solution_put(current_offset, current_puzzle_id, SHA256_SOLUTION_STATUS_FOUND);
+                b_wait_for_input = true;
+                continue;
+            }
+        }
+
+        /* Flow control waits to write leaves for a later tree, a tree reduced from overwritten leaves would have a wrong
+           root, so the Merkle job stops without one. Leaves replace the current puzzle, its result would be dropped */
+        if ((true == b_merkle_held) && (true == _sha256_merkle_storage_stop_requested()))
+        {
+            _sha256_status_job_count(0, job_hashes);
+            _sha256_merkle_storage_release(&b_merkle_held);
+            _sha256_estimate_count(job_hashes, true, control_start_us);
+            b_wait_for_input = true;
+            continue;
+        }
+
+        /* Search a batch of candidates before checking the input queue again, stop early when the search wraps back to
+           the start offset or reaches a cached range */
+        if (SHA256_JOB_TYPE_CHAIN == current_job_type)
+        {
+            /* A hash chain has no nonce space to wrap, it stops at its end and at the next checkpoint */
+            batch_hashes = _sha256_chain_batch_limit(&sha256_chain_job, batch_size);
+        }
+        else if (SHA256_JOB_TYPE_MERKLE == current_job_type)
+        {
+            /* Reduction stops by itself at the root */
+            batch_hashes = batch_size;
+        }
+        else
+        {
+            batch_hashes = _sha256_batch_limit(batch_size, start_offset - current_offset);
+            if (SHA256_RESULT_CACHE_RANGE == cache_lookup)
+            {
+                batch_hashes = _sha256_batch_limit(batch_hashes, cache_range_start - current_offset);
+            }
+#ifdef CONFIG_SHA256_CALC_NONCE_64BIT
+            /* Stop at the low nonce word wrap, the kernels only change the low nonce word per candidate */
+            batch_hashes = _sha256_batch_limit(batch_hashes, (uint32_t)0 - (uint32_t)current_offset);
+#endif
+        }
+        /* Stop at the hash budget */
+        if ((0 != job_budget.hash_budget) && ((job_budget.hash_budget - job_hashes) < batch_hashes))
+        {
+            batch_hashes = (uint32_t)(job_budget.hash_budget - job_hashes);
+        }
+
+        batch_start_us = esp_timer_get_time();
+
+        if (SHA256_JOB_TYPE_SHA256D == current_job_type)
+        {
+            hashes = _sha256d_batch_search(&sha256d_job, &current_offset, batch_hashes, &b_solution_found);
+        }
+        else if (SHA256_JOB_TYPE_HMAC == current_job_type)
+        {
+            hashes = _sha256_hmac_batch_search(&sha256_hmac_job, &current_offset, batch_hashes, &b_solution_found);
+        }
+        else if (SHA256_JOB_TYPE_CHAIN == current_job_type)
+        {
+            hashes = _sha256_chain_batch_search(&sha256_chain_job, &current_offset, batch_hashes);
+            b_solution_found = false;
+        }
+        else if (SHA256_JOB_TYPE_MERKLE == current_job_type)
+        {
+            hashes = sha256_merkle_tree_reduce(&merkle_tree, batch_hashes);
+            b_solution_found = false;
+        }
+        else
+        {
+            hashes = sha256_batch_search(&kernel_ctx, block, &target, &current_offset, batch_hashes, &b_solution_found);
+        }
+
+        batch_end_us = esp_timer_get_time();
+        job_hashes += hashes;
+        batch_size = _sha256_batch_size_update(batch_size, hashes, batch_end_us - batch_start_us, batch_start_us - control_start_us);
+
+        /* Search reached the start of a cached range without a match, so the cached solution is the first match */
+        if ((false == b_solution_found) && (SHA256_RESULT_CACHE_RANGE == cache_lookup) && (current_offset == cache_range_start))
+        {
+            current_offset = cache_solution;
+            b_solution_found = true;
+        }
+
+        /* A Merkle job reports its proofs and then its root once the tree is reduced */
+        if (SHA256_JOB_TYPE_MERKLE == current_job_type)
+        {
+            if (true == sha256_merkle_tree_done(&merkle_tree))
+            {
+                /* Root and proofs are out of the leaf storage, it is released before the results wait for room in their
+                   queues, flow control may wait for it to drain them */
+                memcpy(merkle_root, _g_sha256_merkle_nodes[0].words, sizeof(merkle_root));
+                _sha256_merkle_storage_release(&b_merkle_held);
+
+                _sha256_merkle_proofs_put(&merkle_tree, current_puzzle_id);
+                _sha256_progress_put(current_offset, current_puzzle_id, SHA256_SOLUTION_STATUS_MERKLE_ROOT, job_hashes, merkle_root);
+                b_wait_for_input = true;
+            }
+        }
+        /* A hash chain reports its digest at the end, when the budget ran out and at every checkpoint */
+        else if (SHA256_JOB_TYPE_CHAIN == current_job_type)
+        {
+            if (0 == sha256_chain_job.iterations_left)
+            {
+                _sha256_progress_put(current_offset, current_puzzle_id, SHA256_SOLUTION_STATUS_CHAIN_DONE, job_hashes, sha256_chain_job.digest);
+                b_wait_for_input = true;
+            }
+            else if (true == _sha256_job_budget_spent(&job_budget, job_hashes, batch_end_us - job_start_us))
+            {
+                _sha256_progress_put(current_offset, current_puzzle_id, SHA256_SOLUTION_STATUS_BUDGET_EXHAUSTED, job_hashes, sha256_chain_job.digest);
+                b_wait_for_input = true;
+            }
+            else if ((0 != sha256_chain_job.checkpoint_interval) && (0 == sha256_chain_job.checkpoint_left))
+            {
+                /* Chain continues with the next batch, a new input still cancels it */
+                _sha256_progress_put(current_offset, current_puzzle_id, SHA256_SOLUTION_STATUS_CHAIN_CHECKPOINT, job_hashes, sha256_chain_job.digest);
+                sha256_chain_job.checkpoint_left = sha256_chain_job.checkpoint_interval;
+            }
+        }
+        /* If there is a match, send discovered solution into queue, blocking call */
+        else if (true == b_solution_found)
+        {
+            if (SHA256_JOB_TYPE_SHA256 == current_job_type)
+            {
+                sha256_result_cache_insert(p_sha256_input_variables, current_offset);
+            }
+
+            _sha256_solution_put(current_offset, current_puzzle_id, SHA256_SOLUTION_STATUS_FOUND);
+
+            /* Next queue receive will be blocking (wait for new input variables) */
+            b_wait_for_input = true;
+        }
+        /* If the search wrapped back to the start offset, every offset was searched without a match */
+        else if ((0 != hashes) && (current_offset == start_offset))
+        {
+            ESP_LOGW(LOG_TAG, "Nonce space exhausted without a match. Puzzle ID: %d", current_puzzle_id);
+
+            _sha256_solution_put(start_offset, current_puzzle_id, SHA256_SOLUTION_STATUS_EXHAUSTED);
+
+            b_wait_for_input = true;
+        }
+        /* If the budget ran out, report how far the search got so the master can hand out the rest */
+        else if (true == _sha256_job_budget_spent(&job_budget, job_hashes, batch_end_us - job_start_us))
+        {
+            _sha256_progress_put(current_offset, current_puzzle_id, SHA256_SOLUTION_STATUS_BUDGET_EXHAUSTED, job_hashes,
+                ((SHA256_JOB_TYPE_SHA256D == current_job_type) && (true == sha256d_job.b_best_track)) ? sha256d_job.best_digest : NULL);
+
+            b_wait_for_input = true;
+        }
+#ifdef CONFIG_SHA256_CALC_NONCE_64BIT
+        /* Low nonce word wrapped, prepare the kernel for the next high nonce word */
+        else if ((SHA256_JOB_TYPE_SHA256 == current_job_type) && (0 == (uint32_t)current_offset))
+        {
+            _sha256_kernel_prepare(&kernel_ctx, block, current_offset);
+        }
+        else if ((SHA256_JOB_TYPE_HMAC == current_job_type) && (0 == (uint32_t)current_offset))
+        {
+            _sha256_hmac_kernel_prepare(&sha256_hmac_job, current_offset);
+        }
+#endif
+
+        _sha256_estimate_count(job_hashes, b_wait_for_input, batch_end_us);
+    }
+}
+
+static uint32_t _sha256_batch_search(const sha256_kernel_w0_ctx_t *p_kernel_ctx, const uint32_t *p_block, const sha256_target_t *p_target, sha256_nonce_t *p_offset, uint32_t batch_hashes, bool *p_b_solution_found)
+{
+    uint32_t digest[SHA256_KERNEL_STATE_WORDS];
+    sha256_nonce_t current_offset = *p_offset;
+    bool b_solution_found = false;
+    uint32_t hashes = 0;
+
+    for (hashes = 0; hashes < batch_hashes; hashes++)
+    {
+        PROFILER_START(kernel_start);
+
+        /* Hash the input offset, little endian bytes of its low word are the first big endian message word */
+        sha256_kernel_w0_hash(p_kernel_ctx, __builtin_bswap32((uint32_t)current_offset), digest);
+
+        PROFILER_STOP(PROFILER_STAGE_KERNEL, kernel_start);
+        PROFILER_START(compare_start);
+
+        /* Compare the output hash with the target */
+        b_solution_found = _sha256_target_match(p_target, digest);
+
+        PROFILER_STOP(PROFILER_STAGE_COMPARE, compare_start);
+
+        /* Stop the batch on a match, the current offset is the solution */
+        if (true == b_solution_found)
+        {
+            hashes++;
+            break;
+        }
+
+        /* Increment the current offset if no match */
+        current_offset++;
+    }
+
+    *p_offset = current_offset;
+    *p_b_solution_found = b_solution_found;
+
+    return hashes;
+}
+
+static uint32_t _sha256_batch_search_plain(const sha256_kernel_w0_ctx_t *p_kernel_ctx, const uint32_t *p_block, const sha256_target_t *p_target, sha256_nonce_t *p_offset, uint32_t batch_hashes, bool *p_b_solution_found)
+{
+    uint32_t block[SHA256_KERNEL_BLOCK_WORDS];
+    uint32_t digest[SHA256_KERNEL_STATE_WORDS];
+    sha256_nonce_t current_offset = *p_offset;
+    bool b_solution_found = false;
+    uint32_t hashes = 0;
+
+    memcpy(block, p_block, sizeof(block));
+
+    for (hashes = 0; hashes < batch_hashes; hashes++)
+    {
+        PROFILER_START(kernel_start);
+
+        block[0] = __builtin_bswap32((uint32_t)current_offset);
+        sha256_kernel_block_hash(block, digest);
+
+        PROFILER_STOP(PROFILER_STAGE_KERNEL, kernel_start);
+        PROFILER_START(compare_start);
+
+        b_solution_found = _sha256_target_match(p_target, digest);
+
+        PROFILER_STOP(PROFILER_STAGE_COMPARE, compare_start);
+
+        if (true == b_solution_found)
+        {
+            hashes++;
+            break;
+        }
+
+        current_offset++;
+    }
+
+    *p_offset = current_offset;
+    *p_b_solution_found = b_solution_found;
+
+    return hashes;
+}
+
+static uint32_t _sha256_batch_search_mbedtls(const sha256_kernel_w0_ctx_t *p_kernel_ctx, const uint32_t *p_block, const sha256_target_t *p_target, sha256_nonce_t *p_offset, uint32_t batch_hashes, bool *p_b_solution_found)
+{
+    uint8_t hash[SHA256_BYTE_DIGEST_SIZE];
+    uint32_t digest[SHA256_KERNEL_STATE_WORDS];
+    sha256_nonce_t current_offset = *p_offset;
+    bool b_solution_found = false;
+    uint32_t hashes = 0;
+
+    for (hashes = 0; hashes < batch_hashes; hashes++)
+    {
+        PROFILER_START(kernel_start);
+
+        /* Nonce is hashed as its little endian bytes, same as the in memory layout */
+        mbedtls_sha256((const uint8_t *)&current_offset, SHA256_NONCE_SIZE, hash, 0);
+        _sha256_words_load(digest, hash, SHA256_KERNEL_STATE_WORDS);
+
+        PROFILER_STOP(PROFILER_STAGE_KERNEL, kernel_start);
+        PROFILER_START(compare_start);
+
+        b_solution_found = _sha256_target_match(p_target, digest);
+
+        PROFILER_STOP(PROFILER_STAGE_COMPARE, compare_start);
+
+        if (true == b_solution_found)
+        {
+            hashes++;
+            break;
+        }
+
+        current_offset++;
+    }
+
+    *p_offset = current_offset;
+    *p_b_solution_found = b_solution_found;
+
+    return hashes;
+}
+
+static uint32_t _sha256d_batch_search(sha256d_job_t *p_sha256d_job, sha256_nonce_t *p_offset, uint32_t batch_hashes, bool *p_b_solution_found)
+{
+    uint32_t digest[SHA256_KERNEL_STATE_WORDS];
+    uint32_t *p_nonce_words = &p_sha256d_job->block[p_sha256d_job->nonce_word];
+    sha256_nonce_t current_offset = *p_offset;
+    bool b_solution_found = false;
+    uint32_t hashes = 0;
+
+#ifdef CONFIG_SHA256_CALC_NONCE_64BIT
+    /* Batches don't cross a low nonce word wrap, the high word is constant within a batch */
+    p_nonce_words[1] = __builtin_bswap32((uint32_t)(current_offset >> 32));
+#endif
+
+    for (hashes = 0; hashes < batch_hashes; hashes++)
+    {
+        PROFILER_START(kernel_start);
+
+        /* Compress the last block into the prefix midstate, then hash the digest again */
+        p_nonce_words[0] = __builtin_bswap32((uint32_t)current_offset);
+        memcpy(digest, p_sha256d_job->midstate, sizeof(digest));
+        sha256_kernel_compress(digest, p_sha256d_job->block);
+        sha256_kernel_digest_hash(digest, digest);
+
+        PROFILER_STOP(PROFILER_STAGE_KERNEL, kernel_start);
+        PROFILER_START(compare_start);
+
+        b_solution_found = _sha256d_job_match(p_sha256d_job, digest);
+        if ((false == b_solution_found) && (true == p_sha256d_job->b_best_track)) _sha256d_best_update(p_sha256d_job, digest);
+
+        PROFILER_STOP(PROFILER_STAGE_COMPARE, compare_start);
+
+        if (true == b_solution_found)
+        {
+            hashes++;
+            break;
+        }
+
+        current_offset++;
+    }
+
+    *p_offset = current_offset;
+    *p_b_solution_found = b_solution_found;
+
+    return hashes;
+}
+
+static uint32_t _sha256_hmac_batch_search(sha256_hmac_job_t *p_sha256_hmac_job, sha256_nonce_t *p_offset, uint32_t batch_hashes, bool *p_b_solution_found)
+{
+    uint32_t digest[SHA256_KERNEL_STATE_WORDS];
+    sha256_nonce_t current_offset = *p_offset;
+    bool b_solution_found = false;
+    uint32_t hashes = 0;
+
+    for (hashes = 0; hashes < batch_hashes; hashes++)
+    {
+        PROFILER_START(kernel_start);
+
+        /* Inner digest goes straight into the outer block, which is compressed into the outer key pad midstate */
+        sha256_kernel_w0_hash(&p_sha256_hmac_job->inner_kernel_ctx, __builtin_bswap32((uint32_t)current_offset), p_sha256_hmac_job->outer_block);
+        memcpy(digest, p_sha256_hmac_job->outer_midstate, sizeof(digest));
+        sha256_kernel_compress(digest, p_sha256_hmac_job->outer_block);
+
+        PROFILER_STOP(PROFILER_STAGE_KERNEL, kernel_start);
+        PROFILER_START(compare_start);
+
+        b_solution_found = _sha256_target_match(&p_sha256_hmac_job->target, digest);
+
+        PROFILER_STOP(PROFILER_STAGE_COMPARE, compare_start);
+
+        if (true == b_solution_found)
+        {
+            hashes++;
+            break;
+        }
+
+        current_offset++;
+    }
+
+    *p_offset = current_offset;
+    *p_b_solution_found = b_solution_found;
+
+    return hashes;
+}
+
+static uint32_t _sha256_chain_batch_search(sha256_chain_job_t *p_sha256_chain_job, sha256_nonce_t *p_offset, uint32_t batch_hashes)
+{
+    /* Digest stays in the kernel between iterations, nothing is padded or compared per iteration */
+    sha256_kernel_digest_chain(p_sha256_chain_job->digest, batch_hashes);
+
+    p_sha256_chain_job->iterations_left -= batch_hashes;
+    if (0 != p_sha256_chain_job->checkpoint_interval) p_sha256_chain_job->checkpoint_left -= batch_hashes;
+    *p_offset += batch_hashes;
+
+    return batch_hashes;
+}
+
+static uint32_t _sha256_batch_size_update(uint32_t batch_size, uint32_t hashes, int64_t batch_us, int64_t control_us)
+{
+    uint64_t next_batch_size = batch_size;
+    sha256_calculator_status_t *p_status = &_g_sha256_calculator_status;
+
+    if (batch_us <= 0) batch_us = 1;
+
+    /* Scale the batch so it lasts the targeted duration, grow at most 2x per batch so a preempted batch doesn't overshoot */
+    if (0 != hashes)
+    {
+        next_batch_size = ((uint64_t)hashes * SHA256_BATCH_TARGET_US) / (uint64_t)batch_us;
+        if (next_batch_size > (2 * (uint64_t)batch_size)) next_batch_size = 2 * (uint64_t)batch_size;
+        if (next_batch_size < SHA256_BATCH_SIZE_MIN) next_batch_size = SHA256_BATCH_SIZE_MIN;
+        if (next_batch_size > SHA256_BATCH_SIZE_MAX) next_batch_size = SHA256_BATCH_SIZE_MAX;
+    }
+
+    portENTER_CRITICAL(&_g_sha256_calculator_status_spinlock);
+
+    p_status->batch_size = (uint32_t)next_batch_size;
+    if (next_batch_size < p_status->batch_size_min) p_status->batch_size_min = (uint32_t)next_batch_size;
+    if (next_batch_size > p_status->batch_size_max) p_status->batch_size_max = (uint32_t)next_batch_size;
+    p_status->batch_duration_us = (uint32_t)batch_us;
+    p_status->control_overhead_ppm = (uint32_t)((control_us * 1000000) / (control_us + batch_us));
+    p_status->hash_rate = (uint32_t)(((uint64_t)hashes * 1000000) / (uint64_t)batch_us);
+    p_status->hashes_total += hashes;
+
+    portEXIT_CRITICAL(&_g_sha256_calculator_status_spinlock);
+
+    return (uint32_t)next_batch_size;
+}
+
+static void _sha256_solution_put(sha256_nonce_t offset_solution, uint8_t puzzle_id, uint8_t status)
+{
+    sha256_offset_solution_queue_element_t sha256_offset_solution_queue_element = {0};
+    PROFILER_START(start);
+
+    /* Set offset solution, puzzle ID and status of the solution */
+    sha256_offset_solution_queue_element.sha256_offset_solution.offset_solution = offset_solution;
+    sha256_offset_solution_queue_element.puzzle_id = puzzle_id;
+    sha256_offset_solution_queue_element.status = status;
+
+    while (false == spsc_ring_push(&_g_queue_sha256_solution, &sha256_offset_solution_queue_element))
+    {
+        vTaskDelay(SHA256_QUEUE_FULL_RETRY_TICKS);
+    }
+
+    PROFILER_STOP(PROFILER_STAGE_QUEUE_PUT, start);
+}
+
+static inline bool _sha256_job_budget_spent(const sha256_job_budget_t *p_job_budget, uint64_t job_hashes, int64_t job_us)
+{
+    if ((0 != p_job_budget->hash_budget) && (job_hashes >= p_job_budget->hash_budget)) return true;
+    if ((0 != p_job_budget->time_budget_ms) && (job_us >= ((int64_t)p_job_budget->time_budget_ms * 1000))) return true;
+
+    return false;
+}
+
+static void _sha256_progress_put(sha256_nonce_t next_offset, uint8_t puzzle_id, uint8_t status, uint64_t job_hashes, const uint32_t *p_digest)
+{
+    sha256_progress_queue_element_t sha256_progress_queue_element = {0};
+    int i = 0;
+
+    sha256_progress_queue_element.sha256_offset_solution_queue_element.sha256_offset_solution.offset_solution = next_offset;
+    sha256_progress_queue_element.sha256_offset_solution_queue_element.puzzle_id = puzzle_id;
+    sha256_progress_queue_element.sha256_offset_solution_queue_element.status = status;
+    sha256_progress_queue_element.hashes = job_hashes;
+
+    /* Digest words are big endian, the digest bytes are their bytes in order */
+    if (NULL != p_digest)
+    {
+        for (i = 0; i < SHA256_BYTE_DIGEST_SIZE; i++)
+        {
+            sha256_progress_queue_element.best_digest[i] = (uint8_t)(p_digest[i / 4] >> (24 - (8 * (i % 4))));
+        }
+    }
+
+    /* Progress record goes first, flow control takes it when it sees the solution */
+    while (false == spsc_ring_push(&_g_queue_sha256_progress, &sha256_progress_queue_element))
+    {
+        vTaskDelay(SHA256_QUEUE_FULL_RETRY_TICKS);
+    }
+
+    _sha256_solution_put(next_offset, puzzle_id, status);
+}
+
+static void _sha256_status_job_count(int64_t idle_us, uint64_t hashes_superseded)
+{
+    portENTER_CRITICAL(&_g_sha256_calculator_status_spinlock);
+
+    _g_sha256_calculator_status.idle_us_total += (uint64_t)idle_us;
+    _g_sha256_calculator_status.hashes_superseded += hashes_superseded;
+
+    portEXIT_CRITICAL(&_g_sha256_calculator_status_spinlock);
+}
+
+static void _sha256_status_cache_count(sha256_result_cache_lookup_t lookup)
+{
+    portENTER_CRITICAL(&_g_sha256_calculator_status_spinlock);
+
+    if (SHA256_RESULT_CACHE_HIT == lookup) _g_sha256_calculator_status.cache_hits++;
+    else if (SHA256_RESULT_CACHE_RANGE == lookup) _g_sha256_calculator_status.cache_range_hits++;
+    else _g_sha256_calculator_status.cache_misses++;
+
+    portEXIT_CRITICAL(&_g_sha256_calculator_status_spinlock);
+}
+
+static void _sha256_merkle_storage_release(bool *p_b_merkle_held)
+{
+    if (false == *p_b_merkle_held)
+    {
+        return;
+    }
+
+    portENTER_CRITICAL(&_g_sha256_calculator_status_spinlock);
+    _g_sha256_merkle_storage_holders--;
+    portEXIT_CRITICAL(&_g_sha256_calculator_status_spinlock);
+
+    *p_b_merkle_held = false;
+}
+
+static bool _sha256_merkle_storage_stop_requested(void)
+{
+    bool b_stop = false;
+
+    portENTER_CRITICAL(&_g_sha256_calculator_status_spinlock);
+    b_stop = _g_b_sha256_merkle_storage_stop;
+    portEXIT_CRITICAL(&_g_sha256_calculator_status_spinlock);
+
+    return b_stop;
+}
 
-/** @brief Calculate SHA256 task priority. */
-#define TASK_SHA256_CALC_PRIORITY               (0)
+static void _sha256d_prefix_release(void)
+{
+    portENTER_CRITICAL(&_g_sha256_calculator_status_spinlock);
+    _g_sha256d_prefix_holders--;
+    portEXIT_CRITICAL(&_g_sha256_calculator_status_spinlock);
+}
 
-/* ============================== TYPE DEFINITIONS */
+static void _sha256_estimate_start(const sha256_input_variables_queue_element_t *p_sha256_input_variables_queue_element, const sha256d_job_t *p_sha256d_job,
+                                   const sha256_job_budget_t *p_job_budget, int64_t start_us, bool b_active)
+{
+    sha256_job_estimate_t job_estimate = {0};
+    float threshold_share = 0.0f;
+    uint32_t level_nodes = 0;
 
-/* ============================== PRIVATE FUNCTION DECLARATIONS */
+    job_estimate.b_active = b_active;
+    job_estimate.b_search = true;
+    job_estimate.puzzle_id = p_sha256_input_variables_queue_element->puzzle_id;
+    job_estimate.job_type = p_sha256_input_variables_queue_element->job_type;
+    job_estimate.match_hashes = 1.0f;
+    job_estimate.range_hashes = SHA256_NONCE_SPACE_HASHES;
+    job_estimate.time_budget_ms = p_job_budget->time_budget_ms;
+    job_estimate.start_us = start_us;
+    job_estimate.end_us = start_us;
 
-/**
- * @brief Task that calculates SHA256 given the input variables.
- * 
- * @param p_task_params Task parameters (not used).
- */
-static void _calculate_sha256_task(void *p_task_params);
+    if (SHA256_JOB_TYPE_SHA256 == job_estimate.job_type)
+    {
+        job_estimate.match_hashes = _sha256_estimate_mask_hashes(p_sha256_input_variables_queue_element->sha256_input_variables.target_solution_mask_offset);
+    }
+    else if (SHA256_JOB_TYPE_HMAC == job_estimate.job_type)
+    {
+        job_estimate.match_hashes = _sha256_estimate_mask_hashes(p_sha256_input_variables_queue_element->sha256_hmac_input_variables.target_solution_mask_offset);
+    }
+    else if (SHA256_JOB_TYPE_SHA256D == job_estimate.job_type)
+    {
+        if (0 != (p_sha256d_job->match_flags & SHA256D_MATCH_FLAG_TARGET))
+        {
+            job_estimate.match_hashes = _sha256_estimate_mask_hashes(p_sha256_input_variables_queue_element->sha256d_input_variables.target_solution_mask_offset);
+        }
 
-/* ============================== PRIVATE VARIABLES */
+        /* Share of digests at or below the threshold, the leading threshold words are enough for a float */
+        if (0 != (p_sha256d_job->match_flags & SHA256D_MATCH_FLAG_THRESHOLD))
+        {
+            threshold_share = ldexpf((float)p_sha256d_job->threshold_words[0], -32) +
+                              ldexpf((float)p_sha256d_job->threshold_words[1], -64) +
+                              ldexpf((float)p_sha256d_job->threshold_words[2], -96);
+            job_estimate.match_hashes = (threshold_share > (job_estimate.match_hashes / FLT_MAX)) ? (job_estimate.match_hashes / threshold_share) : FLT_MAX;
+        }
+    }
+    else if (SHA256_JOB_TYPE_CHAIN == job_estimate.job_type)
+    {
+        job_estimate.b_search = false;
+        job_estimate.range_hashes = p_sha256_input_variables_queue_element->sha256_chain_input_variables.iterations;
+    }
+    else if (SHA256_JOB_TYPE_MERKLE == job_estimate.job_type)
+    {
+        /* Every level has half of the nodes of the level below, rounded up */
+        job_estimate.b_search = false;
+        job_estimate.range_hashes = 0;
+        level_nodes = p_sha256_input_variables_queue_element->sha256_merkle_input_variables.leaf_count;
+        while (level_nodes > 1)
+        {
+            level_nodes = (level_nodes + 1) / 2;
+            job_estimate.range_hashes += level_nodes;
+        }
+    }
+
+    if ((0 != p_job_budget->hash_budget) && (p_job_budget->hash_budget < job_estimate.range_hashes))
+    {
+        job_estimate.range_hashes = p_job_budget->hash_budget;
+    }
 
-/** @brief SHA256 input queue. */
-static QueueHandle_t _g_queue_sha256_input = NULL;
+    portENTER_CRITICAL(&_g_sha256_calculator_status_spinlock);
+    _g_sha256_job_estimate = job_estimate;
+    portEXIT_CRITICAL(&_g_sha256_calculator_status_spinlock);
+}
 
-/** @brief SHA256 solution queue. */
-static QueueHandle_t _g_queue_sha256_solution = NULL;
+static void _sha256_estimate_count(uint64_t job_hashes, bool b_job_done, int64_t now_us)
+{
+    portENTER_CRITICAL(&_g_sha256_calculator_status_spinlock);
 
-/** @brief SHA256 calculate task handle. */
-static TaskHandle_t _g_task_handle_sha256_calc = NULL;
+    _g_sha256_job_estimate.job_hashes = job_hashes;
+    if (true == b_job_done)
+    {
+        _g_sha256_job_estimate.b_active = false;
+        _g_sha256_job_estimate.end_us = now_us;
+    }
 
-/* ============================== PUBLIC VARIABLES */
+    portEXIT_CRITICAL(&_g_sha256_calculator_status_spinlock);
+}
 
-/* ============================== PUBLIC FUNCTION DEFINITIONS */
+static float _sha256_estimate_mask_hashes(uint8_t target_solution_mask_offset)
+{
+    int mask_bits = target_solution_mask_offset + 1;
 
-void sha256_calculator_init(void)
+    if (mask_bits > SHA256_ESTIMATE_MASK_BITS_MAX) mask_bits = SHA256_ESTIMATE_MASK_BITS_MAX;
+
+    return ldexpf(1.0f, mask_bits);
+}
+
+static uint64_t _sha256_estimate_hashes_to_u64(float hashes)
 {
-    BaseType_t result = pdPASS;
+    /* Two to the power of 64 is the first float above the largest integer */
+    if (hashes >= 18446744073709551616.0f) return UINT64_MAX;
+    if (hashes <= 0.0f) return 0;
+
+    return (uint64_t)hashes;
+}
+
+static void _sha256_nonce_block_prepare(uint32_t *p_block)
+{
+    memset(p_block, 0, SHA256_KERNEL_BLOCK_WORDS * sizeof(uint32_t));
+
+    /* Padding bit right after the nonce and the message length in bits in the last word */
+    p_block[SHA256_NONCE_SIZE / sizeof(uint32_t)] = 0x80000000;
+    p_block[SHA256_KERNEL_BLOCK_WORDS - 1] = SHA256_NONCE_SIZE * 8;
+}
+
+static void _sha256_kernel_prepare(sha256_kernel_w0_ctx_t *p_kernel_ctx, uint32_t *p_block, sha256_nonce_t nonce)
+{
+#ifdef CONFIG_SHA256_CALC_NONCE_64BIT
+    /* Little endian bytes of the high nonce word are the second big endian message word */
+    p_block[1] = __builtin_bswap32((uint32_t)(nonce >> 32));
+#else
+    (void)nonce;
+#endif
+
+    sha256_kernel_w0_prepare(p_kernel_ctx, sha256_kernel_initial_state, p_block);
+}
+
+static inline uint32_t _sha256_batch_limit(uint32_t batch_hashes, sha256_nonce_t distance)
+{
+    if ((0 != distance) && (distance < batch_hashes)) return (uint32_t)distance;
+
+    return batch_hashes;
+}
+
+static inline uint32_t _sha256_chain_batch_limit(const sha256_chain_job_t *p_sha256_chain_job, uint32_t batch_hashes)
+{
+    if (p_sha256_chain_job->iterations_left < batch_hashes) batch_hashes = (uint32_t)p_sha256_chain_job->iterations_left;
+    if ((0 != p_sha256_chain_job->checkpoint_interval) && (p_sha256_chain_job->checkpoint_left < batch_hashes)) batch_hashes = p_sha256_chain_job->checkpoint_left;
+
+    return batch_hashes;
+}
+
+static bool _sha256d_job_prepare(sha256d_job_t *p_sha256d_job, const sha256d_input_variables_t *p_sha256d_input_variables, const uint8_t *p_prefix)
+{
+    uint8_t last_block[SHA256_KERNEL_BLOCK_SIZE] = {0};
+    uint32_t threshold_words[SHA256_KERNEL_STATE_WORDS] = {0};
+    int prefix_size = p_sha256d_input_variables->prefix_size;
+    int tail_size = prefix_size % SHA256_KERNEL_BLOCK_SIZE;
+    uint32_t message_bits = (prefix_size + SHA256_NONCE_SIZE) * 8;
+    int i = 0;
 
-    _g_queue_sha256_input = xQueueCreate(SHA256_INPUT_QUEUE_SIZE, sizeof(sha256_input_variables_queue_element_t));
-    if (NULL == _g_queue_sha256_input)
+    /* The nonce must be word aligned and fit into the last block together with the padding */
+    if ((prefix_size > SHA256D_PREFIX_MAX_SIZE) ||
+        (0 != (prefix_size % sizeof(uint32_t))) ||
+        ((tail_size + SHA256_NONCE_SIZE + SHA256_PADDING_SIZE) > SHA256_KERNEL_BLOCK_SIZE) ||
+        (0 == (p_sha256d_input_variables->match_flags & (SHA256D_MATCH_FLAG_TARGET | SHA256D_MATCH_FLAG_THRESHOLD))))
     {
-        ESP_LOGE(LOG_TAG, "Failed to create queue for SHA256 input. Aborting!");
-        abort();
+        return false;
     }
 
-    _g_queue_sha256_solution = xQueueCreate(SHA256_SOLUTION_QUEUE_SIZE, sizeof(sha256_offset_solution_queue_element_t));
-    if (NULL == _g_queue_sha256_solution)
+    /* Full prefix blocks are the same for every candidate */
+    memcpy(p_sha256d_job->midstate, sha256_kernel_initial_state, sizeof(p_sha256d_job->midstate));
+    for (i = 0; (i + SHA256_KERNEL_BLOCK_SIZE) <= prefix_size; i += SHA256_KERNEL_BLOCK_SIZE)
     {
-        ESP_LOGE(LOG_TAG, "Failed to create queue for SHA256 solution. Aborting!");
-        abort();
+        _sha256_words_load(p_sha256d_job->block, &p_prefix[i], SHA256_KERNEL_BLOCK_WORDS);
+        sha256_kernel_compress(p_sha256d_job->midstate, p_sha256d_job->block);
     }
 
-    result = xTaskCreate(_calculate_sha256_task, "SHA256_CALC", TASK_SHA256_CALC_STACK_DEPTH, NULL, TASK_SHA256_CALC_PRIORITY, &_g_task_handle_sha256_calc);
-    if (pdPASS != result)
+    /* Last block holds the prefix tail, the nonce words set per candidate, the padding bit and the message length */
+    memcpy(last_block, &p_prefix[prefix_size - tail_size], tail_size);
+    last_block[tail_size + SHA256_NONCE_SIZE] = 0x80;
+    _sha256_words_load(p_sha256d_job->block, last_block, SHA256_KERNEL_BLOCK_WORDS);
+    p_sha256d_job->block[SHA256_KERNEL_BLOCK_WORDS - 1] = message_bits;
+    p_sha256d_job->nonce_word = tail_size / sizeof(uint32_t);
+
+    p_sha256d_job->match_flags = p_sha256d_input_variables->match_flags;
+    p_sha256d_job->b_best_track = false;
+    memset(p_sha256d_job->best_words, 0xFF, sizeof(p_sha256d_job->best_words));
+    memset(p_sha256d_job->best_digest, 0, sizeof(p_sha256d_job->best_digest));
+    _sha256_target_prepare(&p_sha256d_job->target, p_sha256d_input_variables->target_solution_mask_offset, p_sha256d_input_variables->target_solution);
+
+    /* Threshold words are stored most significant first, a little endian threshold starts at the last byte */
+    _sha256_words_load(threshold_words, p_sha256d_input_variables->threshold, SHA256_KERNEL_STATE_WORDS);
+    for (i = 0; i < SHA256_KERNEL_STATE_WORDS; i++)
     {
-        ESP_LOGE(LOG_TAG, "Failed to create task for SHA256 calculation. Aborting!");
-        abort();
+        p_sha256d_job->threshold_words[i] = (0 != (p_sha256d_job->match_flags & SHA256D_MATCH_FLAG_THRESHOLD_LE)) ?
+            __builtin_bswap32(threshold_words[SHA256_KERNEL_STATE_WORDS - 1 - i]) : threshold_words[i];
     }
 
-    ESP_LOGI(LOG_TAG, "Initialized calculator.");
+    return true;
 }
 
-void sha256_calculator_queue_input_put(sha256_input_variables_queue_element_t *p_sha256_input_variables_queue_element)
+static bool _sha256_hmac_job_prepare(sha256_hmac_job_t *p_sha256_hmac_job, const sha256_hmac_input_variables_t *p_sha256_hmac_input_variables)
 {
-    xQueueSendToBack(_g_queue_sha256_input, (void*)p_sha256_input_variables_queue_element, portMAX_DELAY);
+    uint8_t key_block[SHA256_KERNEL_BLOCK_SIZE] = {0};
+    uint32_t pad_block[SHA256_KERNEL_BLOCK_WORDS] = {0};
+    int i = 0;
+
+    if (p_sha256_hmac_input_variables->key_size > SHA256_HMAC_KEY_MAX_SIZE)
+    {
+        return false;
+    }
+
+    memcpy(key_block, p_sha256_hmac_input_variables->key, p_sha256_hmac_input_variables->key_size);
+
+    /* Key pad blocks are the same for every candidate, only their midstates are kept */
+    for (i = 0; i < SHA256_KERNEL_BLOCK_SIZE; i++) key_block[i] ^= SHA256_HMAC_IPAD;
+    _sha256_words_load(pad_block, key_block, SHA256_KERNEL_BLOCK_WORDS);
+    memcpy(p_sha256_hmac_job->inner_midstate, sha256_kernel_initial_state, sizeof(p_sha256_hmac_job->inner_midstate));
+    sha256_kernel_compress(p_sha256_hmac_job->inner_midstate, pad_block);
+
+    for (i = 0; i < SHA256_KERNEL_BLOCK_SIZE; i++) key_block[i] ^= (SHA256_HMAC_IPAD ^ SHA256_HMAC_OPAD);
+    _sha256_words_load(pad_block, key_block, SHA256_KERNEL_BLOCK_WORDS);
+    memcpy(p_sha256_hmac_job->outer_midstate, sha256_kernel_initial_state, sizeof(p_sha256_hmac_job->outer_midstate));
+    sha256_kernel_compress(p_sha256_hmac_job->outer_midstate, pad_block);
+
+    /* Inner message is the nonce after the key pad block, the outer message is the inner digest after the other one */
+    _sha256_nonce_block_prepare(p_sha256_hmac_job->inner_block);
+    p_sha256_hmac_job->inner_block[SHA256_KERNEL_BLOCK_WORDS - 1] = (SHA256_KERNEL_BLOCK_SIZE + SHA256_NONCE_SIZE) * 8;
+
+    memset(p_sha256_hmac_job->outer_block, 0, sizeof(p_sha256_hmac_job->outer_block));
+    p_sha256_hmac_job->outer_block[SHA256_KERNEL_STATE_WORDS] = 0x80000000;
+    p_sha256_hmac_job->outer_block[SHA256_KERNEL_BLOCK_WORDS - 1] = (SHA256_KERNEL_BLOCK_SIZE + SHA256_BYTE_DIGEST_SIZE) * 8;
+
+    _sha256_target_prepare(&p_sha256_hmac_job->target, p_sha256_hmac_input_variables->target_solution_mask_offset, p_sha256_hmac_input_variables->target_solution);
+
+    return true;
 }
 
-bool sha256_calculator_queue_solution_get(sha256_offset_solution_queue_element_t *p_sha256_offset_solution_queue_element)
+static bool _sha256_chain_job_prepare(sha256_chain_job_t *p_sha256_chain_job, const sha256_chain_input_variables_t *p_sha256_chain_input_variables)
 {
-    bool b_received_data = false;
-    BaseType_t ret = errQUEUE_EMPTY;
+    if (0 == p_sha256_chain_input_variables->iterations)
+    {
+        return false;
+    }
 
-    ret = xQueueReceive(_g_queue_sha256_solution, (void*)p_sha256_offset_solution_queue_element, 0);
-    if (pdPASS == ret) b_received_data = true;
+    _sha256_words_load(p_sha256_chain_job->digest, p_sha256_chain_input_variables->seed, SHA256_KERNEL_STATE_WORDS);
+    p_sha256_chain_job->iterations_left = p_sha256_chain_input_variables->iterations;
+    p_sha256_chain_job->checkpoint_interval = p_sha256_chain_input_variables->checkpoint_interval;
+    p_sha256_chain_job->checkpoint_left = p_sha256_chain_input_variables->checkpoint_interval;
 
-    return b_received_data;
+    return true;
 }
 
-/* ============================== PRIVATE FUNCTION DEFINITIONS */
-
-static void _calculate_sha256_task(void *p_task_params)
+static bool _sha256_merkle_job_prepare(sha256_merkle_tree_t *p_merkle_tree, const sha256_merkle_input_variables_t *p_sha256_merkle_input_variables)
 {
-    sha256_input_variables_queue_element_t sha256_input_variables_queue_element = {0};
-    sha256_input_variables_t *p_sha256_input_variables = &sha256_input_variables_queue_element.sha256_input_variables;
-    sha256_offset_solution_queue_element_t sha256_offset_solution_queue_element = {0};
-    sha256_offset_solution_t *p_sha256_offset_solution = &sha256_offset_solution_queue_element.sha256_offset_solution;
-    BaseType_t ret = errQUEUE_EMPTY;
-    uint8_t hash[SHA256_BYTE_DIGEST_SIZE] = {0};
-    uint8_t full_bytes = 0;
-    uint8_t remaining_bits = 0;
-    uint8_t remaining_bits_mask = 0x00;
-    int byte_cmp = 1;
-    int bit_cmp = 1;
-    TickType_t ticks_to_wait = portMAX_DELAY;
-
-    uint32_t current_offset = 0;
-    uint8_t current_puzzle_id = 0;
-
+    int i = 0;
 
-    while (1)
+    if ((0 == p_sha256_merkle_input_variables->leaf_count) || (SHA256_MERKLE_LEAVES_MAX < p_sha256_merkle_input_variables->leaf_count) ||
+        (0 != (p_sha256_merkle_input_variables->flags & ~SHA256_MERKLE_FLAGS)) ||
+        (SHA256_MERKLE_PROOFS_MAX < p_sha256_merkle_input_variables->proof_count))
     {
-        /* Read inputs from queue, blocking call immediately after a solution found, else non-blocking call */
-        ret = xQueueReceive(_g_queue_sha256_input, (void *)&sha256_input_variables_queue_element, ticks_to_wait);
+        return false;
+    }
 
-        /* If new inputs read, recalculate parameters */
-        if (pdPASS == ret)
+    for (i = 0; i < p_sha256_merkle_input_variables->proof_count; i++)
+    {
+        if (p_sha256_merkle_input_variables->proof_leaf_indices[i] >= p_sha256_merkle_input_variables->leaf_count)
         {
-            /* Set new offset */
-            current_offset = p_sha256_input_variables->input_offset;
-            /* Set new puzzle ID */
-            current_puzzle_id = sha256_input_variables_queue_element.puzzle_id;
+            return false;
+        }
 
-            /* Set next reads from input queue as non-blocking calls */
-            ticks_to_wait = 0;
+        _g_sha256_merkle_proofs[i].leaf_index = p_sha256_merkle_input_variables->proof_leaf_indices[i];
+        _g_sha256_merkle_proofs[i].p_siblings = _g_sha256_merkle_proof_siblings[i];
+    }
 
-            full_bytes = (p_sha256_input_variables->target_solution_mask_offset + 1) / 8;
-            remaining_bits = (p_sha256_input_variables->target_solution_mask_offset + 1) % 8;
-            if (remaining_bits != 0) remaining_bits_mask = 0xFF << (8 - remaining_bits);
+    sha256_merkle_tree_init(p_merkle_tree, _g_sha256_merkle_nodes, p_sha256_merkle_input_variables->leaf_count,
+        p_sha256_merkle_input_variables->flags, _g_sha256_merkle_proofs, p_sha256_merkle_input_variables->proof_count);
 
-            byte_cmp = (0 == full_bytes) ? 0 : 1;
-            bit_cmp = (0 == remaining_bits) ? 0 : 1;
-        }
+    return true;
+}
 
-        /* Hash the input offset */
-        mbedtls_sha256((uint8_t *)(&current_offset), sizeof(current_offset), (unsigned char *)&hash, 0);
+static void _sha256_merkle_proofs_put(const sha256_merkle_tree_t *p_merkle_tree, uint8_t puzzle_id)
+{
+    sha256_merkle_proof_queue_element_t sha256_merkle_proof_queue_element = {0};
+    const sha256_merkle_proof_t *p_proof = NULL;
+    uint32_t level = 0;
+    uint32_t i = 0;
+    int j = 0;
 
-        /* Compare the output hash with the target */
-        if (0 != full_bytes)
+    for (i = 0; i < p_merkle_tree->proof_count; i++)
+    {
+        p_proof = &p_merkle_tree->p_proofs[i];
+        level = 0;
+
+        /* A proof of a single leaf tree has no siblings, it still gets one element */
+        do
         {
-            byte_cmp = memcmp(hash, p_sha256_input_variables->target_solution, full_bytes);
-        }
-        if (0 != remaining_bits)
+            memset(&sha256_merkle_proof_queue_element, 0, sizeof(sha256_merkle_proof_queue_element));
+            sha256_merkle_proof_queue_element.puzzle_id = puzzle_id;
+            sha256_merkle_proof_queue_element.leaf_index = (uint16_t)p_proof->leaf_index;
+            sha256_merkle_proof_queue_element.depth = (uint8_t)p_merkle_tree->level;
+            sha256_merkle_proof_queue_element.first_level = (uint8_t)level;
+
+            while ((level < p_merkle_tree->level) && (sha256_merkle_proof_queue_element.sibling_count < SHA256_MERKLE_PROOF_SIBLINGS_MAX))
+            {
+                /* Node words are big endian, the digest bytes are their bytes in order */
+                for (j = 0; j < SHA256_BYTE_DIGEST_SIZE; j++)
+                {
+                    sha256_merkle_proof_queue_element.siblings[sha256_merkle_proof_queue_element.sibling_count][j] =
+                        (uint8_t)(p_proof->p_siblings[level].words[j / 4] >> (24 - (8 * (j % 4))));
+                }
+
+                sha256_merkle_proof_queue_element.sibling_count++;
+                level++;
+            }
+
+            while (false == spsc_ring_push(&_g_queue_sha256_proof, &sha256_merkle_proof_queue_element))
+            {
+                vTaskDelay(SHA256_QUEUE_FULL_RETRY_TICKS);
+            }
+        } while (level < p_merkle_tree->level);
+    }
+}
+
+static void _sha256_hmac_kernel_prepare(sha256_hmac_job_t *p_sha256_hmac_job, sha256_nonce_t nonce)
+{
+#ifdef CONFIG_SHA256_CALC_NONCE_64BIT
+    /* Little endian bytes of the high nonce word are the second big endian message word */
+    p_sha256_hmac_job->inner_block[1] = __builtin_bswap32((uint32_t)(nonce >> 32));
+#else
+    (void)nonce;
+#endif
+
+    sha256_kernel_w0_prepare(&p_sha256_hmac_job->inner_kernel_ctx, p_sha256_hmac_job->inner_midstate, p_sha256_hmac_job->inner_block);
+}
+
+static inline bool _sha256d_job_match(const sha256d_job_t *p_sha256d_job, const uint32_t *p_digest)
+{
+    bool b_little_endian = (0 != (p_sha256d_job->match_flags & SHA256D_MATCH_FLAG_THRESHOLD_LE));
+    uint32_t digest_word = 0;
+    int i = 0;
+
+    if ((0 != (p_sha256d_job->match_flags & SHA256D_MATCH_FLAG_TARGET)) && (false == _sha256_target_match(&p_sha256d_job->target, p_digest)))
+    {
+        return false;
+    }
+
+    if (0 != (p_sha256d_job->match_flags & SHA256D_MATCH_FLAG_THRESHOLD))
+    {
+        /* Compare from the most significant word, the first differing word decides */
+        for (i = 0; i < SHA256_KERNEL_STATE_WORDS; i++)
         {
-            bit_cmp = ((hash[full_bytes] & remaining_bits_mask) == (p_sha256_input_variables->target_solution[full_bytes] & remaining_bits_mask)) ? 0 : 1;
+            digest_word = (true == b_little_endian) ? __builtin_bswap32(p_digest[SHA256_KERNEL_STATE_WORDS - 1 - i]) : p_digest[i];
+
+            if (digest_word < p_sha256d_job->threshold_words[i]) return true;
+            if (digest_word > p_sha256d_job->threshold_words[i]) return false;
         }
+    }
 
-        /* If there is a match, send discovered solution into queue, blocking call */
-        if ((0 == byte_cmp) && (0 == bit_cmp))
+    return true;
+}
+
+static inline void _sha256d_best_update(sha256d_job_t *p_sha256d_job, const uint32_t *p_digest)
+{
+    bool b_little_endian = (0 != (p_sha256d_job->match_flags & SHA256D_MATCH_FLAG_THRESHOLD_LE));
+    uint32_t digest_word = 0;
+    int i = 0;
+
+    /* Same order as the threshold compare, the first differing word decides */
+    for (i = 0; i < SHA256_KERNEL_STATE_WORDS; i++)
+    {
+        digest_word = (true == b_little_endian) ? __builtin_bswap32(p_digest[SHA256_KERNEL_STATE_WORDS - 1 - i]) : p_digest[i];
+
+        if (digest_word > p_sha256d_job->best_words[i]) return;
+        if (digest_word < p_sha256d_job->best_words[i]) break;
+    }
+    if (SHA256_KERNEL_STATE_WORDS == i) return;
+
+    for (i = 0; i < SHA256_KERNEL_STATE_WORDS; i++)
+    {
+        p_sha256d_job->best_words[i] = (true == b_little_endian) ? __builtin_bswap32(p_digest[SHA256_KERNEL_STATE_WORDS - 1 - i]) : p_digest[i];
+    }
+    memcpy(p_sha256d_job->best_digest, p_digest, sizeof(p_sha256d_job->best_digest));
+}
+
+static void _sha256_target_prepare(sha256_target_t *p_target, uint8_t target_solution_mask_offset, const uint8_t *p_target_solution)
+{
+    uint32_t target_words[SHA256_KERNEL_STATE_WORDS] = {0};
+    int mask_bits = target_solution_mask_offset + 1;
+    int word_bits = 0;
+    int i = 0;
+
+    p_target->compare_words = 0;
+
+    _sha256_words_load(target_words, p_target_solution, SHA256_KERNEL_STATE_WORDS);
+
+    for (i = 0; i < SHA256_KERNEL_STATE_WORDS; i++)
+    {
+        /* Number of compared bits in this word, counted from the most significant bit */
+        word_bits = mask_bits - (i * 32);
+        if (word_bits < 0) word_bits = 0;
+        if (word_bits > 32) word_bits = 32;
+
+        p_target->mask_words[i] = (0 == word_bits) ? 0 : (0xFFFFFFFF << (32 - word_bits));
+        p_target->target_words[i] = target_words[i] & p_target->mask_words[i];
+
+        if (0 != word_bits) p_target->compare_words = i + 1;
+    }
+}
+
+static void _sha256_words_load(uint32_t *p_words, const uint8_t *p_bytes, int words)
+{
+    int i = 0;
+
+    for (i = 0; i < words; i++)
+    {
+        p_words[i] = (((uint32_t)p_bytes[4 * i] << 24) |
+                      ((uint32_t)p_bytes[4 * i + 1] << 16) |
+                      ((uint32_t)p_bytes[4 * i + 2] << 8) |
+                      ((uint32_t)p_bytes[4 * i + 3]));
+    }
+}
+
+static inline bool _sha256_target_match(const sha256_target_t *p_target, const uint32_t *p_digest)
+{
+    int i = 0;
+
+    for (i = 0; i < p_target->compare_words; i++)
+    {
+        if ((p_digest[i] & p_target->mask_words[i]) != p_target->target_words[i]) return false;
+    }
+
+    return true;
+}
+
+#ifdef CONFIG_SHA256_CALC_AUTOTUNE
+static void _sha256_autotune(void)
+{
+    sha256_autotune_record_t record = {0};
+    sha256_autotune_params_t autotune_params = {0};
+    esp_chip_info_t chip_info = {0};
+    BaseType_t result = pdPASS;
+    esp_err_t err = ESP_OK;
+    bool b_nvs_ready = false;
+    bool b_record_loaded = false;
+    uint32_t best_hash_rate = 0;
+    int core_id = 0;
+    int kernel_variant = 0;
+
+    esp_chip_info(&chip_info);
+
+    /* NVS is shared with the rest of the application, a partition that needs an erase is left alone */
+    err = nvs_flash_init();
+    b_nvs_ready = (ESP_OK == err);
+    if (false == b_nvs_ready)
+    {
+        ESP_LOGW(LOG_TAG, "NVS not available (%s), autotune result won't be stored.", esp_err_to_name(err));
+    }
+
+#ifndef CONFIG_SHA256_CALC_AUTOTUNE_FORCE
+    /* Reuse the stored choice if it was measured on the same chip revision and CPU frequency */
+    if ((true == b_nvs_ready) && (true == _sha256_autotune_load(&record)))
+    {
+        b_record_loaded = ((SHA256_AUTOTUNE_RECORD_VERSION == record.version) &&
+                           (chip_info.revision == record.chip_revision) &&
+                           (CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ == record.cpu_freq_mhz) &&
+                           (SHA256_KERNEL_VARIANT_COUNT > record.kernel_variant) &&
+                           (portNUM_PROCESSORS > record.core_id));
+    }
+#endif
+
+    if (false == b_record_loaded)
+    {
+        memset(&record, 0, sizeof(record));
+        record.version = SHA256_AUTOTUNE_RECORD_VERSION;
+        record.chip_revision = chip_info.revision;
+        record.cpu_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ;
+
+        /* Measure every kernel variant on every core, one core after the other */
+        autotune_params.task_handle_caller = xTaskGetCurrentTaskHandle();
+        for (core_id = 0; core_id < portNUM_PROCESSORS; core_id++)
         {
-            /* Set offset solution as current offset */
-            p_sha256_offset_solution->offset_solution = current_offset;
-            /* Set puzzle ID of the solution */
-            sha256_offset_solution_queue_element.puzzle_id = current_puzzle_id;
+            autotune_params.p_hash_rates = record.hash_rates[core_id];
 
-            xQueueSendToBack(_g_queue_sha256_solution, (void *)(&sha256_offset_solution_queue_element), portMAX_DELAY);
+            result = xTaskCreatePinnedToCore(_sha256_autotune_task, "SHA256_TUNE", TASK_SHA256_AUTOTUNE_STACK_DEPTH, &autotune_params, TASK_SHA256_AUTOTUNE_PRIORITY, NULL, core_id);
+            if (pdPASS != result)
+            {
+                ESP_LOGE(LOG_TAG, "Failed to create task for SHA256 autotune. Aborting!");
+                abort();
+            }
 
-            /* Next queue receive will be blocking (wait for new input variables) */
-            ticks_to_wait = portMAX_DELAY;
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
         }
-        /* Increment the current offset if no match */
-        else
+
+        for (core_id = 0; core_id < portNUM_PROCESSORS; core_id++)
         {
-            current_offset++;
+            for (kernel_variant = 0; kernel_variant < SHA256_KERNEL_VARIANT_COUNT; kernel_variant++)
+            {
+                if (record.hash_rates[core_id][kernel_variant] > best_hash_rate)
+                {
+                    best_hash_rate = record.hash_rates[core_id][kernel_variant];
+                    record.kernel_variant = kernel_variant;
+                    record.core_id = core_id;
+                }
+            }
         }
+
+        if (true == b_nvs_ready) _sha256_autotune_store(&record);
     }
+
+    _g_sha256_calc_core_id = record.core_id;
+    _g_sha256_calculator_capabilities.kernel_variant = record.kernel_variant;
+    _g_sha256_calculator_capabilities.core_id = record.core_id;
+    memcpy(_g_sha256_calculator_capabilities.kernel_hash_rates, record.hash_rates[record.core_id], sizeof(_g_sha256_calculator_capabilities.kernel_hash_rates));
+
+    ESP_LOGI(LOG_TAG, "Autotune (%s): kernel variant %u on core %u, mbedtls %lu H/s, precomputed %lu H/s, plain %lu H/s.",
+        (true == b_record_loaded) ? "stored" : "measured",
+        record.kernel_variant,
+        record.core_id,
+        (unsigned long)record.hash_rates[record.core_id][SHA256_KERNEL_VARIANT_MBEDTLS],
+        (unsigned long)record.hash_rates[record.core_id][SHA256_KERNEL_VARIANT_PRECOMPUTED],
+        (unsigned long)record.hash_rates[record.core_id][SHA256_KERNEL_VARIANT_PLAIN]);
+}
+
+static void _sha256_autotune_task(void *p_task_params)
+{
+    sha256_autotune_params_t *p_autotune_params = (sha256_autotune_params_t *)p_task_params;
+    int kernel_variant = 0;
+
+    for (kernel_variant = 0; kernel_variant < SHA256_KERNEL_VARIANT_COUNT; kernel_variant++)
+    {
+        p_autotune_params->p_hash_rates[kernel_variant] = _sha256_kernel_measure(kernel_variant, SHA256_AUTOTUNE_MEASURE_US);
+    }
+
+    xTaskNotifyGive(p_autotune_params->task_handle_caller);
+    vTaskDelete(NULL);
+}
+
+static bool _sha256_autotune_load(sha256_autotune_record_t *p_record)
+{
+    nvs_handle_t nvs_handle = 0;
+    size_t record_size = sizeof(sha256_autotune_record_t);
+    esp_err_t err = ESP_OK;
+
+    err = nvs_open(SHA256_AUTOTUNE_NVS_NAMESPACE, NVS_READONLY, &nvs_handle);
+    if (ESP_OK != err) return false;
+
+    err = nvs_get_blob(nvs_handle, SHA256_AUTOTUNE_NVS_KEY, p_record, &record_size);
+    nvs_close(nvs_handle);
+
+    return ((ESP_OK == err) && (sizeof(sha256_autotune_record_t) == record_size));
+}
+
+static void _sha256_autotune_store(const sha256_autotune_record_t *p_record)
+{
+    nvs_handle_t nvs_handle = 0;
+    esp_err_t err = ESP_OK;
+
+    err = nvs_open(SHA256_AUTOTUNE_NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+    if (ESP_OK == err)
+    {
+        err = nvs_set_blob(nvs_handle, SHA256_AUTOTUNE_NVS_KEY, p_record, sizeof(sha256_autotune_record_t));
+        if (ESP_OK == err) err = nvs_commit(nvs_handle);
+        nvs_close(nvs_handle);
+    }
+
+    if (ESP_OK != err)
+    {
+        ESP_LOGW(LOG_TAG, "Failed to store autotune record (%s).", esp_err_to_name(err));
+    }
+}
+
+static uint32_t _sha256_kernel_measure(uint8_t kernel_variant, int64_t measure_us)
+{
+    uint8_t target_solution[SHA256_BYTE_DIGEST_SIZE] = {0};
+    uint32_t block[SHA256_KERNEL_BLOCK_WORDS] = {0};
+    sha256_kernel_w0_ctx_t kernel_ctx = {0};
+    sha256_target_t target = {0};
+    sha256_nonce_t offset = 0;
+    bool b_solution_found = false;
+    uint64_t hashes = 0;
+    int64_t start_us = 0;
+    int64_t elapsed_us = 0;
+
+    /* Fully masked zero target, only a zero digest would match */
+    _sha256_nonce_block_prepare(block);
+    _sha256_kernel_prepare(&kernel_ctx, block, offset);
+    _sha256_target_prepare(&target, (SHA256_BYTE_DIGEST_SIZE * 8) - 1, target_solution);
+
+    start_us = esp_timer_get_time();
+    do
+    {
+        hashes += _g_sha256_batch_search[kernel_variant](&kernel_ctx, block, &target, &offset, SHA256_AUTOTUNE_BATCH_HASHES, &b_solution_found);
+        elapsed_us = esp_timer_get_time() - start_us;
+    } while (elapsed_us < measure_us);
+
+    return (uint32_t)((hashes * 1000000ULL) / (uint64_t)elapsed_us);
+}
+#endif
+
+static void _sha256_hash_rate_calibrate(void)
+{
+    uint8_t target_solution[SHA256_BYTE_DIGEST_SIZE] = {0};
+    uint32_t block[SHA256_KERNEL_BLOCK_WORDS] = {0};
+    sha256_kernel_w0_ctx_t kernel_ctx = {0};
+    sha256_target_t target = {0};
+    sha256d_input_variables_t sha256d_input_variables = {0};
+    sha256_hmac_input_variables_t sha256_hmac_input_variables = {0};
+    /* Prepared jobs are kept off the stack of the task that initializes the calculator */
+    static sha256d_job_t sha256d_job = {0};
+    static sha256_hmac_job_t sha256_hmac_job = {0};
+    sha256_chain_job_t sha256_chain_job = {0};
+    sha256_merkle_tree_t merkle_tree = {0};
+    uint32_t merkle_hashes = 0;
+    sha256_nonce_t offset = 0;
+    bool b_solution_found = false;
+    int64_t start_us = 0;
+    int64_t sha256_us = 0;
+    int64_t sha256d_us = 0;
+    int64_t hmac_us = 0;
+    int64_t chain_us = 0;
+    int64_t merkle_us = 0;
+
+    /* Fully masked zero target, only a zero digest would match */
+    _sha256_nonce_block_prepare(block);
+    _sha256_kernel_prepare(&kernel_ctx, block, offset);
+    _sha256_target_prepare(&target, (SHA256_BYTE_DIGEST_SIZE * 8) - 1, target_solution);
+
+    start_us = esp_timer_get_time();
+    _g_sha256_batch_search[_g_sha256_calculator_capabilities.kernel_variant](&kernel_ctx, block, &target, &offset, SHA256_CALIBRATION_HASHES, &b_solution_found);
+    sha256_us = esp_timer_get_time() - start_us;
+
+    /* Bitcoin header sized prefix with a zero threshold, no candidate matches */
+    sha256d_input_variables.prefix_size = SHA256D_BENCHMARK_PREFIX_SIZE;
+    sha256d_input_variables.match_flags = SHA256D_MATCH_FLAG_THRESHOLD;
+    _sha256d_job_prepare(&sha256d_job, &sha256d_input_variables, _g_sha256d_prefix);
+    offset = 0;
+
+    start_us = esp_timer_get_time();
+    _sha256d_batch_search(&sha256d_job, &offset, SHA256_CALIBRATION_HASHES, &b_solution_found);
+    sha256d_us = esp_timer_get_time() - start_us;
+
+    /* Fully masked zero target again, the key doesn't change the cost */
+    sha256_hmac_input_variables.target_solution_mask_offset = (SHA256_BYTE_DIGEST_SIZE * 8) - 1;
+    _sha256_hmac_job_prepare(&sha256_hmac_job, &sha256_hmac_input_variables);
+    offset = 0;
+    _sha256_hmac_kernel_prepare(&sha256_hmac_job, offset);
+
+    start_us = esp_timer_get_time();
+    _sha256_hmac_batch_search(&sha256_hmac_job, &offset, SHA256_CALIBRATION_HASHES, &b_solution_found);
+    hmac_us = esp_timer_get_time() - start_us;
+
+    /* Zero seed, the digests don't change the cost */
+    sha256_chain_job.iterations_left = SHA256_CALIBRATION_HASHES;
+    offset = 0;
+
+    start_us = esp_timer_get_time();
+    _sha256_chain_batch_search(&sha256_chain_job, &offset, SHA256_CALIBRATION_HASHES);
+    chain_us = esp_timer_get_time() - start_us;
+
+    /* Full leaf storage of zero leaves, reduced again until enough node hashes were done */
+    start_us = esp_timer_get_time();
+    while (merkle_hashes < SHA256_CALIBRATION_HASHES)
+    {
+        sha256_merkle_tree_init(&merkle_tree, _g_sha256_merkle_nodes, SHA256_MERKLE_LEAVES_MAX, 0, NULL, 0);
+        merkle_hashes += sha256_merkle_tree_reduce(&merkle_tree, SHA256_CALIBRATION_HASHES - merkle_hashes);
+    }
+    merkle_us = esp_timer_get_time() - start_us;
+
+    if (sha256_us > 0) _g_sha256_calculator_capabilities.hash_rate_sha256 = (uint32_t)((SHA256_CALIBRATION_HASHES * 1000000LL) / sha256_us);
+    if (sha256d_us > 0) _g_sha256_calculator_capabilities.hash_rate_sha256d = (uint32_t)((SHA256_CALIBRATION_HASHES * 1000000LL) / sha256d_us);
+    if (hmac_us > 0) _g_sha256_calculator_capabilities.hash_rate_hmac = (uint32_t)((SHA256_CALIBRATION_HASHES * 1000000LL) / hmac_us);
+    if (chain_us > 0) _g_sha256_calculator_capabilities.hash_rate_chain = (uint32_t)((SHA256_CALIBRATION_HASHES * 1000000LL) / chain_us);
+    if (merkle_us > 0) _g_sha256_calculator_capabilities.hash_rate_merkle = (uint32_t)((SHA256_CALIBRATION_HASHES * 1000000LL) / merkle_us);
+
+    ESP_LOGI(LOG_TAG, "Calibrated hash rate: SHA256 %lu H/s, SHA256d %lu H/s, HMAC %lu H/s, chain %lu H/s, Merkle %lu H/s.",
+        (unsigned long)_g_sha256_calculator_capabilities.hash_rate_sha256,
+        (unsigned long)_g_sha256_calculator_capabilities.hash_rate_sha256d,
+        (unsigned long)_g_sha256_calculator_capabilities.hash_rate_hmac,
+        (unsigned long)_g_sha256_calculator_capabilities.hash_rate_chain,
+        (unsigned long)_g_sha256_calculator_capabilities.hash_rate_merkle);
+}
+
+#ifdef CONFIG_SHA256_CALC_BENCHMARK
+static void _sha256_benchmark(void)
+{
+    uint8_t hash[SHA256_BYTE_DIGEST_SIZE] = {0};
+    uint32_t block[SHA256_KERNEL_BLOCK_WORDS] = {0};
+    uint32_t digest[SHA256_KERNEL_STATE_WORDS] = {0};
+    sha256_kernel_w0_ctx_t kernel_ctx = {0};
+    int64_t start_us = 0;
+    int64_t mbedtls_us = 0;
+    int64_t plain_us = 0;
+    int64_t precomputed_us = 0;
+    int64_t sha256d_us = 0;
+    sha256_nonce_t offset = 0;
+    sha256d_input_variables_t sha256d_input_variables = {0};
+    sha256d_job_t sha256d_job = {0};
+    bool b_solution_found = false;
+
+    _sha256_nonce_block_prepare(block);
+
+    start_us = esp_timer_get_time();
+    for (offset = 0; offset < SHA256_BENCHMARK_HASHES; offset++)
+    {
+        mbedtls_sha256((uint8_t *)(&offset), SHA256_NONCE_SIZE, hash, 0);
+    }
+    mbedtls_us = esp_timer_get_time() - start_us;
+
+    start_us = esp_timer_get_time();
+    for (offset = 0; offset < SHA256_BENCHMARK_HASHES; offset++)
+    {
+        block[0] = __builtin_bswap32((uint32_t)offset);
+        sha256_kernel_block_hash(block, digest);
+    }
+    plain_us = esp_timer_get_time() - start_us;
+
+    start_us = esp_timer_get_time();
+    sha256_kernel_w0_prepare(&kernel_ctx, sha256_kernel_initial_state, block);
+    for (offset = 0; offset < SHA256_BENCHMARK_HASHES; offset++)
+    {
+        sha256_kernel_w0_hash(&kernel_ctx, __builtin_bswap32((uint32_t)offset), digest);
+    }
+    precomputed_us = esp_timer_get_time() - start_us;
+
+    /* Bitcoin header sized prefix with a zero threshold, no candidate matches */
+    sha256d_input_variables.prefix_size = SHA256D_BENCHMARK_PREFIX_SIZE;
+    sha256d_input_variables.match_flags = SHA256D_MATCH_FLAG_THRESHOLD;
+    _sha256d_job_prepare(&sha256d_job, &sha256d_input_variables, _g_sha256d_prefix);
+    offset = 0;
+
+    start_us = esp_timer_get_time();
+    _sha256d_batch_search(&sha256d_job, &offset, SHA256_BENCHMARK_HASHES, &b_solution_found);
+    sha256d_us = esp_timer_get_time() - start_us;
+
+    ESP_LOGI(LOG_TAG, "Benchmark of %d hashes: mbedtls %lld H/s, plain kernel %lld H/s, precomputed kernel %lld H/s, SHA256d %lld H/s.",
+        SHA256_BENCHMARK_HASHES,
+        (SHA256_BENCHMARK_HASHES * 1000000LL) / mbedtls_us,
+        (SHA256_BENCHMARK_HASHES * 1000000LL) / plain_us,
+        (SHA256_BENCHMARK_HASHES * 1000000LL) / precomputed_us,
+        (SHA256_BENCHMARK_HASHES * 1000000LL) / sha256d_us);
 }
+#endif
 
 /* ============================== INTERRUPT FUNCTION DEFINITIONS */
@@ -0,0 +1,500 @@
+/**
+ * @file sha256_kernel.c
+ * @author Iwan Ćulumović
+ * @brief SHA256 compression kernels specialized for single block candidates. Plain C without platform dependencies.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/* ============================== INCLUDES */
+
+#include <string.h>
+#include "sha256_kernel.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Rotate right. */
+#define ROTR(x, n)                              (((x) >> (n)) | ((x) << (32 - (n))))
+
+/** @brief Choose. */
+#define CH(x, y, z)                             (((x) & (y)) ^ (~(x) & (z)))
+
+/** @brief Majority. */
+#define MAJ(x, y, z)                            (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+
+/** @brief Upper case sigma 0, used on a. */
+#define BSIG0(x)                                (ROTR((x), 2) ^ ROTR((x), 13) ^ ROTR((x), 22))
+
+/** @brief Upper case sigma 1, used on e. */
+#define BSIG1(x)                                (ROTR((x), 6) ^ ROTR((x), 11) ^ ROTR((x), 25))
+
+/** @brief Lower case sigma 0, used in the message schedule. */
+#define SSIG0(x)                                (ROTR((x), 7) ^ ROTR((x), 18) ^ ((x) >> 3))
+
+/** @brief Lower case sigma 1, used in the message schedule. */
+#define SSIG1(x)                                (ROTR((x), 17) ^ ROTR((x), 19) ^ ((x) >> 10))
+
+/** @brief Single round with precomputed round constant plus message word, renames state by argument order. The
+ * temporaries take the type of the state, so the same round works on plain words and on lanes. */
+#define ROUND(a, b, c, d, e, f, g, h, k_w)      \
+    do {                                        \
+        __typeof__(h) t1 = (h) + BSIG1(e) + CH((e), (f), (g)) + (k_w); \
+        __typeof__(h) t2 = BSIG0(a) + MAJ((a), (b), (c)); \
+        (d) += t1;                              \
+        (h) = t1 + t2;                          \
+    } while (0)
+
+/** @brief Eight rounds starting at round t. */
+#define ROUNDS_8(t, w)                          \
+    do {                                        \
+        ROUND(a, b, c, d, e, f, g, h, _g_k[(t) + 0] + (w)[(t) + 0]); \
+        ROUND(h, a, b, c, d, e, f, g, _g_k[(t) + 1] + (w)[(t) + 1]); \
+        ROUND(g, h, a, b, c, d, e, f, _g_k[(t) + 2] + (w)[(t) + 2]); \
+        ROUND(f, g, h, a, b, c, d, e, _g_k[(t) + 3] + (w)[(t) + 3]); \
+        ROUND(e, f, g, h, a, b, c, d, _g_k[(t) + 4] + (w)[(t) + 4]); \
+        ROUND(d, e, f, g, h, a, b, c, _g_k[(t) + 5] + (w)[(t) + 5]); \
+        ROUND(c, d, e, f, g, h, a, b, _g_k[(t) + 6] + (w)[(t) + 6]); \
+        ROUND(b, c, d, e, f, g, h, a, _g_k[(t) + 7] + (w)[(t) + 7]); \
+    } while (0)
+
+/** @brief Full message schedule word. */
+#define SCHEDULE(w, t)                          (SSIG1((w)[(t) - 2]) + (w)[(t) - 7] + SSIG0((w)[(t) - 15]) + (w)[(t) - 16])
+
+/** @brief First schedule word that depends on every earlier word, see sha256_kernel_w0_hash. */
+#define W0_SCHEDULE_FULL_START                  (38)
+
+/** @brief Number of digest words in a digest hash block, the remaining words are padding. */
+#define DIGEST_BLOCK_WORDS                      (SHA256_KERNEL_STATE_WORDS)
+
+/* ============================== TYPE DEFINITIONS */
+
+/* ============================== PRIVATE FUNCTION DECLARATIONS */
+
+/* ============================== PRIVATE VARIABLES */
+
+/** @brief SHA256 round constants. */
+static const uint32_t _g_k[SHA256_KERNEL_SCHEDULE_WORDS] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+/** @brief Round constant plus padding word for rounds 8 to 15 of a digest hash block (32 byte message). */
+static const uint32_t _g_digest_k_w[SHA256_KERNEL_BLOCK_WORDS - DIGEST_BLOCK_WORDS] =
+{
+    0xd807aa98 + 0x80000000, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174 + 256,
+};
+
+/** @brief Padding words 8 to 15 of a digest hash block (32 byte message). */
+static const uint32_t _g_digest_padding[SHA256_KERNEL_BLOCK_WORDS - DIGEST_BLOCK_WORDS] =
+{
+    0x80000000, 0, 0, 0, 0, 0, 0, 256,
+};
+
+/** @brief Round constant plus message word of the padding block of a 64 byte message. The whole schedule of the block
+ * is constant, so the rounds need no message schedule. */
+static const uint32_t _g_pair_padding_k_w[SHA256_KERNEL_SCHEDULE_WORDS] =
+{
+    0xc28a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf374,
+    0x649b69c1, 0xf0fe4786, 0x0fe1edc6, 0x240cf254, 0x4fe9346f, 0x6cc984be, 0x61b9411e, 0x16f988fa,
+    0xf2c65152, 0xa88e5a6d, 0xb019fc65, 0xb9d99ec7, 0x9a1231c3, 0xe70eeaa0, 0xfdb1232b, 0xc7353eb0,
+    0x3069bad5, 0xcb976d5f, 0x5a0f118f, 0xdc1eeefd, 0x0a35b689, 0xde0b7a04, 0x58f4ca9d, 0xe15d5b16,
+    0x007f3e86, 0x37088980, 0xa507ea32, 0x6fab9537, 0x17406110, 0x0d8cd6f1, 0xcdaa3b6d, 0xc0bbbe37,
+    0x83613bda, 0xdb48a363, 0x0b02e931, 0x6fd15ca7, 0x521afaca, 0x31338431, 0x6ed41a95, 0x6d437890,
+    0xc39c91f2, 0x9eccabbd, 0xb5c9a0e6, 0x532fb63c, 0xd2c741c6, 0x07237ea3, 0xa4954b68, 0x4c191d76,
+};
+
+/* ============================== PUBLIC VARIABLES */
+
+const uint32_t sha256_kernel_initial_state[SHA256_KERNEL_STATE_WORDS] =
+{
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+/* ============================== PUBLIC FUNCTION DEFINITIONS */
+
+void sha256_kernel_compress(uint32_t *p_state, const uint32_t *p_block)
+{
+    uint32_t w[SHA256_KERNEL_SCHEDULE_WORDS];
+    uint32_t a = p_state[0], b = p_state[1], c = p_state[2], d = p_state[3];
+    uint32_t e = p_state[4], f = p_state[5], g = p_state[6], h = p_state[7];
+    int t = 0;
+
+    memcpy(w, p_block, SHA256_KERNEL_BLOCK_WORDS * sizeof(uint32_t));
+    for (t = SHA256_KERNEL_BLOCK_WORDS; t < SHA256_KERNEL_SCHEDULE_WORDS; t++)
+    {
+        w[t] = SCHEDULE(w, t);
+    }
+
+    for (t = 0; t < SHA256_KERNEL_SCHEDULE_WORDS; t += 8)
+    {
+        ROUNDS_8(t, w);
+    }
+
+    p_state[0] += a; p_state[1] += b; p_state[2] += c; p_state[3] += d;
+    p_state[4] += e; p_state[5] += f; p_state[6] += g; p_state[7] += h;
+}
+
+void sha256_kernel_block_hash(const uint32_t *p_block, uint32_t *p_digest)
+{
+    memcpy(p_digest, sha256_kernel_initial_state, sizeof(sha256_kernel_initial_state));
+    sha256_kernel_compress(p_digest, p_block);
+}
+
+void sha256_kernel_w0_prepare(sha256_kernel_w0_ctx_t *p_ctx, const uint32_t *p_state, const uint32_t *p_block)
+{
+    uint32_t *w = p_ctx->w;
+    uint32_t *s = p_ctx->round_1_state;
+    uint32_t t1 = 0;
+    int t = 0;
+
+    memcpy(p_ctx->initial_state, p_state, sizeof(p_ctx->initial_state));
+
+    /* Message words 1 to 15 are constant, word 0 is added per candidate */
+    memcpy(w, p_block, SHA256_KERNEL_BLOCK_WORDS * sizeof(uint32_t));
+    w[0] = 0;
+    for (t = 1; t < SHA256_KERNEL_BLOCK_WORDS; t++)
+    {
+        p_ctx->k_w[t] = _g_k[t] + w[t];
+    }
+
+    /* Schedule terms that only depend on words 1 to 15, words 17, 19 and 21 are fully constant */
+    w[16] = SSIG1(w[14]) + w[9] + SSIG0(w[1]);
+    w[17] = SSIG1(w[15]) + w[10] + SSIG0(w[2]) + w[1];
+    w[18] = w[11] + SSIG0(w[3]) + w[2];
+    w[19] = SSIG1(w[17]) + w[12] + SSIG0(w[4]) + w[3];
+    w[20] = w[13] + SSIG0(w[5]) + w[4];
+    w[21] = SSIG1(w[19]) + w[14] + SSIG0(w[6]) + w[5];
+    w[22] = w[15] + SSIG0(w[7]) + w[6];
+    w[23] = SSIG1(w[21]) + SSIG0(w[8]) + w[7];
+    w[24] = w[17] + SSIG0(w[9]) + w[8];
+    w[25] = SSIG0(w[10]) + w[9];
+    w[26] = w[19] + SSIG0(w[11]) + w[10];
+    w[27] = SSIG0(w[12]) + w[11];
+    w[28] = w[21] + SSIG0(w[13]) + w[12];
+    w[29] = SSIG0(w[14]) + w[13];
+    w[30] = SSIG0(w[15]) + w[14];
+    w[31] = w[15];
+    w[32] = SSIG0(w[17]);
+    w[33] = w[17];
+    w[34] = SSIG0(w[19]);
+    w[35] = w[19];
+    w[36] = SSIG0(w[21]);
+    w[37] = w[21];
+
+    /* Round 0 without the message word, the word is added to a and e per candidate */
+    t1 = p_state[7] + BSIG1(p_state[4]) + CH(p_state[4], p_state[5], p_state[6]) + _g_k[0];
+    s[0] = t1 + BSIG0(p_state[0]) + MAJ(p_state[0], p_state[1], p_state[2]);
+    s[1] = p_state[0];
+    s[2] = p_state[1];
+    s[3] = p_state[2];
+    s[4] = p_state[3] + t1;
+    s[5] = p_state[4];
+    s[6] = p_state[5];
+    s[7] = p_state[6];
+}
+
+void sha256_kernel_w0_hash(const sha256_kernel_w0_ctx_t *p_ctx, uint32_t w0, uint32_t *p_digest)
+{
+    const uint32_t *p_w = p_ctx->w;
+    const uint32_t *k_w = p_ctx->k_w;
+    uint32_t w[SHA256_KERNEL_SCHEDULE_WORDS];
+    uint32_t a = p_ctx->round_1_state[0] + w0, b = p_ctx->round_1_state[1];
+    uint32_t c = p_ctx->round_1_state[2], d = p_ctx->round_1_state[3];
+    uint32_t e = p_ctx->round_1_state[4] + w0, f = p_ctx->round_1_state[5];
+    uint32_t g = p_ctx->round_1_state[6], h = p_ctx->round_1_state[7];
+    int t = 0;
+
+    /* Only the terms that depend on word 0 are computed per candidate */
+    w[16] = p_w[16] + w0;
+    w[17] = p_w[17];
+    w[18] = p_w[18] + SSIG1(w[16]);
+    w[19] = p_w[19];
+    w[20] = p_w[20] + SSIG1(w[18]);
+    w[21] = p_w[21];
+    w[22] = p_w[22] + SSIG1(w[20]);
+    w[23] = p_w[23] + w[16];
+    w[24] = p_w[24] + SSIG1(w[22]);
+    w[25] = p_w[25] + SSIG1(w[23]) + w[18];
+    w[26] = p_w[26] + SSIG1(w[24]);
+    w[27] = p_w[27] + SSIG1(w[25]) + w[20];
+    w[28] = p_w[28] + SSIG1(w[26]);
+    w[29] = p_w[29] + SSIG1(w[27]) + w[22];
+    w[30] = p_w[30] + SSIG1(w[28]) + w[23];
+    w[31] = p_w[31] + SSIG1(w[29]) + w[24] + SSIG0(w[16]);
+    w[32] = p_w[32] + SSIG1(w[30]) + w[25] + w[16];
+    w[33] = p_w[33] + SSIG1(w[31]) + w[26] + SSIG0(w[18]);
+    w[34] = p_w[34] + SSIG1(w[32]) + w[27] + w[18];
+    w[35] = p_w[35] + SSIG1(w[33]) + w[28] + SSIG0(w[20]);
+    w[36] = p_w[36] + SSIG1(w[34]) + w[29] + w[20];
+    w[37] = p_w[37] + SSIG1(w[35]) + w[30] + SSIG0(w[22]);
+    for (t = W0_SCHEDULE_FULL_START; t < SHA256_KERNEL_SCHEDULE_WORDS; t++)
+    {
+        w[t] = SCHEDULE(w, t);
+    }
+
+    /* Rounds 1 to 15 use precomputed constants, round 0 is already folded into the state */
+    ROUND(a, b, c, d, e, f, g, h, k_w[1]);
+    ROUND(h, a, b, c, d, e, f, g, k_w[2]);
+    ROUND(g, h, a, b, c, d, e, f, k_w[3]);
+    ROUND(f, g, h, a, b, c, d, e, k_w[4]);
+    ROUND(e, f, g, h, a, b, c, d, k_w[5]);
+    ROUND(d, e, f, g, h, a, b, c, k_w[6]);
+    ROUND(c, d, e, f, g, h, a, b, k_w[7]);
+    ROUND(b, c, d, e, f, g, h, a, k_w[8]);
+    ROUND(a, b, c, d, e, f, g, h, k_w[9]);
+    ROUND(h, a, b, c, d, e, f, g, k_w[10]);
+    ROUND(g, h, a, b, c, d, e, f, k_w[11]);
+    ROUND(f, g, h, a, b, c, d, e, k_w[12]);
+    ROUND(e, f, g, h, a, b, c, d, k_w[13]);
+    ROUND(d, e, f, g, h, a, b, c, k_w[14]);
+    ROUND(c, d, e, f, g, h, a, b, k_w[15]);
+    ROUND(b, c, d, e, f, g, h, a, _g_k[16] + w[16]);
+
+    /* Round 17 onwards continue with the same register rotation as round 1 */
+    for (t = 17; t < 57; t += 8)
+    {
+        ROUND(a, b, c, d, e, f, g, h, _g_k[t + 0] + w[t + 0]);
+        ROUND(h, a, b, c, d, e, f, g, _g_k[t + 1] + w[t + 1]);
+        ROUND(g, h, a, b, c, d, e, f, _g_k[t + 2] + w[t + 2]);
+        ROUND(f, g, h, a, b, c, d, e, _g_k[t + 3] + w[t + 3]);
+        ROUND(e, f, g, h, a, b, c, d, _g_k[t + 4] + w[t + 4]);
+        ROUND(d, e, f, g, h, a, b, c, _g_k[t + 5] + w[t + 5]);
+        ROUND(c, d, e, f, g, h, a, b, _g_k[t + 6] + w[t + 6]);
+        ROUND(b, c, d, e, f, g, h, a, _g_k[t + 7] + w[t + 7]);
+    }
+    ROUND(a, b, c, d, e, f, g, h, _g_k[57] + w[57]);
+    ROUND(h, a, b, c, d, e, f, g, _g_k[58] + w[58]);
+    ROUND(g, h, a, b, c, d, e, f, _g_k[59] + w[59]);
+    ROUND(f, g, h, a, b, c, d, e, _g_k[60] + w[60]);
+    ROUND(e, f, g, h, a, b, c, d, _g_k[61] + w[61]);
+    ROUND(d, e, f, g, h, a, b, c, _g_k[62] + w[62]);
+    ROUND(c, d, e, f, g, h, a, b, _g_k[63] + w[63]);
+
+    /* After 63 rounds from round 1 the state is rotated by one, a holds the value of h */
+    p_digest[0] = p_ctx->initial_state[0] + b;
+    p_digest[1] = p_ctx->initial_state[1] + c;
+    p_digest[2] = p_ctx->initial_state[2] + d;
+    p_digest[3] = p_ctx->initial_state[3] + e;
+    p_digest[4] = p_ctx->initial_state[4] + f;
+    p_digest[5] = p_ctx->initial_state[5] + g;
+    p_digest[6] = p_ctx->initial_state[6] + h;
+    p_digest[7] = p_ctx->initial_state[7] + a;
+}
+
+void sha256_kernel_digest_hash(const uint32_t *p_digest_in, uint32_t *p_digest)
+{
+    uint32_t w[SHA256_KERNEL_SCHEDULE_WORDS];
+    uint32_t a = sha256_kernel_initial_state[0], b = sha256_kernel_initial_state[1];
+    uint32_t c = sha256_kernel_initial_state[2], d = sha256_kernel_initial_state[3];
+    uint32_t e = sha256_kernel_initial_state[4], f = sha256_kernel_initial_state[5];
+    uint32_t g = sha256_kernel_initial_state[6], h = sha256_kernel_initial_state[7];
+    int t = 0;
+
+    memcpy(w, p_digest_in, DIGEST_BLOCK_WORDS * sizeof(uint32_t));
+    memcpy(&w[DIGEST_BLOCK_WORDS], _g_digest_padding, sizeof(_g_digest_padding));
+    for (t = SHA256_KERNEL_BLOCK_WORDS; t < SHA256_KERNEL_SCHEDULE_WORDS; t++)
+    {
+        w[t] = SCHEDULE(w, t);
+    }
+
+    ROUNDS_8(0, w);
+
+    /* Rounds 8 to 15 only see padding, their round constant plus message word is precomputed */
+    ROUND(a, b, c, d, e, f, g, h, _g_digest_k_w[0]);
+    ROUND(h, a, b, c, d, e, f, g, _g_digest_k_w[1]);
+    ROUND(g, h, a, b, c, d, e, f, _g_digest_k_w[2]);
+    ROUND(f, g, h, a, b, c, d, e, _g_digest_k_w[3]);
+    ROUND(e, f, g, h, a, b, c, d, _g_digest_k_w[4]);
+    ROUND(d, e, f, g, h, a, b, c, _g_digest_k_w[5]);
+    ROUND(c, d, e, f, g, h, a, b, _g_digest_k_w[6]);
+    ROUND(b, c, d, e, f, g, h, a, _g_digest_k_w[7]);
+
+    for (t = 16; t < SHA256_KERNEL_SCHEDULE_WORDS; t += 8)
+    {
+        ROUNDS_8(t, w);
+    }
+
+    p_digest[0] = sha256_kernel_initial_state[0] + a;
+    p_digest[1] = sha256_kernel_initial_state[1] + b;
+    p_digest[2] = sha256_kernel_initial_state[2] + c;
+    p_digest[3] = sha256_kernel_initial_state[3] + d;
+    p_digest[4] = sha256_kernel_initial_state[4] + e;
+    p_digest[5] = sha256_kernel_initial_state[5] + f;
+    p_digest[6] = sha256_kernel_initial_state[6] + g;
+    p_digest[7] = sha256_kernel_initial_state[7] + h;
+}
+
+void sha256_kernel_digest_chain(uint32_t *p_digest, uint32_t iterations)
+{
+    uint32_t w[SHA256_KERNEL_SCHEDULE_WORDS];
+    uint32_t a = 0, b = 0, c = 0, d = 0, e = 0, f = 0, g = 0, h = 0;
+    uint32_t i = 0;
+    int t = 0;
+
+    /* Padding words stay in the schedule, every iteration only replaces the digest words */
+    memcpy(w, p_digest, DIGEST_BLOCK_WORDS * sizeof(uint32_t));
+    memcpy(&w[DIGEST_BLOCK_WORDS], _g_digest_padding, sizeof(_g_digest_padding));
+
+    for (i = 0; i < iterations; i++)
+    {
+        for (t = SHA256_KERNEL_BLOCK_WORDS; t < SHA256_KERNEL_SCHEDULE_WORDS; t++)
+        {
+            w[t] = SCHEDULE(w, t);
+        }
+
+        a = sha256_kernel_initial_state[0]; b = sha256_kernel_initial_state[1];
+        c = sha256_kernel_initial_state[2]; d = sha256_kernel_initial_state[3];
+        e = sha256_kernel_initial_state[4]; f = sha256_kernel_initial_state[5];
+        g = sha256_kernel_initial_state[6]; h = sha256_kernel_initial_state[7];
+
+        ROUNDS_8(0, w);
+
+        ROUND(a, b, c, d, e, f, g, h, _g_digest_k_w[0]);
+        ROUND(h, a, b, c, d, e, f, g, _g_digest_k_w[1]);
+        ROUND(g, h, a, b, c, d, e, f, _g_digest_k_w[2]);
+        ROUND(f, g, h, a, b, c, d, e, _g_digest_k_w[3]);
+        ROUND(e, f, g, h, a, b, c, d, _g_digest_k_w[4]);
+        ROUND(d, e, f, g, h, a, b, c, _g_digest_k_w[5]);
+        ROUND(c, d, e, f, g, h, a, b, _g_digest_k_w[6]);
+        ROUND(b, c, d, e, f, g, h, a, _g_digest_k_w[7]);
+
+        for (t = 16; t < SHA256_KERNEL_SCHEDULE_WORDS; t += 8)
+        {
+            ROUNDS_8(t, w);
+        }
+
+        /* Digest of this iteration is the message of the next one */
+        w[0] = sha256_kernel_initial_state[0] + a;
+        w[1] = sha256_kernel_initial_state[1] + b;
+        w[2] = sha256_kernel_initial_state[2] + c;
+        w[3] = sha256_kernel_initial_state[3] + d;
+        w[4] = sha256_kernel_initial_state[4] + e;
+        w[5] = sha256_kernel_initial_state[5] + f;
+        w[6] = sha256_kernel_initial_state[6] + g;
+        w[7] = sha256_kernel_initial_state[7] + h;
+    }
+
+    memcpy(p_digest, w, DIGEST_BLOCK_WORDS * sizeof(uint32_t));
+}
+
+void sha256_kernel_pair_hash(const uint32_t *p_left, const uint32_t *p_right, uint32_t *p_digest)
+{
+    uint32_t block[SHA256_KERNEL_BLOCK_WORDS];
+    uint32_t state[SHA256_KERNEL_STATE_WORDS];
+    uint32_t a = 0, b = 0, c = 0, d = 0, e = 0, f = 0, g = 0, h = 0;
+    int t = 0;
+
+    /* Both halves are copied first, the digest may overwrite either of them */
+    memcpy(block, p_left, DIGEST_BLOCK_WORDS * sizeof(uint32_t));
+    memcpy(&block[DIGEST_BLOCK_WORDS], p_right, DIGEST_BLOCK_WORDS * sizeof(uint32_t));
+    sha256_kernel_block_hash(block, state);
+
+    a = state[0]; b = state[1]; c = state[2]; d = state[3];
+    e = state[4]; f = state[5]; g = state[6]; h = state[7];
+
+    /* Second block is only padding, every round constant plus message word is precomputed */
+    for (t = 0; t < SHA256_KERNEL_SCHEDULE_WORDS; t += 8)
+    {
+        ROUND(a, b, c, d, e, f, g, h, _g_pair_padding_k_w[t + 0]);
+        ROUND(h, a, b, c, d, e, f, g, _g_pair_padding_k_w[t + 1]);
+        ROUND(g, h, a, b, c, d, e, f, _g_pair_padding_k_w[t + 2]);
+        ROUND(f, g, h, a, b, c, d, e, _g_pair_padding_k_w[t + 3]);
+        ROUND(e, f, g, h, a, b, c, d, _g_pair_padding_k_w[t + 4]);
+        ROUND(d, e, f, g, h, a, b, c, _g_pair_padding_k_w[t + 5]);
+        ROUND(c, d, e, f, g, h, a, b, _g_pair_padding_k_w[t + 6]);
+        ROUND(b, c, d, e, f, g, h, a, _g_pair_padding_k_w[t + 7]);
+    }
+
+    p_digest[0] = state[0] + a;
+    p_digest[1] = state[1] + b;
+    p_digest[2] = state[2] + c;
+    p_digest[3] = state[3] + d;
+    p_digest[4] = state[4] + e;
+    p_digest[5] = state[5] + f;
+    p_digest[6] = state[6] + g;
+    p_digest[7] = state[7] + h;
+}
+
+void sha256_kernel_lanes_compress(sha256_kernel_lanes_t *p_state, const sha256_kernel_lanes_t *p_block)
+{
+    sha256_kernel_lanes_t w[SHA256_KERNEL_SCHEDULE_WORDS];
+    sha256_kernel_lanes_t a = p_state[0], b = p_state[1], c = p_state[2], d = p_state[3];
+    sha256_kernel_lanes_t e = p_state[4], f = p_state[5], g = p_state[6], h = p_state[7];
+    int t = 0;
+
+    memcpy(w, p_block, SHA256_KERNEL_BLOCK_WORDS * sizeof(sha256_kernel_lanes_t));
+    for (t = SHA256_KERNEL_BLOCK_WORDS; t < SHA256_KERNEL_SCHEDULE_WORDS; t++)
+    {
+        w[t] = SCHEDULE(w, t);
+    }
+
+    for (t = 0; t < SHA256_KERNEL_SCHEDULE_WORDS; t += 8)
+    {
+        ROUNDS_8(t, w);
+    }
+
+    p_state[0] += a; p_state[1] += b; p_state[2] += c; p_state[3] += d;
+    p_state[4] += e; p_state[5] += f; p_state[6] += g; p_state[7] += h;
+}
+
+void sha256_kernel_lanes_digest_hash(const sha256_kernel_lanes_t *p_digest_in, sha256_kernel_lanes_t *p_digest)
+{
+    sha256_kernel_lanes_t w[SHA256_KERNEL_SCHEDULE_WORDS];
+    sha256_kernel_lanes_t a = {0}, b = {0}, c = {0}, d = {0}, e = {0}, f = {0}, g = {0}, h = {0};
+    int t = 0;
+
+    /* The initial hash value is the same in every lane */
+    a += sha256_kernel_initial_state[0]; b += sha256_kernel_initial_state[1];
+    c += sha256_kernel_initial_state[2]; d += sha256_kernel_initial_state[3];
+    e += sha256_kernel_initial_state[4]; f += sha256_kernel_initial_state[5];
+    g += sha256_kernel_initial_state[6]; h += sha256_kernel_initial_state[7];
+
+    memcpy(w, p_digest_in, DIGEST_BLOCK_WORDS * sizeof(sha256_kernel_lanes_t));
+    for (t = DIGEST_BLOCK_WORDS; t < SHA256_KERNEL_BLOCK_WORDS; t++)
+    {
+        w[t] = (sha256_kernel_lanes_t){0} + _g_digest_padding[t - DIGEST_BLOCK_WORDS];
+    }
+    for (t = SHA256_KERNEL_BLOCK_WORDS; t < SHA256_KERNEL_SCHEDULE_WORDS; t++)
+    {
+        w[t] = SCHEDULE(w, t);
+    }
+
+    ROUNDS_8(0, w);
+
+    /* Rounds 8 to 15 only see padding, same as sha256_kernel_digest_hash */
+    ROUND(a, b, c, d, e, f, g, h, _g_digest_k_w[0]);
+    ROUND(h, a, b, c, d, e, f, g, _g_digest_k_w[1]);
+    ROUND(g, h, a, b, c, d, e, f, _g_digest_k_w[2]);
+    ROUND(f, g, h, a, b, c, d, e, _g_digest_k_w[3]);
+    ROUND(e, f, g, h, a, b, c, d, _g_digest_k_w[4]);
+    ROUND(d, e, f, g, h, a, b, c, _g_digest_k_w[5]);
+    ROUND(c, d, e, f, g, h, a, b, _g_digest_k_w[6]);
+    ROUND(b, c, d, e, f, g, h, a, _g_digest_k_w[7]);
+
+    for (t = 16; t < SHA256_KERNEL_SCHEDULE_WORDS; t += 8)
+    {
+        ROUNDS_8(t, w);
+    }
+
+    p_digest[0] = sha256_kernel_initial_state[0] + a;
+    p_digest[1] = sha256_kernel_initial_state[1] + b;
+    p_digest[2] = sha256_kernel_initial_state[2] + c;
+    p_digest[3] = sha256_kernel_initial_state[3] + d;
+    p_digest[4] = sha256_kernel_initial_state[4] + e;
+    p_digest[5] = sha256_kernel_initial_state[5] + f;
+    p_digest[6] = sha256_kernel_initial_state[6] + g;
+    p_digest[7] = sha256_kernel_initial_state[7] + h;
+}
+
+/* ============================== PRIVATE FUNCTION DEFINITIONS */
+
+/* ============================== INTERRUPT FUNCTION DEFINITIONS */
@@ -0,0 +1,154 @@
+/**
+ * @file sha256_merkle.c
+ * @author Iwan Ćulumović
+ * @brief SHA256 Merkle tree reduction. Reduces the leaves to the root level by level in place with the fixed length
+ * pair kernel and collects proof paths on the way. Plain C without platform dependencies.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/* ============================== INCLUDES */
+
+#include <stddef.h>
+#include "sha256_merkle.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/* ============================== TYPE DEFINITIONS */
+
+/* ============================== PRIVATE FUNCTION DECLARATIONS */
+
+/**
+ * @brief Stores the sibling of the ancestor of every proof on the level about to be reduced.
+ * 
+ * @param p_tree Pointer to the tree.
+ */
+static void _sha256_merkle_proofs_collect(sha256_merkle_tree_t *p_tree);
+
+/* ============================== PRIVATE VARIABLES */
+
+/* ============================== PUBLIC VARIABLES */
+
+/* ============================== PUBLIC FUNCTION DEFINITIONS */
+
+uint32_t sha256_merkle_depth(uint32_t leaf_count)
+{
+    uint32_t depth = 0;
+
+    while (leaf_count > 1)
+    {
+        leaf_count = (leaf_count + 1) / 2;
+        depth++;
+    }
+
+    return depth;
+}
+
+uint32_t sha256_merkle_hashes(uint32_t leaf_count, uint8_t flags)
+{
+    uint32_t hashes = (0 != (SHA256_MERKLE_FLAG_HASH_LEAVES & flags)) ? leaf_count : 0;
+
+    while (leaf_count > 1)
+    {
+        leaf_count = (leaf_count + 1) / 2;
+        hashes += leaf_count;
+    }
+
+    return hashes;
+}
+
+void sha256_merkle_tree_init(sha256_merkle_tree_t *p_tree, sha256_merkle_node_t *p_nodes, uint32_t leaf_count, uint8_t flags, sha256_merkle_proof_t *p_proofs, uint32_t proof_count)
+{
+    uint32_t i = 0;
+
+    p_tree->p_nodes = p_nodes;
+    p_tree->node_count = leaf_count;
+    p_tree->node_index = 0;
+    p_tree->level = 0;
+    p_tree->flags = flags;
+    p_tree->b_leaves_pending = (0 != (SHA256_MERKLE_FLAG_HASH_LEAVES & flags));
+    p_tree->p_proofs = p_proofs;
+    p_tree->proof_count = proof_count;
+
+    for (i = 0; i < proof_count; i++)
+    {
+        p_proofs[i].node_index = p_proofs[i].leaf_index;
+    }
+}
+
+uint32_t sha256_merkle_tree_reduce(sha256_merkle_tree_t *p_tree, uint32_t max_hashes)
+{
+    sha256_merkle_node_t *p_nodes = p_tree->p_nodes;
+    bool b_sha256d = (0 != (SHA256_MERKLE_FLAG_SHA256D & p_tree->flags));
+    uint32_t hashes = 0;
+    uint32_t parent_count = 0;
+    uint32_t left = 0;
+    uint32_t right = 0;
+
+    /* Leaves are hashed in place before the first level, each is a single 32 byte message */
+    while ((true == p_tree->b_leaves_pending) && (hashes < max_hashes))
+    {
+        sha256_kernel_digest_hash(p_nodes[p_tree->node_index].words, p_nodes[p_tree->node_index].words);
+        if (true == b_sha256d) sha256_kernel_digest_hash(p_nodes[p_tree->node_index].words, p_nodes[p_tree->node_index].words);
+
+        hashes++;
+        p_tree->node_index++;
+        if (p_tree->node_index == p_tree->node_count)
+        {
+            p_tree->node_index = 0;
+            p_tree->b_leaves_pending = false;
+        }
+    }
+
+    while ((p_tree->node_count > 1) && (hashes < max_hashes))
+    {
+        if (0 == p_tree->node_index) _sha256_merkle_proofs_collect(p_tree);
+
+        /* Parent j only reads children 2j and 2j + 1, which are never below j, so the level is reduced in place */
+        left = 2 * p_tree->node_index;
+        right = ((left + 1) < p_tree->node_count) ? (left + 1) : left;
+        sha256_kernel_pair_hash(p_nodes[left].words, p_nodes[right].words, p_nodes[p_tree->node_index].words);
+        if (true == b_sha256d) sha256_kernel_digest_hash(p_nodes[p_tree->node_index].words, p_nodes[p_tree->node_index].words);
+
+        hashes++;
+        p_tree->node_index++;
+        parent_count = (p_tree->node_count + 1) / 2;
+        if (p_tree->node_index == parent_count)
+        {
+            p_tree->node_count = parent_count;
+            p_tree->node_index = 0;
+            p_tree->level++;
+        }
+    }
+
+    return hashes;
+}
+
+bool sha256_merkle_tree_done(const sha256_merkle_tree_t *p_tree)
+{
+    return ((false == p_tree->b_leaves_pending) && (1 == p_tree->node_count));
+}
+
+/* ============================== PRIVATE FUNCTION DEFINITIONS */
+
+static void _sha256_merkle_proofs_collect(sha256_merkle_tree_t *p_tree)
+{
+    sha256_merkle_proof_t *p_proof = NULL;
+    uint32_t sibling = 0;
+    uint32_t i = 0;
+
+    for (i = 0; i < p_tree->proof_count; i++)
+    {
+        p_proof = &p_tree->p_proofs[i];
+
+        /* Last node of an odd level is its own sibling */
+        sibling = p_proof->node_index ^ 1;
+        if (sibling >= p_tree->node_count) sibling = p_proof->node_index;
+
+        p_proof->p_siblings[p_tree->level] = p_tree->p_nodes[sibling];
+        p_proof->node_index /= 2;
+    }
+}
+
+/* ============================== INTERRUPT FUNCTION DEFINITIONS */
@@ -0,0 +1,206 @@
+/**
+ * @file sha256_result_cache.c
+ * @author Iwan Ćulumović
+ * @brief SHA256 result cache module. Bounded LRU cache of solved puzzles so resubmitted puzzles are answered without
+ * searching again.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/* ============================== INCLUDES */
+
+#include <string.h>
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "sha256_result_cache.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Log tag. */
+#define LOG_TAG                                 ("SHA256_CACHE")
+
+/** @brief Number of cached puzzles. */
+#define SHA256_RESULT_CACHE_SIZE                (CONFIG_SHA256_CALC_RESULT_CACHE_SIZE)
+
+/* ============================== TYPE DEFINITIONS */
+
+/**
+ * @brief Result cache entry.
+ * 
+ */
+typedef struct {
+    bool b_valid;                                           //! Entry holds a solved puzzle
+    uint8_t target_solution_mask_offset;                    //! Mask offset of the puzzle
+    uint8_t target_solution[SHA256_BYTE_DIGEST_SIZE];       //! Target solution with bits outside of the mask cleared
+    sha256_nonce_t start;                                   //! Start offset of the search
+    sha256_nonce_t solution;                                //! First matching offset at or after the start offset
+    uint32_t last_used;                                     //! Use stamp for LRU eviction
+} sha256_result_cache_entry_t;
+
+/* ============================== PRIVATE FUNCTION DECLARATIONS */
+
+/**
+ * @brief Copies the target solution of the input variables with bits outside of the mask cleared.
+ * 
+ * @param p_sha256_input_variables Pointer to the input variables.
+ * @param p_target_solution Pointer to where the masked target solution will be written.
+ */
+static void _sha256_result_cache_masked_target(const sha256_input_variables_t *p_sha256_input_variables, uint8_t *p_target_solution);
+
+/**
+ * @brief Finds the entry with the same masked target solution and solution.
+ * 
+ * @param p_sha256_input_variables Pointer to the input variables.
+ * @param p_target_solution Pointer to the masked target solution.
+ * @param solution Offset solution.
+ * 
+ * @return sha256_result_cache_entry_t* Matching entry or NULL.
+ */
+static sha256_result_cache_entry_t *_sha256_result_cache_find(const sha256_input_variables_t *p_sha256_input_variables, const uint8_t *p_target_solution, sha256_nonce_t solution);
+
+/* ============================== PRIVATE VARIABLES */
+
+/** @brief Result cache entries. */
+static sha256_result_cache_entry_t _g_sha256_result_cache[SHA256_RESULT_CACHE_SIZE] = {0};
+
+/** @brief Use stamp of the most recently used entry. */
+static uint32_t _g_sha256_result_cache_stamp = 0;
+
+/* ============================== PUBLIC VARIABLES */
+
+/* ============================== PUBLIC FUNCTION DEFINITIONS */
+
+void sha256_result_cache_init(void)
+{
+    memset(_g_sha256_result_cache, 0, sizeof(_g_sha256_result_cache));
+    _g_sha256_result_cache_stamp = 0;
+
+    ESP_LOGI(LOG_TAG, "Initialized result cache with %d entries.", SHA256_RESULT_CACHE_SIZE);
+}
+
+sha256_result_cache_lookup_t sha256_result_cache_lookup(const sha256_input_variables_t *p_sha256_input_variables, sha256_nonce_t *p_range_start, sha256_nonce_t *p_solution)
+{
+    sha256_result_cache_lookup_t lookup = SHA256_RESULT_CACHE_MISS;
+    sha256_result_cache_entry_t *p_entry = NULL;
+    sha256_result_cache_entry_t *p_best = NULL;
+    uint8_t target_solution[SHA256_BYTE_DIGEST_SIZE] = {0};
+    sha256_nonce_t start = p_sha256_input_variables->input_offset;
+    sha256_nonce_t distance = 0;
+    sha256_nonce_t best_distance = (sha256_nonce_t)-1;
+    int i = 0;
+
+    _sha256_result_cache_masked_target(p_sha256_input_variables, target_solution);
+
+    for (i = 0; i < SHA256_RESULT_CACHE_SIZE; i++)
+    {
+        p_entry = &_g_sha256_result_cache[i];
+
+        if (false == p_entry->b_valid) continue;
+        if (p_entry->target_solution_mask_offset != p_sha256_input_variables->target_solution_mask_offset) continue;
+        if (0 != memcmp(p_entry->target_solution, target_solution, SHA256_BYTE_DIGEST_SIZE)) continue;
+
+        /* Offsets wrap around, so ranges are compared as distances from the entry start offset */
+        if ((start - p_entry->start) <= (p_entry->solution - p_entry->start))
+        {
+            lookup = SHA256_RESULT_CACHE_HIT;
+            p_best = p_entry;
+            break;
+        }
+
+        /* Prefer the range the search reaches first */
+        distance = p_entry->start - start;
+        if (distance < best_distance)
+        {
+            lookup = SHA256_RESULT_CACHE_RANGE;
+            best_distance = distance;
+            p_best = p_entry;
+        }
+    }
+
+    if (NULL != p_best)
+    {
+        p_best->last_used = ++_g_sha256_result_cache_stamp;
+        *p_range_start = p_best->start;
+        *p_solution = p_best->solution;
+    }
+
+    return lookup;
+}
+
+void sha256_result_cache_insert(const sha256_input_variables_t *p_sha256_input_variables, sha256_nonce_t solution)
+{
+    sha256_result_cache_entry_t *p_entry = NULL;
+    uint8_t target_solution[SHA256_BYTE_DIGEST_SIZE] = {0};
+    sha256_nonce_t start = p_sha256_input_variables->input_offset;
+    int i = 0;
+
+    _sha256_result_cache_masked_target(p_sha256_input_variables, target_solution);
+
+    /* Same puzzle and solution, keep the widest searched range */
+    p_entry = _sha256_result_cache_find(p_sha256_input_variables, target_solution, solution);
+    if (NULL != p_entry)
+    {
+        if ((solution - start) > (solution - p_entry->start)) p_entry->start = start;
+        p_entry->last_used = ++_g_sha256_result_cache_stamp;
+        return;
+    }
+
+    /* Take a free entry or evict the least recently used one */
+    p_entry = &_g_sha256_result_cache[0];
+    for (i = 0; i < SHA256_RESULT_CACHE_SIZE; i++)
+    {
+        if (false == _g_sha256_result_cache[i].b_valid)
+        {
+            p_entry = &_g_sha256_result_cache[i];
+            break;
+        }
+        if (_g_sha256_result_cache[i].last_used < p_entry->last_used) p_entry = &_g_sha256_result_cache[i];
+    }
+
+    p_entry->b_valid = true;
+    p_entry->target_solution_mask_offset = p_sha256_input_variables->target_solution_mask_offset;
+    memcpy(p_entry->target_solution, target_solution, SHA256_BYTE_DIGEST_SIZE);
+    p_entry->start = start;
+    p_entry->solution = solution;
+    p_entry->last_used = ++_g_sha256_result_cache_stamp;
+}
+
+/* ============================== PRIVATE FUNCTION DEFINITIONS */
+
+static void _sha256_result_cache_masked_target(const sha256_input_variables_t *p_sha256_input_variables, uint8_t *p_target_solution)
+{
+    int mask_bits = p_sha256_input_variables->target_solution_mask_offset + 1;
+    int full_bytes = mask_bits / 8;
+    int remaining_bits = mask_bits % 8;
+
+    memset(p_target_solution, 0, SHA256_BYTE_DIGEST_SIZE);
+    memcpy(p_target_solution, p_sha256_input_variables->target_solution, full_bytes);
+    if (0 != remaining_bits)
+    {
+        p_target_solution[full_bytes] = p_sha256_input_variables->target_solution[full_bytes] & (0xFF << (8 - remaining_bits));
+    }
+}
+
+static sha256_result_cache_entry_t *_sha256_result_cache_find(const sha256_input_variables_t *p_sha256_input_variables, const uint8_t *p_target_solution, sha256_nonce_t solution)
+{
+    sha256_result_cache_entry_t *p_entry = NULL;
+    int i = 0;
+
+    for (i = 0; i < SHA256_RESULT_CACHE_SIZE; i++)
+    {
+        p_entry = &_g_sha256_result_cache[i];
+
+        if ((true == p_entry->b_valid) &&
+            (p_entry->solution == solution) &&
+            (p_entry->target_solution_mask_offset == p_sha256_input_variables->target_solution_mask_offset) &&
+            (0 == memcmp(p_entry->target_solution, p_target_solution, SHA256_BYTE_DIGEST_SIZE)))
+        {
+            return p_entry;
+        }
+    }
+
+    return NULL;
+}
+
+/* ============================== INTERRUPT FUNCTION DEFINITIONS */
@@ -0,0 +1,249 @@
+/**
+ * @file sha256_stream.c
+ * @author Iwan Ćulumović
+ * @brief SHA256 stream module. Hashes a message the master streams in frames, frame by frame as they arrive, and
+ * queues its digest once the last frame arrived. Frames are handled in the transport task, which never waits for flow
+ * control: a digest that finds the queue full is dropped and counted in the next digest.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/* ============================== INCLUDES */
+
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include "sha256_stream.h"
+#include "freertos/FreeRTOS.h"
+#include "spsc_ring.h"
+#include "mbedtls/sha256.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/** @brief Log tag. */
+#define LOG_TAG                                 ("SHA256_STREAM")
+
+/** @brief Digest queue size. Must be a power of two. */
+#define SHA256_STREAM_DIGEST_QUEUE_SIZE         (2)
+
+/** @brief Frame size of the startup benchmark in bytes. */
+#define SHA256_STREAM_BENCHMARK_FRAME_SIZE      (4096)
+
+/** @brief Number of frames hashed by the startup benchmark. */
+#define SHA256_STREAM_BENCHMARK_FRAMES          (64)
+
+/* ============================== TYPE DEFINITIONS */
+
+/**
+ * @brief Message being streamed.
+ * 
+ */
+typedef struct {
+    bool b_active;                                      //! First frame arrived and the last one didn't yet
+    bool b_frame_lost;                                  //! A frame was lost or came out of order
+    uint8_t dropped;                                    //! Digests dropped since the last queued one
+    uint8_t puzzle_id;                                  //! Puzzle ID of the first frame
+    uint16_t sequence;                                  //! Sequence number of the next frame
+    uint64_t message_size;                              //! Bytes hashed so far
+    int64_t start_us;                                   //! Arrival of the first frame
+    mbedtls_sha256_context sha256_context;              //! Hash of the bytes so far
+} sha256_stream_t;
+
+/* ============================== PRIVATE FUNCTION DECLARATIONS */
+
+/**
+ * @brief Starts a new message.
+ * 
+ * @param puzzle_id Puzzle ID of the message.
+ */
+static void _sha256_stream_start(uint8_t puzzle_id);
+
+/**
+ * @brief Finishes the message and puts its digest into the digest queue. If the queue is full the digest is dropped
+ * and counted. Non-blocking function.
+ * 
+ */
+static void _sha256_stream_finish(void);
+
+#ifdef CONFIG_SHA256_CALC_BENCHMARK
+/**
+ * @brief Measures and logs the stream hashing throughput in MB/s, without the transport.
+ * 
+ */
+static void _sha256_stream_benchmark(void);
+#endif
+
+/* ============================== PRIVATE VARIABLES */
+
+/** @brief Digest queue, produced by the transport task and consumed by flow control. */
+static spsc_ring_t _g_queue_sha256_stream_digest = {0};
+
+/** @brief Digest queue storage. */
+static sha256_stream_digest_queue_element_t _g_queue_sha256_stream_digest_storage[SHA256_STREAM_DIGEST_QUEUE_SIZE] = {0};
+
+/** @brief Message being streamed, only touched by the transport task. */
+static sha256_stream_t _g_sha256_stream = {0};
+
+/* ============================== PUBLIC VARIABLES */
+
+/* ============================== PUBLIC FUNCTION DEFINITIONS */
+
+void sha256_stream_init(void)
+{
+    if (false == spsc_ring_init(&_g_queue_sha256_stream_digest, _g_queue_sha256_stream_digest_storage, SHA256_STREAM_DIGEST_QUEUE_SIZE, sizeof(sha256_stream_digest_queue_element_t)))
+    {
+        ESP_LOGE(LOG_TAG, "Failed to create queue for SHA256 stream digest. Aborting!");
+        abort();
+    }
+
+    mbedtls_sha256_init(&_g_sha256_stream.sha256_context);
+
+#ifdef CONFIG_SHA256_CALC_BENCHMARK
+    _sha256_stream_benchmark();
+#endif
+
+    ESP_LOGI(LOG_TAG, "Initialized stream.");
+}
+
+void sha256_stream_frame(uint8_t puzzle_id, uint8_t flags, uint16_t sequence, const uint8_t *p_data, size_t data_size)
+{
+    sha256_stream_t *p_stream = &_g_sha256_stream;
+
+    if (0 != (SHA256_STREAM_FLAG_FIRST & flags))
+    {
+        if (true == p_stream->b_active)
+        {
+            ESP_LOGW(LOG_TAG, "Stream of puzzle ID %d dropped after %llu bytes.", p_stream->puzzle_id, (unsigned long long)p_stream->message_size);
+        }
+
+        _sha256_stream_start(puzzle_id);
+    }
+    /* A frame without a started message still gets a digest response, so the master learns about it */
+    else if (false == p_stream->b_active)
+    {
+        _sha256_stream_start(puzzle_id);
+        p_stream->b_frame_lost = true;
+    }
+
+    /* Frames of a lost message are only counted, the digest of the message can't be correct anymore */
+    if ((NULL == p_data) || (sequence != p_stream->sequence) || (puzzle_id != p_stream->puzzle_id))
+    {
+        p_stream->b_frame_lost = true;
+    }
+
+    if (false == p_stream->b_frame_lost)
+    {
+        mbedtls_sha256_update(&p_stream->sha256_context, p_data, data_size);
+    }
+
+    p_stream->sequence = sequence + 1;
+    p_stream->message_size += data_size;
+
+    if (0 != (SHA256_STREAM_FLAG_LAST & flags))
+    {
+        _sha256_stream_finish();
+    }
+}
+
+bool sha256_stream_queue_digest_get(sha256_stream_digest_queue_element_t *p_sha256_stream_digest_queue_element)
+{
+    return spsc_ring_pop(&_g_queue_sha256_stream_digest, p_sha256_stream_digest_queue_element);
+}
+
+/* ============================== PRIVATE FUNCTION DEFINITIONS */
+
+static void _sha256_stream_start(uint8_t puzzle_id)
+{
+    sha256_stream_t *p_stream = &_g_sha256_stream;
+
+    p_stream->b_active = true;
+    p_stream->b_frame_lost = false;
+    p_stream->puzzle_id = puzzle_id;
+    p_stream->sequence = 0;
+    p_stream->message_size = 0;
+    p_stream->start_us = esp_timer_get_time();
+
+    mbedtls_sha256_starts(&p_stream->sha256_context, 0);
+}
+
+static void _sha256_stream_finish(void)
+{
+    sha256_stream_t *p_stream = &_g_sha256_stream;
+    sha256_stream_digest_queue_element_t sha256_stream_digest_queue_element = {0};
+    int64_t duration_us = esp_timer_get_time() - p_stream->start_us;
+    uint64_t mb_per_s_x100 = 0;
+
+    sha256_stream_digest_queue_element.puzzle_id = p_stream->puzzle_id;
+    sha256_stream_digest_queue_element.message_size = p_stream->message_size;
+    sha256_stream_digest_queue_element.duration_us = (uint32_t)duration_us;
+
+    if (true == p_stream->b_frame_lost)
+    {
+        ESP_LOGW(LOG_TAG, "Stream of puzzle ID %d lost a frame.", p_stream->puzzle_id);
+        sha256_stream_digest_queue_element.status = SHA256_STREAM_STATUS_FRAME_LOST;
+    }
+    else
+    {
+        mbedtls_sha256_finish(&p_stream->sha256_context, sha256_stream_digest_queue_element.digest);
+        sha256_stream_digest_queue_element.status = SHA256_STREAM_STATUS_DONE;
+
+        /* Bytes per microsecond are MB/s, logged with two decimals */
+        if (duration_us <= 0) duration_us = 1;
+        mb_per_s_x100 = (p_stream->message_size * 100) / (uint64_t)duration_us;
+        ESP_LOGI(LOG_TAG, "Stream of %llu bytes hashed in %lld us, %llu.%02llu MB/s.",
+            (unsigned long long)p_stream->message_size, (long long)duration_us,
+            (unsigned long long)(mb_per_s_x100 / 100), (unsigned long long)(mb_per_s_x100 % 100));
+    }
+
+    p_stream->b_active = false;
+
+    /* Waiting for flow control here would stall the transport task, which flow control may itself wait on to send a
+       response. The master learns about dropped digests from the next one and streams those messages again. */
+    sha256_stream_digest_queue_element.dropped = p_stream->dropped;
+    if (true == spsc_ring_push(&_g_queue_sha256_stream_digest, &sha256_stream_digest_queue_element))
+    {
+        p_stream->dropped = 0;
+    }
+    else
+    {
+        ESP_LOGW(LOG_TAG, "Digest of puzzle ID %d dropped, digest queue full.", p_stream->puzzle_id);
+        if (UINT8_MAX != p_stream->dropped) p_stream->dropped++;
+    }
+}
+
+#ifdef CONFIG_SHA256_CALC_BENCHMARK
+static void _sha256_stream_benchmark(void)
+{
+    static uint8_t frame[SHA256_STREAM_BENCHMARK_FRAME_SIZE] = {0};
+    mbedtls_sha256_context sha256_context = {0};
+    uint8_t hash[SHA256_BYTE_DIGEST_SIZE] = {0};
+    int64_t start_us = 0;
+    int64_t duration_us = 0;
+    uint64_t mb_per_s_x100 = 0;
+    int i = 0;
+
+    mbedtls_sha256_init(&sha256_context);
+
+    start_us = esp_timer_get_time();
+    mbedtls_sha256_starts(&sha256_context, 0);
+    for (i = 0; i < SHA256_STREAM_BENCHMARK_FRAMES; i++)
+    {
+        mbedtls_sha256_update(&sha256_context, frame, sizeof(frame));
+    }
+    mbedtls_sha256_finish(&sha256_context, hash);
+    duration_us = esp_timer_get_time() - start_us;
+
+    mbedtls_sha256_free(&sha256_context);
+
+    /* Bytes per microsecond are MB/s, logged with two decimals */
+    if (duration_us <= 0) duration_us = 1;
+    mb_per_s_x100 = ((uint64_t)SHA256_STREAM_BENCHMARK_FRAMES * SHA256_STREAM_BENCHMARK_FRAME_SIZE * 100) / (uint64_t)duration_us;
+    ESP_LOGI(LOG_TAG, "Benchmark of %d frames of %d bytes: %lld us, %llu.%02llu MB/s.",
+        SHA256_STREAM_BENCHMARK_FRAMES, SHA256_STREAM_BENCHMARK_FRAME_SIZE, (long long)duration_us,
+        (unsigned long long)(mb_per_s_x100 / 100), (unsigned long long)(mb_per_s_x100 % 100));
+}
+#endif
+
+/* ============================== INTERRUPT FUNCTION DEFINITIONS */
@@ -0,0 +1,102 @@
+/**
+ * @file spsc_ring.c
+ * @author Iwan Ćulumović
+ * @brief Lock-free single producer single consumer ring buffer module. Doesn't depend on FreeRTOS so it can be used
+ * between an ISR and a task, or between tasks on different cores, without critical sections.
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/* ============================== INCLUDES */
+
+#include <string.h>
+#include "spsc_ring.h"
+
+/* ============================== MACRO DEFINITIONS */
+
+/* ============================== TYPE DEFINITIONS */
+
+/* ============================== PRIVATE FUNCTION DECLARATIONS */
+
+/* ============================== PRIVATE VARIABLES */
+
+/* ============================== PUBLIC VARIABLES */
+
+/* ============================== PUBLIC FUNCTION DEFINITIONS */
+
+bool spsc_ring_init(spsc_ring_t *p_ring, void *p_storage, uint32_t capacity, size_t item_size)
+{
+    if ((0 == capacity) || (0 != (capacity & (capacity - 1)))) return false;
+
+    atomic_init(&p_ring->head, 0);
+    atomic_init(&p_ring->tail, 0);
+    p_ring->tail_cache = 0;
+    p_ring->head_cache = 0;
+    p_ring->p_storage = (uint8_t *)p_storage;
+    p_ring->mask = capacity - 1;
+    p_ring->item_size = item_size;
+
+    return true;
+}
+
+bool spsc_ring_push(spsc_ring_t *p_ring, const void *p_item)
+{
+    uint32_t head = atomic_load_explicit(&p_ring->head, memory_order_relaxed);
+
+    /* Only reload the consumer index when the cached one says the ring is full */
+    if ((head - p_ring->tail_cache) > p_ring->mask)
+    {
+        p_ring->tail_cache = atomic_load_explicit(&p_ring->tail, memory_order_acquire);
+        if ((head - p_ring->tail_cache) > p_ring->mask) return false;
+    }
+
+    memcpy(&p_ring->p_storage[(head & p_ring->mask) * p_ring->item_size], p_item, p_ring->item_size);
+
+    /* Publish the item, release orders the copy before the index update */
+    atomic_store_explicit(&p_ring->head, head + 1, memory_order_release);
+
+    return true;
+}
+
+bool spsc_ring_pop(spsc_ring_t *p_ring, void *p_item)
+{
+    uint32_t tail = atomic_load_explicit(&p_ring->tail, memory_order_relaxed);
+
+    /* Only reload the producer index when the cached one says the ring is empty */
+    if (tail == p_ring->head_cache)
+    {
+        p_ring->head_cache = atomic_load_explicit(&p_ring->head, memory_order_acquire);
+        if (tail == p_ring->head_cache) return false;
+    }
+
+    memcpy(p_item, &p_ring->p_storage[(tail & p_ring->mask) * p_ring->item_size], p_ring->item_size);
+
+    /* Free the slot, release orders the copy before the index update */
+    atomic_store_explicit(&p_ring->tail, tail + 1, memory_order_release);
+
+    return true;
+}
+
+bool spsc_ring_is_empty(spsc_ring_t *p_ring)
+{
+    uint32_t tail = atomic_load_explicit(&p_ring->tail, memory_order_relaxed);
+
+    if (tail != p_ring->head_cache) return false;
+
+    p_ring->head_cache = atomic_load_explicit(&p_ring->head, memory_order_acquire);
+
+    return (tail == p_ring->head_cache);
+}
+
+uint32_t spsc_ring_count(spsc_ring_t *p_ring)
+{
+    uint32_t tail = atomic_load_explicit(&p_ring->tail, memory_order_acquire);
+    uint32_t head = atomic_load_explicit(&p_ring->head, memory_order_acquire);
+
+    return head - tail;
+}
+
+/* ============================== PRIVATE FUNCTION DEFINITIONS */
+
+/* ============================== INTERRUPT FUNCTION DEFINITIONS */